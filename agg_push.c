@@ -0,0 +1,418 @@
+//------------------------------------------------------------------------------
+/**
+ * @file agg_push.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server result push to line aggregator (tools/jig_agg).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+//------------------------------------------------------------------------------
+#include "agg_push.h"
+#include "result_store.h"
+#include "lz.h"
+#include "crc.h"
+
+//------------------------------------------------------------------------------
+static char         AggHost [64];
+static int          AggPort = AGG_PORT;
+static char         AggStation [AGG_STATION_SIZE];
+static char         AggPath [128];
+
+static int          AggFd   = -1;   // aggregator socket
+static int          StoreFd = -1;   // result.dat (read only)
+static uint32_t     StoreId = 0;
+static uint64_t     AggCursor = 0;
+
+static uint8_t      *RawBuf = NULL, *LzBuf = NULL;
+static uint32_t     AggSent = 0;
+
+static pthread_t    thread_agg;
+
+//------------------------------------------------------------------------------
+static void agg_close (void)
+{
+    if (AggFd >= 0)     close (AggFd);
+    AggFd = -1;
+}
+
+//------------------------------------------------------------------------------
+static int agg_send (const void *data, int len)
+{
+    const uint8_t *p = data;
+    int ret, pos = 0;
+
+    while (pos < len) {
+        if ((ret = send (AggFd, p + pos, len - pos, MSG_NOSIGNAL)) <= 0) {
+            if ((ret < 0) && (errno == EINTR))  continue;
+            printf ("%s : %s:%d send error (%s)\n", __func__, AggHost, AggPort,
+                ret ? strerror(errno) : "closed");
+            return 0;
+        }
+        pos += ret;
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// ACK / NACK 수신 (timeout_ms)
+//------------------------------------------------------------------------------
+static int agg_recv_ack (agg_msg_t *pmsg, int timeout_ms)
+{
+    struct pollfd pfd = { .fd = AggFd, .events = POLLIN };
+    uint8_t *p = (uint8_t *)pmsg;
+    int ret, pos = 0;
+
+    while (pos < (int)sizeof(agg_msg_t)) {
+        if (poll (&pfd, 1, timeout_ms) != 1) {
+            printf ("%s : %s:%d ack timeout\n", __func__, AggHost, AggPort);
+            return 0;
+        }
+        if ((ret = recv (AggFd, p + pos, sizeof(agg_msg_t) - pos, 0)) <= 0) {
+            if ((ret < 0) && (errno == EINTR))  continue;
+            return 0;
+        }
+        pos += ret;
+    }
+    if ((pmsg->magic != AGG_MAGIC) || (pmsg->type != eAGG_ACK)) {
+        printf ("%s : %s:%d nack (type = %d)\n", __func__, AggHost, AggPort, pmsg->type);
+        return 0;
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+static void agg_msg_init (agg_msg_t *pmsg, int type)
+{
+    memset (pmsg, 0, sizeof(agg_msg_t));
+    pmsg->magic    = AGG_MAGIC;
+    pmsg->type     = (uint16_t)type;
+    pmsg->store_id = StoreId;
+    memcpy (pmsg->station, AggStation, AGG_STATION_SIZE);
+}
+
+//------------------------------------------------------------------------------
+// store id : 첫 record 의 crc (record 가 없으면 0)
+//------------------------------------------------------------------------------
+static int agg_store_open (void)
+{
+    result_hdr_t hdr;
+
+    if ((StoreFd < 0) && ((StoreFd = open (AggPath, O_RDONLY)) < 0))
+        return 0;
+    if (pread (StoreFd, &hdr, sizeof(hdr), 0) != sizeof(hdr))  return 0;
+    if (hdr.magic != RESULT_REC_MAGIC)                          return 0;
+
+    StoreId = hdr.crc;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// offset 의 record 가 완전히 기록되었고 crc 가 맞으면 return record size (buf = 임시 buffer)
+//------------------------------------------------------------------------------
+static int agg_rec_valid (uint64_t offset, uint64_t end, uint8_t *buf)
+{
+    result_hdr_t hdr;
+    int rec;
+
+    if (offset + sizeof(hdr) > end)                                 return 0;
+    if (pread (StoreFd, &hdr, sizeof(hdr), offset) != sizeof(hdr))  return 0;
+    if ((hdr.magic != RESULT_REC_MAGIC) || (hdr.size > AGG_BATCH_SIZE - sizeof(hdr)))
+        return 0;
+
+    rec = sizeof(hdr) + hdr.size;
+    if ((offset + rec > end) || (pread (StoreFd, buf, rec, offset) != rec))    return 0;
+    if (crc32_calc (buf + sizeof(hdr), hdr.size) != hdr.crc)                   return 0;
+    return rec;
+}
+
+//------------------------------------------------------------------------------
+// offset 이후 다음 정상 record (result_store 가 건너뛴 깨진 구간 다음), return 0 = 없음
+//------------------------------------------------------------------------------
+static uint64_t agg_rec_resync (uint64_t offset, uint64_t end)
+{
+    const uint32_t magic = RESULT_REC_MAGIC;
+    uint8_t buf [4096];
+    ssize_t len, i;
+
+    for (; offset + sizeof(result_hdr_t) <= end; offset += len - (sizeof(magic) -1)) {
+        if ((len = pread (StoreFd, buf, sizeof(buf), offset)) < (ssize_t)sizeof(magic))
+            break;
+        for (i = 0; i + (ssize_t)sizeof(magic) <= len; i++)
+            if (!memcmp (&buf[i], &magic, sizeof(magic)) && agg_rec_valid (offset + i, end, LzBuf))
+                return offset + i;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// cursor 이하의 마지막 record 경계 (return == cursor 이면 record 경계)
+//------------------------------------------------------------------------------
+static uint64_t agg_boundary (uint64_t cursor, uint64_t end)
+{
+    uint64_t offset = 0, next;
+    int rec;
+
+    while (offset < cursor) {
+        if ((rec = agg_rec_valid (offset, end, LzBuf)) != 0)
+            next = offset + rec;
+        else if ((next = agg_rec_resync (offset + 1, end)) == 0)
+            break;
+        if (next > cursor)  break;
+        offset = next;
+    }
+    return offset;
+}
+
+//------------------------------------------------------------------------------
+static int agg_hello (void)
+{
+    agg_msg_t msg;
+
+    agg_msg_init (&msg, eAGG_HELLO);
+    if (!agg_send (&msg, sizeof(msg)) || !agg_recv_ack (&msg, AGG_ACK_MS))
+        return 0;
+    AggCursor = msg.offset;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// aggregator 의 resume offset 확인.
+// result.dat 이 잘렸거나 바뀌어서 EOF 이후 또는 record 중간이면 같은 offset 의 내용이 다르므로
+// store id 를 바꾸어 처음부터 다시 전송 (이전 store id, offset 으로 계산하므로 재시작 후에도 같은 id).
+//------------------------------------------------------------------------------
+static int agg_resume (void)
+{
+    struct stat st;
+    int i;
+
+    for (i = 0; i < AGG_RESYNC_MAX; i++) {
+        if (!agg_hello () || fstat (StoreFd, &st))  return 0;
+
+        if ((AggCursor <= (uint64_t)st.st_size) &&
+            (agg_boundary (AggCursor, st.st_size) == AggCursor))
+            return 1;
+
+        printf ("%s : store %08x resume offset %llu invalid (size %llu), new store\n",
+            __func__, StoreId, (unsigned long long)AggCursor, (unsigned long long)st.st_size);
+        StoreId = crc32_update (StoreId, &AggCursor, sizeof(AggCursor));
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+static int agg_connect (void)
+{
+    struct addrinfo hints, *res = NULL;
+    struct pollfd pfd;
+    struct timeval tv;
+    char port [8];
+    int fd, err = 0, i;
+    socklen_t len = sizeof(err);
+
+    memset (&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    snprintf (port, sizeof(port), "%d", AggPort);
+
+    if (getaddrinfo (AggHost, port, &hints, &res) || (res == NULL))
+        goto err_out;
+
+    if ((fd = socket (res->ai_family, res->ai_socktype | SOCK_NONBLOCK, 0)) < 0)
+        goto err_out;
+
+    if (connect (fd, res->ai_addr, res->ai_addrlen) && (errno != EINPROGRESS)) {
+        close (fd); goto err_out;
+    }
+    pfd.fd = fd;    pfd.events = POLLOUT;
+    if ((poll (&pfd, 1, AGG_CONNECT_MS) != 1) ||
+        getsockopt (fd, SOL_SOCKET, SO_ERROR, &err, &len) || err) {
+        close (fd); goto err_out;
+    }
+    freeaddrinfo (res);     res = NULL;
+
+    fcntl (fd, F_SETFL, fcntl (fd, F_GETFL) & ~O_NONBLOCK);
+    tv.tv_sec  = AGG_ACK_MS / 1000;
+    tv.tv_usec = (AGG_ACK_MS % 1000) * 1000;
+    setsockopt (fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    i = 1;
+    setsockopt (fd, SOL_SOCKET, SO_KEEPALIVE, &i, sizeof(i));
+    AggFd = fd;
+
+    /* aggregator 가 받은 위치부터 다시 전송 */
+    if (!agg_resume ()) {
+        agg_close ();
+        goto err_out;
+    }
+    printf ("%s : %s:%d connected, station %s, store %08x, resume offset %llu\n", __func__,
+        AggHost, AggPort, AggStation, StoreId, (unsigned long long)AggCursor);
+    return 1;
+
+err_out:
+    if (res != NULL)    freeaddrinfo (res);
+    printf ("%s : %s:%d connect fail (%s)\n", __func__, AggHost, AggPort,
+        err ? strerror(err) : strerror(errno));
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// cursor 부터 완전히 기록된 record 를 RawBuf 에 모음, return record 수
+//------------------------------------------------------------------------------
+static int agg_batch (int *psize)
+{
+    result_hdr_t hdr;
+    struct stat st;
+    uint64_t offset = AggCursor;
+    int cnt = 0, size = 0, rec;
+
+    if (fstat (StoreFd, &st))   return 0;
+
+    while ((cnt < AGG_BATCH_MAX) && (offset + sizeof(hdr) <= (uint64_t)st.st_size)) {
+        if (pread (StoreFd, &hdr, sizeof(hdr), offset) != sizeof(hdr))  break;
+        rec = sizeof(hdr) + hdr.size;
+        if ((hdr.magic == RESULT_REC_MAGIC) && (hdr.size <= AGG_BATCH_SIZE - sizeof(hdr)) &&
+            (size + rec > AGG_BATCH_SIZE))
+            break;
+        /*
+            writer thread 가 기록 중인 record (뒤에 정상 record 없음) 는 다음 poll 에서 다시,
+            중간의 깨진 구간 (boot 시 result_store 가 건너뜀) 은 batch 첫 record 일때 건너뜀
+        */
+        if (!agg_rec_valid (offset, st.st_size, RawBuf + size)) {
+            uint64_t next;
+
+            if (cnt || ((next = agg_rec_resync (offset + 1, st.st_size)) == 0))
+                break;
+            printf ("%s : broken record, skip %llu ~ %llu\n", __func__,
+                (unsigned long long)offset, (unsigned long long)next);
+            AggCursor = offset = next;
+            continue;
+        }
+
+        size   += rec;
+        offset += rec;
+        cnt++;
+    }
+    *psize = size;
+    return cnt;
+}
+
+//------------------------------------------------------------------------------
+static int agg_push (int cnt, int size)
+{
+    agg_msg_t msg;
+    uint64_t next = AggCursor + size;
+    int len;
+
+    agg_msg_init (&msg, eAGG_DATA);
+    msg.cnt      = cnt;
+    msg.raw_size = size;
+    msg.crc      = crc32_calc (RawBuf, size);
+    msg.offset   = AggCursor;
+
+    len = lz_compress (RawBuf, size, LzBuf, AGG_PAYLOAD_MAX);
+    if (len && (len < size)) {
+        msg.flags = AGG_FLAG_LZ;
+        msg.size  = len;
+    } else
+        msg.size  = size;
+
+    if (!agg_send (&msg, sizeof(msg)) ||
+        !agg_send ((msg.flags & AGG_FLAG_LZ) ? LzBuf : RawBuf, msg.size) ||
+        !agg_recv_ack (&msg, AGG_ACK_MS))
+        return 0;
+
+    if (msg.offset != next)
+        printf ("%s : offset mismatch %llu != %llu\n", __func__,
+            (unsigned long long)msg.offset, (unsigned long long)next);
+    AggCursor = msg.offset;
+    AggSent  += cnt;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+static void *thread_agg_func (void *arg)
+{
+    int cnt, size;
+
+    while (1) {
+        /* result.dat 에 record 가 생긴 후 store id 확정 */
+        if ((AggFd < 0) && (!agg_store_open () || !agg_connect ())) {
+            usleep (AGG_RETRY_MS * 1000);
+            continue;
+        }
+        if (!(cnt = agg_batch (&size))) {
+            usleep (AGG_POLL_MS * 1000);
+            continue;
+        }
+        if (!agg_push (cnt, size)) {
+            agg_close ();
+            usleep (AGG_RETRY_MS * 1000);
+        }
+    }
+    return arg;
+}
+
+//------------------------------------------------------------------------------
+// A(cmd), host, [port], [station]
+//------------------------------------------------------------------------------
+int agg_push_config (char *cfg)
+{
+    char *tok;
+
+    if (strtok (cfg, ",") == NULL)                  return 0;
+    if ((tok = strtok (NULL, ", \t\r\n")) == NULL)  return 0;
+
+    memset  (AggHost, 0, sizeof(AggHost));
+    strncpy (AggHost, tok, sizeof(AggHost) -1);
+    if ((tok = strtok (NULL, ", \t\r\n")) != NULL)
+        AggPort = atoi (tok);
+    if ((tok = strtok (NULL, ", \t\r\n")) != NULL) {
+        memset  (AggStation, 0, sizeof(AggStation));
+        strncpy (AggStation, tok, sizeof(AggStation) -1);
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+int agg_push_init (const char *result_fname)
+{
+    if (!AggHost[0])    return 0;
+
+    memset  (AggPath, 0, sizeof(AggPath));
+    strncpy (AggPath, result_fname ? result_fname : RESULT_FILE_PATH, sizeof(AggPath) -1);
+    if (!AggStation[0])
+        gethostname (AggStation, sizeof(AggStation) -1);
+
+    RawBuf = malloc (AGG_BATCH_SIZE);
+    LzBuf  = malloc (AGG_PAYLOAD_MAX);
+    if ((RawBuf == NULL) || (LzBuf == NULL)) {
+        printf ("%s : memory alloc error\n", __func__);
+        return 0;
+    }
+    printf ("%s : station %s -> %s:%d\n", __func__, AggStation, AggHost, AggPort);
+    pthread_create (&thread_agg, NULL, thread_agg_func, NULL);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
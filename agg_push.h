@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------------
+/**
+ * @file agg_push.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server result push to line aggregator (tools/jig_agg).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __AGG_PUSH_H__
+#define __AGG_PUSH_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+//
+// server cfg 'A' line 이 있으면 result.dat 에 기록된 record 를 aggregator 로 전송.
+//
+//   A(cmd), host, [port], [station] (station 기본값 = hostname)
+//
+// 전송 단위는 result.dat 의 raw record (hdr + section, record crc 포함) 묶음.
+//   server -> agg : HELLO (station, store id)
+//   agg -> server : ACK (offset = 해당 station / store 에서 받은 마지막 record 다음 offset)
+//   server -> agg : DATA (offset 부터 최대 AGG_BATCH_MAX record, lz 압축)
+//   agg -> server : ACK (저장 후 다음 offset) / NACK (format 오류)
+//
+// 재전송 위치는 aggregator 가 알려주므로 server 는 cursor 를 따로 저장하지 않음.
+// aggregator 가 없는 동안에도 test 는 그대로 진행, 재접속시 밀린 record 부터 전송.
+// store id = result.dat 첫 record 의 crc (result.dat 를 지우고 새로 시작하면 다른 store).
+// resume offset 이 EOF 이후 또는 record 중간이면 (result.dat 이 잘리거나 바뀜) store id 를 바꾸어
+// 처음부터 다시 전송 (AGG_RESYNC_MAX 회). 중간의 깨진 record 구간은 건너뜀.
+//
+//------------------------------------------------------------------------------
+#define AGG_PORT            9200
+#define AGG_MAGIC           0x4D47414A  // "JAGM"
+#define AGG_STATION_SIZE    16
+
+#define AGG_BATCH_MAX       64
+#define AGG_BATCH_SIZE      (256*1024)
+#define AGG_PAYLOAD_MAX     (AGG_BATCH_SIZE + AGG_BATCH_SIZE / 255 + 16)   // LZ_BOUND
+
+#define AGG_POLL_MS         1000
+#define AGG_RETRY_MS        5000
+#define AGG_CONNECT_MS      1000
+#define AGG_ACK_MS          5000
+#define AGG_RESYNC_MAX      4
+
+enum {
+    eAGG_HELLO = 1,
+    eAGG_DATA,
+    eAGG_ACK,
+    eAGG_NACK,
+    eAGG_QUERY,     // jig_agg -q : payload = mac, 응답 DATA (agg record 묶음)
+};
+
+/* payload 압축 (lz.c) */
+#define AGG_FLAG_LZ         0x01
+
+typedef struct agg_msg__t {
+    uint32_t    magic;
+    uint16_t    type;
+    uint16_t    flags;
+    uint32_t    cnt;        // record 수
+    uint32_t    store_id;
+    uint32_t    raw_size;   // 압축 전 payload size
+    uint32_t    size;       // 전송 payload size
+    uint32_t    crc;        // crc32 (압축 전 payload)
+    uint32_t    reserved;
+    uint64_t    offset;     // DATA : 첫 record 의 result.dat offset, ACK : 다음 offset
+    char        station [AGG_STATION_SIZE];
+}   agg_msg_t;
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+/* server cfg 'A' line */
+extern  int     agg_push_config (char *cfg);
+extern  int     agg_push_init   (const char *result_fname);
+
+//------------------------------------------------------------------------------
+#endif  // __AGG_PUSH_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,492 @@
+//------------------------------------------------------------------------------
+/**
+ * @file backend.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server hardware backend (adc, gpio, fb, touch, printer).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+
+//------------------------------------------------------------------------------
+#include "backend.h"
+#include "lp_net.h"
+#include "lib_i2cadc/lib_i2cadc.h"
+#include "lib_usblp/lib_usblp.h"
+#include "lib_gpio/lib_gpio.h"
+#include "mono_time.h"
+
+//------------------------------------------------------------------------------
+#define MEM_ADC_FD_BASE     0x100
+#define MEM_ADC_CH_MAX      4
+#define MEM_GPIO_MAX        1024
+#define SCRIPT_ADC_MAX      64
+#define SCRIPT_VALUE_MAX    16
+
+//------------------------------------------------------------------------------
+// backend interface
+//------------------------------------------------------------------------------
+typedef struct adc_ops__t {
+    int     (*init)     (const char *i2c_path);
+    int     (*read)     (int fd, const char *name, int *value, int *pin);
+}   adc_ops_t;
+
+typedef struct gpio_ops__t {
+    int     (*export)   (int gpio);
+    int     (*direction)(int gpio, int dir);
+    int     (*get_value)(int gpio, int *value);
+    int     (*set_value)(int gpio, int value);
+}   gpio_ops_t;
+
+typedef struct fb_ops__t {
+    fb_info_t *(*init)  (const char *fb_path);
+}   fb_ops_t;
+
+typedef struct ts_ops__t {
+    ts_t    *(*init)    (const char *event_path);
+    void    (*deinit)   (ts_t *pts);
+    int     (*get_event)(fb_info_t *pfb, ts_t *pts, ts_event_t *event);
+}   ts_ops_t;
+
+typedef struct lp_ops__t {
+    int     (*config)   (void);
+    int     (*connection)(void);
+    int     (*print_mac)(char *mac, int ch);
+    int     (*print_err)(char *msg1, char *msg2, char *msg3, int ch);
+}   lp_ops_t;
+
+//------------------------------------------------------------------------------
+static const char *BackendName [eBACKEND_END] = { "dev", "mem", "script", "none", "net" };
+static const char *HwName      [eHW_END]      = { "adc", "gpio", "fb", "ts", "lp" };
+
+static int BackendType [eHW_END];
+
+//------------------------------------------------------------------------------
+// dev : 실제 device (lib 함수 return type 차이를 흡수)
+//------------------------------------------------------------------------------
+static int dev_adc_init (const char *i2c_path)
+{
+    return adc_board_init (i2c_path);
+}
+
+static int dev_adc_read (int fd, const char *name, int *value, int *pin)
+{
+    return adc_board_read (fd, name, value, pin);
+}
+
+static int dev_gpio_export      (int gpio)              { return gpio_export (gpio);            }
+static int dev_gpio_direction   (int gpio, int dir)     { return gpio_direction (gpio, dir);    }
+static int dev_gpio_get_value   (int gpio, int *value)  { return gpio_get_value (gpio, value);  }
+static int dev_gpio_set_value   (int gpio, int value)   { return gpio_set_value (gpio, value);  }
+
+static fb_info_t *dev_fb_init (const char *fb_path)
+{
+    return fb_init (fb_path);
+}
+
+static ts_t *dev_ts_init (const char *event_path)
+{
+    return ts_init (event_path);
+}
+
+static void dev_ts_deinit (ts_t *pts)
+{
+    ts_deinit (pts);
+}
+
+static int dev_ts_get_event (fb_info_t *pfb, ts_t *pts, ts_event_t *event)
+{
+    return ts_get_event (pfb, pts, event);
+}
+
+static int dev_lp_config     (void)  { return usblp_config ();      }
+static int dev_lp_connection (void)  { return usblp_connection ();  }
+
+static int dev_lp_print_mac (char *mac, int ch)
+{
+    usblp_print_mac (mac, ch);
+    return 1;
+}
+
+static int dev_lp_print_err (char *msg1, char *msg2, char *msg3, int ch)
+{
+    usblp_print_err (msg1, msg2, msg3, ch);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// mem / script : adc
+//------------------------------------------------------------------------------
+typedef struct script_adc__t {
+    char    name [32];
+    int     cnt;
+    int     mv  [SCRIPT_VALUE_MAX];
+    int     pos [MEM_ADC_CH_MAX];
+}   script_adc_t;
+
+static script_adc_t     ScriptAdc [SCRIPT_ADC_MAX];
+static int              ScriptAdcCnt = 0, MemAdcCnt = 0;
+static pthread_mutex_t  mem_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int mem_adc_init (const char *i2c_path)
+{
+    (void)i2c_path;
+    /* device_check.c 의 i2c_fd_to_ch() 에서 channel 구분 가능하도록 channel 별 fd */
+    return MEM_ADC_FD_BASE + (MemAdcCnt++ % MEM_ADC_CH_MAX);
+}
+
+static int mem_adc_read (int fd, const char *name, int *value, int *pin)
+{
+    int i, ch = (fd - MEM_ADC_FD_BASE) % MEM_ADC_CH_MAX;
+
+    *value = BACKEND_MEM_ADC_MV;
+    *pin   = 1;
+
+    if ((ch < 0) || (name == NULL))     return 1;
+
+    pthread_mutex_lock (&mem_mutex);
+    for (i = 0; i < ScriptAdcCnt; i++) {
+        script_adc_t *s = &ScriptAdc[i];
+
+        if (strcmp (s->name, name))     continue;
+        /* mem : name 별 고정값 (첫 값), script : 읽을 때 마다 순환 */
+        *value = s->mv[s->pos[ch]];
+        if (BackendType[eHW_ADC] == eBACKEND_SCRIPT)
+            s->pos[ch] = (s->pos[ch] + 1) % s->cnt;
+        break;
+    }
+    pthread_mutex_unlock (&mem_mutex);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// mem / script : gpio (set/script 로 값이 지정된 gpio 만 read 성공)
+//------------------------------------------------------------------------------
+static int  MemGpio      [MEM_GPIO_MAX];
+static char MemGpioValid [MEM_GPIO_MAX];
+
+static int mem_gpio_export    (int gpio)            { return (gpio >= 0) && (gpio < MEM_GPIO_MAX); }
+static int mem_gpio_direction (int gpio, int dir)   { (void)dir;  return mem_gpio_export (gpio); }
+
+static int mem_gpio_get_value (int gpio, int *value)
+{
+    if (!mem_gpio_export (gpio) || !MemGpioValid[gpio])     return 0;
+    *value = MemGpio[gpio];
+    return 1;
+}
+
+static int mem_gpio_set_value (int gpio, int value)
+{
+    if (!mem_gpio_export (gpio))    return 0;
+    MemGpio[gpio] = value;  MemGpioValid[gpio] = 1;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// mem : framebuffer (ui lib 가 memory 에 draw)
+//------------------------------------------------------------------------------
+static fb_info_t *mem_fb_init (const char *fb_path)
+{
+    fb_info_t *pfb;
+
+    (void)fb_path;
+    if ((pfb = calloc (1, sizeof(fb_info_t))) == NULL)  return NULL;
+
+    pfb->fd     = -1;
+    pfb->w      = BACKEND_MEM_FB_W;
+    pfb->h      = BACKEND_MEM_FB_H;
+    pfb->bpp    = BACKEND_MEM_FB_BPP;
+    pfb->stride = BACKEND_MEM_FB_W * (BACKEND_MEM_FB_BPP / 8);
+    if ((pfb->data = calloc (1, pfb->stride * pfb->h)) == NULL) {
+        free (pfb);
+        return NULL;
+    }
+    pfb->base = pfb->data;
+    return pfb;
+}
+
+//------------------------------------------------------------------------------
+// mem / none : touch 입력 없음
+//------------------------------------------------------------------------------
+static ts_t *mem_ts_init (const char *event_path)
+{
+    (void)event_path;
+    return NULL;
+}
+
+static void mem_ts_deinit (ts_t *pts)
+{
+    (void)pts;
+}
+
+static int mem_ts_get_event (fb_info_t *pfb, ts_t *pts, ts_event_t *event)
+{
+    (void)pfb;  (void)pts;  (void)event;
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// mem : label printer (출력 내용을 file 에 기록)
+//------------------------------------------------------------------------------
+static FILE *MemLpFp = NULL;
+
+static int mem_lp_config     (void)  { return 1; }
+static int mem_lp_connection (void)  { return 1; }
+
+static int mem_lp_print_mac (char *mac, int ch)
+{
+    if (MemLpFp != NULL) {
+        fprintf (MemLpFp, "%llu,%d,mac,%s\n", (unsigned long long)real_ms (), ch, mac);
+        fflush  (MemLpFp);
+    }
+    return 1;
+}
+
+static int mem_lp_print_err (char *msg1, char *msg2, char *msg3, int ch)
+{
+    if (MemLpFp != NULL) {
+        fprintf (MemLpFp, "%llu,%d,err,%s,%s,%s\n",
+            (unsigned long long)real_ms (), ch, msg1, msg2, msg3);
+        fflush  (MemLpFp);
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+static const adc_ops_t  AdcOps  [eBACKEND_END] = {
+    { dev_adc_init, dev_adc_read },
+    { mem_adc_init, mem_adc_read },
+    { mem_adc_init, mem_adc_read },
+    { mem_adc_init, mem_adc_read },
+    { dev_adc_init, dev_adc_read },
+};
+static const gpio_ops_t GpioOps [eBACKEND_END] = {
+    { dev_gpio_export, dev_gpio_direction, dev_gpio_get_value, dev_gpio_set_value },
+    { mem_gpio_export, mem_gpio_direction, mem_gpio_get_value, mem_gpio_set_value },
+    { mem_gpio_export, mem_gpio_direction, mem_gpio_get_value, mem_gpio_set_value },
+    { mem_gpio_export, mem_gpio_direction, mem_gpio_get_value, mem_gpio_set_value },
+    { dev_gpio_export, dev_gpio_direction, dev_gpio_get_value, dev_gpio_set_value },
+};
+static const fb_ops_t   FbOps   [eBACKEND_END] = {
+    { dev_fb_init },
+    { mem_fb_init },
+    { mem_fb_init },
+    { mem_fb_init },
+    { dev_fb_init },
+};
+static const ts_ops_t   TsOps   [eBACKEND_END] = {
+    { dev_ts_init, dev_ts_deinit, dev_ts_get_event },
+    { mem_ts_init, mem_ts_deinit, mem_ts_get_event },
+    { mem_ts_init, mem_ts_deinit, mem_ts_get_event },
+    { mem_ts_init, mem_ts_deinit, mem_ts_get_event },
+    { dev_ts_init, dev_ts_deinit, dev_ts_get_event },
+};
+static const lp_ops_t   LpOps   [eBACKEND_END] = {
+    { dev_lp_config, dev_lp_connection, dev_lp_print_mac, dev_lp_print_err },
+    { mem_lp_config, mem_lp_connection, mem_lp_print_mac, mem_lp_print_err },
+    { mem_lp_config, mem_lp_connection, mem_lp_print_mac, mem_lp_print_err },
+    { mem_lp_config, mem_lp_connection, mem_lp_print_mac, mem_lp_print_err },
+    { lp_net_open,   lp_net_connection, lp_net_print_mac, lp_net_print_err },
+};
+
+#define ADC     (&AdcOps  [BackendType[eHW_ADC ]])
+#define GPIO    (&GpioOps [BackendType[eHW_GPIO]])
+#define FB      (&FbOps   [BackendType[eHW_FB  ]])
+#define TS      (&TsOps   [BackendType[eHW_TS  ]])
+#define LP      (&LpOps   [BackendType[eHW_LP  ]])
+
+//------------------------------------------------------------------------------
+// script file load
+//------------------------------------------------------------------------------
+static int script_adc_load (const char *fname)
+{
+    char buf [256], *tok;
+    FILE *fp;
+
+    if ((fp = fopen (fname, "r")) == NULL) {
+        printf ("%s : %s open error (%s)\n", __func__, fname, strerror(errno));
+        return 0;
+    }
+    while ((fgets (buf, sizeof(buf), fp) != NULL) && (ScriptAdcCnt < SCRIPT_ADC_MAX)) {
+        script_adc_t *s = &ScriptAdc[ScriptAdcCnt];
+
+        if ((buf[0] == '#') || (buf[0] == '\n'))        continue;
+        if ((tok = strtok (buf, ", \t\r\n")) == NULL)   continue;
+
+        memset  (s, 0, sizeof(script_adc_t));
+        strncpy (s->name, tok, sizeof(s->name) -1);
+        while (((tok = strtok (NULL, ", \t\r\n")) != NULL) && (s->cnt < SCRIPT_VALUE_MAX))
+            s->mv[s->cnt++] = atoi (tok);
+        if (s->cnt)     ScriptAdcCnt++;
+    }
+    fclose (fp);
+    return 1;
+}
+
+static int script_gpio_load (const char *fname)
+{
+    char buf [256];
+    int gpio, value;
+    FILE *fp;
+
+    if ((fp = fopen (fname, "r")) == NULL) {
+        printf ("%s : %s open error (%s)\n", __func__, fname, strerror(errno));
+        return 0;
+    }
+    while (fgets (buf, sizeof(buf), fp) != NULL) {
+        if (buf[0] == '#')  continue;
+        if (sscanf (buf, "%d,%d", &gpio, &value) == 2)
+            mem_gpio_set_value (gpio, value);
+    }
+    fclose (fp);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// B(cmd), device, backend, [file]
+//------------------------------------------------------------------------------
+int backend_config (char *cfg)
+{
+    char *tok, *fname = NULL;
+    int hw, type;
+
+    if (strtok (cfg, ",") == NULL)                  return 0;
+    if ((tok = strtok (NULL, ", \t\r\n")) == NULL)  return 0;
+    for (hw = 0; hw < eHW_END; hw++)
+        if (!strcmp (tok, HwName[hw]))  break;
+
+    if ((tok = strtok (NULL, ", \t\r\n")) == NULL)  return 0;
+    for (type = 0; type < eBACKEND_END; type++)
+        if (!strcmp (tok, BackendName[type]))   break;
+
+    /* net 은 lpmode 설정으로만 선택 (lp_net_init) */
+    if ((hw == eHW_END) || (type == eBACKEND_END) || (type == eBACKEND_NET)) {
+        printf ("%s : unknown backend (%s)\n", __func__, tok);
+        return 0;
+    }
+    if ((tok = strtok (NULL, ", \t\r\n")) != NULL)  fname = tok;
+
+    if (type == eBACKEND_SCRIPT) {
+        if (fname == NULL)  return 0;
+        if ((hw == eHW_ADC)  && !script_adc_load  (fname))  return 0;
+        if ((hw == eHW_GPIO) && !script_gpio_load (fname))  return 0;
+    }
+    /* mem adc : file 이 있으면 name 별 고정값 (script 와 같은 형식, 첫 값 사용) */
+    if ((type == eBACKEND_MEM) && (hw == eHW_ADC) && (fname != NULL) && !script_adc_load (fname))
+        return 0;
+    if ((hw == eHW_LP) && (type != eBACKEND_DEV) && (fname != NULL)) {
+        if ((MemLpFp = fopen (fname, "a")) == NULL)
+            printf ("%s : %s open error (%s)\n", __func__, fname, strerror(errno));
+    }
+    BackendType[hw] = type;
+    printf ("%s : %s = %s %s\n", __func__, HwName[hw], BackendName[type], fname ? fname : "");
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+int backend_type (int hw)
+{
+    return ((hw >= 0) && (hw < eHW_END)) ? BackendType[hw] : eBACKEND_DEV;
+}
+
+//------------------------------------------------------------------------------
+int backend_select (int hw, int type)
+{
+    if ((hw < 0) || (hw >= eHW_END) || (type < 0) || (type >= eBACKEND_END))
+        return 0;
+
+    BackendType[hw] = type;
+    printf ("%s : %s = %s\n", __func__, HwName[hw], BackendName[type]);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+int hw_adc_init (const char *i2c_path)
+{
+    return ADC->init (i2c_path);
+}
+
+int hw_adc_read (int fd, const char *name, int *value, int *pin)
+{
+    return ADC->read (fd, name, value, pin);
+}
+
+//------------------------------------------------------------------------------
+int hw_gpio_export (int gpio)
+{
+    return GPIO->export (gpio);
+}
+
+int hw_gpio_direction (int gpio, int dir)
+{
+    return GPIO->direction (gpio, dir);
+}
+
+int hw_gpio_get_value (int gpio, int *value)
+{
+    return GPIO->get_value (gpio, value);
+}
+
+int hw_gpio_set_value (int gpio, int value)
+{
+    return GPIO->set_value (gpio, value);
+}
+
+//------------------------------------------------------------------------------
+fb_info_t *hw_fb_init (const char *fb_path)
+{
+    return FB->init (fb_path);
+}
+
+//------------------------------------------------------------------------------
+ts_t *hw_ts_init (const char *event_path)
+{
+    return TS->init (event_path);
+}
+
+void hw_ts_deinit (ts_t *pts)
+{
+    TS->deinit (pts);
+}
+
+int hw_ts_get_event (fb_info_t *pfb, ts_t *pts, ts_event_t *event)
+{
+    return TS->get_event (pfb, pts, event);
+}
+
+//------------------------------------------------------------------------------
+int hw_usblp_config (void)
+{
+    return LP->config ();
+}
+
+int hw_usblp_connection (void)
+{
+    return LP->connection ();
+}
+
+int hw_usblp_print_mac (char *mac, int ch)
+{
+    return LP->print_mac (mac, ch);
+}
+
+int hw_usblp_print_err (char *msg1, char *msg2, char *msg3, int ch)
+{
+    return LP->print_err (msg1, msg2, msg3, ch);
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+/**
+ * @file backend.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server hardware backend (adc, gpio, fb, touch, printer).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __BACKEND_H__
+#define __BACKEND_H__
+
+//------------------------------------------------------------------------------
+#include "lib_fbui/lib_fb.h"
+#include "lib_fbui/lib_ui.h"
+
+//------------------------------------------------------------------------------
+//
+// server 의 hardware 접근은 hw_xxx() 를 통해 backend 로 전달됨.
+// server cfg 의 'B' 라인으로 device 별 backend 선택 (기본값 dev).
+//
+//   B(cmd), device(adc, gpio, fb, ts, lp), backend(dev, mem, script, none), [script/output file]
+//
+// dev    : 실제 device (lib_i2cadc, lib_gpio, lib_fbui, lib_usblp)
+// mem    : in-memory (adc = BACKEND_MEM_ADC_MV 고정, gpio = set 값 유지, fb = memory framebuffer,
+//          lp = 출력 내용을 file 에 기록(선택), ts = 입력 없음)
+//          adc 는 file ("name,mV") 이 있으면 name 별 고정값. led on / audio off 처럼 값이 내려가는
+//          check port 는 낮은 값을 지정 (BACKEND_MEM_ADC_MV 이면 ADC_SETTLE_MS 동안 측정 후 fail).
+// script : adc/gpio 값을 file 에서 읽음. (adc : "name,mV,mV,..." 읽을 때 마다 순환, gpio : "num,value")
+// none   : ts 미사용
+// net    : lp 전용, 'S' line lpmode 1, 2 설정시 자동 선택 (lp_net.c)
+//
+//------------------------------------------------------------------------------
+#define BACKEND_MEM_ADC_MV      5000
+#define BACKEND_MEM_FB_W        1920
+#define BACKEND_MEM_FB_H        1080
+#define BACKEND_MEM_FB_BPP      32
+
+enum {
+    eBACKEND_DEV = 0,
+    eBACKEND_MEM,
+    eBACKEND_SCRIPT,
+    eBACKEND_NONE,
+    eBACKEND_NET,
+    eBACKEND_END
+};
+
+enum {
+    eHW_ADC = 0,
+    eHW_GPIO,
+    eHW_FB,
+    eHW_TS,
+    eHW_LP,
+    eHW_END
+};
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+/* server cfg 'B' line */
+extern  int         backend_config      (char *cfg);
+extern  int         backend_type        (int hw);
+extern  int         backend_select      (int hw, int type);
+
+extern  int         hw_adc_init         (const char *i2c_path);
+extern  int         hw_adc_read         (int fd, const char *name, int *value, int *pin);
+
+extern  int         hw_gpio_export      (int gpio);
+extern  int         hw_gpio_direction   (int gpio, int dir);
+extern  int         hw_gpio_get_value   (int gpio, int *value);
+extern  int         hw_gpio_set_value   (int gpio, int value);
+
+extern  fb_info_t   *hw_fb_init         (const char *fb_path);
+
+extern  ts_t        *hw_ts_init         (const char *event_path);
+extern  void        hw_ts_deinit        (ts_t *pts);
+extern  int         hw_ts_get_event     (fb_info_t *pfb, ts_t *pts, ts_event_t *event);
+
+extern  int         hw_usblp_config     (void);
+extern  int         hw_usblp_connection (void);
+extern  int         hw_usblp_print_mac  (char *mac, int ch);
+extern  int         hw_usblp_print_err  (char *msg1, char *msg2, char *msg3, int ch);
+
+//------------------------------------------------------------------------------
+#endif  // __BACKEND_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
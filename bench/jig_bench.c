@@ -0,0 +1,596 @@
+//------------------------------------------------------------------------------
+/**
+ * @file jig_bench.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server hot path micro benchmark (make bench).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <termios.h>
+#include <sys/utsname.h>
+
+//------------------------------------------------------------------------------
+#include "../server.h"
+#include "../mono_time.h"
+#include "../protocol_v3.h"
+
+//------------------------------------------------------------------------------
+// device_check.c
+//------------------------------------------------------------------------------
+extern int  device_resp_parse       (const char *resp, parse_resp_data_t *pdata);
+extern void device_header_classify  (server_t *p, int did, int *header, char *resp);
+
+//------------------------------------------------------------------------------
+#define BENCH_FB_W      1920
+#define BENCH_FB_H      1080
+#define BENCH_FB_BPP    32
+
+/* 결과 출력 (json line) : {"bench":..,"iter":..,"ns_per_op":..,"ops_per_sec":..} */
+static FILE *BenchOut;
+static const char *OPT_FILTER = NULL, *OPT_CFG = "configs/m1_server.c5.cfg";
+static const char *OPT_UI_CFG = "configs/m1_ui.c5.cfg";
+static int  OPT_SCALE = 1;
+
+static server_t BenchServer;
+static volatile int BenchSink;
+
+/* client -> server frame sample */
+static const char *BenchFrame [] = {
+    "@,R,-1,-001,P,               ready,#",
+    "@,S,05,0000,P,        192.168.0.10,#",
+    "@,S,04,0001,C,             adc-100,#",
+    "@,S,02,0003,P,           3.0-10000,#",
+    "@,M,-1,-001,P,        001e06aabbcc,#",
+    "@,E,-1,-001,F,       usb 3.0 speed,#",
+    "@,X,-1,-001,P,            complete,#",
+};
+#define BENCH_FRAME_CNT     (int)(sizeof(BenchFrame) / sizeof(BenchFrame[0]))
+
+//------------------------------------------------------------------------------
+static int bench_skip (const char *name)
+{
+    return (OPT_FILTER != NULL) && (strstr (name, OPT_FILTER) == NULL);
+}
+
+static void bench_report (const char *name, uint64_t iter, uint64_t elapsed_us)
+{
+    double ns = iter ? elapsed_us * 1000.0 / iter : 0.0;
+
+    fprintf (BenchOut, "{\"bench\":\"%s\",\"iter\":%llu,\"ns_per_op\":%.1f,\"ops_per_sec\":%.0f}\n",
+        name, (unsigned long long)iter, ns, ns > 0 ? 1000000000.0 / ns : 0.0);
+    fflush  (BenchOut);
+}
+
+static void bench_error (const char *name, const char *msg)
+{
+    fprintf (BenchOut, "{\"bench\":\"%s\",\"error\":\"%s\"}\n", name, msg);
+}
+
+//------------------------------------------------------------------------------
+// server cfg 의 D, H 라인만 읽어서 BenchServer 구성 (fb/uart/adc 초기화 없음)
+//------------------------------------------------------------------------------
+static void bench_load_cfg (server_t *p, const char *fname)
+{
+    char buf [256];
+    FILE *fp;
+
+    if ((fp = fopen (fname, "r")) == NULL)  return;
+
+    while (fgets (buf, sizeof(buf), fp) != NULL) {
+        if ((buf[0] == 'D') && (p->d_item_cnt < (int)(sizeof(p->d_item) / sizeof(p->d_item[0])))) {
+            d_item_t *d = &p->d_item[p->d_item_cnt];
+            if (sscanf (buf, "D,%d,%d,%d,%d,%d",
+                        &d->gid, &d->did, &d->uid_l, &d->uid_r, &d->is_str) == 5)
+                p->d_item_cnt++;
+        }
+        if ((buf[0] == 'H') && (p->h_item_cnt < (int)(sizeof(p->h_item) / sizeof(p->h_item[0])))) {
+            h_item_t *h = &p->h_item[p->h_item_cnt];
+            if (sscanf (buf, "H,%d,%d,%d,%d", &h->did, &h->pin, &h->max, &h->min) == 4)
+                p->h_item_cnt++;
+        }
+    }
+    fclose (fp);
+}
+
+//------------------------------------------------------------------------------
+static void bench_ptc_event (void)
+{
+    const char *name = "ptc_event";
+    uint64_t i, n = 200000ull * OPT_SCALE, start, frames = 0;
+    uart_t uart;
+
+    if (bench_skip (name))  return;
+
+    memset (&uart, 0, sizeof(uart));
+    if (!ptc_grp_init (&uart, 1) ||
+        !ptc_func_init (&uart, 0, SERIAL_RESP_SIZE, protocol_check, protocol_catch)) {
+        bench_error (name, "protocol init");
+        return;
+    }
+    start = mono_us ();
+    for (i = 0; i < n; i++) {
+        const char *f = BenchFrame[i % BENCH_FRAME_CNT];
+        int j;
+
+        for (j = 0; j < SERIAL_RESP_SIZE; j++) {
+            ptc_event (&uart, (unsigned char)f[j]);
+            if (uart.p[0].var.pass) {
+                uart.p[0].var.pass = 0;
+                uart.p[0].var.open = 1;
+                frames++;
+            }
+        }
+    }
+    bench_report (name, n, mono_us () - start);
+    BenchSink = (int)frames;
+    ptc_grp_close (&uart);
+}
+
+//------------------------------------------------------------------------------
+// pty 로 frame 전송, protocol_msg_rx() 로 수신 (uart_read 1 byte 단위)
+//------------------------------------------------------------------------------
+static void bench_protocol_msg_rx (void)
+{
+    const char *name = "protocol_msg_rx";
+    char path [64], rx_msg [SERIAL_RESP_SIZE +1];
+    uint64_t n = 5000ull * OPT_SCALE, sent = 0, recv = 0, start, last;
+    struct termios tio;
+    uart_t *puart;
+    int master;
+
+    if (bench_skip (name))  return;
+
+    if (((master = posix_openpt (O_RDWR | O_NOCTTY)) < 0) ||
+        grantpt (master) || unlockpt (master) || ptsname_r (master, path, sizeof(path))) {
+        bench_error (name, "pty");
+        return;
+    }
+    if ((puart = uart_init (path, 115200)) == NULL) {
+        bench_error (name, "uart_init");
+        close (master);
+        return;
+    }
+    tcgetattr (puart->fd, &tio);    cfmakeraw (&tio);   tcsetattr (puart->fd, TCSANOW, &tio);
+    ptc_grp_init  (puart, 1);
+    ptc_func_init (puart, 0, SERIAL_RESP_SIZE, protocol_check, protocol_catch);
+
+    memset (rx_msg, 0, sizeof(rx_msg));
+    start = last = mono_us ();
+    while (recv < n) {
+        /* pty buffer 가 넘치지 않도록 64 frame 단위 전송 */
+        for (; (sent < n) && (sent - recv < 64); sent++) {
+            const char *f = BenchFrame[sent % BENCH_FRAME_CNT];
+            if (write (master, f, SERIAL_RESP_SIZE) != SERIAL_RESP_SIZE)    break;
+            if (write (master, "\r\n", 2) != 2)                             break;
+        }
+        if (protocol_msg_rx (puart, rx_msg)) {
+            recv++;
+            last = mono_us ();
+        }
+        /* frame 손실 (1 sec 동안 수신 없음) */
+        else if (mono_us () - last > 1000000)   break;
+    }
+    bench_report (name, recv, mono_us () - start);
+
+    uart_close (puart);
+    close (master);
+}
+
+//------------------------------------------------------------------------------
+// BenchFrame (v2) 을 protocol_v3_conv_tx() 와 같은 방식으로 v3 frame 으로 변환
+//------------------------------------------------------------------------------
+static int bench_v3_frame (uint8_t *buf, int size, const char *f, int seq)
+{
+    char value [DEVICE_RESP_SIZE +1], *v = value;
+
+    memcpy (value, &f[14], DEVICE_RESP_SIZE -2);
+    value[DEVICE_RESP_SIZE -2] = 0;
+    while (*v == ' ')   v++;
+    return ptc_v3_encode (buf, size, f[2], f[12], atoi (&f[4]), atoi (&f[7]), seq, v, strlen (v));
+}
+
+//------------------------------------------------------------------------------
+static void bench_ptc_v3_decode (void)
+{
+    const char *name = "ptc_v3_decode";
+    uint8_t frame [BENCH_FRAME_CNT][PTC_V3_HDR_SIZE + DEVICE_RESP_SIZE + PTC_V3_CRC_SIZE];
+    int size [BENCH_FRAME_CNT];
+    uint64_t i, n = 200000ull * OPT_SCALE, start, frames = 0;
+    ptc_v3_rx_t *rx;
+    ptc_frame_t *pf;
+
+    if (bench_skip (name))  return;
+
+    rx = calloc (1, sizeof(ptc_v3_rx_t));
+    pf = calloc (1, sizeof(ptc_frame_t));
+    if ((rx == NULL) || (pf == NULL)) {
+        bench_error (name, "malloc");
+        free (rx);  free (pf);
+        return;
+    }
+    for (i = 0; i < BENCH_FRAME_CNT; i++)
+        size[i] = bench_v3_frame (frame[i], sizeof(frame[i]), BenchFrame[i], (int)i);
+
+    start = mono_us ();
+    for (i = 0; i < n; i++) {
+        int j, k = (int)(i % BENCH_FRAME_CNT);
+
+        for (j = 0; j < size[k]; j++)
+            frames += ptc_v3_decode (rx, frame[k][j], pf);
+    }
+    bench_report (name, n, mono_us () - start);
+    BenchSink = (int)frames;
+    free (rx);  free (pf);
+}
+
+//------------------------------------------------------------------------------
+// 1.5 Mbaud (8N1, 10 bit/byte) link 에서 v2 / v3 비교 (bit error 주입)
+//   frames_per_sec : 오류 없이 수신된 frame 기준 link 최대 처리량
+//   lost           : 수신되지 않은 frame (재전송 대상)
+//   undetected     : 수신되었으나 내용이 다른 frame (오류 검출 실패)
+//------------------------------------------------------------------------------
+#define BENCH_WIRE_BAUD     1500000
+
+static uint32_t BenchRand = 0x12345678;
+
+/* xorshift32 (실행마다 같은 결과), bit 별로 ber 확률로 반전 */
+static void bench_bit_error (uint8_t *buf, int size, uint32_t threshold)
+{
+    int i, b;
+
+    if (!threshold) return;
+    for (i = 0; i < size; i++)
+        for (b = 0; b < 8; b++) {
+            BenchRand ^= BenchRand << 13;
+            BenchRand ^= BenchRand >> 17;
+            BenchRand ^= BenchRand << 5;
+            if (BenchRand < threshold)  buf[i] ^= 1 << b;
+        }
+}
+
+static void bench_wire_report (const char *name, double ber, uint64_t n, uint64_t bytes,
+                               uint64_t ok, uint64_t undetected)
+{
+    double sec = bytes * 10.0 / BENCH_WIRE_BAUD;
+
+    fprintf (BenchOut, "{\"bench\":\"%s\",\"baud\":%d,\"ber\":%g,\"frames\":%llu,"
+        "\"bytes_per_frame\":%.1f,\"frames_per_sec\":%.0f,\"lost\":%llu,\"undetected\":%llu}\n",
+        name, BENCH_WIRE_BAUD, ber, (unsigned long long)n, (double)bytes / n, ok / sec,
+        (unsigned long long)(n - ok - undetected), (unsigned long long)undetected);
+    fflush  (BenchOut);
+}
+
+static void bench_wire_v2 (double ber, uint64_t n)
+{
+    char tx [SERIAL_RESP_SIZE +2], rx [SERIAL_RESP_SIZE +1];
+    uint64_t i, bytes = 0, ok = 0, bad = 0;
+    uart_t uart;
+
+    memset (&uart, 0, sizeof(uart));
+    if (!ptc_grp_init (&uart, 1) ||
+        !ptc_func_init (&uart, 0, SERIAL_RESP_SIZE, protocol_check, protocol_catch)) {
+        bench_error ("wire_v2", "protocol init");
+        return;
+    }
+    for (i = 0; i < n; i++) {
+        const char *f = BenchFrame[i % BENCH_FRAME_CNT];
+        int j;
+
+        memcpy (tx, f, SERIAL_RESP_SIZE);
+        tx[SERIAL_RESP_SIZE] = '\r';    tx[SERIAL_RESP_SIZE +1] = '\n';
+        bench_bit_error ((uint8_t *)tx, sizeof(tx), (uint32_t)(ber * 4294967296.0));
+        bytes += sizeof(tx);
+
+        for (j = 0; j < (int)sizeof(tx); j++) {
+            ptc_var_t *var = &uart.p[0].var;
+
+            ptc_event (&uart, (unsigned char)tx[j]);
+            if (!var->pass) continue;
+
+            var->pass = 0;
+            var->open = 1;
+            for (int k = 0; k < SERIAL_RESP_SIZE; k++)
+                rx[k] = var->buf[(var->p_sp + k) % var->size];
+            if (memcmp (rx, f, SERIAL_RESP_SIZE))   bad++;
+            else                                    ok++;
+        }
+    }
+    bench_wire_report ("wire_v2", ber, n, bytes, ok, bad);
+    ptc_grp_close (&uart);
+}
+
+static void bench_wire_v3 (double ber, uint64_t n)
+{
+    uint8_t tx [PTC_V3_HDR_SIZE + DEVICE_RESP_SIZE + PTC_V3_CRC_SIZE];
+    uint8_t ref [sizeof(tx)], chk [sizeof(tx)];
+    uint64_t i, bytes = 0, ok = 0, bad = 0;
+    ptc_v3_rx_t *rx = calloc (1, sizeof(ptc_v3_rx_t));
+    ptc_frame_t *pf = calloc (1, sizeof(ptc_frame_t));
+
+    if ((rx == NULL) || (pf == NULL)) {
+        bench_error ("wire_v3", "malloc");
+        free (rx);  free (pf);
+        return;
+    }
+    for (i = 0; i < n; i++) {
+        const char *f = BenchFrame[i % BENCH_FRAME_CNT];
+        int j, size = bench_v3_frame (ref, sizeof(ref), f, (int)(i & 0xFFFF));
+
+        memcpy (tx, ref, size);
+        bench_bit_error (tx, size, (uint32_t)(ber * 4294967296.0));
+        bytes += size;
+
+        for (j = 0; j < size; j++) {
+            if (ptc_v3_decode (rx, tx[j], pf) != 1) continue;
+
+            /* 수신 frame 을 다시 encode 하여 원본과 비교 */
+            if ((ptc_v3_encode (chk, sizeof(chk), pf->cmd, pf->status, pf->gid, pf->did,
+                                pf->seq, pf->payload, pf->len) != size) || memcmp (chk, ref, size))
+                bad++;
+            else
+                ok++;
+        }
+    }
+    bench_wire_report ("wire_v3", ber, n, bytes, ok, bad);
+    free (rx);  free (pf);
+}
+
+static void bench_protocol_wire (void)
+{
+    const double ber [] = { 0, 1e-5, 1e-4, 1e-3 };
+    uint64_t n = 200000ull * OPT_SCALE;
+    int i;
+
+    if (bench_skip ("wire_v2") && bench_skip ("wire_v3"))   return;
+
+    for (i = 0; i < (int)(sizeof(ber) / sizeof(ber[0])); i++) {
+        if (!bench_skip ("wire_v2"))    bench_wire_v2 (ber[i], n);
+        if (!bench_skip ("wire_v3"))    bench_wire_v3 (ber[i], n);
+    }
+}
+
+//------------------------------------------------------------------------------
+static void bench_resp_parse (void)
+{
+    const char *name = "device_resp_parse";
+    uint64_t i, n = 1000000ull * OPT_SCALE, start;
+    parse_resp_data_t pdata;
+
+    if (bench_skip (name))  return;
+
+    start = mono_us ();
+    for (i = 0; i < n; i++) {
+        device_resp_parse (BenchFrame[(i % (BENCH_FRAME_CNT -1)) +1], &pdata);
+        BenchSink += pdata.gid;
+    }
+    bench_report (name, n, mono_us () - start);
+}
+
+//------------------------------------------------------------------------------
+static void bench_resp_form (void)
+{
+    const char *name = "serial_resp_form";
+    char serial_resp [SERIAL_RESP_SIZE +16], resp [DEVICE_RESP_SIZE +1];
+    uint64_t i, n = 1000000ull * OPT_SCALE, start;
+
+    if (bench_skip (name))  return;
+
+    start = mono_us ();
+    for (i = 0; i < n; i++) {
+        DEVICE_RESP_FORM_STR (resp, 'P', "192.168.0.10");
+        SERIAL_RESP_FORM (serial_resp, 'A', (int)(i % 14), (int)(i % 10), resp);
+        BenchSink += serial_resp[5];
+    }
+    bench_report (name, n, mono_us () - start);
+}
+
+//------------------------------------------------------------------------------
+static void bench_header_classify (void)
+{
+    const char *name = "header_classify";
+    uint64_t i, n = 1000000ull * OPT_SCALE, start;
+    int header [HEADER_PIN_MAX +1], j;
+    char resp [DEVICE_RESP_SIZE +1];
+
+    if (bench_skip (name))  return;
+
+    start = mono_us ();
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < HEADER_PIN_MAX; j++)
+            header[j] = ((j + i) & 3) ? 3300 : 0;
+        memset (resp, 0, sizeof(resp));
+        device_header_classify (&BenchServer, (int)(i % 4), header, resp);
+        BenchSink += resp[0];
+    }
+    bench_report (name, n, mono_us () - start);
+}
+
+//------------------------------------------------------------------------------
+static void bench_find_ditem_pos (void)
+{
+    const char *name = "find_ditem_pos";
+    uint64_t i, n = 1000000ull * OPT_SCALE, start;
+
+    if (bench_skip (name))  return;
+    if (!BenchServer.d_item_cnt) {
+        bench_error (name, "no D item");
+        return;
+    }
+
+    start = mono_us ();
+    for (i = 0; i < n; i++) {
+        d_item_t *d = &BenchServer.d_item[i % BenchServer.d_item_cnt];
+        BenchSink += find_ditem_pos (&BenchServer, d->gid, d->did);
+    }
+    bench_report (name, n, mono_us () - start);
+}
+
+//------------------------------------------------------------------------------
+// memory framebuffer (fb device 없이 ui draw)
+//------------------------------------------------------------------------------
+static void bench_ui (void)
+{
+    uint64_t i, n = 20000ull * OPT_SCALE, start;
+    fb_info_t fb;
+    ui_grp_t *pui;
+    d_item_t *d;
+
+    if (bench_skip ("ui_set_ritem") && bench_skip ("ui_set_sitem"))    return;
+    if (!BenchServer.d_item_cnt)    return;
+
+    memset (&fb, 0, sizeof(fb));
+    fb.fd     = -1;
+    fb.w      = BENCH_FB_W;
+    fb.h      = BENCH_FB_H;
+    fb.bpp    = BENCH_FB_BPP;
+    fb.stride = BENCH_FB_W * (BENCH_FB_BPP / 8);
+    if ((fb.data = calloc (1, fb.stride * fb.h)) == NULL)   return;
+    fb.base   = fb.data;
+
+    if ((pui = ui_init (&fb, OPT_UI_CFG)) == NULL) {
+        bench_error ("ui_set_ritem", "ui_init");
+        free (fb.data);
+        return;
+    }
+
+    if (!bench_skip ("ui_set_ritem")) {
+        start = mono_us ();
+        for (i = 0; i < n; i++) {
+            d = &BenchServer.d_item[i % BenchServer.d_item_cnt];
+            ui_set_ritem (&fb, pui, d->uid_l, (i & 1) ? COLOR_GREEN : COLOR_RED, -1);
+        }
+        bench_report ("ui_set_ritem", n, mono_us () - start);
+    }
+    if (!bench_skip ("ui_set_sitem")) {
+        start = mono_us ();
+        for (i = 0; i < n; i++) {
+            d = &BenchServer.d_item[i % BenchServer.d_item_cnt];
+            ui_set_sitem (&fb, pui, d->uid_l, -1, -1, (i & 1) ? "PASS" : "192.168.0.10");
+        }
+        bench_report ("ui_set_sitem", n, mono_us () - start);
+    }
+    ui_close (pui);
+    free (fb.data);
+}
+
+//------------------------------------------------------------------------------
+// network label job 생성 (template patch + Code128/QR bitmap), 결과 = labels/sec
+//------------------------------------------------------------------------------
+static void bench_label_render (void)
+{
+    static char job [LABEL_JOB_SIZE];
+    char mac [16];
+    uint64_t i, n = 20000ull * OPT_SCALE, start;
+
+    if (bench_skip ("label_render_mac") && bench_skip ("label_render_mac_cached") &&
+        bench_skip ("label_render_err"))
+        return;
+
+    label_init (LABEL_TPL_DIR);
+
+    /* mac 이 매번 다름 : bitmap 생성 포함 */
+    if (!bench_skip ("label_render_mac")) {
+        start = mono_us ();
+        for (i = 0; i < n; i++) {
+            snprintf (mac, sizeof(mac), "001e06%06x", (unsigned)(i & 0xFFFFFF));
+            BenchSink += label_render (eLABEL_MAC, job, sizeof(job), (int)(i & 1), mac, NULL, NULL);
+        }
+        bench_report ("label_render_mac", n, mono_us () - start);
+    }
+    /* 같은 mac 재출력 : cache 된 bitmap */
+    if (!bench_skip ("label_render_mac_cached")) {
+        start = mono_us ();
+        for (i = 0; i < n * 10; i++)
+            BenchSink += label_render (eLABEL_MAC, job, sizeof(job), 0, "001e06aabbcc", NULL, NULL);
+        bench_report ("label_render_mac_cached", n * 10, mono_us () - start);
+    }
+    if (!bench_skip ("label_render_err")) {
+        start = mono_us ();
+        for (i = 0; i < n * 10; i++)
+            BenchSink += label_render (eLABEL_ERR, job, sizeof(job), 1, "usb3 fail", "eth speed", "");
+        bench_report ("label_render_err", n * 10, mono_us () - start);
+    }
+}
+
+//------------------------------------------------------------------------------
+static void print_usage (const char *prog)
+{
+    puts("");
+    printf("Usage: %s [-f filter] [-n scale] [-c server cfg] [-u ui cfg] [-o output]\n", prog);
+    puts("\n"
+        "  -f : run benchmarks whose name contains filter\n"
+        "  -n : iteration scale (default 1)\n"
+        "  -o : json line output file (default stdout)\n"
+        "\n"
+    );
+    exit(1);
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char *argv[])
+{
+    struct utsname un;
+    int c;
+
+    BenchOut = stdout;
+    while ((c = getopt (argc, argv, "f:n:c:u:o:h")) != -1) {
+        switch (c) {
+        case 'f':   OPT_FILTER = optarg;            break;
+        case 'n':   OPT_SCALE  = atoi (optarg);     break;
+        case 'c':   OPT_CFG    = optarg;            break;
+        case 'u':   OPT_UI_CFG = optarg;            break;
+        case 'o':
+            if ((BenchOut = fopen (optarg, "a")) == NULL) {
+                printf ("%s : %s open error (%s)\n", argv[0], optarg, strerror(errno));
+                return 1;
+            }
+            break;
+        case 'h':
+        default:
+            print_usage (argv[0]);
+            break;
+        }
+    }
+    if (OPT_SCALE < 1)  OPT_SCALE = 1;
+
+    bench_load_cfg (&BenchServer, OPT_CFG);
+
+    /* 실행 환경 (release 간 비교용) */
+    uname (&un);
+    fprintf (BenchOut, "{\"bench\":\"info\",\"ts\":%llu,\"machine\":\"%s\",\"release\":\"%s\","
+        "\"d_item\":%d,\"h_item\":%d,\"scale\":%d}\n",
+        (unsigned long long)real_ms (), un.machine, un.release,
+        BenchServer.d_item_cnt, BenchServer.h_item_cnt, OPT_SCALE);
+
+    bench_ptc_event       ();
+    bench_protocol_msg_rx ();
+    bench_ptc_v3_decode   ();
+    bench_protocol_wire   ();
+    bench_resp_parse      ();
+    bench_resp_form       ();
+    bench_header_classify ();
+    bench_find_ditem_pos  ();
+    bench_ui              ();
+    bench_label_render    ();
+
+    if (BenchOut != stdout)     fclose (BenchOut);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
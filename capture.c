@@ -0,0 +1,408 @@
+//------------------------------------------------------------------------------
+/**
+ * @file capture.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server uart session capture & replay (pty).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <pthread.h>
+
+//------------------------------------------------------------------------------
+#include "capture.h"
+#include "mono_time.h"
+
+//------------------------------------------------------------------------------
+#define CAPTURE_BUF_SIZE    (64 * 1024)
+#define CAPTURE_SYNC_MS     100
+
+/* replay 종료 후 server 응답(tx) 수신 대기 */
+#define REPLAY_DRAIN_MS     2000
+
+//------------------------------------------------------------------------------
+typedef struct capture_pend__t {
+    uint64_t    first_us;
+    uint64_t    last_us;
+    int         size;
+    uint8_t     data [CAPTURE_CHUNK_MAX];
+}   capture_pend_t;
+
+static FILE             *CaptureFp = NULL;
+static uint8_t          CaptureBuf [CAPTURE_BUF_SIZE];
+static int              CaptureLen = 0;
+static uint64_t         CaptureLastUs = 0;
+static capture_pend_t   CapturePend [CAPTURE_CH_MAX];
+
+static pthread_t        thread_capture;
+static pthread_mutex_t  capture_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+//------------------------------------------------------------------------------
+// CaptureBuf 에 record 추가 (capture_mutex lock 상태에서 호출)
+//------------------------------------------------------------------------------
+static void capture_put (uint64_t ts_us, int ch, int dir, const void *data, int size)
+{
+    capture_rec_t rec;
+    uint64_t dt = (ts_us > CaptureLastUs) ? ts_us - CaptureLastUs : 0;
+
+    if (CaptureLen + (int)sizeof(rec) + size > CAPTURE_BUF_SIZE) {
+        fwrite (CaptureBuf, 1, CaptureLen, CaptureFp);
+        CaptureLen = 0;
+    }
+    rec.dt_us = (dt > UINT32_MAX) ? UINT32_MAX : (uint32_t)dt;
+    rec.ch    = (uint8_t)ch;
+    rec.dir   = (uint8_t)dir;
+    rec.size  = (uint16_t)size;
+
+    memcpy (&CaptureBuf[CaptureLen], &rec, sizeof(rec));   CaptureLen += sizeof(rec);
+    memcpy (&CaptureBuf[CaptureLen], data, size);          CaptureLen += size;
+
+    if (ts_us > CaptureLastUs)  CaptureLastUs = ts_us;
+}
+
+//------------------------------------------------------------------------------
+// 보류중인 rx chunk 기록 (record 의 시간 순서 유지를 위해 모든 channel 을 함께 처리)
+//------------------------------------------------------------------------------
+static void capture_pend_flush (uint64_t now_us, int force)
+{
+    int ch;
+
+    for (ch = 0; ch < CAPTURE_CH_MAX; ch++) {
+        capture_pend_t *pend = &CapturePend[ch];
+
+        if (!pend->size)    continue;
+        if (!force && (now_us - pend->last_us < CAPTURE_COALESCE_US))   continue;
+
+        capture_put (pend->first_us, ch, eCAPTURE_RX, pend->data, pend->size);
+        pend->size = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+void capture_data (int ch, int dir, const void *data, int size)
+{
+    uint64_t now = mono_us ();
+    capture_pend_t *pend;
+
+    if ((CaptureFp == NULL) || (ch < 0) || (ch >= CAPTURE_CH_MAX) || (size <= 0))
+        return;
+
+    pthread_mutex_lock (&capture_mutex);
+
+    pend = &CapturePend[ch];
+    if ((dir == eCAPTURE_RX) && (size + pend->size <= CAPTURE_CHUNK_MAX) &&
+        (!pend->size || (now - pend->last_us < CAPTURE_COALESCE_US))) {
+        if (!pend->size)    pend->first_us = now;
+        memcpy (&pend->data[pend->size], data, size);
+        pend->size   += size;
+        pend->last_us = now;
+    } else {
+        capture_pend_flush (now, 1);
+        if (dir == eCAPTURE_RX) {
+            pend->first_us = pend->last_us = now;
+            pend->size = (size > CAPTURE_CHUNK_MAX) ? CAPTURE_CHUNK_MAX : size;
+            memcpy (pend->data, data, pend->size);
+        } else
+            capture_put (now, ch, dir, data, size);
+    }
+    pthread_mutex_unlock (&capture_mutex);
+}
+
+//------------------------------------------------------------------------------
+void capture_flush (void)
+{
+    if (CaptureFp == NULL)  return;
+
+    pthread_mutex_lock (&capture_mutex);
+    capture_pend_flush (mono_us (), 1);
+    if (CaptureLen) {
+        fwrite (CaptureBuf, 1, CaptureLen, CaptureFp);
+        CaptureLen = 0;
+    }
+    fflush (CaptureFp);
+    pthread_mutex_unlock (&capture_mutex);
+}
+
+//------------------------------------------------------------------------------
+static void *thread_capture_func (void *arg)
+{
+    while (1) {
+        usleep (CAPTURE_SYNC_MS * 1000);
+
+        pthread_mutex_lock (&capture_mutex);
+        capture_pend_flush (mono_us (), 0);
+        if (CaptureLen) {
+            fwrite (CaptureBuf, 1, CaptureLen, CaptureFp);
+            CaptureLen = 0;
+            fflush (CaptureFp);
+        }
+        pthread_mutex_unlock (&capture_mutex);
+    }
+    return arg;
+}
+
+//------------------------------------------------------------------------------
+int capture_init (const char *fname)
+{
+    capture_hdr_t hdr;
+
+    if ((CaptureFp = fopen (fname, "wb")) == NULL) {
+        printf ("%s : %s open error (%s)\n", __func__, fname, strerror(errno));
+        return 0;
+    }
+    memset (&hdr, 0, sizeof(hdr));
+    hdr.magic    = CAPTURE_MAGIC;
+    hdr.version  = CAPTURE_VERSION;
+    hdr.ch_cnt   = CAPTURE_CH_MAX;
+    hdr.start_ts = real_ms ();
+    fwrite (&hdr, 1, sizeof(hdr), CaptureFp);
+
+    CaptureLastUs = mono_us ();
+    pthread_create (&thread_capture, NULL, thread_capture_func, NULL);
+    atexit (capture_flush);
+
+    printf ("%s : uart capture = %s\n", __func__, fname);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+typedef struct replay_buf__t {
+    uint8_t     *data;
+    size_t      len, cap;
+}   replay_buf_t;
+
+static uint8_t      *ReplayData = NULL;
+static size_t       ReplaySize  = 0;
+static int          ReplayFast  = 0;
+static int          ReplayChCnt = 0;
+static int          ReplayMaster [CAPTURE_CH_MAX] = { -1, -1 };
+static int          ReplaySlave  [CAPTURE_CH_MAX] = { -1, -1 };
+static char         ReplayPath   [CAPTURE_CH_MAX][64];
+static replay_buf_t ReplayExpect [CAPTURE_CH_MAX], ReplayActual [CAPTURE_CH_MAX];
+
+static pthread_t        thread_replay, thread_replay_rx;
+static pthread_mutex_t  replay_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+//------------------------------------------------------------------------------
+static void replay_buf_add (replay_buf_t *b, const void *data, size_t size)
+{
+    if (b->len + size > b->cap) {
+        size_t cap = b->cap ? b->cap * 2 : 4096;
+        uint8_t *p;
+
+        while (cap < b->len + size)     cap *= 2;
+        if ((p = realloc (b->data, cap)) == NULL)   return;
+        b->data = p;    b->cap = cap;
+    }
+    memcpy (&b->data[b->len], data, size);
+    b->len += size;
+}
+
+//------------------------------------------------------------------------------
+// server 가 전송한 data (pty master 로 수신) 수집
+//------------------------------------------------------------------------------
+static void *thread_replay_rx_func (void *arg)
+{
+    struct pollfd pfd [CAPTURE_CH_MAX];
+    uint8_t buf [256];
+    int ch, n;
+
+    for (ch = 0; ch < ReplayChCnt; ch++) {
+        pfd[ch].fd     = ReplayMaster[ch];
+        pfd[ch].events = POLLIN;
+    }
+    while (1) {
+        if (poll (pfd, ReplayChCnt, 100) <= 0)  continue;
+
+        for (ch = 0; ch < ReplayChCnt; ch++) {
+            if (!(pfd[ch].revents & POLLIN))    continue;
+            if ((n = read (pfd[ch].fd, buf, sizeof(buf))) <= 0)     continue;
+
+            pthread_mutex_lock   (&replay_mutex);
+            replay_buf_add (&ReplayActual[ch], buf, n);
+            pthread_mutex_unlock (&replay_mutex);
+        }
+    }
+    return arg;
+}
+
+//------------------------------------------------------------------------------
+static int replay_report (uint64_t elapsed_us, const size_t *rx_bytes, const int *rx_frames)
+{
+    int ch, mismatch = 0;
+
+    pthread_mutex_lock (&replay_mutex);
+    printf ("%s : %s mode, elapsed %.3f sec\n", __func__,
+        ReplayFast ? "fast" : "realtime", elapsed_us / 1000000.0);
+
+    for (ch = 0; ch < ReplayChCnt; ch++) {
+        replay_buf_t *e = &ReplayExpect[ch], *a = &ReplayActual[ch];
+        size_t i, len = (e->len < a->len) ? e->len : a->len;
+
+        for (i = 0; (i < len) && (e->data[i] == a->data[i]); i++);
+
+        printf ("%s : ch %d rx %zu bytes (%d frames, %.1f frames/sec), tx expect %zu / actual %zu bytes",
+            __func__, ch, rx_bytes[ch], rx_frames[ch],
+            elapsed_us ? rx_frames[ch] * 1000000.0 / elapsed_us : 0.0, e->len, a->len);
+
+        if ((i == e->len) && (i == a->len)) {
+            printf (", match\n");
+            continue;
+        }
+        mismatch++;
+        printf (", mismatch at %zu\n", i);
+        printf ("    expect : %.*s\n", (int)((e->len - i > 40) ? 40 : e->len - i), &e->data[i]);
+        printf ("    actual : %.*s\n", (int)((a->len - i > 40) ? 40 : a->len - i), &a->data[i]);
+    }
+    pthread_mutex_unlock (&replay_mutex);
+    return mismatch;
+}
+
+//------------------------------------------------------------------------------
+static void *thread_replay_func (void *arg)
+{
+    size_t pos = sizeof(capture_hdr_t), rx_bytes [CAPTURE_CH_MAX] = { 0, };
+    int rx_frames [CAPTURE_CH_MAX] = { 0, }, i;
+    uint64_t t0 = mono_us (), ts = 0, drain, elapsed;
+
+    while (pos + sizeof(capture_rec_t) <= ReplaySize) {
+        capture_rec_t rec;
+        const uint8_t *data;
+
+        memcpy (&rec, &ReplayData[pos], sizeof(rec));
+        pos += sizeof(rec);
+        if (pos + rec.size > ReplaySize)    break;
+        data = &ReplayData[pos];
+        pos += rec.size;
+
+        if (rec.ch >= ReplayChCnt)      continue;
+
+        ts += rec.dt_us;
+        if (rec.dir == eCAPTURE_TX) {
+            pthread_mutex_lock   (&replay_mutex);
+            replay_buf_add (&ReplayExpect[rec.ch], data, rec.size);
+            pthread_mutex_unlock (&replay_mutex);
+            continue;
+        }
+        if (!ReplayFast) {
+            uint64_t now = mono_us ();
+            if (t0 + ts > now)  usleep (t0 + ts - now);
+        }
+        for (i = 0; i < rec.size; ) {
+            int n = write (ReplayMaster[rec.ch], &data[i], rec.size - i);
+            if (n < 0) {
+                if (errno == EINTR)     continue;
+                break;
+            }
+            i += n;
+        }
+        for (i = 0; i < rec.size; i++)
+            if (data[i] == '#')     rx_frames[rec.ch]++;
+        rx_bytes[rec.ch] += rec.size;
+    }
+
+    elapsed = mono_us () - t0;
+
+    /* server 응답 대기 : 수신량 변화가 없을 때 까지 */
+    {
+        size_t last = (size_t)-1, cur;
+        int ch;
+
+        for (drain = mono_us ();;) {
+            usleep (100 * 1000);
+            pthread_mutex_lock   (&replay_mutex);
+            for (ch = 0, cur = 0; ch < ReplayChCnt; ch++)   cur += ReplayActual[ch].len;
+            pthread_mutex_unlock (&replay_mutex);
+            if (cur == last)                                    break;
+            if (mono_us () - drain > REPLAY_DRAIN_MS * 1000)    break;
+            last = cur;
+        }
+    }
+    /* regression test 용 : 불일치가 있으면 exit code 1 */
+    exit (replay_report (elapsed, rx_bytes, rx_frames) ? 1 : 0);
+    return arg;
+}
+
+//------------------------------------------------------------------------------
+int replay_init (const char *fname, int fast)
+{
+    capture_hdr_t *hdr;
+    FILE *fp;
+    long size;
+    int ch;
+
+    if ((fp = fopen (fname, "rb")) == NULL) {
+        printf ("%s : %s open error (%s)\n", __func__, fname, strerror(errno));
+        return 0;
+    }
+    fseek (fp, 0, SEEK_END);    size = ftell (fp);  fseek (fp, 0, SEEK_SET);
+
+    if ((size < (long)sizeof(capture_hdr_t)) || ((ReplayData = malloc (size)) == NULL) ||
+        (fread (ReplayData, 1, size, fp) != (size_t)size)) {
+        fclose (fp);
+        return 0;
+    }
+    fclose (fp);
+
+    hdr = (capture_hdr_t *)ReplayData;
+    if ((hdr->magic != CAPTURE_MAGIC) || (hdr->version != CAPTURE_VERSION)) {
+        printf ("%s : %s is not capture file\n", __func__, fname);
+        return 0;
+    }
+    ReplaySize  = (size_t)size;
+    ReplayFast  = fast;
+    ReplayChCnt = (hdr->ch_cnt > CAPTURE_CH_MAX) ? CAPTURE_CH_MAX : hdr->ch_cnt;
+
+    for (ch = 0; ch < ReplayChCnt; ch++) {
+        struct termios tio;
+
+        if ((ReplayMaster[ch] = posix_openpt (O_RDWR | O_NOCTTY)) < 0)  return 0;
+        if (grantpt (ReplayMaster[ch]) || unlockpt (ReplayMaster[ch]))  return 0;
+        if (ptsname_r (ReplayMaster[ch], ReplayPath[ch], sizeof(ReplayPath[ch])))
+            return 0;
+
+        /* slave 를 열어두어 server 의 open/close 와 무관하게 master 유지, echo off */
+        if ((ReplaySlave[ch] = open (ReplayPath[ch], O_RDWR | O_NOCTTY)) < 0)  return 0;
+        tcgetattr (ReplaySlave[ch], &tio);
+        cfmakeraw (&tio);
+        tcsetattr (ReplaySlave[ch], TCSANOW, &tio);
+
+        printf ("%s : ch %d replay pty = %s\n", __func__, ch, ReplayPath[ch]);
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+const char *replay_uart_path (int ch)
+{
+    if ((ch < 0) || (ch >= ReplayChCnt) || (ReplayMaster[ch] < 0))  return NULL;
+    return ReplayPath[ch];
+}
+
+//------------------------------------------------------------------------------
+void replay_start (void)
+{
+    if (!ReplayChCnt)   return;
+
+    pthread_create (&thread_replay_rx, NULL, thread_replay_rx_func, NULL);
+    pthread_create (&thread_replay,    NULL, thread_replay_func,    NULL);
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
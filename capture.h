@@ -0,0 +1,71 @@
+//------------------------------------------------------------------------------
+/**
+ * @file capture.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server uart session capture & replay (pty).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __CAPTURE_H__
+#define __CAPTURE_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+//
+// capture file : capture_hdr_t + { capture_rec_t + data[size] } ...
+// rx 는 1 byte 씩 수신되므로 같은 channel 의 연속 수신 byte 는 하나의 record 로 합침.
+//
+//------------------------------------------------------------------------------
+#define CAPTURE_MAGIC       0x50434A47  // "GJCP"
+#define CAPTURE_VERSION     1
+#define CAPTURE_CH_MAX      2
+
+/* rx byte 간격이 이 값 이상이면 새 record */
+#define CAPTURE_COALESCE_US 5000
+#define CAPTURE_CHUNK_MAX   256
+
+enum {
+    eCAPTURE_RX = 0,        // client -> server
+    eCAPTURE_TX,            // server -> client
+};
+
+typedef struct capture_hdr__t {
+    uint32_t    magic;
+    uint16_t    version;
+    uint16_t    ch_cnt;
+    uint64_t    start_ts;   // epoch ms
+}   capture_hdr_t;
+
+typedef struct capture_rec__t {
+    uint32_t    dt_us;      // 이전 record 와의 간격 (us)
+    uint8_t     ch;
+    uint8_t     dir;        // eCAPTURE_xx
+    uint16_t    size;
+}   capture_rec_t;
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+/* capture (protocol_msg_rx/tx hook) */
+extern  int         capture_init    (const char *fname);
+extern  void        capture_data    (int ch, int dir, const void *data, int size);
+extern  void        capture_flush   (void);
+
+/* replay (pty) : fast = 0 원래 속도, 1 대기 없이 전송 */
+extern  int         replay_init     (const char *fname, int fast);
+extern  const char  *replay_uart_path(int ch);
+extern  void        replay_start    (void);
+
+//------------------------------------------------------------------------------
+#endif  // __CAPTURE_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,386 @@
+//------------------------------------------------------------------------------
+/**
+ * @file cfg_reload.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server config hot reload (inotify, server.cfg / ui cfg).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <libgen.h>
+#include <pthread.h>
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+
+//------------------------------------------------------------------------------
+#include "server.h"
+#include "cfg_reload.h"
+#include "log_ring.h"
+#include "crc.h"
+
+//------------------------------------------------------------------------------
+static server_t         *CfgServer = NULL;
+static pthread_mutex_t  *AdcMutex  = NULL;
+static pthread_mutex_t  *UiMutex   = NULL;
+static char             CfgName [STR_PATH_LENGTH];
+static char             CfgPath [STR_PATH_LENGTH];
+static uint32_t         CfgCrc = 0;                 // 마지막으로 읽은 file
+static uint32_t         UiCrc = 0;                  // 마지막으로 적용된 ui cfg (cfg_mutex)
+
+/* 검증된 cfg (main loop 적용 대기) */
+static pthread_mutex_t  cfg_mutex = PTHREAD_MUTEX_INITIALIZER;
+static server_t         *CfgStage = NULL;
+static int              CfgStageShared = 0;         // d, h, u item
+static int              CfgStageUi = 0;             // ui cfg 다시 생성
+static uint32_t         CfgStageUiCrc = 0;          // 적용 성공시 UiCrc
+static int              CfgStageCh = 0;             // channel 별 power rail (bit)
+static volatile int     CfgPending = 0;
+
+/* 마지막 *.cfg 변경 후 CFG_RELOAD_SETTLE_MS (timer wheel -> eventfd) */
+static tw_timer_t       CfgSettle;
+static int              CfgSettleFd = -1;
+
+static pthread_t        thread_cfg;
+
+//------------------------------------------------------------------------------
+static int file_crc (const char *path, uint32_t *crc)
+{
+    uint8_t buf [1024];
+    size_t size;
+    FILE *fp;
+
+    if ((fp = fopen (path, "r")) == NULL)   return 0;
+
+    *crc = 0;
+    while ((size = fread (buf, 1, sizeof(buf), fp)) > 0)
+        *crc = crc32_update (*crc, buf, size);
+    fclose (fp);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// 새 cfg 검증, return 0 = 적용 불가 (reason)
+//------------------------------------------------------------------------------
+static int cfg_validate (server_t *p, server_t *n, char *reason)
+{
+    int ch, i, j;
+
+    if (strcmp (p->fb_path, n->fb_path) ||
+        (p->ch_cnt != n->ch_cnt) || (p->usblp_mode != n->usblp_mode)) {
+        sprintf (reason, "S changed, restart");
+        return 0;
+    }
+    if (strcmp (p->ts_vid, n->ts_vid) || (p->ts_reset_gpio != n->ts_reset_gpio)) {
+        sprintf (reason, "T changed, restart");
+        return 0;
+    }
+    if (access (n->ui_path, R_OK)) {
+        sprintf (reason, "ui cfg not found");
+        return 0;
+    }
+    for (ch = 0; ch < p->ch_cnt; ch++) {
+        channel_t *pc = &p->ch[ch], *nc = &n->ch[ch];
+
+        if (strcmp (pc->i2c_path, nc->i2c_path) || strcmp (pc->uart_path, nc->uart_path) ||
+            (pc->uart_baud != nc->uart_baud)) {
+            sprintf (reason, "C,%d changed, restart", ch);
+            return 0;
+        }
+        if (!nc->pw_item_cnt) {
+            sprintf (reason, "P,%d no rail", ch);
+            return 0;
+        }
+        for (i = 0; i < nc->pw_item_cnt; i++) {
+            if (!nc->pw_item[i].cname[0] || (nc->pw_item[i].check_mV <= 0)) {
+                sprintf (reason, "P,%d,%d check_mV", ch, i);
+                return 0;
+            }
+        }
+    }
+    if (!n->d_item_cnt) {
+        sprintf (reason, "no D item");
+        return 0;
+    }
+    for (i = 0; i < n->d_item_cnt; i++) {
+        d_item_t *d = &n->d_item[i];
+
+        if ((d->uid_l < 0) || (d->uid_r < 0)) {
+            sprintf (reason, "D,%d,%d uid", d->gid, d->did);
+            return 0;
+        }
+        for (j = 0; j < i; j++) {
+            if ((n->d_item[j].gid == d->gid) && (n->d_item[j].did == d->did)) {
+                sprintf (reason, "D,%d,%d duplicate", d->gid, d->did);
+                return 0;
+            }
+        }
+    }
+    for (i = 0; i < n->h_item_cnt; i++) {
+        h_item_t *h = &n->h_item[i];
+
+        if ((h->pin < 0) || (h->pin > HEADER_PIN_MAX) || (h->max < h->min)) {
+            sprintf (reason, "H,%d,%d range", h->did, h->pin);
+            return 0;
+        }
+    }
+    for (i = 0; i < n->q_item_cnt; i++) {
+        spc_limit_t *q = &n->q_item[i];
+
+        if (q->lsl_on && q->usl_on && (q->usl <= q->lsl)) {
+            sprintf (reason, "Q,%d,%d range", q->gid, q->did);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// cfg 를 별도의 server_t 에 읽고 검증 후 적용 대기 (cfg_reload thread)
+//------------------------------------------------------------------------------
+static void cfg_reload_stage (void)
+{
+    char reason [LOG_STR_SIZE];
+    uint32_t cfg_crc, ui_crc = 0, ui_crc_cur;
+    server_t *n;
+
+    if (!file_crc (CfgPath, &cfg_crc))                  return;
+    if ((n = calloc (1, sizeof(server_t))) == NULL)     return;
+
+    pthread_mutex_lock   (&cfg_mutex);
+    ui_crc_cur = UiCrc;
+    pthread_mutex_unlock (&cfg_mutex);
+
+    memset (reason, 0, sizeof(reason));
+    if (!server_config_load (n, CfgName))
+        sprintf (reason, "signature not found");
+    else if (file_crc (n->ui_path, &ui_crc) && (cfg_crc == CfgCrc) && (ui_crc == ui_crc_cur)) {
+        /* 내용 변경 없음 (같은 내용 저장) */
+        free (n);
+        return;
+    }
+    else
+        cfg_validate (CfgServer, n, reason);
+
+    CfgCrc = cfg_crc;
+    if (reason[0]) {
+        printf ("%s : %s rejected (%s)\n", __func__, CfgName, reason);
+        LOG_EVENT (LOG_CH_NONE, eLOG_CFG_REJECT, reason);
+        free (n);
+        return;
+    }
+
+    pthread_mutex_lock (&cfg_mutex);
+    /* 적용 전 다시 바뀌면 이전 대기 cfg 는 버림 */
+    free (CfgStage);
+    CfgStage        = n;
+    CfgStageShared  = 1;
+    CfgStageUi     |= (ui_crc != UiCrc) || strcmp (n->ui_path, CfgServer->ui_path);
+    CfgStageUiCrc   = ui_crc;
+    CfgStageCh      = (1 << n->ch_cnt) -1;
+    CfgPending      = 1;
+    pthread_mutex_unlock (&cfg_mutex);
+
+    printf ("%s : %s staged (d_item %d, h_item %d, ui %d)\n", __func__,
+        CfgName, n->d_item_cnt, n->h_item_cnt, CfgStageUi);
+}
+
+//------------------------------------------------------------------------------
+// timer thread : cfg thread 에 알림 (file 읽기, 검증은 cfg thread 에서)
+static void cfg_settle_func (tw_timer_t *t)
+{
+    uint64_t one = 1;
+
+    if (write (CfgSettleFd, &one, sizeof(one)) != sizeof(one))
+        printf ("%s : eventfd write error\n", __func__);
+    (void)t;
+}
+
+//------------------------------------------------------------------------------
+static void *thread_cfg_func (void *arg)
+{
+    char buf [4096] __attribute__ ((aligned (__alignof__ (struct inotify_event))));
+    struct pollfd pfd[2] = {
+        { .fd = (int)(intptr_t)arg, .events = POLLIN },
+        { .fd = CfgSettleFd,        .events = POLLIN },
+    };
+    uint64_t cnt;
+    ssize_t len, pos;
+
+    while (1) {
+        if (poll (pfd, 2, -1) <= 0)     continue;
+
+        if (pfd[0].revents & POLLIN) {
+            if ((len = read (pfd[0].fd, buf, sizeof(buf))) <= 0)    continue;
+
+            for (pos = 0; pos < len; ) {
+                struct inotify_event *ev = (struct inotify_event *)&buf[pos];
+                char *ext = ev->len ? strrchr (ev->name, '.') : NULL;
+
+                /* *.cfg 만 (editor 임시 file 제외), 변경이 끝날때 까지 대기 (다시 설정) */
+                if ((ext != NULL) && !strcmp (ext, ".cfg"))
+                    tw_arm (&CfgSettle, CFG_RELOAD_SETTLE_MS);
+                pos += sizeof(struct inotify_event) + ev->len;
+            }
+        }
+        if ((pfd[1].revents & POLLIN) && (read (pfd[1].fd, &cnt, sizeof(cnt)) == sizeof(cnt)))
+            cfg_reload_stage ();
+    }
+    return arg;
+}
+
+//------------------------------------------------------------------------------
+// d, h, q, u item, ui 교체 (main loop, cfg_mutex / ui_mutex 잡은 상태)
+//------------------------------------------------------------------------------
+static void cfg_apply_shared (server_t *p, server_t *n)
+{
+    if (CfgStageUi) {
+        if (!ui_reinit (p, n->ui_path)) {
+            /* UiCrc 는 그대로 (같은 ui cfg 를 다시 저장하면 다시 시도) */
+            printf ("%s : %s ui init error, keep current config\n", __func__, n->ui_path);
+            LOG_EVENT (LOG_CH_NONE, eLOG_CFG_REJECT, "ui cfg error");
+            goto out;
+        }
+        memcpy (p->ui_path, n->ui_path, sizeof(p->ui_path));
+        ui_update (p->pfb, p->pui, -1);
+        spc_model (p->ui_path);
+    }
+    memcpy (p->d_item, n->d_item, sizeof(p->d_item));
+    memcpy (p->h_item, n->h_item, sizeof(p->h_item));
+    memcpy (p->q_item, n->q_item, sizeof(p->q_item));
+    memcpy (p->u_item, n->u_item, sizeof(p->u_item));
+    p->d_item_cnt = n->d_item_cnt;
+    p->h_item_cnt = n->h_item_cnt;
+    p->q_item_cnt = n->q_item_cnt;
+    UiCrc = CfgStageUiCrc;
+
+    printf ("%s : %s applied (d_item %d, h_item %d, ui %d)\n",
+        __func__, CfgName, p->d_item_cnt, p->h_item_cnt, CfgStageUi);
+    LOG_EVENT (LOG_CH_NONE, eLOG_CFG_RELOAD, CfgName,
+        p->d_item_cnt, p->h_item_cnt, CfgStageUi);
+out:
+    CfgStageShared = 0;
+    CfgStageUi     = 0;
+}
+
+//------------------------------------------------------------------------------
+// main loop : 적용 가능한 부분부터 적용
+//------------------------------------------------------------------------------
+void cfg_reload_apply (server_t *p)
+{
+    server_t *n;
+    int ch, i, busy = 0;
+
+    if (!CfgPending || pthread_mutex_trylock (&cfg_mutex))  return;
+
+    n = CfgStage;
+    /* power rail : channel 별로 test 가 끝난 channel 부터 */
+    for (ch = 0; ch < p->ch_cnt; ch++) {
+        channel_t *pch = &p->ch[ch];
+
+        if (pch->status == eSTATUS_RUN)     { busy = 1;  continue; }
+        if (!(CfgStageCh & (1 << ch)))      continue;
+
+        pthread_mutex_lock   (AdcMutex);
+        for (i = 0; i < n->ch[ch].pw_item_cnt; i++) {
+            memcpy (pch->pw_item[i].cname, n->ch[ch].pw_item[i].cname, STR_NAME_LENGTH);
+            pch->pw_item[i].check_mV = n->ch[ch].pw_item[i].check_mV;
+        }
+        pch->pw_item_cnt = n->ch[ch].pw_item_cnt;
+        pthread_mutex_unlock (AdcMutex);
+
+        CfgStageCh &= ~(1 << ch);
+        LOG_EVENT (ch, eLOG_CFG_POWER, CfgName, pch->pw_item_cnt);
+    }
+
+    /*
+        d, h, u item, ui : 두 channel 공용이므로 모든 channel 의 test 가 끝난 후.
+        ui thread 가 fb/ui, table 을 사용하지 않을때 (ui_mutex) 교체,
+        channel_start 는 ui thread 에서 실행되므로 lock 을 잡은 후 RUN 여부를 다시 확인.
+    */
+    if (CfgStageShared && !busy) {
+        pthread_mutex_lock (UiMutex);
+        for (ch = 0; ch < p->ch_cnt; ch++)
+            if (p->ch[ch].status == eSTATUS_RUN)    busy = 1;
+
+        if (!busy)  cfg_apply_shared (p, n);
+        pthread_mutex_unlock (UiMutex);
+    }
+    if (!CfgStageShared && !CfgStageCh) {
+        free (CfgStage);
+        CfgStage   = NULL;
+        CfgPending = 0;
+    }
+    pthread_mutex_unlock (&cfg_mutex);
+}
+
+//------------------------------------------------------------------------------
+static int cfg_watch (int fd, const char *path)
+{
+    char dir [STR_PATH_LENGTH];
+
+    memset  (dir, 0, sizeof(dir));
+    strncpy (dir, path, sizeof(dir) -1);
+    if (inotify_add_watch (fd, dirname (dir), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        printf ("%s : %s watch error (%s)\n", __func__, dir, strerror(errno));
+        return 0;
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+int cfg_reload_init (server_t *p, const char *cfg_fname,
+                     pthread_mutex_t *adc_mutex, pthread_mutex_t *ui_mutex)
+{
+    char cfg_dir [STR_PATH_LENGTH], ui_dir [STR_PATH_LENGTH];
+    int fd;
+
+    CfgServer = p;
+    AdcMutex  = adc_mutex;
+    UiMutex   = ui_mutex;
+    strncpy (CfgName, cfg_fname, sizeof(CfgName) -1);
+
+    if (!server_config_path (cfg_fname, CfgPath)) {
+        printf ("%s : %s not found, hot reload disabled\n", __func__, cfg_fname);
+        return 0;
+    }
+    file_crc (CfgPath,    &CfgCrc);
+    file_crc (p->ui_path, &UiCrc);
+
+    if ((fd = inotify_init1 (IN_CLOEXEC)) < 0) {
+        printf ("%s : inotify error (%s)\n", __func__, strerror(errno));
+        return 0;
+    }
+    if ((CfgSettleFd = eventfd (0, EFD_CLOEXEC)) < 0) {
+        printf ("%s : eventfd error (%s)\n", __func__, strerror(errno));
+        close (fd);
+        return 0;
+    }
+    tw_setup (&CfgSettle, cfg_settle_func, NULL);
+    memset  (cfg_dir, 0, sizeof(cfg_dir));  strncpy (cfg_dir, CfgPath,    sizeof(cfg_dir) -1);
+    memset  (ui_dir,  0, sizeof(ui_dir));   strncpy (ui_dir,  p->ui_path, sizeof(ui_dir)  -1);
+
+    cfg_watch (fd, CfgPath);
+    if (strcmp (dirname (cfg_dir), dirname (ui_dir)))
+        cfg_watch (fd, p->ui_path);
+
+    printf ("%s : watch %s, %s (settle %d ms)\n", __func__,
+        CfgPath, p->ui_path, CFG_RELOAD_SETTLE_MS);
+
+    pthread_create (&thread_cfg, NULL, thread_cfg_func, (void *)(intptr_t)fd);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
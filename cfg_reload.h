@@ -0,0 +1,54 @@
+//------------------------------------------------------------------------------
+/**
+ * @file cfg_reload.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server config hot reload (inotify, server.cfg / ui cfg).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __CFG_RELOAD_H__
+#define __CFG_RELOAD_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <pthread.h>
+
+//------------------------------------------------------------------------------
+//
+// server cfg / ui cfg directory 를 inotify 로 감시, *.cfg 변경 후 CFG_RELOAD_SETTLE_MS
+// 동안 추가 변경이 없으면 별도의 server_t 에 table 만 읽어서 검증 (cfg_reload thread).
+//
+//   reload  : D (item mapping), H (header 판정), Q (spc limit), U (ui id), P (power rail), ui cfg
+//   restart : S, C, T 가 바뀌면 적용하지 않음 (cfg_reject log)
+//   boot 만 : M (gpio), B (backend), L (network printer), A (aggregator) 는 reload 시 무시
+//
+// 검증된 cfg 는 main loop (cfg_reload_apply) 에서 적용.
+//   P       : channel 별, 해당 channel 이 test 중(RUN) 이 아닐때
+//   D,H,Q,U : 모든 channel 의 test 가 끝난 후 (ui cfg 가 바뀌었으면 ui 도 다시 생성)
+//             ui thread 가 table 을 쓰지 않도록 ui_mutex 를 잡고 RUN 여부 재확인 후 교체.
+// test 중인 board 는 기존 cfg 로 끝까지 진행.
+// ui cfg 적용에 실패하면 마지막 ui crc 를 유지하므로 다음 저장 때 다시 시도.
+//
+//------------------------------------------------------------------------------
+#define CFG_RELOAD_SETTLE_MS    500
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+struct server__t;
+
+extern  int     cfg_reload_init     (struct server__t *p, const char *cfg_fname,
+                                     pthread_mutex_t *adc_mutex, pthread_mutex_t *ui_mutex);
+extern  void    cfg_reload_apply    (struct server__t *p);
+
+//------------------------------------------------------------------------------
+#endif  // __CFG_RELOAD_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,48 @@
+//------------------------------------------------------------------------------
+/**
+ * @file crc.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server CRC functions.
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include "crc.h"
+
+//------------------------------------------------------------------------------
+static uint32_t Crc32Table [256];
+static int      Crc32Ready = 0;
+
+//------------------------------------------------------------------------------
+static void crc32_table_init (void)
+{
+    uint32_t i, j, c;
+
+    for (i = 0; i < 256; i++) {
+        for (c = i, j = 0; j < 8; j++)
+            c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+        Crc32Table[i] = c;
+    }
+    __atomic_store_n (&Crc32Ready, 1, __ATOMIC_RELEASE);
+}
+
+//------------------------------------------------------------------------------
+uint32_t crc32_update (uint32_t crc, const void *data, size_t size)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    if (!__atomic_load_n (&Crc32Ready, __ATOMIC_ACQUIRE))
+        crc32_table_init ();
+
+    crc = ~crc;
+    while (size--)
+        crc = Crc32Table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,31 @@
+//------------------------------------------------------------------------------
+/**
+ * @file crc.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server CRC functions.
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __CRC_H__
+#define __CRC_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+// CRC-32 (IEEE 802.3, reflected 0xEDB88320), crc 초기값 0
+//------------------------------------------------------------------------------
+extern  uint32_t    crc32_update    (uint32_t crc, const void *data, size_t size);
+
+#define crc32_calc(data, size)      crc32_update (0, data, size)
+
+//------------------------------------------------------------------------------
+#endif  // __CRC_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
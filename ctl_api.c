@@ -0,0 +1,389 @@
+//------------------------------------------------------------------------------
+/**
+ * @file ctl_api.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server local control API (unix domain socket, newline delimited json).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <errno.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+//------------------------------------------------------------------------------
+#include "ctl_api.h"
+
+//------------------------------------------------------------------------------
+typedef struct ctl_conn__t {
+    int         fd;
+    int         events;     // CTL_EV_xxx
+    uint32_t    dropped;
+    int         rx_len;
+    int         tx_len;
+    char        rx [CTL_LINE_MAX];
+    char        tx [CTL_TX_SIZE];
+}   ctl_conn_t;
+
+static const char *CtlCmdName [eCTL_END] = {
+    "status", "stop", "finish", "print_err", "print_mac",
+    "lp_init", "ip", "request", "retest", "subscribe", "unsubscribe",
+};
+
+static const char *CtlEvName [] = { "status", "item", "result" };
+
+//------------------------------------------------------------------------------
+static ctl_conn_t   *CtlConn = NULL;
+static int          CtlFd = -1;
+static ctl_func_t   CtlFunc = NULL;
+static void         *CtlArg = NULL;
+/* subscriber 가 없으면 event 는 lock 없이 바로 return */
+static volatile int CtlEvMask = 0;
+/* CTL_CMD_PER_POLL 초과로 처리하지 못한 line 있음 */
+static int          CtlPending = 0;
+
+static pthread_mutex_t  ctl_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+//------------------------------------------------------------------------------
+// json string escape (", \, control 문자)
+//------------------------------------------------------------------------------
+char *ctl_json_str (char *dst, int size, const char *src)
+{
+    int pos = 0;
+
+    for (; *src && (pos < size - 7); src++) {
+        unsigned char c = (unsigned char)*src;
+
+        if ((c == '"') || (c == '\\')) {
+            dst[pos++] = '\\';  dst[pos++] = c;
+        } else if (c < 0x20)
+            pos += sprintf (dst + pos, "\\u%04x", c);
+        else
+            dst[pos++] = c;
+    }
+    dst[pos] = 0;
+    return dst;
+}
+
+//------------------------------------------------------------------------------
+// flat object 의 "key" : value 시작 위치
+//------------------------------------------------------------------------------
+static const char *json_find (const char *line, const char *key)
+{
+    char pat [32];
+    const char *p, *v;
+    int len = snprintf (pat, sizeof(pat), "\"%s\"", key);
+
+    for (p = line; (p = strstr (p, pat)) != NULL; p += len) {
+        for (v = p + len; isspace ((unsigned char)*v); v++);
+        if (*v != ':')  continue;
+        for (v++; isspace ((unsigned char)*v); v++);
+        return v;
+    }
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+static int json_int (const char *line, const char *key, int def)
+{
+    const char *v = json_find (line, key);
+
+    if (v == NULL)  return def;
+    if (*v == '"')  v++;
+    return (isdigit ((unsigned char)*v) || (*v == '-')) ? atoi (v) : def;
+}
+
+//------------------------------------------------------------------------------
+static int json_str (const char *line, const char *key, char *out, int size)
+{
+    const char *v = json_find (line, key);
+    int pos = 0;
+
+    if ((v == NULL) || (*v++ != '"'))   return 0;
+    for (; *v && (*v != '"') && (pos < size -1); v++) {
+        if ((*v == '\\') && v[1])   v++;
+        out[pos++] = *v;
+    }
+    out[pos] = 0;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// tx buffer 에 추가 (ctl_mutex lock 상태), return 0 = buffer 부족
+//------------------------------------------------------------------------------
+static int conn_put (ctl_conn_t *c, const char *line, int len)
+{
+    if (c->tx_len + len > CTL_TX_SIZE)  return 0;
+
+    memcpy (c->tx + c->tx_len, line, len);
+    c->tx_len += len;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+static void conn_close (ctl_conn_t *c)
+{
+    close (c->fd);
+    c->fd = -1;     c->events = 0;
+    c->rx_len = c->tx_len = 0;
+    c->rx[0]  = 0;
+}
+
+//------------------------------------------------------------------------------
+static void ctl_mask_update (void)
+{
+    int i, mask = 0;
+
+    for (i = 0; i < CTL_CONN_MAX; i++)
+        if (CtlConn[i].fd >= 0)     mask |= CtlConn[i].events;
+    CtlEvMask = mask;
+}
+
+//------------------------------------------------------------------------------
+static int ctl_events (const char *str)
+{
+    int i, mask = 0;
+
+    if (strstr (str, "all"))    return CTL_EV_ALL;
+    for (i = 0; i < (int)(sizeof(CtlEvName) / sizeof(CtlEvName[0])); i++)
+        if (strstr (str, CtlEvName[i]))     mask |= (1 << i);
+    return mask;
+}
+
+//------------------------------------------------------------------------------
+// request 1 line 처리 후 응답을 tx buffer 에 추가
+//------------------------------------------------------------------------------
+static void ctl_line (ctl_conn_t *c, const char *line)
+{
+    char name [32], buf [CTL_TX_SIZE / 4], resp [CTL_TX_SIZE / 4 + 64], err [64];
+    ctl_req_t req;
+    int ret = -1, len;
+
+    memset (&req, 0, sizeof(req));
+    memset (buf,  0, sizeof(buf));
+    req.id  = json_int (line, "id",  0);
+    req.ch  = json_int (line, "ch", -1);
+    req.gid = json_int (line, "gid", -1);
+    req.did = json_int (line, "did", -1);
+
+    req.cmd = eCTL_END;
+    if (json_str (line, "cmd", name, sizeof(name)))
+        for (req.cmd = 0; (req.cmd < eCTL_END) && strcmp (name, CtlCmdName[req.cmd]); req.cmd++);
+
+    switch (req.cmd) {
+        case eCTL_END:
+            snprintf (buf, sizeof(buf), "unknown cmd");
+            break;
+        case eCTL_SUBSCRIBE:
+            if (!json_str (line, "events", name, sizeof(name)))
+                strcpy (name, "all");
+            pthread_mutex_lock   (&ctl_mutex);
+            c->events = ctl_events (name);
+            ctl_mask_update ();
+            pthread_mutex_unlock (&ctl_mutex);
+            snprintf (buf, sizeof(buf), ",\"events\":%d", c->events);
+            ret = 0;
+            break;
+        case eCTL_UNSUBSCRIBE:
+            pthread_mutex_lock   (&ctl_mutex);
+            c->events = 0;
+            ctl_mask_update ();
+            pthread_mutex_unlock (&ctl_mutex);
+            ret = 0;
+            break;
+        default:
+            ret = CtlFunc (CtlArg, &req, buf, sizeof(buf));
+            if ((ret == 0) && (req.cmd == eCTL_STATUS)) {
+                len = strlen (buf);
+                snprintf (buf + len, sizeof(buf) - len, ",\"dropped\":%u", c->dropped);
+            }
+            break;
+    }
+
+    if (ret == 0)
+        len = snprintf (resp, sizeof(resp), "{\"id\":%d,\"ok\":true%s}\n", req.id, buf);
+    else
+        len = snprintf (resp, sizeof(resp), "{\"id\":%d,\"ok\":false,\"err\":\"%s\"}\n",
+                req.id, ctl_json_str (err, sizeof(err), buf));
+    if (len >= (int)sizeof(resp))   len = sizeof(resp) -1;
+
+    pthread_mutex_lock   (&ctl_mutex);
+    if (!conn_put (c, resp, len))   c->dropped++;
+    pthread_mutex_unlock (&ctl_mutex);
+}
+
+//------------------------------------------------------------------------------
+// rd = 0 : 이미 받은 line 만 처리. return 남은 처리 가능 command 수
+//------------------------------------------------------------------------------
+static int conn_rx (ctl_conn_t *c, int budget, int rd)
+{
+    char *s, *e;
+    int n = 0;
+
+    if (rd)
+        n = recv (c->fd, c->rx + c->rx_len, CTL_LINE_MAX - c->rx_len - 1, MSG_DONTWAIT);
+    if ((rd && !n) || ((n < 0) && (errno != EAGAIN) && (errno != EINTR))) {
+        pthread_mutex_lock   (&ctl_mutex);
+        conn_close (c);
+        ctl_mask_update ();
+        pthread_mutex_unlock (&ctl_mutex);
+        return budget;
+    }
+    if (n > 0)  c->rx_len += n;
+    c->rx[c->rx_len] = 0;
+
+    for (s = c->rx; budget && ((e = strchr (s, '\n')) != NULL); s = e + 1, budget--) {
+        *e = 0;
+        if (e > s)  ctl_line (c, s);
+    }
+    c->rx_len -= (s - c->rx);
+    memmove (c->rx, s, c->rx_len);
+    /* 너무 긴 line 은 버림 */
+    if (c->rx_len >= CTL_LINE_MAX -1)   c->rx_len = 0;
+    c->rx[c->rx_len] = 0;
+    return budget;
+}
+
+//------------------------------------------------------------------------------
+static void conn_tx (ctl_conn_t *c)
+{
+    int n;
+
+    if (!c->tx_len)     return;
+
+    n = send (c->fd, c->tx, c->tx_len, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (n > 0) {
+        c->tx_len -= n;
+        memmove (c->tx, c->tx + n, c->tx_len);
+    } else if ((n < 0) && (errno != EAGAIN) && (errno != EINTR)) {
+        conn_close (c);
+        ctl_mask_update ();
+    }
+}
+
+//------------------------------------------------------------------------------
+// main loop : accept, request 처리, tx flush (대기 없음)
+//------------------------------------------------------------------------------
+void ctl_poll (void)
+{
+    struct pollfd pfd [CTL_CONN_MAX + 1];
+    int i, fd, n, budget = CTL_CMD_PER_POLL;
+
+    if (CtlFd < 0)  return;
+
+    pfd[0].fd = CtlFd;  pfd[0].events = POLLIN;
+    for (i = 0; i < CTL_CONN_MAX; i++) {
+        pfd[i + 1].fd     = CtlConn[i].fd;
+        pfd[i + 1].events = POLLIN | (CtlConn[i].tx_len ? POLLOUT : 0);
+    }
+    if ((n = poll (pfd, CTL_CONN_MAX + 1, 0)) <= 0) {
+        /* 다른 thread 에서 추가된 event, 이전 loop 에서 남은 request */
+        if (!CtlEvMask && !CtlPending)  return;
+        for (i = 0; i <= CTL_CONN_MAX; i++)     pfd[i].revents = 0;
+    }
+    CtlPending = 0;
+
+    if ((pfd[0].revents & POLLIN) && ((fd = accept (CtlFd, NULL, NULL)) >= 0)) {
+        fcntl (fd, F_SETFL, fcntl (fd, F_GETFL) | O_NONBLOCK);
+        fcntl (fd, F_SETFD, FD_CLOEXEC);
+        for (i = 0; i < CTL_CONN_MAX; i++) {
+            if (CtlConn[i].fd >= 0)     continue;
+            pthread_mutex_lock   (&ctl_mutex);
+            memset (&CtlConn[i], 0, offsetof(ctl_conn_t, rx));
+            CtlConn[i].fd    = fd;
+            CtlConn[i].rx[0] = 0;
+            pthread_mutex_unlock (&ctl_mutex);
+            break;
+        }
+        if (i == CTL_CONN_MAX)  close (fd);
+    }
+    for (i = 0; i < CTL_CONN_MAX; i++) {
+        ctl_conn_t *c = &CtlConn[i];
+
+        if ((c->fd >= 0) && (pfd[i + 1].revents & (POLLIN | POLLHUP | POLLERR)) && budget)
+            budget = conn_rx (c, budget, 1);
+        /* 이전 loop 에서 남은 line (budget 초과) */
+        if ((c->fd >= 0) && budget && strchr (c->rx, '\n'))
+            budget = conn_rx (c, budget, 0);
+        if ((c->fd >= 0) && strchr (c->rx, '\n'))
+            CtlPending = 1;
+
+        pthread_mutex_lock   (&ctl_mutex);
+        if (c->fd >= 0)     conn_tx (c);
+        pthread_mutex_unlock (&ctl_mutex);
+    }
+}
+
+//------------------------------------------------------------------------------
+void ctl_event (int mask, const char *fmt, ...)
+{
+    char line [CTL_LINE_MAX];
+    va_list va;
+    int i, len;
+
+    if (!(CtlEvMask & mask))    return;
+
+    line[0] = '{';
+    va_start (va, fmt);
+    len = vsnprintf (line + 1, sizeof(line) - 3, fmt, va) + 1;
+    va_end (va);
+    if (len > (int)sizeof(line) - 3)    len = sizeof(line) - 3;
+    line[len++] = '}';  line[len++] = '\n';
+
+    pthread_mutex_lock (&ctl_mutex);
+    for (i = 0; i < CTL_CONN_MAX; i++) {
+        ctl_conn_t *c = &CtlConn[i];
+
+        if ((c->fd < 0) || !(c->events & mask))     continue;
+        if (!conn_put (c, line, len))   c->dropped++;
+    }
+    pthread_mutex_unlock (&ctl_mutex);
+}
+
+//------------------------------------------------------------------------------
+int ctl_init (const char *path, ctl_func_t func, void *arg)
+{
+    struct sockaddr_un addr;
+    int i;
+
+    if ((CtlConn = malloc (sizeof(ctl_conn_t) * CTL_CONN_MAX)) == NULL)
+        return 0;
+    for (i = 0; i < CTL_CONN_MAX; i++)  CtlConn[i].fd = -1;
+
+    memset  (&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy (addr.sun_path, path ? path : CTL_SOCK_PATH, sizeof(addr.sun_path) -1);
+
+    /* 이전 실행에서 남은 socket file */
+    unlink (addr.sun_path);
+    if (((CtlFd = socket (AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0) ||
+        bind (CtlFd, (struct sockaddr *)&addr, sizeof(addr)) || listen (CtlFd, 4)) {
+        printf ("%s : %s bind error (%s)\n", __func__, addr.sun_path, strerror(errno));
+        if (CtlFd >= 0)     close (CtlFd);
+        CtlFd = -1;
+        return 0;
+    }
+    CtlFunc = func;
+    CtlArg  = arg;
+    printf ("%s : %s\n", __func__, addr.sun_path);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
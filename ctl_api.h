@@ -0,0 +1,91 @@
+//------------------------------------------------------------------------------
+/**
+ * @file ctl_api.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server local control API (unix domain socket, newline delimited json).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __CTL_API_H__
+#define __CTL_API_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+//
+// touch 동작 (ts_event_check) 을 script, handling robot 에서 사용하기 위한 api.
+// 1 line = 1 json object (flat, string / 정수 값만 사용).
+//
+//   request  : {"id":1,"cmd":"stop","ch":0}
+//   response : {"id":1,"ok":true, ...} / {"id":1,"ok":false,"err":"not running"}
+//   event    : {"event":"item","ch":0,"gid":5,"did":2,"status":"P","value":"941"}
+//
+//   cmd       : status [ch], stop ch (X), finish ch (E), print_err ch, print_mac ch,
+//               lp_init, ip, request ch gid did, retest ch,
+//               subscribe events ("status,item,result" / "all"), unsubscribe
+//
+// socket 은 non-blocking, main loop 에서 ctl_poll 로 처리 (uart 처리 사이, 대기 없음).
+// 한번에 CTL_CMD_PER_POLL 개 까지만 처리, 나머지는 다음 loop 에서.
+// event 는 다른 thread (ui tick) 에서도 발생하므로 tx buffer 에 넣고 main loop 에서 전송,
+// tx buffer 가 가득 찬 client 의 event 는 버림 (dropped count 는 status 응답에 포함).
+//
+//------------------------------------------------------------------------------
+#define CTL_SOCK_PATH       "/run/jig_server.sock"
+
+#define CTL_CONN_MAX        8
+#define CTL_LINE_MAX        512
+#define CTL_TX_SIZE         (64*1024)
+#define CTL_CMD_PER_POLL    8
+
+enum {
+    eCTL_STATUS = 0,
+    eCTL_STOP,
+    eCTL_FINISH,
+    eCTL_PRINT_ERR,
+    eCTL_PRINT_MAC,
+    eCTL_LP_INIT,
+    eCTL_IP,
+    eCTL_REQUEST,
+    eCTL_RETEST,
+    eCTL_SUBSCRIBE,
+    eCTL_UNSUBSCRIBE,
+    eCTL_END
+};
+
+/* event subscription */
+#define CTL_EV_STATUS       0x01
+#define CTL_EV_ITEM         0x02
+#define CTL_EV_RESULT       0x04
+#define CTL_EV_ALL          0x07
+
+typedef struct ctl_req__t {
+    int         id;
+    int         cmd;
+    int         ch;         // -1 = 없음
+    int         gid, did;
+}   ctl_req_t;
+
+/* return 0 = ok (buf : 응답에 추가할 json field, ",\"ip\":\"...\""), -1 = error (buf : message) */
+typedef int (*ctl_func_t) (void *arg, const ctl_req_t *req, char *buf, int size);
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+extern  int     ctl_init    (const char *path, ctl_func_t func, void *arg);
+extern  void    ctl_poll    (void);
+/* fmt : json object 내용 ("\"event\":\"item\",...") */
+extern  void    ctl_event   (int mask, const char *fmt, ...);
+extern  char    *ctl_json_str (char *dst, int size, const char *src);
+
+//------------------------------------------------------------------------------
+#endif  // __CTL_API_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
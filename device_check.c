@@ -33,6 +33,29 @@
 
 //------------------------------------------------------------------------------
 #include "server.h"
+#include "log_ring.h"
+#include "mono_time.h"
+
+//------------------------------------------------------------------------------
+static int i2c_fd_to_ch (server_t *p, int fd)
+{
+    int nch;
+
+    for (nch = 0; nch < p->ch_cnt; nch++)
+        if (p->ch[nch].i2c_fd == fd)    return nch;
+
+    return LOG_CH_NONE;
+}
+
+//------------------------------------------------------------------------------
+static int adc_read (int nch, int fd, const char *name, int *value, int *pin)
+{
+    uint64_t start_us = mono_us ();
+    int ret = hw_adc_read (fd, name, value, pin);
+
+    metrics_observe (nch, eHIST_ADC_READ, mono_us () - start_us);
+    return ret;
+}
 
 //------------------------------------------------------------------------------
 static int iperf3_client_func (const char *server_ip, int did)
@@ -74,7 +97,7 @@ int device_resp_parse (const char *resp_msg, parse_resp_data_t *pdata)
     char *ptr, resp[SERIAL_RESP_SIZE+1];
 
     if ((msg_size != SERIAL_RESP_SIZE) && (msg_size != DEVICE_RESP_SIZE)) {
-        printf ("%s : unknown resp size = %d, resp = %s\n", __func__, msg_size, resp_msg);
+        LOG_EVENT (LOG_CH_NONE, eLOG_RESP_SIZE, resp_msg, msg_size);
         return 0;
     }
 
@@ -120,8 +143,92 @@ int device_resp_parse (const char *resp_msg, parse_resp_data_t *pdata)
 }
 
 //------------------------------------------------------------------------------
-int device_resp_check (server_t *p, int fd, parse_resp_data_t *pdata)
+// led, audio : check_value 를 넘을때 까지 adc 반복 측정 (low = 값이 내려가는 check)
+// 측정 사이에는 adc_mutex 를 풀어서 다른 adc 사용자 (power_mon, 다른 channel) 가 대기하지 않도록 함.
+// threshold 를 넘거나 ADC_SETTLE_MS 가 지나면 종료.
+// return 측정 횟수, peak = 최소 (low) / 최대값
+//------------------------------------------------------------------------------
+#define ADC_SETTLE_MS           1000
+#define ADC_SETTLE_PERIOD_US    1000
+
+static int adc_settle (int nch, int fd, const char *port, int low, int check_value,
+                        int *peak, pthread_mutex_t *adc_mutex)
+{
+    uint64_t start = mono_ms ();
+    int value, pin, cnt = 0;
+
+    adc_read (nch, fd, port, peak, &pin);
+    while ((mono_ms () - start) < ADC_SETTLE_MS) {
+        if (adc_mutex)  pthread_mutex_unlock (adc_mutex);
+        usleep (ADC_SETTLE_PERIOD_US);
+        if (adc_mutex)  pthread_mutex_lock   (adc_mutex);
+
+        adc_read (nch, fd, port, &value, &pin);
+        cnt++;
+        if (low) {
+            if (value < *peak)          *peak = value;
+            if (value < check_value)    break;
+        } else {
+            if (value > *peak)          *peak = value;
+            if (value > check_value)    break;
+        }
+    }
+    return cnt;
+}
+
+//------------------------------------------------------------------------------
+// header pin 2개씩 (odd, even) mV 값을 문자로 변환
+// '0' : low/low, '1' : high/low, '2' : low/high, '3' : high/high, '-' : 판정불가
+//------------------------------------------------------------------------------
+#define GPIO_LOW_mV     100
+#define GPIO_HIGH_mV    3000
+
+void device_header_classify (server_t *p, int did, int *header, char *resp)
 {
+    int pin, i, max_mv = GPIO_HIGH_mV, min_mv = GPIO_LOW_mV;
+
+    // Header max min config
+    for (i = 0; i < p->h_item_cnt; i++) {
+        if (p->h_item[i].pin)   continue;
+        if ((DEVICE_ID(did) == p->h_item[i].did)) {
+            max_mv = p->h_item[i].max;  min_mv = p->h_item[i].min;
+            break;
+        }
+    }
+
+    // Header pin config
+    for (i = 0; i < p->h_item_cnt; i++) {
+        if (!p->h_item[i].pin)  continue;
+        if ((DEVICE_ID(did) == p->h_item[i].did)) {
+            if      (header[p->h_item[i].pin -1] >= p->h_item[i].max)
+                header[p->h_item[i].pin -1] = max_mv;
+            else if (header[p->h_item[i].pin -1] <= p->h_item[i].min)
+                header[p->h_item[i].pin -1] = min_mv;
+        }
+    }
+
+    for (i = 0, pin = 0; i < DEVICE_RESP_SIZE -2; i ++) {
+        pin = (i * 2);
+        if      ((header[pin] <= min_mv) && (header[pin + 1] <= min_mv))
+            resp[i] = '0';
+        else if ((header[pin] >= max_mv) && (header[pin + 1] <= min_mv))
+            resp[i] = '1';
+        else if ((header[pin] <= min_mv) && (header[pin + 1] >= max_mv))
+            resp[i] = '2';
+        else if ((header[pin] >= max_mv) && (header[pin + 1] >= max_mv))
+            resp[i] = '3';
+        else
+            resp[i] = '-';
+    }
+}
+
+//------------------------------------------------------------------------------
+// adc_mutex : caller 가 lock 한 상태로 호출 (led, audio 측정 대기 중에는 unlock)
+//------------------------------------------------------------------------------
+int device_resp_check (server_t *p, int fd, parse_resp_data_t *pdata, pthread_mutex_t *adc_mutex)
+{
+    int nch = i2c_fd_to_ch (p, fd);
+
     /* Device request I2C ADC Check */
     switch (pdata->gid) {
         /* IR, MISC SPI B/T, MISC HP Detect Thread running */
@@ -130,8 +237,7 @@ int device_resp_check (server_t *p, int fd, parse_resp_data_t *pdata)
         case eGID_SYSTEM:
             // mem did
             if (pdata->did == 0) {
-                printf ("%s : mem_test_size = %d, mem_size = %d\n",
-                        __func__, p->test_mem_model, pdata->resp_i);
+                LOG_EVENT (nch, eLOG_CHECK_MEM, NULL, p->test_mem_model, pdata->resp_i);
                 memset (pdata->resp_s, 0, sizeof(pdata->resp_s));
                 sprintf(pdata->resp_s, "%d", p->test_mem_model);
             }
@@ -141,14 +247,14 @@ int device_resp_check (server_t *p, int fd, parse_resp_data_t *pdata)
             if ((pdata->did == 2) || (pdata->did == 6) || (pdata->did == 7)) {
                 int iperf_speed = 0;
                 iperf_speed = iperf3_client_func (pdata->resp_s, pdata->did);
-                printf ("%s : iperf = %d\n", __func__, iperf_speed);
+                LOG_EVENT (nch, eLOG_CHECK_IPERF, NULL, pdata->did, iperf_speed);
                 memset (pdata->resp_s, 0, sizeof(pdata->resp_s));
                 sprintf(pdata->resp_s, "%d", iperf_speed);
             }
             break;
         case eGID_LED: case eGID_AUDIO:
             {
-                int value, prev_value, check_value, pin, i;
+                int prev_value, check_value, i;
                 char *ptr, adc_port[DEVICE_RESP_SIZE -2];
 
                 if ((ptr = strtok (pdata->resp_s, "-")) != NULL) {
@@ -159,88 +265,32 @@ int device_resp_check (server_t *p, int fd, parse_resp_data_t *pdata)
                     else
                         check_value = DEVICE_ACTION(pdata->did) ? 300 : 50; /* default value */
                 }
-                printf ("%s : adc port = %s, check_value = %d\n",
-                            __func__, adc_port, check_value);
-
-                adc_board_read (fd, adc_port, &prev_value, &pin);
-                for (i = 0; i < 1000; i++) {
-                    usleep (1000);
-                    adc_board_read (fd, adc_port, &value, &pin);
-
-                    if (pdata->gid == eGID_LED) {
-                        if(!DEVICE_ACTION(pdata->did)) {
-                            if (value < prev_value)     prev_value = value;
-                            if (value < check_value)    break;
-                        }
-                        if( DEVICE_ACTION(pdata->did)) {
-                            if (value > prev_value)     prev_value = value;
-                            if (value > check_value)    break;
-                        }
-                    } else {
-                        if(!DEVICE_ACTION(pdata->did)) {
-                            if (value > prev_value)     prev_value = value;
-                            if (value > check_value)    break;
-                        }
-                        if( DEVICE_ACTION(pdata->did)) {
-                            if (value < prev_value)     prev_value = value;
-                            if (value < check_value)    break;
-                        }
-                    }
-                }
-                printf ("%s : count = %d, led value = %d (check_value = %d)\n",
-                        __func__, i, prev_value, check_value);
+                LOG_EVENT (nch, eLOG_CHECK_ADC_PORT, adc_port,
+                            pdata->gid, pdata->did, check_value);
+
+                /* led on, audio off = 최소값 / led off, audio on = 최대값 */
+                i = adc_settle (nch, fd, adc_port,
+                        (pdata->gid == eGID_LED) ? !DEVICE_ACTION(pdata->did) : DEVICE_ACTION(pdata->did),
+                        check_value, &prev_value, adc_mutex);
+                LOG_EVENT (nch, eLOG_CHECK_ADC_VALUE, NULL,
+                            pdata->gid, pdata->did, i, prev_value);
                 memset (pdata->resp_s, 0, sizeof(pdata->resp_s));
                 sprintf(pdata->resp_s, "%d", prev_value);
             }
             break;
         case eGID_HEADER:
-#define HEADER_PIN_MAX  40
-#define GPIO_LOW_mV     100
-#define GPIO_HIGH_mV    3000
             {
-                int header[HEADER_PIN_MAX +1];
-                int pin, i, max_mv = GPIO_HIGH_mV, min_mv = GPIO_LOW_mV;
-
-                // Header max min config
-                for (i = 0; i < p->h_item_cnt; i++) {
-                    if (p->h_item[i].pin)   continue;
-                    if ((DEVICE_ID(pdata->did) == p->h_item[i].did)) {
-                        max_mv = p->h_item[i].max;  min_mv = p->h_item[i].min;
-                        break;
-                    }
-                }
+                int header[HEADER_PIN_MAX +1], pin;
+
                 usleep (100 * 1000);    // gpio setup stable delay
 
                 memset (header, 0, sizeof(header));
                 //int adc_board_read (int fd, const char *h_name, int *read_value, int *cnt)
-                adc_board_read (fd, pdata->resp_s, &header[0], &pin);
-
-                // Header pin config
-                for (i = 0; i < p->h_item_cnt; i++) {
-                    if (!p->h_item[i].pin)  continue;
-                    if ((DEVICE_ID(pdata->did) == p->h_item[i].did)) {
-                        if      (header[p->h_item[i].pin -1] >= p->h_item[i].max)
-                            header[p->h_item[i].pin -1] = max_mv;
-                        else if (header[p->h_item[i].pin -1] <= p->h_item[i].min)
-                            header[p->h_item[i].pin -1] = min_mv;
-                    }
-                }
+                adc_read (nch, fd, pdata->resp_s, &header[0], &pin);
 
                 memset (pdata->resp_s, 0, sizeof(pdata->resp_s));
-                for (i = 0, pin = 0; i < DEVICE_RESP_SIZE -2; i ++) {
-                    pin = (i * 2);
-                    if      ((header[pin] <= min_mv) && (header[pin + 1] <= min_mv))
-                        pdata->resp_s[i] = '0';
-                    else if ((header[pin] >= max_mv) && (header[pin + 1] <= min_mv))
-                        pdata->resp_s[i] = '1';
-                    else if ((header[pin] <= min_mv) && (header[pin + 1] >= max_mv))
-                        pdata->resp_s[i] = '2';
-                    else if ((header[pin] >= max_mv) && (header[pin + 1] >= max_mv))
-                        pdata->resp_s[i] = '3';
-                    else
-                        pdata->resp_s[i] = '-';
-                }
-                printf ("%s : %s\n", __func__, pdata->resp_s);
+                device_header_classify (p, pdata->did, header, pdata->resp_s);
+                LOG_EVENT (nch, eLOG_CHECK_HEADER, pdata->resp_s, pdata->did);
             }
             break;
         /* not implement */
@@ -55,11 +55,15 @@
 #define RESP_CMD_ERROR      'E'
 #define RESP_CMD_ACK        'A'
 #define RESP_CMD_OKAY       'O'
+#define RESP_CMD_BATCH      'N'     // v3 only (protocol_v3.h)
 
 #define DEVICE_GID_SIZE     2
 #define DEVICE_DID_SIZE     4
 #define DEVICE_RESP_SIZE    22  // [status(1), value(20)]
 
+/* eGID_HEADER : 40 pin header adc value (mV) */
+#define HEADER_PIN_MAX      40
+
 #define SERIAL_RESP_FORM(buf, cmd, gid, did, resp)  sprintf (buf, "@,%c,%02d,%04d,%22s,#", cmd, gid, did, resp)
 #define DEVICE_RESP_FORM_INT(buf, status, value)    sprintf (buf, "%c,%20d", status, value)
 #define DEVICE_RESP_FORM_STR(buf, status, value)    sprintf (buf, "%c,%20s", status, value)
@@ -145,7 +149,9 @@ typedef struct parse_resp_data__t {
 //------------------------------------------------------------------------------
 // server.c
 // extern int  device_resp_parse   (const char *resp, parse_resp_data_t *pdata);
-// extern int  device_resp_check   (server_t *p, int fd, parse_resp_data_t *pdata);
+// extern int  device_resp_check   (server_t *p, int fd, parse_resp_data_t *pdata,
+//                                  pthread_mutex_t *adc_mutex);
+// extern void device_header_classify (server_t *p, int did, int *header, char *resp);
 
 //------------------------------------------------------------------------------
 #endif  // __DEVICE_CHECK_H__
@@ -0,0 +1,608 @@
+//------------------------------------------------------------------------------
+/**
+ * @file label.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server label template (ZPL) with Code128/QR bitmap.
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+//------------------------------------------------------------------------------
+#include "label.h"
+
+//------------------------------------------------------------------------------
+enum {
+    eFLD_TEXT = 0,      // template 고정 문자열
+    eFLD_CH,
+    eFLD_MAC,
+    eFLD_MAC_COLON,
+    eFLD_MSG1,
+    eFLD_MSG2,
+    eFLD_MSG3,
+    eFLD_CODE128,
+    eFLD_QR,
+    eFLD_DATE,
+    eFLD_END
+};
+
+static const char *FieldName [eFLD_END] = {
+    "", "{CH}", "{MAC}", "{MAC:}", "{MSG1}", "{MSG2}", "{MSG3}", "{CODE128}", "{QR}", "{DATE}",
+};
+
+typedef struct label_op__t {
+    int     field;
+    int     off, len;       // eFLD_TEXT : template 내 위치
+}   label_op_t;
+
+typedef struct label_tpl__t {
+    char        text [LABEL_TPL_SIZE];
+    label_op_t  op   [LABEL_OP_MAX];
+    int         op_cnt;
+}   label_tpl_t;
+
+/* 같은 mac 재출력시 bitmap 재사용 (MAC touch) */
+typedef struct label_gfa__t {
+    char    key  [32];
+    int     len;
+    char    data [LABEL_JOB_SIZE / 2];
+}   label_gfa_t;
+
+//------------------------------------------------------------------------------
+static const char *DefaultTpl [eLABEL_END] = {
+    "^XA^CI28"
+    "^FO30,20^A0N,28,28^FDCH {CH}^FS"
+    "^FO150,20^A0N,28,28^FD{MAC:}^FS"
+    "^FO30,60{CODE128}^FS"
+    "^FO460,10{QR}^FS"
+    "^XZ\n",
+
+    "^XA^CI28"
+    "^FO30,20^A0N,28,28^FDCH {CH}^FS"
+    "^FO30,55^A0N,28,28^FD{MSG1}^FS"
+    "^FO30,90^A0N,28,28^FD{MSG2}^FS"
+    "^FO30,125^A0N,28,28^FD{MSG3}^FS"
+    "^XZ\n",
+};
+
+static label_tpl_t  LabelTpl [eLABEL_END];
+static label_gfa_t  GfaCache [2];
+
+static pthread_mutex_t  label_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+//------------------------------------------------------------------------------
+// Code128 (code set B) : bar/space width, stop = 7 width
+//------------------------------------------------------------------------------
+static const char *Code128Pattern [107] = {
+    "212222", "222122", "222221", "121223", "121322", "131222", "122213", "122312",
+    "132212", "221213", "221312", "231212", "112232", "122132", "122231", "113222",
+    "123122", "123221", "223211", "221132", "221231", "213212", "223112", "312131",
+    "311222", "321122", "321221", "312212", "322112", "322211", "212123", "212321",
+    "232121", "111323", "131123", "131321", "112313", "132113", "132311", "211313",
+    "231113", "231311", "112133", "112331", "132131", "113123", "113321", "133121",
+    "313121", "211331", "231131", "213113", "213311", "213131", "311123", "311321",
+    "331121", "312113", "312311", "332111", "314111", "221411", "431111", "111224",
+    "111422", "121124", "121421", "141122", "141221", "112214", "112412", "122114",
+    "122411", "142112", "142211", "241211", "221114", "413111", "241112", "134111",
+    "111242", "121142", "121241", "114212", "124112", "124211", "411212", "421112",
+    "421211", "212141", "214121", "412121", "111143", "111341", "131141", "114113",
+    "114311", "411113", "411311", "113141", "114131", "311141", "411131", "211412",
+    "211214", "211232", "2331112",
+};
+
+#define CODE128_START_B     104
+#define CODE128_STOP        106
+
+static int code128_put (int sym, uint8_t *module, int pos, int max)
+{
+    const char *w = Code128Pattern[sym];
+    int i, j;
+
+    for (i = 0; w[i]; i++) {
+        for (j = 0; j < (w[i] - '0'); j++) {
+            if (pos >= max)     return -1;
+            /* 짝수 index = bar */
+            module[pos++] = !(i & 1);
+        }
+    }
+    return pos;
+}
+
+int code128_encode (const char *str, uint8_t *module, int max)
+{
+    int i, pos = 0, sum = CODE128_START_B;
+
+    if ((pos = code128_put (CODE128_START_B, module, pos, max)) < 0)    return 0;
+    for (i = 0; str[i]; i++) {
+        int v = ((uint8_t)str[i] < 32 || (uint8_t)str[i] > 127) ? 0 : str[i] - 32;
+
+        sum += v * (i + 1);
+        if ((pos = code128_put (v, module, pos, max)) < 0)      return 0;
+    }
+    if ((pos = code128_put (sum % 103,    module, pos, max)) < 0)   return 0;
+    if ((pos = code128_put (CODE128_STOP, module, pos, max)) < 0)   return 0;
+    return pos;
+}
+
+//------------------------------------------------------------------------------
+// QR code (version 1 ~ 3, ECC level M, byte mode, 1 block)
+//------------------------------------------------------------------------------
+static const int QrDataCw [QR_VERSION_MAX + 1] = { 0, 16, 28, 44 };
+static const int QrEccCw  [QR_VERSION_MAX + 1] = { 0, 10, 16, 26 };
+
+#define QR(g, x, y)     (g)[(y) * QR_SIZE_MAX + (x)]
+
+static uint8_t gf_mul (uint8_t x, uint8_t y)
+{
+    int z = 0, i;
+
+    for (i = 7; i >= 0; i--) {
+        z = (z << 1) ^ ((z >> 7) * 0x11D);
+        z ^= ((y >> i) & 1) * x;
+    }
+    return (uint8_t)z;
+}
+
+static void qr_ecc (const uint8_t *data, int len, uint8_t *ecc, int degree)
+{
+    uint8_t div [32], root = 1, factor;
+    int i, j;
+
+    if ((degree <= 0) || (degree > (int)sizeof(div)))   return;
+
+    /* Reed-Solomon generator polynomial (최고차항 제외) */
+    memset (div, 0, sizeof(div));
+    div[degree - 1] = 1;
+    for (i = 0; i < degree; i++) {
+        for (j = 0; j < degree; j++) {
+            div[j] = gf_mul (div[j], root);
+            if (j + 1 < degree)     div[j] ^= div[j + 1];
+        }
+        root = gf_mul (root, 0x02);
+    }
+    memset (ecc, 0, degree);
+    for (i = 0; i < len; i++) {
+        factor = data[i] ^ ecc[0];
+        memmove (ecc, ecc + 1, degree - 1);
+        ecc[degree - 1] = 0;
+        for (j = 0; j < degree; j++)
+            ecc[j] ^= gf_mul (div[j], factor);
+    }
+}
+
+static void qr_func (uint8_t *grid, uint8_t *func, int x, int y, int dark)
+{
+    QR(grid, x, y) = dark;
+    QR(func, x, y) = 1;
+}
+
+static void qr_finder (uint8_t *grid, uint8_t *func, int size, int cx, int cy)
+{
+    int dx, dy, d;
+
+    for (dy = -4; dy <= 4; dy++) {
+        for (dx = -4; dx <= 4; dx++) {
+            int x = cx + dx, y = cy + dy;
+
+            if ((x < 0) || (y < 0) || (x >= size) || (y >= size))   continue;
+            d = abs (dx) > abs (dy) ? abs (dx) : abs (dy);
+            qr_func (grid, func, x, y, (d != 2) && (d != 4));
+        }
+    }
+}
+
+static void qr_format (uint8_t *grid, uint8_t *func, int size, int mask)
+{
+    /* ECC level M = 00 */
+    int data = (0 << 3) | mask, rem = data, bits, i;
+
+    for (i = 0; i < 10; i++)
+        rem = (rem << 1) ^ ((rem >> 9) * 0x537);
+    bits = ((data << 10) | rem) ^ 0x5412;
+
+    for (i = 0; i <= 5; i++)    qr_func (grid, func, 8, i, (bits >> i) & 1);
+    qr_func (grid, func, 8, 7, (bits >> 6) & 1);
+    qr_func (grid, func, 8, 8, (bits >> 7) & 1);
+    qr_func (grid, func, 7, 8, (bits >> 8) & 1);
+    for (i = 9; i < 15; i++)    qr_func (grid, func, 14 - i, 8, (bits >> i) & 1);
+
+    for (i = 0; i < 8; i++)     qr_func (grid, func, size - 1 - i, 8, (bits >> i) & 1);
+    for (i = 8; i < 15; i++)    qr_func (grid, func, 8, size - 15 + i, (bits >> i) & 1);
+    qr_func (grid, func, 8, size - 8, 1);
+}
+
+static int qr_mask_bit (int mask, int x, int y)
+{
+    switch (mask) {
+        case 0:     return ((x + y) % 2) == 0;
+        case 1:     return (y % 2) == 0;
+        case 2:     return (x % 3) == 0;
+        case 3:     return ((x + y) % 3) == 0;
+        case 4:     return ((x / 3 + y / 2) % 2) == 0;
+        case 5:     return ((x * y % 2) + (x * y % 3)) == 0;
+        case 6:     return (((x * y % 2) + (x * y % 3)) % 2) == 0;
+        default:    return ((((x + y) % 2) + (x * y % 3)) % 2) == 0;
+    }
+}
+
+static void qr_apply_mask (uint8_t *grid, const uint8_t *func, int size, int mask)
+{
+    int x, y;
+
+    for (y = 0; y < size; y++)
+        for (x = 0; x < size; x++)
+            if (!QR(func, x, y))    QR(grid, x, y) ^= qr_mask_bit (mask, x, y);
+}
+
+/* N1 (같은 색 5개 이상), N3 (1:1:3:1:1 finder 유사 pattern) 용 line 검사 */
+static int qr_line_penalty (const uint8_t *line, int size)
+{
+    static const uint8_t f1 [11] = { 1,0,1,1,1,0,1,0,0,0,0 };
+    static const uint8_t f2 [11] = { 0,0,0,0,1,0,1,1,1,0,1 };
+    int i, run = 1, p = 0;
+
+    for (i = 1; i <= size; i++) {
+        if ((i < size) && (line[i] == line[i - 1]))     { run++;    continue; }
+        if (run >= 5)   p += 3 + (run - 5);
+        run = 1;
+    }
+    for (i = 0; i + 11 <= size; i++)
+        if (!memcmp (&line[i], f1, 11) || !memcmp (&line[i], f2, 11))
+            p += 40;
+    return p;
+}
+
+static int qr_penalty (const uint8_t *grid, int size)
+{
+    uint8_t line [QR_SIZE_MAX];
+    int x, y, p = 0, dark = 0, k;
+
+    for (y = 0; y < size; y++) {
+        for (x = 0; x < size; x++)  line[x] = QR(grid, x, y);
+        p += qr_line_penalty (line, size);
+    }
+    for (x = 0; x < size; x++) {
+        for (y = 0; y < size; y++)  line[y] = QR(grid, x, y);
+        p += qr_line_penalty (line, size);
+    }
+    for (y = 0; y < size; y++) {
+        for (x = 0; x < size; x++) {
+            dark += QR(grid, x, y);
+            if ((x + 1 < size) && (y + 1 < size) &&
+                (QR(grid, x, y) == QR(grid, x + 1, y)) &&
+                (QR(grid, x, y) == QR(grid, x, y + 1)) &&
+                (QR(grid, x, y) == QR(grid, x + 1, y + 1)))
+                p += 3;
+        }
+    }
+    /* N4 : dark 비율 50% 에서 5% 벗어날 때 마다 10 */
+    k = (abs (dark * 20 - size * size * 10) + size * size - 1) / (size * size) - 1;
+    return p + ((k > 0) ? k * 10 : 0);
+}
+
+int qr_encode (const char *str, uint8_t *grid)
+{
+    uint8_t func [QR_SIZE_MAX * QR_SIZE_MAX], best [QR_SIZE_MAX * QR_SIZE_MAX];
+    uint8_t cw [128];
+    int len = strlen (str), ver, size, i, bit, mask, best_p = -1;
+
+    for (ver = 1; ver <= QR_VERSION_MAX; ver++)
+        if (len + 2 <= QrDataCw[ver])   break;
+    if (ver > QR_VERSION_MAX)   return 0;
+    size = 17 + 4 * ver;
+
+    /* data codeword : mode(0100) + count(8bit) + data + terminator + pad */
+    memset (cw, 0, sizeof(cw));
+    bit = 0;
+#define PUT_BITS(v, n)  do { int _i; for (_i = (n) - 1; _i >= 0; _i--, bit++) \
+                            cw[bit >> 3] |= (((v) >> _i) & 1) << (7 - (bit & 7)); } while (0)
+    PUT_BITS (0x4, 4);
+    PUT_BITS (len, 8);
+    for (i = 0; i < len; i++)   PUT_BITS ((uint8_t)str[i], 8);
+    bit += 4;   // terminator (0000), data 영역을 넘지 않음 (len + 2 <= data cw)
+#undef PUT_BITS
+    for (i = (bit + 7) / 8; i < QrDataCw[ver]; i++)
+        cw[i] = ((i - (bit + 7) / 8) & 1) ? 0x11 : 0xEC;
+    qr_ecc (cw, QrDataCw[ver], &cw[QrDataCw[ver]], QrEccCw[ver]);
+
+    /* function pattern */
+    memset (grid, 0, QR_SIZE_MAX * QR_SIZE_MAX);
+    memset (func, 0, sizeof(func));
+    for (i = 0; i < size; i++) {
+        qr_func (grid, func, 6, i, !(i & 1));
+        qr_func (grid, func, i, 6, !(i & 1));
+    }
+    qr_finder (grid, func, size, 3, 3);
+    qr_finder (grid, func, size, size - 4, 3);
+    qr_finder (grid, func, size, 3, size - 4);
+    if (ver > 1) {
+        int c = size - 7, dx, dy;
+
+        for (dy = -2; dy <= 2; dy++)
+            for (dx = -2; dx <= 2; dx++)
+                qr_func (grid, func, c + dx, c + dy,
+                    (abs (dx) == 2) || (abs (dy) == 2) || (!dx && !dy));
+    }
+    qr_format (grid, func, size, 0);
+
+    /* zigzag data 배치 */
+    {
+        int right, vert, j, total = (QrDataCw[ver] + QrEccCw[ver]) * 8;
+
+        for (i = 0, right = size - 1; right >= 1; right -= 2) {
+            if (right == 6)     right = 5;
+            for (vert = 0; vert < size; vert++) {
+                for (j = 0; j < 2; j++) {
+                    int x = right - j, up = ((right + 1) & 2) == 0;
+                    int y = up ? size - 1 - vert : vert;
+
+                    if (QR(func, x, y) || (i >= total))     continue;
+                    QR(grid, x, y) = (cw[i >> 3] >> (7 - (i & 7))) & 1;
+                    i++;
+                }
+            }
+        }
+    }
+
+    /* penalty 가 가장 작은 mask 선택 */
+    for (mask = 0; mask < 8; mask++) {
+        int p;
+
+        qr_apply_mask (grid, func, size, mask);
+        qr_format     (grid, func, size, mask);
+        if ((p = qr_penalty (grid, size)) < best_p || best_p < 0) {
+            best_p = p;
+            memcpy (best, grid, sizeof(best));
+        }
+        qr_apply_mask (grid, func, size, mask);
+    }
+    memcpy (grid, best, sizeof(best));
+    return size;
+}
+
+//------------------------------------------------------------------------------
+// ZPL ^GFA (hex, 이전 line 과 같으면 ':')
+//------------------------------------------------------------------------------
+static const char HexChar [] = "0123456789ABCDEF";
+
+static int gfa_begin (char *buf, int size, int w, int h)
+{
+    int bpr = (w + 7) / 8;
+
+    return snprintf (buf, size, "^GFA,%d,%d,%d,", bpr * h, bpr * h, bpr);
+}
+
+static int gfa_row (char *buf, int size, const uint8_t *row, const uint8_t *prev, int bpr)
+{
+    int i;
+
+    if ((prev != NULL) && !memcmp (row, prev, bpr)) {
+        if (size < 1)   return -1;
+        buf[0] = ':';
+        return 1;
+    }
+    if (size < bpr * 2)     return -1;
+    for (i = 0; i < bpr; i++) {
+        buf[i * 2 + 0] = HexChar[row[i] >> 4];
+        buf[i * 2 + 1] = HexChar[row[i] & 0xF];
+    }
+    return bpr * 2;
+}
+
+static void row_set (uint8_t *row, int x0, int n)
+{
+    int x;
+
+    for (x = x0; x < x0 + n; x++)   row[x >> 3] |= 0x80 >> (x & 7);
+}
+
+static int gfa_code128 (char *buf, int size, const char *str)
+{
+    uint8_t module [CODE128_MODULE_MAX], row [CODE128_MODULE_MAX * LABEL_BAR_DOT / 8 + 1];
+    int i, n, len, ret, bpr;
+
+    if ((n = code128_encode (str, module, CODE128_MODULE_MAX)) == 0)    return 0;
+
+    bpr = (n * LABEL_BAR_DOT + 7) / 8;
+    memset (row, 0, sizeof(row));
+    for (i = 0; i < n; i++)
+        if (module[i])  row_set (row, i * LABEL_BAR_DOT, LABEL_BAR_DOT);
+
+    len = gfa_begin (buf, size, n * LABEL_BAR_DOT, LABEL_BAR_HEIGHT);
+    for (i = 0; i < LABEL_BAR_HEIGHT; i++) {
+        if ((ret = gfa_row (buf + len, size - len, row, i ? row : NULL, bpr)) < 0)
+            return 0;
+        len += ret;
+    }
+    return len;
+}
+
+static int gfa_qr (char *buf, int size, const char *str)
+{
+    uint8_t grid [QR_SIZE_MAX * QR_SIZE_MAX];
+    uint8_t row [2][QR_SIZE_MAX * LABEL_QR_DOT / 8 + 1];
+    int n, x, y, len, ret, bpr, cur = 0;
+
+    if ((n = qr_encode (str, grid)) == 0)   return 0;
+
+    bpr = (n * LABEL_QR_DOT + 7) / 8;
+    len = gfa_begin (buf, size, n * LABEL_QR_DOT, n * LABEL_QR_DOT);
+    for (y = 0; y < n * LABEL_QR_DOT; y++) {
+        memset (row[cur], 0, sizeof(row[cur]));
+        for (x = 0; x < n; x++)
+            if (QR(grid, x, y / LABEL_QR_DOT))  row_set (row[cur], x * LABEL_QR_DOT, LABEL_QR_DOT);
+
+        if ((ret = gfa_row (buf + len, size - len, row[cur], y ? row[!cur] : NULL, bpr)) < 0)
+            return 0;
+        len += ret;     cur = !cur;
+    }
+    return len;
+}
+
+//------------------------------------------------------------------------------
+static int gfa_cached (int field, char *buf, int size, const char *mac)
+{
+    label_gfa_t *c = &GfaCache[field == eFLD_QR];
+    int len;
+
+    pthread_mutex_lock (&label_mutex);
+    if (strcmp (c->key, mac) || !c->len) {
+        c->len = (field == eFLD_QR) ? gfa_qr      (c->data, sizeof(c->data), mac)
+                                    : gfa_code128 (c->data, sizeof(c->data), mac);
+        strncpy (c->key, mac, sizeof(c->key) -1);
+    }
+    len = (c->len <= size) ? c->len : 0;
+    memcpy (buf, c->data, len);
+    pthread_mutex_unlock (&label_mutex);
+    return len;
+}
+
+//------------------------------------------------------------------------------
+// template compile : 고정 문자열 / field 로 분리
+//------------------------------------------------------------------------------
+static int label_compile (label_tpl_t *t, const char *text)
+{
+    int pos = 0, start = 0, f;
+
+    memset  (t, 0, sizeof(label_tpl_t));
+    strncpy (t->text, text, sizeof(t->text) -1);
+
+    while (t->text[pos] && (t->op_cnt < LABEL_OP_MAX - 1)) {
+        for (f = 1; f < eFLD_END; f++)
+            if (!strncmp (&t->text[pos], FieldName[f], strlen (FieldName[f])))   break;
+
+        if (f == eFLD_END)  { pos++;    continue; }
+
+        if (pos > start) {
+            t->op[t->op_cnt].field = eFLD_TEXT;
+            t->op[t->op_cnt].off   = start;
+            t->op[t->op_cnt++].len = pos - start;
+        }
+        t->op[t->op_cnt++].field = f;
+        pos  += strlen (FieldName[f]);
+        start = pos;
+    }
+    if (t->text[start]) {
+        t->op[t->op_cnt].field = eFLD_TEXT;
+        t->op[t->op_cnt].off   = start;
+        t->op[t->op_cnt++].len = strlen (&t->text[start]);
+    }
+    return t->op_cnt;
+}
+
+//------------------------------------------------------------------------------
+static int label_load (label_tpl_t *t, const char *dir, const char *fname, const char *dfl)
+{
+    char path [256], text [LABEL_TPL_SIZE];
+    FILE *fp;
+    int len = 0;
+
+    snprintf (path, sizeof(path), "%s/%s", dir ? dir : LABEL_TPL_DIR, fname);
+    memset (text, 0, sizeof(text));
+    if ((fp = fopen (path, "r")) != NULL) {
+        char line [256];
+
+        /* '#' 으로 시작하는 line 은 주석 */
+        while ((fgets (line, sizeof(line), fp) != NULL) && (len < (int)sizeof(text) - 1)) {
+            if (line[0] == '#')     continue;
+            len += snprintf (text + len, sizeof(text) - len, "%s", line);
+        }
+        fclose (fp);
+    }
+    label_compile (t, len ? text : dfl);
+    printf ("%s : %s %s, %d ops\n", __func__, len ? path : "default", fname, t->op_cnt);
+    return len ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------
+int label_init (const char *dir)
+{
+    label_load (&LabelTpl[eLABEL_MAC], dir, LABEL_TPL_MAC, DefaultTpl[eLABEL_MAC]);
+    label_load (&LabelTpl[eLABEL_ERR], dir, LABEL_TPL_ERR, DefaultTpl[eLABEL_ERR]);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// s1 = mac (eLABEL_MAC) or msg1, s2 = msg2, s3 = msg3
+// return job size (0 = buffer 부족)
+//------------------------------------------------------------------------------
+int label_render (int type, char *buf, int size, int ch,
+                  const char *s1, const char *s2, const char *s3)
+{
+    label_tpl_t *t;
+    int i, len = 0, n;
+
+    if ((type < 0) || (type >= eLABEL_END))     return 0;
+
+    t = &LabelTpl[type];
+    if (!t->op_cnt)     label_compile (t, DefaultTpl[type]);
+
+    s1 = s1 ? s1 : "";  s2 = s2 ? s2 : "";  s3 = s3 ? s3 : "";
+
+    for (i = 0; i < t->op_cnt; i++) {
+        label_op_t *op = &t->op[i];
+
+        n = 0;
+        switch (op->field) {
+            case eFLD_TEXT:
+                if ((n = op->len) >= size - len)    return 0;
+                memcpy (buf + len, &t->text[op->off], n);
+                break;
+            case eFLD_CH:
+                n = snprintf (buf + len, size - len, "%d", ch);
+                break;
+            case eFLD_MAC:
+            case eFLD_MSG1:
+                n = snprintf (buf + len, size - len, "%s", s1);
+                break;
+            case eFLD_MSG2:
+                n = snprintf (buf + len, size - len, "%s", s2);
+                break;
+            case eFLD_MSG3:
+                n = snprintf (buf + len, size - len, "%s", s3);
+                break;
+            case eFLD_MAC_COLON:
+                {
+                    int j;
+                    for (j = 0; s1[j] && (len + n + 2 < size); j++) {
+                        if (j && !(j & 1))  buf[len + n++] = ':';
+                        buf[len + n++] = s1[j];
+                    }
+                }
+                break;
+            case eFLD_CODE128:
+            case eFLD_QR:
+                if (s1[0] && !(n = gfa_cached (op->field, buf + len, size - len - 1, s1)))
+                    return 0;
+                break;
+            case eFLD_DATE:
+                {
+                    time_t now = time (NULL);
+                    struct tm tm;
+
+                    localtime_r (&now, &tm);
+                    n = strftime (buf + len, size - len, "%Y-%m-%d %H:%M:%S", &tm);
+                }
+                break;
+        }
+        if ((len += n) >= size)     return 0;
+    }
+    buf[len] = 0;
+    return len;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,75 @@
+//------------------------------------------------------------------------------
+/**
+ * @file label.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server label template (ZPL) with Code128/QR bitmap.
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __LABEL_H__
+#define __LABEL_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+//
+// ZPL template 의 고정 문자열은 load 시 한번만 분리(compile) 하고,
+// 출력시에는 field 만 채워서 job 생성. (lpmode 2 : raw port printer)
+//
+//   {CH}      : channel (0, 1)
+//   {MAC}     : mac (001e06xxxxxx)         {MAC:} : mac (00:1e:06:xx:xx:xx)
+//   {MSG1}    : err msg line 1 ~ {MSG3}
+//   {CODE128} : mac Code128 bitmap (^GFA)   {QR}   : mac QR code bitmap (^GFA)
+//   {DATE}    : YYYY-mm-dd HH:MM:SS
+//
+// template file 이 없으면 기본 template 사용.
+//
+//------------------------------------------------------------------------------
+#define LABEL_TPL_DIR       "configs"
+#define LABEL_TPL_MAC       "label_mac.zpl"
+#define LABEL_TPL_ERR       "label_err.zpl"
+
+#define LABEL_TPL_SIZE      2048
+#define LABEL_OP_MAX        64
+#define LABEL_JOB_SIZE      8192
+
+/* bitmap 크기 (printer dot) */
+#define LABEL_BAR_DOT       2       // Code128 module width
+#define LABEL_BAR_HEIGHT    60
+#define LABEL_QR_DOT        4       // QR module size
+
+#define CODE128_MODULE_MAX  512
+/* QR version 1 ~ 3, ECC level M, byte mode (최대 42 byte) */
+#define QR_VERSION_MAX      3
+#define QR_SIZE_MAX         (17 + 4 * QR_VERSION_MAX)
+
+enum {
+    eLABEL_MAC = 0,
+    eLABEL_ERR,
+    eLABEL_END
+};
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+extern  int     label_init      (const char *dir);
+extern  int     label_render    (int type, char *buf, int size, int ch,
+                                 const char *s1, const char *s2, const char *s3);
+
+/* bar = 1, return module 수 */
+extern  int     code128_encode  (const char *str, uint8_t *module, int max);
+/* grid[y * QR_SIZE_MAX + x] = 1 (dark), return size (0 = error) */
+extern  int     qr_encode       (const char *str, uint8_t *grid);
+
+//------------------------------------------------------------------------------
+#endif  // __LABEL_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,247 @@
+//------------------------------------------------------------------------------
+/**
+ * @file log_ring.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server binary event log (lock-free per-thread ring).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+//------------------------------------------------------------------------------
+#include "log_ring.h"
+
+//------------------------------------------------------------------------------
+// single producer (owner thread) / single consumer (writer thread) ring
+//------------------------------------------------------------------------------
+typedef struct log_ring__t {
+    volatile uint32_t   head;   // producer write position
+    volatile uint32_t   tail;   // consumer read position
+    volatile uint32_t   drop;   // dropped record count (ring full)
+    log_rec_t           rec [LOG_RING_SIZE];
+}   log_ring_t;
+
+static log_ring_t   *RingList [LOG_RING_MAX];
+static volatile int RingCount = 0;
+
+static __thread log_ring_t *ThreadRing = NULL;
+
+static int          LogFd = -1;
+static char         LogPath [128];
+static off_t        LogSize = 0;
+
+static pthread_t        thread_log;
+static pthread_mutex_t  log_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+//------------------------------------------------------------------------------
+static uint64_t log_time_ns (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+//------------------------------------------------------------------------------
+static log_ring_t *log_ring_get (void)
+{
+    int slot;
+
+    if (ThreadRing != NULL)     return ThreadRing;
+
+    slot = __atomic_fetch_add (&RingCount, 1, __ATOMIC_ACQ_REL);
+    if (slot >= LOG_RING_MAX)   return NULL;
+
+    if ((ThreadRing = calloc (1, sizeof(log_ring_t))) == NULL)
+        return NULL;
+
+    __atomic_store_n (&RingList[slot], ThreadRing, __ATOMIC_RELEASE);
+    return ThreadRing;
+}
+
+//------------------------------------------------------------------------------
+void log_event (int ch, int event, const char *str, int nargs, ...)
+{
+    log_ring_t *ring = log_ring_get ();
+    log_rec_t *rec;
+    uint32_t head, tail;
+    va_list ap;
+    int i;
+
+    if (ring == NULL)   return;
+
+    head = ring->head;
+    tail = __atomic_load_n (&ring->tail, __ATOMIC_ACQUIRE);
+
+    /* ring full : never block the caller */
+    if ((head - tail) >= LOG_RING_SIZE) {
+        __atomic_fetch_add (&ring->drop, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    rec = &ring->rec[head & (LOG_RING_SIZE -1)];
+    rec->ts_ns = log_time_ns ();
+    rec->event = (uint16_t)event;
+    rec->ch    = (uint8_t)ch;
+    rec->nargs = (uint8_t)((nargs > LOG_ARG_CNT) ? LOG_ARG_CNT : nargs);
+
+    va_start (ap, nargs);
+    for (i = 0; i < LOG_ARG_CNT; i++)
+        rec->arg[i] = (i < rec->nargs) ? va_arg (ap, int) : 0;
+    va_end (ap);
+
+    if (str != NULL)    strncpy (rec->str, str, LOG_STR_SIZE);
+    else                rec->str[0] = 0;
+
+    __atomic_store_n (&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+//------------------------------------------------------------------------------
+static int log_file_open (void)
+{
+    log_file_hdr_t hdr;
+
+    if ((LogFd = open (LogPath, O_WRONLY | O_CREAT | O_APPEND, 0644)) < 0) {
+        printf ("%s : %s open error (%s)\n", __func__, LogPath, strerror(errno));
+        return 0;
+    }
+    if ((LogSize = lseek (LogFd, 0, SEEK_END)) == 0) {
+        memset (&hdr, 0, sizeof(hdr));
+        memcpy (hdr.magic, LOG_FILE_MAGIC, sizeof(hdr.magic));
+        hdr.rec_size  = sizeof(log_rec_t);
+        hdr.event_cnt = eLOG_END;
+        if (write (LogFd, &hdr, sizeof(hdr)) == sizeof(hdr))
+            LogSize = sizeof(hdr);
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// jig_server.blog -> jig_server.blog.1 -> ... -> jig_server.blog.(ROTATE -1)
+//------------------------------------------------------------------------------
+static void log_file_rotate (void)
+{
+    char src[sizeof(LogPath) + 8], dst[sizeof(LogPath) + 8];
+    int i;
+
+    close (LogFd);  LogFd = -1;
+
+    for (i = LOG_FILE_ROTATE -1; i > 0; i--) {
+        if (i > 1)  sprintf (src, "%s.%d", LogPath, i -1);
+        else        sprintf (src, "%s", LogPath);
+        sprintf (dst, "%s.%d", LogPath, i);
+        rename  (src, dst);
+    }
+    log_file_open ();
+}
+
+//------------------------------------------------------------------------------
+static void log_ring_drain (log_ring_t *ring)
+{
+    uint32_t head, tail, cnt, drop;
+
+    /* report dropped records first */
+    if ((drop = __atomic_exchange_n (&ring->drop, 0, __ATOMIC_RELAXED))) {
+        log_rec_t rec;
+
+        memset (&rec, 0, sizeof(rec));
+        rec.ts_ns  = log_time_ns ();
+        rec.event  = eLOG_DROP;
+        rec.ch     = LOG_CH_NONE;
+        rec.nargs  = 1;
+        rec.arg[0] = (int32_t)drop;
+        if (write (LogFd, &rec, sizeof(rec)) == sizeof(rec))
+            LogSize += sizeof(rec);
+    }
+
+    head = __atomic_load_n (&ring->head, __ATOMIC_ACQUIRE);
+    tail = ring->tail;
+
+    while (tail != head) {
+        /* contiguous part of the ring */
+        uint32_t pos = tail & (LOG_RING_SIZE -1);
+        ssize_t  wsize;
+
+        cnt = head - tail;
+        if (cnt > (LOG_RING_SIZE - pos))    cnt = LOG_RING_SIZE - pos;
+
+        wsize = write (LogFd, &ring->rec[pos], cnt * sizeof(log_rec_t));
+        if (wsize <= 0)     break;
+
+        cnt = (uint32_t)wsize / sizeof(log_rec_t);
+        tail += cnt;
+        LogSize += wsize;
+    }
+    __atomic_store_n (&ring->tail, tail, __ATOMIC_RELEASE);
+}
+
+//------------------------------------------------------------------------------
+void log_flush (void)
+{
+    int i, cnt;
+
+    pthread_mutex_lock (&log_mutex);
+    if (LogFd >= 0) {
+        cnt = __atomic_load_n (&RingCount, __ATOMIC_ACQUIRE);
+        if (cnt > LOG_RING_MAX)     cnt = LOG_RING_MAX;
+
+        for (i = 0; i < cnt; i++) {
+            log_ring_t *ring = __atomic_load_n (&RingList[i], __ATOMIC_ACQUIRE);
+            if (ring != NULL)   log_ring_drain (ring);
+        }
+        if (LogSize >= LOG_FILE_MAX_SIZE)   log_file_rotate ();
+    }
+    pthread_mutex_unlock (&log_mutex);
+}
+
+//------------------------------------------------------------------------------
+static void *thread_log_func (void *arg)
+{
+    while (1) {
+        log_flush ();
+        usleep (LOG_WRITER_DELAY);
+    }
+    return arg;
+}
+
+//------------------------------------------------------------------------------
+int log_init (const char *fname)
+{
+    char *ptr;
+
+    memset  (LogPath, 0, sizeof(LogPath));
+    strncpy (LogPath, fname ? fname : LOG_FILE_PATH, sizeof(LogPath) -1);
+
+    /* log directory */
+    if ((ptr = strrchr (LogPath, '/')) != NULL) {
+        *ptr = 0;   mkdir (LogPath, 0755);  *ptr = '/';
+    }
+
+    if (!log_file_open ())  return 0;
+
+    atexit (log_flush);
+    pthread_create (&thread_log, NULL, thread_log_func, NULL);
+
+    LOG_EVENT (LOG_CH_NONE, eLOG_BOOT, NULL, 1);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
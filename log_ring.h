@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+/**
+ * @file log_ring.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server binary event log (lock-free per-thread ring).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __LOG_RING_H__
+#define __LOG_RING_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+//
+// Hot path 에서는 문자열 포맷 없이 binary record 만 ring 에 기록한다.
+// 기록된 record 는 writer thread 가 log file 로 저장하고,
+// tools/log_decode 에서 아래 event table 을 이용하여 문자열로 변환한다.
+//
+//------------------------------------------------------------------------------
+#define LOG_FILE_PATH       "log/jig_server.blog"
+#define LOG_FILE_MAGIC      "JIGBLOG1"
+#define LOG_FILE_MAX_SIZE   (4 * 1024 * 1024)
+#define LOG_FILE_ROTATE     4
+
+/* per thread ring size (power of 2) */
+#define LOG_RING_SIZE       4096
+#define LOG_RING_MAX        16
+
+#define LOG_WRITER_DELAY    (100*1000)
+
+#define LOG_ARG_CNT         4
+#define LOG_STR_SIZE        36
+
+/* channel not defined */
+#define LOG_CH_NONE         0xFF
+
+//------------------------------------------------------------------------------
+// event id, name, decode format (%d : next int arg, %s : str)
+// 기록된 log 파일 호환을 위해 새 event 는 항상 마지막에 추가한다.
+//------------------------------------------------------------------------------
+#define LOG_EVENT_TABLE(X)  \
+    X(eLOG_BOOT,            "boot",         "server start, log version %d")             \
+    X(eLOG_DROP,            "drop",         "ring full, %d records dropped")            \
+    X(eLOG_UART_TX,         "uart_tx",      "fd = %d, size = %d, data = %s")            \
+    X(eLOG_UART_CATCH,      "uart_catch",   "unknown command %s")                       \
+    X(eLOG_RESP_SIZE,       "resp_size",    "unknown resp size = %d, resp = %s")        \
+    X(eLOG_PARSE_MAC,       "parse_mac",    "MAC Addr = %s")                            \
+    X(eLOG_PARSE_ERR,       "parse_err",    "Err Msg(%d) = %s")                         \
+    X(eLOG_PARSE_UNKNOWN,   "parse_cmd",    "unknown command!! (%s)")                   \
+    X(eLOG_CHECK_MEM,       "check_mem",    "mem_test_size = %d, mem_size = %d")        \
+    X(eLOG_CHECK_IPERF,     "check_iperf",  "did = %d, iperf = %d")                     \
+    X(eLOG_CHECK_ADC_PORT,  "check_adc",    "gid = %d, did = %d, check_value = %d, adc port = %s") \
+    X(eLOG_CHECK_ADC_VALUE, "check_adc_v",  "gid = %d, did = %d, count = %d, value = %d")  \
+    X(eLOG_CHECK_HEADER,    "check_header", "did = %d, pattern = %s")             \
+    X(eLOG_MAC_DUP,         "mac_dup",      "MAC Addr = %s duplicated (first seen = %d, count = %d)") \
+    X(eLOG_POWER_ON,        "power_on",     "board insert, all rails up = %d ms, debounced = %d ms") \
+    X(eLOG_POWER_OFF,       "power_off",    "board remove, glitch = %d")                \
+    X(eLOG_POWER_WAVE,      "power_wave",   "rail %s ramp = %d us, droop = %d mV, overshoot = %d mV, settle = %d mV") \
+    X(eLOG_SEQ_RETRY,       "seq_retry",    "seq = %d, gid = %d, did = %d, retry = %d") \
+    X(eLOG_SEQ_DROP,        "seq_drop",     "seq = %d, gid = %d, did = %d, no reply") \
+    X(eLOG_PROTOCOL_VER,    "protocol_ver", "frame version = v%d") \
+    X(eLOG_BATCH,           "batch",        "seq = %d, records = %d, applied = %d") \
+    X(eLOG_CFG_RELOAD,      "cfg_reload",   "%s applied, d_item = %d, h_item = %d, ui = %d") \
+    X(eLOG_CFG_POWER,       "cfg_power",    "%s applied, power rail = %d") \
+    X(eLOG_CFG_REJECT,      "cfg_reject",   "%s") \
+    X(eLOG_SOFT_RESTART,    "soft_restart", "reinit [%s], req = %d, done = %d, fail = %d, recovery = %d ms") \
+    X(eLOG_SPC_DRIFT,       "spc_drift",    "%s, gid = %d, did = %d, cpk(x100) = %d, ewma = %d") \
+    X(eLOG_SCHED_DONE,      "sched_done",   "mac %s, items = %d, estimate = %d ms, actual = %d ms, resource wait = %d ms") \
+    X(eLOG_SPC_FULL,        "spc_full",     "%s, key table full (%d), gid = %d, did = %d not tracked")
+
+#define LOG_EVENT_ENUM(id, name, fmt)   id,
+
+enum {
+    LOG_EVENT_TABLE(LOG_EVENT_ENUM)
+    eLOG_END
+};
+
+//------------------------------------------------------------------------------
+// 64 bytes record (file/ring 공통 format)
+//------------------------------------------------------------------------------
+typedef struct log_rec__t {
+    uint64_t    ts_ns;          // CLOCK_REALTIME (ns)
+    uint16_t    event;
+    uint8_t     ch;
+    uint8_t     nargs;
+    int32_t     arg [LOG_ARG_CNT];
+    char        str [LOG_STR_SIZE];
+}   log_rec_t;
+
+typedef struct log_file_hdr__t {
+    char        magic[8];
+    uint32_t    rec_size;
+    uint32_t    event_cnt;
+}   log_file_hdr_t;
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+extern  int     log_init    (const char *fname);
+extern  void    log_flush   (void);
+extern  void    log_event   (int ch, int event, const char *str, int nargs, ...);
+
+#define LOG_EVENT(ch, event, str, ...) \
+    log_event (ch, event, str, LOG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+
+#define LOG_NARGS(...)          LOG_NARGS_(0, ##__VA_ARGS__, 4, 3, 2, 1, 0)
+#define LOG_NARGS_(_0, _1, _2, _3, _4, n, ...)  n
+
+//------------------------------------------------------------------------------
+#endif  // __LOG_RING_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,440 @@
+//------------------------------------------------------------------------------
+/**
+ * @file lp_net.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server network label printer (lpmode 1 : tcp server, 2 : tcp direct).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+//------------------------------------------------------------------------------
+#include "lp_net.h"
+#include "label.h"
+#include "backend.h"
+#include "mono_time.h"
+#include "spooler.h"
+
+//------------------------------------------------------------------------------
+typedef struct lp_job__t {
+    uint32_t    id;
+    int         len;
+    char        data [LABEL_JOB_SIZE];
+
+    /* print error(N), ack 전 연결 끊김시 spooler 로 다시 넣기 위한 원본 */
+    int         type;       // eSPOOL_MAC, eSPOOL_ERR
+    int         ch;
+    char        text [3][32];
+}   lp_job_t;
+
+typedef struct lp_ep__t {
+    char        host [64];
+    int         port;
+    int         fd;
+    uint64_t    fail_ms;    // 마지막 접속 실패 시각 (0 = 없음)
+    uint64_t    nack_ms;    // 마지막 print error 시각 (0 = 없음)
+
+    /* lpmode 1 : ack 대기중인 job */
+    lp_job_t    wait [LP_NET_WINDOW];
+    int         wait_cnt;
+    char        rx [128];
+    int         rx_len;
+
+    uint32_t    sent, acked, nack;
+}   lp_ep_t;
+
+//------------------------------------------------------------------------------
+static lp_ep_t      LpEp [LP_NET_MAX];
+static int          LpEpCnt = 0;
+static int          LpMode  = eLP_NET_USB;
+static uint32_t     LpJobId = 1;
+
+static pthread_mutex_t  lp_net_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t        thread_lp_net;
+
+//------------------------------------------------------------------------------
+// 출력되지 않은 job 을 spooler 로 다시 넣음 (새 job id, 다른 printer 또는 spooler retry 로 출력)
+// spool thread 에서 호출되어도 spool_mutex 는 잡혀있지 않으므로 enqueue 가능
+//------------------------------------------------------------------------------
+static void lp_job_requeue (const lp_job_t *job)
+{
+    printf ("%s : job %u, ch = %d requeue\n", __func__, job->id, job->ch);
+    if (job->type == eSPOOL_MAC)
+        spool_print_mac (job->text[0], job->ch);
+    else
+        spool_print_err (job->text[0], sizeof(job->text[0]), 3, job->ch);
+}
+
+//------------------------------------------------------------------------------
+static void ep_close (lp_ep_t *ep)
+{
+    int i;
+
+    if (ep->fd >= 0)    close (ep->fd);
+    ep->fd     = -1;
+    ep->rx_len = 0;
+
+    /* ack 를 받지 못한 job 은 출력 여부를 알 수 없으므로 다시 출력 */
+    for (i = 0; i < ep->wait_cnt; i++)
+        lp_job_requeue (&ep->wait[i]);
+    ep->wait_cnt = 0;
+}
+
+//------------------------------------------------------------------------------
+static int ep_send (lp_ep_t *ep, const char *data, int len)
+{
+    int ret, pos = 0;
+
+    while (pos < len) {
+        if ((ret = send (ep->fd, data + pos, len - pos, MSG_NOSIGNAL)) <= 0) {
+            if ((ret < 0) && (errno == EINTR))  continue;
+            printf ("%s : %s:%d send error (%s)\n", __func__, ep->host, ep->port,
+                ret ? strerror(errno) : "closed");
+            ep_close (ep);
+            return 0;
+        }
+        pos += ret;
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+static int ep_connect (lp_ep_t *ep)
+{
+    struct addrinfo hints, *res = NULL;
+    struct pollfd pfd;
+    struct timeval tv;
+    char port [8];
+    int fd, err = 0, i;
+    socklen_t len = sizeof(err);
+
+    memset (&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    snprintf (port, sizeof(port), "%d", ep->port);
+
+    if (getaddrinfo (ep->host, port, &hints, &res) || (res == NULL))
+        goto err_out;
+
+    if ((fd = socket (res->ai_family, res->ai_socktype | SOCK_NONBLOCK, 0)) < 0)
+        goto err_out;
+
+    /* non-blocking connect : 응답 없는 printer 로 인한 대기 시간 제한 */
+    if (connect (fd, res->ai_addr, res->ai_addrlen) && (errno != EINPROGRESS)) {
+        close (fd); goto err_out;
+    }
+    pfd.fd = fd;    pfd.events = POLLOUT;
+    if ((poll (&pfd, 1, LP_NET_CONNECT_MS) != 1) ||
+        getsockopt (fd, SOL_SOCKET, SO_ERROR, &err, &len) || err) {
+        close (fd); goto err_out;
+    }
+    freeaddrinfo (res);
+
+    fcntl (fd, F_SETFL, fcntl (fd, F_GETFL) & ~O_NONBLOCK);
+    tv.tv_sec  = LP_NET_SEND_MS / 1000;
+    tv.tv_usec = (LP_NET_SEND_MS % 1000) * 1000;
+    setsockopt (fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    i = 1;
+    setsockopt (fd, SOL_SOCKET, SO_KEEPALIVE, &i, sizeof(i));
+
+    ep->fd = fd;    ep->fail_ms = 0;    ep->rx_len = 0;
+    printf ("%s : %s:%d connected\n", __func__, ep->host, ep->port);
+    return 1;
+
+err_out:
+    if (res != NULL)    freeaddrinfo (res);
+    ep->fail_ms = mono_ms ();
+    printf ("%s : %s:%d connect fail (%s)\n", __func__, ep->host, ep->port,
+        err ? strerror(err) : strerror(errno));
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+static int ep_ready (lp_ep_t *ep)
+{
+    if (ep->fd >= 0)    return 1;
+    if (ep->fail_ms && ((mono_ms () - ep->fail_ms) < LP_NET_RETRY_MS))
+        return 0;
+    return ep_connect (ep);
+}
+
+//------------------------------------------------------------------------------
+// lpmode 1 : ack 수신 (timeout_ms = 0 : 수신된 ack 만 처리)
+//------------------------------------------------------------------------------
+static void ep_ack (lp_ep_t *ep, uint32_t id, int ok)
+{
+    int i;
+
+    for (i = 0; i < ep->wait_cnt; i++) {
+        if (ep->wait[i].id != id)   continue;
+
+        if (ok)     ep->acked++;
+        else {
+            ep->nack++;
+            ep->nack_ms = mono_ms ();
+            printf ("%s : %s:%d job %u print error\n", __func__, ep->host, ep->port, id);
+            lp_job_requeue (&ep->wait[i]);
+        }
+        memmove (&ep->wait[i], &ep->wait[i + 1], (ep->wait_cnt - i - 1) * sizeof(lp_job_t));
+        ep->wait_cnt--;
+        return;
+    }
+}
+
+static int ep_rx_ack (lp_ep_t *ep, int timeout_ms)
+{
+    struct pollfd pfd;
+    char *line, *nl;
+    int ret;
+
+    pfd.fd = ep->fd;    pfd.events = POLLIN;
+    while ((ep->fd >= 0) && (poll (&pfd, 1, timeout_ms) == 1)) {
+        ret = read (ep->fd, ep->rx + ep->rx_len, sizeof(ep->rx) - ep->rx_len - 1);
+        if (ret <= 0) {
+            printf ("%s : %s:%d disconnected\n", __func__, ep->host, ep->port);
+            ep_close (ep);
+            return 0;
+        }
+        ep->rx_len += ret;  ep->rx[ep->rx_len] = 0;
+
+        line = ep->rx;
+        while ((nl = strchr (line, '\n')) != NULL) {
+            *nl = 0;
+            if ((line[0] == 'A') || (line[0] == 'N'))
+                ep_ack (ep, (uint32_t)strtoul (line + 2, NULL, 10), line[0] == 'A');
+            line = nl + 1;
+        }
+        ep->rx_len -= (line - ep->rx);
+        memmove (ep->rx, line, ep->rx_len);
+        /* line 없이 buffer full : 잘못된 응답, 버림 */
+        if (ep->rx_len >= (int)sizeof(ep->rx) - 1)  ep->rx_len = 0;
+
+        if (timeout_ms)     break;
+    }
+    return (ep->fd >= 0);
+}
+
+//------------------------------------------------------------------------------
+// ZPL/job line 에 사용할 수 없는 문자 제거
+//------------------------------------------------------------------------------
+static void lp_str_clean (char *dst, const char *src, int size)
+{
+    int i;
+
+    for (i = 0; src && src[i] && (i < size - 1); i++)
+        dst[i] = strchr ("^~,\r\n", src[i]) ? ' ' : src[i];
+    dst[i] = 0;
+}
+
+//------------------------------------------------------------------------------
+// channel 기본 printer 부터 연결된 printer 를 찾아 전송
+// return 0 = 전송 가능한 printer 없음 (spooler 가 backoff 후 재시도)
+//------------------------------------------------------------------------------
+static int lp_net_send (int ch, lp_job_t *job)
+{
+    int n;
+
+    pthread_mutex_lock (&lp_net_mutex);
+    for (n = 0; n < LpEpCnt; n++) {
+        lp_ep_t *ep = &LpEp[(ch + n) % LpEpCnt];
+
+        if (!ep_ready (ep))     continue;
+
+        if (LpMode == eLP_NET_SERVER) {
+            ep_rx_ack (ep, 0);
+            if (ep->fd < 0)     continue;
+            /* print error 직후의 printer 는 잠시 사용하지 않음 */
+            if (ep->nack_ms && ((mono_ms () - ep->nack_ms) < LP_NET_RETRY_MS))
+                continue;
+            /* window full : 대기하지 않고 다른 printer, 없으면 spooler retry */
+            if (ep->wait_cnt >= LP_NET_WINDOW)
+                continue;
+        }
+        if (!ep_send (ep, job->data, job->len))     continue;
+
+        ep->sent++;
+        if (LpMode == eLP_NET_SERVER)
+            memcpy (&ep->wait[ep->wait_cnt++], job, sizeof(lp_job_t));
+        pthread_mutex_unlock (&lp_net_mutex);
+        return 1;
+    }
+    pthread_mutex_unlock (&lp_net_mutex);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+int lp_net_print_mac (char *mac, int ch)
+{
+    lp_job_t job;
+    char str [32];
+
+    memset (&job, 0, sizeof(job));
+    lp_str_clean (str, mac, sizeof(str));
+    job.type = eSPOOL_MAC;
+    job.ch   = ch;
+    strncpy (job.text[0], str, sizeof(job.text[0]) -1);
+
+    job.id = __sync_fetch_and_add (&LpJobId, 1);
+    if (LpMode == eLP_NET_SERVER)
+        job.len = snprintf (job.data, sizeof(job.data), "J,%u,%d,M,%s\n", job.id, ch, str);
+    else
+        job.len = label_render (eLABEL_MAC, job.data, sizeof(job.data), ch, str, NULL, NULL);
+
+    if (!job.len) {
+        /* template 오류 : 재시도 해도 같은 결과이므로 출력하지 않음 */
+        printf ("%s : ch = %d, label render error\n", __func__, ch);
+        return 1;
+    }
+
+    return lp_net_send (ch, &job);
+}
+
+//------------------------------------------------------------------------------
+int lp_net_print_err (char *msg1, char *msg2, char *msg3, int ch)
+{
+    lp_job_t job;
+    char str [3][32];
+
+    memset (&job, 0, sizeof(job));
+    lp_str_clean (str[0], msg1, sizeof(str[0]));
+    lp_str_clean (str[1], msg2, sizeof(str[1]));
+    lp_str_clean (str[2], msg3, sizeof(str[2]));
+    job.type = eSPOOL_ERR;
+    job.ch   = ch;
+    memcpy (job.text, str, sizeof(job.text));
+
+    job.id = __sync_fetch_and_add (&LpJobId, 1);
+    if (LpMode == eLP_NET_SERVER)
+        job.len = snprintf (job.data, sizeof(job.data), "J,%u,%d,E,%s,%s,%s\n",
+            job.id, ch, str[0], str[1], str[2]);
+    else
+        job.len = label_render (eLABEL_ERR, job.data, sizeof(job.data), ch, str[0], str[1], str[2]);
+
+    if (!job.len) {
+        printf ("%s : ch = %d, label render error\n", __func__, ch);
+        return 1;
+    }
+
+    return lp_net_send (ch, &job);
+}
+
+//------------------------------------------------------------------------------
+// ui thread 에서 호출 : 접속 시도 없이 상태만 확인 (접속은 spool thread 에서 처리)
+//------------------------------------------------------------------------------
+int lp_net_connection (void)
+{
+    int i;
+
+    for (i = 0; i < LpEpCnt; i++) {
+        if (LpEp[i].fd >= 0)    return 1;
+        if (!LpEp[i].fail_ms || ((mono_ms () - LpEp[i].fail_ms) >= LP_NET_RETRY_MS))
+            return 1;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// printer reinit (touch) : 모든 연결 재접속
+//------------------------------------------------------------------------------
+int lp_net_open (void)
+{
+    int i, ret = 0;
+
+    pthread_mutex_lock (&lp_net_mutex);
+    for (i = 0; i < LpEpCnt; i++) {
+        ep_close (&LpEp[i]);
+        LpEp[i].fail_ms = 0;
+        ret |= ep_connect (&LpEp[i]);
+    }
+    pthread_mutex_unlock (&lp_net_mutex);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+// L(cmd), host, [port]
+//------------------------------------------------------------------------------
+int lp_net_config (char *cfg)
+{
+    lp_ep_t *ep;
+    char *tok;
+
+    if (strtok (cfg, ",") == NULL)                  return 0;
+    if ((tok = strtok (NULL, ", \t\r\n")) == NULL)  return 0;
+    if (LpEpCnt >= LP_NET_MAX) {
+        printf ("%s : too many printers (max %d)\n", __func__, LP_NET_MAX);
+        return 0;
+    }
+    ep = &LpEp[LpEpCnt++];
+    memset  (ep, 0, sizeof(lp_ep_t));
+    strncpy (ep->host, tok, sizeof(ep->host) -1);
+    ep->fd = -1;
+    if ((tok = strtok (NULL, ", \t\r\n")) != NULL)
+        ep->port = atoi (tok);
+
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// lpmode 1 : ack 대기중인 job 이 있는 printer 의 응답 처리 (spool thread 와 별도)
+//------------------------------------------------------------------------------
+static void *thread_lp_net_func (void *arg)
+{
+    int i;
+
+    while (1) {
+        pthread_mutex_lock (&lp_net_mutex);
+        for (i = 0; i < LpEpCnt; i++)
+            if ((LpEp[i].fd >= 0) && LpEp[i].wait_cnt)
+                ep_rx_ack (&LpEp[i], 0);
+        pthread_mutex_unlock (&lp_net_mutex);
+        usleep (LP_NET_ACK_POLL_MS * 1000);
+    }
+    return arg;
+}
+
+//------------------------------------------------------------------------------
+// server cfg lpmode 적용 (1, 2 : lp backend 를 net 으로 변경)
+//------------------------------------------------------------------------------
+int lp_net_init (int mode)
+{
+    int i;
+
+    if ((mode != eLP_NET_SERVER) && (mode != eLP_NET_DIRECT))   return 0;
+    if (!LpEpCnt) {
+        printf ("%s : lpmode %d, printer address('L') not found\n", __func__, mode);
+        return 0;
+    }
+    LpMode = mode;
+    if (mode == eLP_NET_DIRECT)
+        label_init (LABEL_TPL_DIR);
+    else
+        pthread_create (&thread_lp_net, NULL, thread_lp_net_func, NULL);
+    for (i = 0; i < LpEpCnt; i++) {
+        if (!LpEp[i].port)
+            LpEp[i].port = (mode == eLP_NET_SERVER) ? LP_NET_SERVER_PORT : LP_NET_RAW_PORT;
+        printf ("%s : lpmode %d, printer %d = %s:%d\n", __func__, mode, i,
+            LpEp[i].host, LpEp[i].port);
+    }
+    return backend_select (eHW_LP, eBACKEND_NET);
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------------
+/**
+ * @file lp_net.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server network label printer (lpmode 1 : tcp server, 2 : tcp direct).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __LP_NET_H__
+#define __LP_NET_H__
+
+//------------------------------------------------------------------------------
+//
+// server cfg 'S' line lpmode 1, 2 에서 사용. printer 주소는 'L' line 으로 설정.
+//
+//   L(cmd), host, [port]
+//
+// lpmode 1 (tcp server) : print server 로 job 전송. 1 job = 1 line, job id 별 ack.
+//      jig -> server : J,<id>,<ch>,M,<mac>\n
+//                      J,<id>,<ch>,E,<msg1>,<msg2>,<msg3>\n
+//      server -> jig : A,<id>\n (printed), N,<id>\n (print error)
+//      ack 를 기다리지 않고 LP_NET_WINDOW 개 까지 연속 전송 (window full 이면 spooler retry).
+//      print error(N) 또는 ack 전에 연결이 끊긴 job 은 spooler 로 다시 넣어서 출력.
+//
+// lpmode 2 (tcp direct) : raw port(9100) printer 로 ZPL 직접 전송 (응답 없음).
+//      label 은 template (label.c, configs/label_xxx.zpl) 으로 생성.
+//
+// 'L' line 이 여러개인 경우 connection pool 로 동작.
+// channel 별 기본 printer (ch % cnt) 연결 실패시 다른 printer 로 출력.
+//
+//------------------------------------------------------------------------------
+#define LP_NET_MAX              4
+#define LP_NET_SERVER_PORT      9101
+#define LP_NET_RAW_PORT         9100
+
+#define LP_NET_WINDOW           8
+/* lpmode 1 : 전송할 job 이 없어도 ack, print error, 연결 끊김 확인 */
+#define LP_NET_ACK_POLL_MS      100
+
+#define LP_NET_CONNECT_MS       1000
+#define LP_NET_SEND_MS          3000
+/* 연결 실패한 printer 는 일정 시간 동안 재접속 하지 않음 */
+#define LP_NET_RETRY_MS         2000
+
+enum {
+    eLP_NET_USB = 0,
+    eLP_NET_SERVER,
+    eLP_NET_DIRECT,
+    eLP_NET_END
+};
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+/* server cfg 'L' line */
+extern  int     lp_net_config       (char *cfg);
+extern  int     lp_net_init         (int mode);
+
+extern  int     lp_net_open         (void);
+extern  int     lp_net_connection   (void);
+extern  int     lp_net_print_mac    (char *mac, int ch);
+extern  int     lp_net_print_err    (char *msg1, char *msg2, char *msg3, int ch);
+
+//------------------------------------------------------------------------------
+#endif  // __LP_NET_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,164 @@
+//------------------------------------------------------------------------------
+/**
+ * @file lz.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief LZ77 block compression (result record push, no external library).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//------------------------------------------------------------------------------
+#include "lz.h"
+
+//------------------------------------------------------------------------------
+#define LZ_HASH_BITS        12
+/* 마지막 몇 byte 는 literal 로 (match 확인시 4 byte read 범위) */
+#define LZ_TAIL_SIZE        12
+
+//------------------------------------------------------------------------------
+static uint32_t lz_read32 (const uint8_t *p)
+{
+    uint32_t v;
+
+    memcpy (&v, p, sizeof(v));
+    return v;
+}
+
+static int lz_hash (uint32_t v) { return (int)((v * 2654435761u) >> (32 - LZ_HASH_BITS)); }
+
+//------------------------------------------------------------------------------
+// 15 이상 길이의 추가 byte (255 단위)
+//------------------------------------------------------------------------------
+static uint8_t *lz_len_put (uint8_t *op, int len)
+{
+    for (len -= 15; len >= 255; len -= 255)
+        *op++ = 255;
+    *op++ = (uint8_t)len;
+    return op;
+}
+
+//------------------------------------------------------------------------------
+static uint8_t *lz_seq_put (uint8_t *op, const uint8_t *oend,
+                            const uint8_t *lit, int lit_len, int offset, int match_len)
+{
+    int m = match_len ? match_len - LZ_MIN_MATCH : 0;
+
+    /* token + 길이 byte + literal + offset */
+    if (op + 1 + lit_len / 255 + 1 + lit_len + 2 + m / 255 + 1 > oend)
+        return NULL;
+
+    *op++ = (uint8_t)(((lit_len < 15) ? lit_len : 15) << 4 | ((m < 15) ? m : 15));
+    if (lit_len >= 15)  op = lz_len_put (op, lit_len);
+    memcpy (op, lit, lit_len);
+    op += lit_len;
+
+    if (match_len) {
+        *op++ = (uint8_t)(offset);
+        *op++ = (uint8_t)(offset >> 8);
+        if (m >= 15)    op = lz_len_put (op, m);
+    }
+    return op;
+}
+
+//------------------------------------------------------------------------------
+int lz_compress (const uint8_t *src, int size, uint8_t *dst, int dst_size)
+{
+    int32_t table [1 << LZ_HASH_BITS];
+    const uint8_t *oend = dst + dst_size;
+    uint8_t *op = dst;
+    int ip = 0, anchor = 0, ref, len, h;
+    uint32_t v;
+
+    memset (table, 0xFF, sizeof(table));
+
+    while (ip < size - LZ_TAIL_SIZE) {
+        v   = lz_read32 (src + ip);
+        h   = lz_hash (v);
+        ref = table[h];
+        table[h] = ip;
+
+        if ((ref < 0) || (ip - ref > LZ_MAX_OFFSET) || (lz_read32 (src + ref) != v)) {
+            ip++;
+            continue;
+        }
+        for (len = LZ_MIN_MATCH; (ip + len < size - 5) && (src[ref + len] == src[ip + len]); len++);
+
+        if ((op = lz_seq_put (op, oend, src + anchor, ip - anchor, ip - ref, len)) == NULL)
+            return 0;
+        ip += len;
+        anchor = ip;
+    }
+    if ((op = lz_seq_put (op, oend, src + anchor, size - anchor, 0, 0)) == NULL)
+        return 0;
+    return (int)(op - dst);
+}
+
+//------------------------------------------------------------------------------
+// 추가 길이 byte 읽기, return -1 = src 끝
+//------------------------------------------------------------------------------
+static int lz_len_get (const uint8_t **ip, const uint8_t *iend)
+{
+    int len = 0;
+    uint8_t b;
+
+    do {
+        if (*ip >= iend)    return -1;
+        b = *(*ip)++;
+        len += b;
+    } while (b == 255);
+    return len;
+}
+
+//------------------------------------------------------------------------------
+int lz_decompress (const uint8_t *src, int size, uint8_t *dst, int dst_size)
+{
+    const uint8_t *ip = src, *iend = src + size;
+    uint8_t *op = dst, *oend = dst + dst_size;
+    int token, lit, match, offset, ext;
+
+    while (ip < iend) {
+        token = *ip++;
+
+        lit = token >> 4;
+        if (lit == 15) {
+            if ((ext = lz_len_get (&ip, iend)) < 0)     return -1;
+            lit += ext;
+        }
+        if ((lit > iend - ip) || (lit > oend - op))     return -1;
+        memcpy (op, ip, lit);
+        ip += lit;  op += lit;
+
+        /* 마지막 sequence */
+        if (ip >= iend)     break;
+
+        if (iend - ip < 2)  return -1;
+        offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        match = token & 0x0F;
+        if (match == 15) {
+            if ((ext = lz_len_get (&ip, iend)) < 0)     return -1;
+            match += ext;
+        }
+        match += LZ_MIN_MATCH;
+        if (!offset || (offset > op - dst) || (match > oend - op))  return -1;
+
+        /* offset < match 인 경우 (반복 pattern) 를 위해 byte 단위 복사 */
+        for (; match; match--, op++)
+            *op = *(op - offset);
+    }
+    return (int)(op - dst);
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
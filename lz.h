@@ -0,0 +1,49 @@
+//------------------------------------------------------------------------------
+/**
+ * @file lz.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief LZ77 block compression (result record push, no external library).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __LZ_H__
+#define __LZ_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+//
+// block format (lz4 block 과 같은 구조)
+//
+//   sequence = | token | [lit len ext] | literal | offset(2, le) | [match len ext] |
+//   token    : 상위 4bit literal 길이, 하위 4bit match 길이 - 4 (15 = 다음 byte 들에 추가 길이)
+//   마지막 sequence 는 literal 만 (offset 없음)
+//
+// result record 는 mac, value, err 의 0 padding 이 많아서 1/4 ~ 1/6 정도로 줄어듬.
+//
+//------------------------------------------------------------------------------
+#define LZ_MIN_MATCH        4
+#define LZ_MAX_OFFSET       65535
+/* 압축이 안되는 data 의 최대 크기 */
+#define LZ_BOUND(size)      ((size) + (size) / 255 + 16)
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+/* return 압축 크기 (0 = dst 부족) */
+extern  int     lz_compress     (const uint8_t *src, int size, uint8_t *dst, int dst_size);
+/* return 복원 크기 (-1 = format 오류, dst 부족) */
+extern  int     lz_decompress   (const uint8_t *src, int size, uint8_t *dst, int dst_size);
+
+//------------------------------------------------------------------------------
+#endif  // __LZ_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,238 @@
+//------------------------------------------------------------------------------
+/**
+ * @file mac_index.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server persistent MAC hash set (mmap, open addressing).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+//------------------------------------------------------------------------------
+#include "mac_index.h"
+#include "result_store.h"
+
+//------------------------------------------------------------------------------
+static char             IndexPath [128];
+static int              IndexFd = -1;
+static mac_index_hdr_t  *IndexHdr = NULL;
+static mac_slot_t       *IndexSlot = NULL;
+static size_t           IndexMapSize = 0;
+static int              IndexFull = 0;
+
+static pthread_mutex_t  index_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+//------------------------------------------------------------------------------
+static inline uint64_t mac_hash (uint64_t key)
+{
+    /* splitmix64 finalizer : 연속된 MAC 값의 bucket 분산 */
+    key ^= key >> 30;   key *= 0xbf58476d1ce4e5b9ull;
+    key ^= key >> 27;   key *= 0x94d049bb133111ebull;
+    return key ^ (key >> 31);
+}
+
+//------------------------------------------------------------------------------
+static void mac_index_unmap (void)
+{
+    if (IndexHdr != NULL)   munmap (IndexHdr, IndexMapSize);
+    if (IndexFd  >= 0)      close  (IndexFd);
+
+    IndexHdr = NULL;    IndexSlot = NULL;
+    IndexFd  = -1;      IndexMapSize = 0;
+}
+
+//------------------------------------------------------------------------------
+static int mac_index_map (const char *fname, uint64_t capacity, int create)
+{
+    size_t size = sizeof(mac_index_hdr_t) + capacity * sizeof(mac_slot_t);
+    struct stat st;
+    int fd;
+
+    if ((fd = open (fname, O_RDWR | (create ? (O_CREAT | O_TRUNC) : 0), 0644)) < 0)
+        return -1;
+
+    if (create) {
+        if (ftruncate (fd, size) < 0)   { close (fd); return -1; }
+    } else {
+        if ((fstat (fd, &st) < 0) || ((size_t)st.st_size < sizeof(mac_index_hdr_t)))
+            { close (fd); return -1; }
+        size = st.st_size;
+    }
+
+    IndexHdr = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (IndexHdr == MAP_FAILED) {
+        IndexHdr = NULL;    close (fd);
+        return -1;
+    }
+    IndexFd = fd;   IndexMapSize = size;
+    IndexSlot = (mac_slot_t *)(IndexHdr + 1);
+
+    if (create) {
+        IndexHdr->magic    = MAC_INDEX_MAGIC;
+        IndexHdr->capacity = capacity;
+        IndexHdr->count    = 0;
+    }
+
+    /* header check (capacity power of 2 & file size) */
+    if ((IndexHdr->magic != MAC_INDEX_MAGIC) ||
+        (IndexHdr->capacity & (IndexHdr->capacity -1)) ||
+        (size < sizeof(mac_index_hdr_t) + IndexHdr->capacity * sizeof(mac_slot_t))) {
+        mac_index_unmap ();
+        return 0;
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+static mac_slot_t *mac_index_find (mac_slot_t *slot, uint64_t capacity, uint64_t key)
+{
+    uint64_t pos = mac_hash (key) & (capacity -1);
+
+    /* linear probing, load factor 70% 이하로 유지 */
+    while (slot[pos].key && (slot[pos].key != key))
+        pos = (pos + 1) & (capacity -1);
+
+    return &slot[pos];
+}
+
+//------------------------------------------------------------------------------
+// 새 파일에 capacity 로 rehash 후 rename (중간에 종료되어도 기존 파일 유지)
+//------------------------------------------------------------------------------
+static int mac_index_grow (uint64_t capacity)
+{
+    char tmp_path[sizeof(IndexPath) + 8];
+    mac_index_hdr_t *old_hdr = IndexHdr;
+    mac_slot_t *old_slot = IndexSlot;
+    size_t old_size = IndexMapSize;
+    int old_fd = IndexFd;
+    uint64_t i;
+
+    sprintf (tmp_path, "%s.tmp", IndexPath);
+    if (mac_index_map (tmp_path, capacity, 1) != 1) {
+        /* 기존 index 유지 */
+        IndexHdr = old_hdr;     IndexSlot = old_slot;
+        IndexFd  = old_fd;      IndexMapSize = old_size;
+        return 0;
+    }
+
+    for (i = 0; i < old_hdr->capacity; i++) {
+        if (!old_slot[i].key)   continue;
+        *mac_index_find (IndexSlot, capacity, old_slot[i].key) = old_slot[i];
+        IndexHdr->count++;
+    }
+    msync (IndexHdr, IndexMapSize, MS_SYNC);
+    rename (tmp_path, IndexPath);
+
+    munmap (old_hdr, old_size);
+    close  (old_fd);
+
+    printf ("%s : capacity %llu, count %llu\n", __func__,
+        (unsigned long long)IndexHdr->capacity, (unsigned long long)IndexHdr->count);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// 이번 실행에서 MAC_INDEX_CAPACITY 개 추가 후에도 load factor 이하가 되는 slot 수
+//------------------------------------------------------------------------------
+static uint64_t mac_index_capacity (uint64_t count)
+{
+    uint64_t need = (count + MAC_INDEX_CAPACITY) * 100 / MAC_INDEX_LOAD_MAX, capacity = 1;
+
+    while (capacity < need)     capacity <<= 1;
+    return capacity;
+}
+
+//------------------------------------------------------------------------------
+int mac_index_init (const char *fname)
+{
+    char *ptr;
+    int ret;
+
+    memset  (IndexPath, 0, sizeof(IndexPath));
+    strncpy (IndexPath, fname ? fname : MAC_INDEX_PATH, sizeof(IndexPath) -1);
+
+    if ((ptr = strrchr (IndexPath, '/')) != NULL) {
+        *ptr = 0;   mkdir (IndexPath, 0755);    *ptr = '/';
+    }
+
+    /* 기존 파일 mmap (load 시간 = mmap 시간), 없거나 손상된 경우 새로 생성 */
+    if ((ret = mac_index_map (IndexPath, 0, 0)) != 1) {
+        if (ret == 0)
+            printf ("%s : %s broken, create new index\n", __func__, IndexPath);
+        if (mac_index_map (IndexPath, mac_index_capacity (0), 1) != 1) {
+            printf ("%s : %s create error (%s)\n", __func__, IndexPath, strerror(errno));
+            return 0;
+        }
+    }
+    /* 실행 중 (M frame) rehash 하지 않도록 시작시 확장 */
+    if (IndexHdr->capacity < mac_index_capacity (IndexHdr->count))
+        mac_index_grow (mac_index_capacity (IndexHdr->count));
+    printf ("%s : %s, %llu mac loaded\n", __func__, IndexPath,
+        (unsigned long long)IndexHdr->count);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// return 1 : duplicate mac (pslot = 이전 기록), 0 : new mac (추가됨), -1 : error
+//------------------------------------------------------------------------------
+int mac_index_check (const char *mac, mac_slot_t *pslot)
+{
+    uint64_t key = result_mac_key (mac) + 1;
+    mac_slot_t *slot;
+    int ret = 0;
+
+    pthread_mutex_lock (&index_mutex);
+    if (IndexHdr == NULL) {
+        pthread_mutex_unlock (&index_mutex);
+        return -1;
+    }
+
+    slot = mac_index_find (IndexSlot, IndexHdr->capacity, key);
+    if (slot->key) {
+        if (pslot != NULL)  *pslot = *slot;
+        slot->count++;
+        ret = 1;
+    } else if (((IndexHdr->count + 1) * 100) > (IndexHdr->capacity * MAC_INDEX_LOAD_FULL)) {
+        /* 다음 시작시 확장 (mac_index_init) */
+        if (!IndexFull)
+            printf ("%s : index full (count %llu, capacity %llu), restart to grow\n", __func__,
+                (unsigned long long)IndexHdr->count, (unsigned long long)IndexHdr->capacity);
+        IndexFull = 1;
+        ret = -1;
+    } else {
+        slot->key      = key;
+        slot->first_ts = (uint32_t)time (NULL);
+        slot->count    = 1;
+        IndexHdr->count++;
+        if (pslot != NULL)  *pslot = *slot;
+    }
+    /* MAP_SHARED : page cache 는 kernel 이 write back (M frame 마다 msync 하지 않음) */
+    pthread_mutex_unlock (&index_mutex);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+int mac_index_count (void)
+{
+    return IndexHdr ? (int)IndexHdr->count : 0;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,60 @@
+//------------------------------------------------------------------------------
+/**
+ * @file mac_index.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server persistent MAC hash set (mmap, open addressing).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __MAC_INDEX_H__
+#define __MAC_INDEX_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+#define MAC_INDEX_PATH      "result/mac_index.dat"
+#define MAC_INDEX_MAGIC     0x58494D4A  // "JMIX"
+
+/*
+ * 한번 실행 중 추가될 수 있는 mac 수.
+ * 시작시 (count + MAC_INDEX_CAPACITY) 가 load factor 70% 이하가 되도록 slot 수 (power of 2) 를
+ * 미리 확장하며 실행 중에는 rehash 하지 않음. 90% 를 넘으면 다음 시작까지 추가하지 않음 (-1).
+ */
+#define MAC_INDEX_CAPACITY  (1 << 16)
+#define MAC_INDEX_LOAD_MAX  70
+#define MAC_INDEX_LOAD_FULL 90
+
+//------------------------------------------------------------------------------
+typedef struct mac_slot__t {
+    uint64_t    key;        // result_mac_key() + 1, 0 = empty
+    uint32_t    first_ts;   // first seen (epoch sec)
+    uint32_t    count;      // seen count
+}   mac_slot_t;
+
+typedef struct mac_index_hdr__t {
+    uint32_t    magic;
+    uint32_t    rsvd;
+    uint64_t    capacity;
+    uint64_t    count;
+    uint64_t    pad;
+}   mac_index_hdr_t;
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+extern  int     mac_index_init  (const char *fname);
+extern  int     mac_index_check (const char *mac, mac_slot_t *pslot);
+extern  int     mac_index_count (void);
+
+//------------------------------------------------------------------------------
+#endif  // __MAC_INDEX_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
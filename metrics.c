@@ -0,0 +1,276 @@
+//------------------------------------------------------------------------------
+/**
+ * @file metrics.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server latency histogram & counter (prometheus text endpoint).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/time.h>
+
+//------------------------------------------------------------------------------
+#include "metrics.h"
+#include "mono_time.h"
+#include "spc.h"
+#include "plan_sched.h"
+
+//------------------------------------------------------------------------------
+#define METRICS_BUF_SIZE    (512 * 1024)
+/* request 를 보내지 않거나 응답을 읽지 않는 client 가 다른 요청을 막지 않도록 */
+#define METRICS_IO_TIMEOUT  (500 * 1000)
+
+//------------------------------------------------------------------------------
+// histogram bucket upper bound (us), 마지막 bucket = +Inf
+//------------------------------------------------------------------------------
+static const uint64_t BucketLe [METRICS_BUCKET_CNT -1] = {
+    100, 500, 1000, 5000, 10000, 50000, 100000, 250000, 500000,
+    1000000, 2500000, 5000000, 10000000, 30000000, 60000000,
+};
+
+static const char *HistName [eHIST_END] = {
+    "jig_ready_wait_seconds",
+    "jig_cycle_seconds",
+    "jig_adc_read_seconds",
+};
+static const char *ItemHistName [eHIST_ITEM_END] = {
+    "jig_item_seconds",
+    "jig_item_request_seconds",
+    "jig_item_check_seconds",
+};
+static const char *CountName [eCNT_END] = {
+    "jig_uart_rx_bytes_total",
+    "jig_uart_tx_bytes_total",
+    "jig_frame_rx_total",
+    "jig_frame_tx_total",
+    "jig_parse_fail_total",
+    "jig_ready_timeout_total",
+    "jig_seq_retry_total",
+    "jig_seq_drop_total",
+    "jig_batch_item_total",
+};
+
+typedef struct item_hist__t {
+    int         gid, did;
+    hist_t      hist;
+}   item_hist_t;
+
+static hist_t       Hist      [METRICS_CH_MAX][eHIST_END];
+static item_hist_t  ItemHist  [METRICS_CH_MAX][eHIST_ITEM_END][METRICS_ITEM_MAX];
+static uint64_t     Count     [METRICS_CH_MAX][eCNT_END];
+static uint64_t     ItemReqUs [METRICS_CH_MAX][METRICS_ITEM_MAX];
+
+static pthread_t    thread_metrics;
+static int          MetricsFd = -1;
+
+//------------------------------------------------------------------------------
+static void hist_add (hist_t *h, uint64_t us)
+{
+    int i;
+
+    for (i = 0; i < METRICS_BUCKET_CNT -1; i++)
+        if (us <= BucketLe[i])  break;
+
+    __atomic_fetch_add (&h->bucket[i], 1,  __ATOMIC_RELAXED);
+    __atomic_fetch_add (&h->sum_us,    us, __ATOMIC_RELAXED);
+    __atomic_fetch_add (&h->count,     1,  __ATOMIC_RELAXED);
+}
+
+//------------------------------------------------------------------------------
+void metrics_count (int ch, int id, uint64_t value)
+{
+    if ((ch < 0) || (ch >= METRICS_CH_MAX) || (id >= eCNT_END))  return;
+
+    __atomic_fetch_add (&Count[ch][id], value, __ATOMIC_RELAXED);
+}
+
+//------------------------------------------------------------------------------
+void metrics_observe (int ch, int id, uint64_t us)
+{
+    if ((ch < 0) || (ch >= METRICS_CH_MAX) || (id >= eHIST_END)) return;
+
+    hist_add (&Hist[ch][id], us);
+}
+
+//------------------------------------------------------------------------------
+void metrics_item_observe (int ch, int id, int pos, int gid, int did, uint64_t us)
+{
+    item_hist_t *ih;
+
+    if ((ch < 0) || (ch >= METRICS_CH_MAX) || (id >= eHIST_ITEM_END))    return;
+    if ((pos < 0) || (pos >= METRICS_ITEM_MAX))                         return;
+
+    ih = &ItemHist[ch][id][pos];
+    ih->gid = gid;  ih->did = did;
+    hist_add (&ih->hist, us);
+}
+
+//------------------------------------------------------------------------------
+// server request (R,gid,did) 전송 시간 기록, status(S) 수신시 latency 측정
+//------------------------------------------------------------------------------
+void metrics_item_request (int ch, int pos)
+{
+    if ((ch < 0) || (ch >= METRICS_CH_MAX))         return;
+    if ((pos < 0) || (pos >= METRICS_ITEM_MAX))     return;
+
+    __atomic_store_n (&ItemReqUs[ch][pos], mono_us (), __ATOMIC_RELAXED);
+}
+
+void metrics_item_reply (int ch, int pos, int gid, int did)
+{
+    uint64_t req_us;
+
+    if ((ch < 0) || (ch >= METRICS_CH_MAX))         return;
+    if ((pos < 0) || (pos >= METRICS_ITEM_MAX))     return;
+
+    if ((req_us = __atomic_exchange_n (&ItemReqUs[ch][pos], 0, __ATOMIC_RELAXED)))
+        metrics_item_observe (ch, eHIST_ITEM_REQ, pos, gid, did, mono_us () - req_us);
+}
+
+//------------------------------------------------------------------------------
+static int hist_render (char *buf, int size, const char *name, const char *label,
+                        const hist_t *h)
+{
+    uint64_t cum = 0;
+    int i, len = 0;
+
+    for (i = 0; i < METRICS_BUCKET_CNT; i++) {
+        cum += __atomic_load_n (&h->bucket[i], __ATOMIC_RELAXED);
+        if (i < METRICS_BUCKET_CNT -1)
+            len += snprintf (buf + len, size - len, "%s_bucket{%s,le=\"%g\"} %llu\n",
+                name, label, BucketLe[i] / 1000000.0, (unsigned long long)cum);
+        else
+            len += snprintf (buf + len, size - len, "%s_bucket{%s,le=\"+Inf\"} %llu\n",
+                name, label, (unsigned long long)cum);
+        if (len >= size)    return size;
+    }
+    len += snprintf (buf + len, size - len, "%s_sum{%s} %.6f\n%s_count{%s} %llu\n",
+        name, label, __atomic_load_n (&h->sum_us, __ATOMIC_RELAXED) / 1000000.0,
+        name, label, (unsigned long long)__atomic_load_n (&h->count, __ATOMIC_RELAXED));
+    return (len >= size) ? size : len;
+}
+
+//------------------------------------------------------------------------------
+int metrics_render (char *buf, int size)
+{
+    char label[64];
+    int ch, id, pos, len = 0;
+
+    for (id = 0; id < eCNT_END; id++) {
+        len += snprintf (buf + len, size - len, "# TYPE %s counter\n", CountName[id]);
+        for (ch = 0; (ch < METRICS_CH_MAX) && (len < size); ch++)
+            len += snprintf (buf + len, size - len, "%s{ch=\"%d\"} %llu\n", CountName[id], ch,
+                (unsigned long long)__atomic_load_n (&Count[ch][id], __ATOMIC_RELAXED));
+        if (len >= size)    return size;
+    }
+
+    for (id = 0; id < eHIST_END; id++) {
+        len += snprintf (buf + len, size - len, "# TYPE %s histogram\n", HistName[id]);
+        for (ch = 0; (ch < METRICS_CH_MAX) && (len < size); ch++) {
+            sprintf (label, "ch=\"%d\"", ch);
+            len += hist_render (buf + len, size - len, HistName[id], label, &Hist[ch][id]);
+        }
+        if (len >= size)    return size;
+    }
+
+    for (id = 0; id < eHIST_ITEM_END; id++) {
+        len += snprintf (buf + len, size - len, "# TYPE %s histogram\n", ItemHistName[id]);
+        for (ch = 0; ch < METRICS_CH_MAX; ch++) {
+            for (pos = 0; (pos < METRICS_ITEM_MAX) && (len < size); pos++) {
+                item_hist_t *ih = &ItemHist[ch][id][pos];
+
+                if (!__atomic_load_n (&ih->hist.count, __ATOMIC_RELAXED))    continue;
+                sprintf (label, "ch=\"%d\",gid=\"%d\",did=\"%d\"", ch, ih->gid, ih->did);
+                len += hist_render (buf + len, size - len, ItemHistName[id], label, &ih->hist);
+            }
+        }
+        if (len >= size)    return size;
+    }
+
+    len += spc_render (buf + len, size - len);
+    if (len < size)
+        len += sched_render (buf + len, size - len);
+    return (len >= size) ? size : len;
+}
+
+//------------------------------------------------------------------------------
+// loopback http server (GET 요청 종류와 관계 없이 metrics 응답)
+//------------------------------------------------------------------------------
+static void *thread_metrics_func (void *arg)
+{
+    char *buf = malloc (METRICS_BUF_SIZE), hdr[128], req[1024];
+    struct timeval tv = { 0, METRICS_IO_TIMEOUT };
+    int fd, len, hlen;
+
+    if (buf == NULL)    return arg;
+
+    while (1) {
+        if ((fd = accept (MetricsFd, NULL, NULL)) < 0) {
+            if (errno != EINTR)     usleep (100 * 1000);
+            continue;
+        }
+        setsockopt (fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt (fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+        /* request header 무시 (timeout 이면 응답 없이 close) */
+        if (read (fd, req, sizeof(req)) >= 0) {
+            len  = metrics_render (buf, METRICS_BUF_SIZE);
+            hlen = sprintf (hdr, "HTTP/1.0 200 OK\r\n"
+                    "Content-Type: text/plain; version=0.0.4\r\n"
+                    "Content-Length: %d\r\n\r\n", len);
+            /* client 가 먼저 끊어도 SIGPIPE 발생하지 않도록 */
+            if (send (fd, hdr, hlen, MSG_NOSIGNAL) == hlen)
+                if (send (fd, buf, len, MSG_NOSIGNAL) != len)
+                    printf ("%s : write error\n", __func__);
+        }
+        close (fd);
+    }
+    free (buf);
+    return arg;
+}
+
+//------------------------------------------------------------------------------
+int metrics_init (int port)
+{
+    struct sockaddr_in addr;
+    int opt = 1;
+
+    if ((MetricsFd = socket (AF_INET, SOCK_STREAM, 0)) < 0)
+        return 0;
+
+    setsockopt (MetricsFd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+    memset (&addr, 0, sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons (port);
+    addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+
+    if ((bind (MetricsFd, (struct sockaddr *)&addr, sizeof(addr)) < 0) ||
+        (listen (MetricsFd, 4) < 0)) {
+        printf ("%s : port %d bind error (%s)\n", __func__, port, strerror(errno));
+        close (MetricsFd);  MetricsFd = -1;
+        return 0;
+    }
+    pthread_create (&thread_metrics, NULL, thread_metrics_func, NULL);
+    printf ("%s : http://127.0.0.1:%d/metrics\n", __func__, port);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
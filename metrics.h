@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+/**
+ * @file metrics.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server latency histogram & counter (prometheus text endpoint).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __METRICS_H__
+#define __METRICS_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// curl http://127.0.0.1:9102/metrics
+//------------------------------------------------------------------------------
+#define METRICS_PORT        9102
+
+#define METRICS_CH_MAX      2
+#define METRICS_ITEM_MAX    100     // server_t d_item max
+#define METRICS_BUCKET_CNT  16
+
+//------------------------------------------------------------------------------
+// channel histogram id
+//------------------------------------------------------------------------------
+enum {
+    eHIST_READY,        // power on -> ready(R)
+    eHIST_CYCLE,        // ready(R) -> complete(X)
+    eHIST_ADC_READ,     // adc_board_read() latency
+    eHIST_END
+};
+
+// item histogram id (per ch, d_item pos)
+enum {
+    eHIST_ITEM,         // previous frame -> status(S) (client item time)
+    eHIST_ITEM_REQ,     // server request(R,gid,did) -> status(S)
+    eHIST_ITEM_CHECK,   // device_resp_check() (server side check)
+    eHIST_ITEM_END
+};
+
+// channel counter id
+enum {
+    eCNT_UART_RX_BYTES,
+    eCNT_UART_TX_BYTES,
+    eCNT_FRAME_RX,
+    eCNT_FRAME_TX,
+    eCNT_PARSE_FAIL,
+    eCNT_READY_TIMEOUT,
+    eCNT_SEQ_RETRY,
+    eCNT_SEQ_DROP,
+    eCNT_BATCH_ITEM,
+    eCNT_END
+};
+
+typedef struct hist__t {
+    uint64_t    bucket [METRICS_BUCKET_CNT];    // le (non cumulative)
+    uint64_t    sum_us;
+    uint64_t    count;
+}   hist_t;
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+extern  int     metrics_init        (int port);
+extern  void    metrics_count       (int ch, int id, uint64_t value);
+extern  void    metrics_observe     (int ch, int id, uint64_t us);
+extern  void    metrics_item_observe(int ch, int id, int pos, int gid, int did, uint64_t us);
+extern  void    metrics_item_request(int ch, int pos);
+extern  void    metrics_item_reply  (int ch, int pos, int gid, int did);
+extern  int     metrics_render      (char *buf, int size);
+
+//------------------------------------------------------------------------------
+#endif  // __METRICS_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
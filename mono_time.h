@@ -0,0 +1,51 @@
+//------------------------------------------------------------------------------
+/**
+ * @file mono_time.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server time helper (monotonic / realtime).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __MONO_TIME_H__
+#define __MONO_TIME_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <time.h>
+
+//------------------------------------------------------------------------------
+// 경과 시간 측정용 (CLOCK_MONOTONIC)
+//------------------------------------------------------------------------------
+static inline uint64_t mono_us (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+static inline uint64_t mono_ms (void)
+{
+    return mono_us () / 1000;
+}
+
+//------------------------------------------------------------------------------
+// 기록용 시간 (CLOCK_REALTIME, epoch ms)
+//------------------------------------------------------------------------------
+static inline uint64_t real_ms (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000ull + ts.tv_nsec / 1000000;
+}
+
+//------------------------------------------------------------------------------
+#endif  // __MONO_TIME_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,588 @@
+//------------------------------------------------------------------------------
+/**
+ * @file plan_sched.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server test plan scheduler (shared resource, item duration history).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+//------------------------------------------------------------------------------
+#include "plan_sched.h"
+#include "crc.h"
+#include "log_ring.h"
+#include "mono_time.h"
+
+//------------------------------------------------------------------------------
+#define SCHED_MAGIC         0x4843534A  // "JSCH"
+#define SCHED_RES_CNT       2
+
+enum {
+    eITEM_WAIT = 0,
+    eITEM_GRANT,
+    eITEM_DONE,
+};
+
+/* item 시간 기록 (snapshot) */
+typedef struct sched_key__t {
+    int32_t     gid, did;
+    uint32_t    cnt;
+    uint32_t    est_us;
+}   sched_key_t;
+
+typedef struct sched_hdr__t {
+    uint32_t    magic;
+    uint32_t    rec_size;
+    uint32_t    cnt;
+    uint32_t    crc;
+}   sched_hdr_t;
+
+typedef struct sched_ch__t {
+    int         active;
+    int         cnt, left;
+    int         grant;      // item idx (-1 = 없음)
+    int         queued;     // grant 가 request queue 에 들어감 (sched_queued)
+    int         done;       // 완료 알림 (0 = 전, 1 = ack 대기, 2 = ack)
+    uint64_t    done_us;    // 마지막 완료 알림 전송
+    uint32_t    drop;
+    uint32_t    est_ms;     // 시작시 예상 완료 시간
+    uint64_t    start_us;
+    uint64_t    grant_us;
+    uint64_t    idle_us;    // resource 대기 시작 (0 = 대기 아님)
+    uint64_t    wait_us;    // resource 대기 누적
+    sched_item_t    item  [SCHED_ITEM_MAX];
+    uint8_t         state [SCHED_ITEM_MAX];
+}   sched_ch_t;
+
+/* channel 별 마지막 board 결과 (metrics) */
+typedef struct sched_report__t {
+    uint32_t    boards;
+    uint32_t    est_ms, actual_ms, wait_ms;
+    double      err_sum;    // |actual - estimate| / actual (%) 누적
+}   sched_report_t;
+
+//------------------------------------------------------------------------------
+static sched_key_t      SchedKey [SCHED_KEY_MAX];
+static int              SchedKeyCnt = 0;
+static int              SchedDirty  = 0;
+static char             SchedPath [128];
+
+static sched_ch_t       SchedCh [SCHED_CH_MAX];
+static sched_report_t   SchedReport [SCHED_CH_MAX];
+
+static pthread_mutex_t  sched_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+//------------------------------------------------------------------------------
+static sched_key_t *sched_key (int gid, int did, int add)
+{
+    sched_key_t *k;
+    int i;
+
+    for (i = 0; i < SchedKeyCnt; i++)
+        if ((SchedKey[i].gid == gid) && (SchedKey[i].did == did))
+            return &SchedKey[i];
+
+    if (!add || (SchedKeyCnt >= SCHED_KEY_MAX))     return NULL;
+
+    k = &SchedKey[SchedKeyCnt++];
+    memset (k, 0, sizeof(sched_key_t));
+    k->gid = gid;
+    k->did = did;
+    return k;
+}
+
+//------------------------------------------------------------------------------
+// ch 의 다음 item 선택 (plan_sched.h 규칙), return item idx (-1 = grant 가능한 item 없음)
+//------------------------------------------------------------------------------
+static int sched_pick (sched_ch_t *chs, int ch, uint64_t now)
+{
+    sched_ch_t *c = &chs[ch];
+    uint64_t load [SCHED_RES_CNT], release [SCHED_RES_CNT], gap_end = UINT64_MAX, key, best_key = 0;
+    int i, n, r, busy = 0, blocked = 0, best = -1, fit = -1;
+
+    memset (load,    0, sizeof(load));
+    memset (release, 0, sizeof(release));
+
+    /* 모든 channel 에 남은 resource 작업량, 다른 channel 이 사용중인 resource */
+    for (n = 0; n < SCHED_CH_MAX; n++) {
+        sched_ch_t *o = &chs[n];
+
+        if (!o->active)     continue;
+        for (i = 0; i < o->cnt; i++) {
+            if (o->state[i] != eITEM_WAIT)  continue;
+            for (r = 0; r < SCHED_RES_CNT; r++)
+                if (o->item[i].res & (1 << r))  load[r] += o->item[i].est_us;
+        }
+        if ((n == ch) || (o->grant < 0))    continue;
+
+        busy |= o->item[o->grant].res;
+        for (r = 0; r < SCHED_RES_CNT; r++) {
+            uint64_t end = o->grant_us + o->item[o->grant].est_us;
+
+            if (o->item[o->grant].res & (1 << r))
+                release[r] = (end > now) ? end : now;
+        }
+    }
+
+    /* resource item : 남은 작업량이 많은 resource 먼저, 같으면 긴 item */
+    for (i = 0; i < c->cnt; i++) {
+        sched_item_t *it = &c->item[i];
+
+        if ((c->state[i] != eITEM_WAIT) || !it->res)    continue;
+        if (it->res & busy) {
+            for (r = 0; r < SCHED_RES_CNT; r++)
+                if ((it->res & busy & (1 << r)) && (release[r] < gap_end))
+                    gap_end = release[r];
+            blocked = 1;
+            continue;
+        }
+        for (key = 0, r = 0; r < SCHED_RES_CNT; r++)
+            if (it->res & (1 << r))     key += load[r];
+        if ((best < 0) || (key > best_key) ||
+            ((key == best_key) && (it->est_us > c->item[best].est_us))) {
+            best     = i;
+            best_key = key;
+        }
+    }
+    if (best >= 0)  return best;
+
+    /* resource 가 없는 item : 대기중이면 resource 가 풀릴때 까지 채우기, 아니면 긴 item */
+    for (i = 0; i < c->cnt; i++) {
+        sched_item_t *it = &c->item[i];
+
+        if ((c->state[i] != eITEM_WAIT) || it->res)     continue;
+        if (!blocked) {
+            if ((best < 0) || (it->est_us > c->item[best].est_us))  best = i;
+            continue;
+        }
+        if ((now + it->est_us <= gap_end) &&
+            ((fit < 0) || (it->est_us > c->item[fit].est_us)))      fit = i;
+        if ((best < 0) || (it->est_us < c->item[best].est_us))      best = i;
+    }
+    return (fit >= 0) ? fit : best;
+}
+
+//------------------------------------------------------------------------------
+// 현재 상태에서 모든 plan channel 을 sched_pick 으로 진행 (예상 시간 사용)
+// return ch 의 예상 완료 시각 (us)
+//------------------------------------------------------------------------------
+static uint64_t sched_simulate (int ch, uint64_t now)
+{
+    static sched_ch_t sim [SCHED_CH_MAX];
+    uint64_t t = now, end;
+    int n, i, next;
+
+    memcpy (sim, SchedCh, sizeof(sim));
+    while (sim[ch].left) {
+        for (n = 0; n < SCHED_CH_MAX; n++) {
+            sched_ch_t *c = &sim[n];
+
+            if (!c->active || (c->grant >= 0) || !c->left)  continue;
+            if ((i = sched_pick (sim, n, t)) < 0)           continue;
+            c->state[i] = eITEM_GRANT;
+            c->grant    = i;
+            c->grant_us = t;
+        }
+        for (next = -1, end = UINT64_MAX, n = 0; n < SCHED_CH_MAX; n++) {
+            sched_ch_t *c = &sim[n];
+            uint64_t e;
+
+            if (!c->active || (c->grant < 0))   continue;
+            /* 예상 시간이 지난 grant 는 지금 끝나는 것으로 */
+            e = c->grant_us + c->item[c->grant].est_us;
+            if (e < t)  e = t;
+            if (e < end) {
+                end  = e;
+                next = n;
+            }
+        }
+        if (next < 0)   break;
+
+        t = end;
+        sim[next].state[sim[next].grant] = eITEM_DONE;
+        sim[next].grant = -1;
+        sim[next].left--;
+    }
+    return t;
+}
+
+//------------------------------------------------------------------------------
+// grant 완료 처리 (sched_mutex lock 상태), return 1 = 현재 grant
+//------------------------------------------------------------------------------
+static int sched_complete (sched_ch_t *c, int gid, int did)
+{
+    if (!c->active || (c->grant < 0))   return 0;
+    if ((c->item[c->grant].gid != gid) || (c->item[c->grant].did != did))
+        return 0;
+
+    c->state[c->grant] = eITEM_DONE;
+    c->grant = -1;
+    c->left--;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+static void sched_load (void)
+{
+    sched_hdr_t hdr;
+    int fd;
+
+    if ((fd = open (SchedPath, O_RDONLY)) < 0)  return;
+
+    if ((read (fd, &hdr, sizeof(hdr)) != sizeof(hdr)) ||
+        (hdr.magic != SCHED_MAGIC) || (hdr.rec_size != sizeof(sched_key_t)) ||
+        (hdr.cnt > SCHED_KEY_MAX) ||
+        (read (fd, SchedKey, sizeof(sched_key_t) * hdr.cnt) != (ssize_t)(sizeof(sched_key_t) * hdr.cnt)) ||
+        (hdr.crc != crc32_calc (SchedKey, sizeof(sched_key_t) * hdr.cnt))) {
+        printf ("%s : %s broken, reset item time\n", __func__, SchedPath);
+        close (fd);
+        return;
+    }
+    close (fd);
+
+    SchedKeyCnt = hdr.cnt;
+    printf ("%s : %d items loaded\n", __func__, SchedKeyCnt);
+}
+
+//------------------------------------------------------------------------------
+// result writer thread : 결과 기록 후 item 시간 snapshot 저장 (tmp -> rename)
+//------------------------------------------------------------------------------
+void sched_save (void)
+{
+    char tmp_path[sizeof(SchedPath) + 8];
+    sched_key_t buf [SCHED_KEY_MAX];
+    sched_hdr_t hdr;
+    int fd, cnt, ok;
+
+    pthread_mutex_lock (&sched_mutex);
+    if (!SchedDirty || !SchedPath[0]) {
+        pthread_mutex_unlock (&sched_mutex);
+        return;
+    }
+    cnt = SchedKeyCnt;
+    memcpy (buf, SchedKey, sizeof(sched_key_t) * cnt);
+    SchedDirty = 0;
+    pthread_mutex_unlock (&sched_mutex);
+
+    hdr.magic    = SCHED_MAGIC;
+    hdr.rec_size = sizeof(sched_key_t);
+    hdr.cnt      = cnt;
+    hdr.crc      = crc32_calc (buf, sizeof(sched_key_t) * cnt);
+
+    sprintf (tmp_path, "%s.tmp", SchedPath);
+    if ((fd = open (tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0) {
+        printf ("%s : %s open error (%s)\n", __func__, tmp_path, strerror(errno));
+        return;
+    }
+    ok = (write (fd, &hdr, sizeof(hdr)) == sizeof(hdr)) &&
+         (write (fd, buf, sizeof(sched_key_t) * cnt) == (ssize_t)(sizeof(sched_key_t) * cnt));
+    fdatasync (fd);
+    close (fd);
+
+    if (ok)     rename (tmp_path, SchedPath);
+    else {
+        printf ("%s : write error (%s)\n", __func__, strerror(errno));
+        unlink (tmp_path);
+        pthread_mutex_lock   (&sched_mutex);
+        SchedDirty = 1;
+        pthread_mutex_unlock (&sched_mutex);
+    }
+}
+
+//------------------------------------------------------------------------------
+int sched_parse_res (const char *str)
+{
+    int res = -1;
+
+    for (; *str; str++) {
+        switch (tolower ((unsigned char)*str)) {
+            case 'a':   res = ((res < 0) ? 0 : res) | SCHED_RES_ADC;   break;
+            case 'n':   res = ((res < 0) ? 0 : res) | SCHED_RES_NET;   break;
+            case '-':   if (res < 0)    res = 0;                        break;
+            default :   break;
+        }
+    }
+    return res;
+}
+
+//------------------------------------------------------------------------------
+uint32_t sched_start (int ch, const sched_item_t *items, int cnt)
+{
+    sched_ch_t *c;
+    int i;
+
+    if ((ch < 0) || (ch >= SCHED_CH_MAX))   return 0;
+
+    pthread_mutex_lock (&sched_mutex);
+    c = &SchedCh[ch];
+    memset (c, 0, sizeof(sched_ch_t));
+    c->cnt = (cnt > SCHED_ITEM_MAX) ? SCHED_ITEM_MAX : cnt;
+    memcpy (c->item, items, sizeof(sched_item_t) * c->cnt);
+    for (i = 0; i < c->cnt; i++) {
+        sched_key_t *k = sched_key (c->item[i].gid, c->item[i].did, 0);
+
+        c->item[i].est_us = (k && k->cnt) ? k->est_us : SCHED_DEFAULT_US;
+    }
+    c->left     = c->cnt;
+    c->grant    = -1;
+    c->start_us = mono_us ();
+    c->active   = 1;
+    c->est_ms   = (uint32_t)((sched_simulate (ch, c->start_us) - c->start_us) / 1000);
+    pthread_mutex_unlock (&sched_mutex);
+
+    printf ("%s : ch %d, %d items, estimate %u ms\n", __func__, ch, c->cnt, c->est_ms);
+    return c->est_ms;
+}
+
+//------------------------------------------------------------------------------
+void sched_stop (int ch)
+{
+    if ((ch < 0) || (ch >= SCHED_CH_MAX) || !SchedCh[ch].active)    return;
+
+    pthread_mutex_lock   (&sched_mutex);
+    SchedCh[ch].active = 0;
+    pthread_mutex_unlock (&sched_mutex);
+}
+
+//------------------------------------------------------------------------------
+int sched_next (int ch, sched_item_t *pitem)
+{
+    sched_ch_t *c;
+    uint64_t now;
+    int i;
+
+    if ((ch < 0) || (ch >= SCHED_CH_MAX))   return 0;
+
+    pthread_mutex_lock (&sched_mutex);
+    c = &SchedCh[ch];
+    if (!c->active || (c->grant >= 0) || !c->left) {
+        pthread_mutex_unlock (&sched_mutex);
+        return 0;
+    }
+    now = mono_us ();
+    if ((i = sched_pick (SchedCh, ch, now)) < 0) {
+        /* 남은 item 이 모두 다른 channel 의 resource 대기 */
+        if (!c->idle_us)    c->idle_us = now;
+        pthread_mutex_unlock (&sched_mutex);
+        return 0;
+    }
+    if (c->idle_us) {
+        c->wait_us += now - c->idle_us;
+        c->idle_us  = 0;
+    }
+    c->state[i] = eITEM_GRANT;
+    c->grant    = i;
+    c->queued   = 0;
+    c->grant_us = now;
+    *pitem = c->item[i];
+    pthread_mutex_unlock (&sched_mutex);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+int sched_granted (int ch, sched_item_t *pitem, int *pqueued)
+{
+    sched_ch_t *c;
+    int ret = 0;
+
+    if ((ch < 0) || (ch >= SCHED_CH_MAX))   return 0;
+
+    pthread_mutex_lock (&sched_mutex);
+    c = &SchedCh[ch];
+    if (c->active && (c->grant >= 0)) {
+        *pitem   = c->item[c->grant];
+        *pqueued = c->queued;
+        ret = 1;
+    }
+    pthread_mutex_unlock (&sched_mutex);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+// grant 가 request queue 에 들어감 (item 시간은 이때 부터)
+//------------------------------------------------------------------------------
+void sched_queued (int ch)
+{
+    if ((ch < 0) || (ch >= SCHED_CH_MAX))   return;
+
+    pthread_mutex_lock (&sched_mutex);
+    if (SchedCh[ch].active && (SchedCh[ch].grant >= 0)) {
+        SchedCh[ch].queued   = 1;
+        SchedCh[ch].grant_us = mono_us ();
+    }
+    pthread_mutex_unlock (&sched_mutex);
+}
+
+//------------------------------------------------------------------------------
+void sched_reply (int ch, int gid, int did, uint32_t us)
+{
+    sched_key_t *k;
+
+    if ((ch < 0) || (ch >= SCHED_CH_MAX))   return;
+
+    pthread_mutex_lock (&sched_mutex);
+    if (sched_complete (&SchedCh[ch], gid, did) && ((k = sched_key (gid, did, 1)) != NULL)) {
+        /* 처음 값은 그대로, 이후 ewma */
+        if (k->cnt)
+            k->est_us = (uint32_t)((int64_t)k->est_us +
+                        (((int64_t)us - (int64_t)k->est_us) / (1 << SCHED_EWMA_SHIFT)));
+        else
+            k->est_us = us;
+        k->cnt++;
+        SchedDirty = 1;
+    }
+    pthread_mutex_unlock (&sched_mutex);
+}
+
+//------------------------------------------------------------------------------
+void sched_drop (int ch, int gid, int did)
+{
+    if ((ch < 0) || (ch >= SCHED_CH_MAX))   return;
+
+    pthread_mutex_lock (&sched_mutex);
+    if (sched_complete (&SchedCh[ch], gid, did)) {
+        SchedCh[ch].drop++;
+        printf ("%s : ch %d, gid %d, did %d no reply, skip\n", __func__, ch, gid, did);
+    }
+    pthread_mutex_unlock (&sched_mutex);
+}
+
+//------------------------------------------------------------------------------
+int sched_done (int ch)
+{
+    sched_ch_t *c;
+    uint64_t now = mono_us ();
+    int ret;
+
+    if ((ch < 0) || (ch >= SCHED_CH_MAX))   return 0;
+
+    pthread_mutex_lock (&sched_mutex);
+    c = &SchedCh[ch];
+    ret = c->active && !c->left && (c->grant < 0) && (c->done < 2) &&
+        (!c->done || (now - c->done_us >= (uint64_t)SCHED_DONE_RETRY_MS * 1000));
+    if (ret) {
+        if (c->done)
+            printf ("%s : ch %d, no ack, resend\n", __func__, ch);
+        c->done    = 1;
+        c->done_us = now;
+    }
+    pthread_mutex_unlock (&sched_mutex);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+void sched_done_ack (int ch)
+{
+    if ((ch < 0) || (ch >= SCHED_CH_MAX))   return;
+
+    pthread_mutex_lock (&sched_mutex);
+    if (SchedCh[ch].active && SchedCh[ch].done)
+        SchedCh[ch].done = 2;
+    pthread_mutex_unlock (&sched_mutex);
+}
+
+//------------------------------------------------------------------------------
+void sched_finish (int ch, uint32_t actual_ms, const char *mac)
+{
+    sched_report_t *r;
+    sched_ch_t *c;
+    uint32_t err;
+
+    if ((ch < 0) || (ch >= SCHED_CH_MAX))   return;
+
+    pthread_mutex_lock (&sched_mutex);
+    c = &SchedCh[ch];
+    if (!c->active) {
+        pthread_mutex_unlock (&sched_mutex);
+        return;
+    }
+    if (c->idle_us)     c->wait_us += mono_us () - c->idle_us;
+    c->active = 0;
+
+    r = &SchedReport[ch];
+    r->boards++;
+    r->est_ms    = c->est_ms;
+    r->actual_ms = actual_ms;
+    r->wait_ms   = (uint32_t)(c->wait_us / 1000);
+    err = (actual_ms > c->est_ms) ? actual_ms - c->est_ms : c->est_ms - actual_ms;
+    if (actual_ms)
+        r->err_sum += (double)err * 100 / actual_ms;
+    pthread_mutex_unlock (&sched_mutex);
+
+    printf ("%s : ch %d, %d items (drop %u), estimate %u ms, actual %u ms, resource wait %u ms\n",
+        __func__, ch, c->cnt, c->drop, r->est_ms, actual_ms, r->wait_ms);
+    LOG_EVENT (ch, eLOG_SCHED_DONE, mac, c->cnt, (int)r->est_ms, (int)actual_ms, (int)r->wait_ms);
+}
+
+//------------------------------------------------------------------------------
+int sched_init (const char *fname)
+{
+    char *ptr;
+    int ch;
+
+    memset  (SchedPath, 0, sizeof(SchedPath));
+    strncpy (SchedPath, fname ? fname : SCHED_FILE_PATH, sizeof(SchedPath) -1);
+
+    if ((ptr = strrchr (SchedPath, '/')) != NULL) {
+        *ptr = 0;   mkdir (SchedPath, 0755);  *ptr = '/';
+    }
+    for (ch = 0; ch < SCHED_CH_MAX; ch++)
+        SchedCh[ch].grant = -1;
+
+    sched_load ();
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+int sched_render (char *buf, int size)
+{
+    uint64_t now = mono_us ();
+    int i, ch, len = 0;
+
+    pthread_mutex_lock (&sched_mutex);
+    len += snprintf (buf + len, size - len, "# TYPE jig_sched_item_ms gauge\n");
+    for (i = 0; (i < SchedKeyCnt) && (len < size); i++)
+        len += snprintf (buf + len, size - len, "jig_sched_item_ms{gid=\"%d\",did=\"%d\"} %.3f\n",
+            SchedKey[i].gid, SchedKey[i].did, SchedKey[i].est_us / 1000.0);
+
+    if (len < size)
+        len += snprintf (buf + len, size - len,
+            "# TYPE jig_sched_estimate_ms gauge\n# TYPE jig_sched_actual_ms gauge\n"
+            "# TYPE jig_sched_wait_ms gauge\n# TYPE jig_sched_error_pct gauge\n"
+            "# TYPE jig_sched_remain_ms gauge\n");
+    for (ch = 0; (ch < SCHED_CH_MAX) && (len < size); ch++) {
+        sched_report_t *r = &SchedReport[ch];
+
+        /* test 중인 board 의 남은 예상 시간 */
+        if (SchedCh[ch].active)
+            len += snprintf (buf + len, size - len, "jig_sched_remain_ms{ch=\"%d\"} %llu\n",
+                ch, (unsigned long long)((sched_simulate (ch, now) - now) / 1000));
+        if (!r->boards || (len >= size))    continue;
+
+        len += snprintf (buf + len, size - len,
+            "jig_sched_estimate_ms{ch=\"%d\"} %u\njig_sched_actual_ms{ch=\"%d\"} %u\n"
+            "jig_sched_wait_ms{ch=\"%d\"} %u\njig_sched_error_pct{ch=\"%d\"} %.3f\n",
+            ch, r->est_ms, ch, r->actual_ms, ch, r->wait_ms, ch, r->err_sum / r->boards);
+    }
+    pthread_mutex_unlock (&sched_mutex);
+    return (len >= size) ? size : len;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
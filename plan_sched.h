@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------------
+/**
+ * @file plan_sched.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server test plan scheduler (shared resource, item duration history).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __PLAN_SCHED_H__
+#define __PLAN_SCHED_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+//
+// plan channel (client ready "ready:<n>:plan", protocol.h) 은 client 가 test 순서를 정하지 않고
+// server 의 요청(R, grant) 을 받은 item 만 시험. grant 는 channel 당 1 개.
+//
+// 다음 grant 선택 (main loop, channel 이 비어 있을때) :
+//   1. 다른 channel 의 grant 가 사용중인 resource 가 필요한 item 은 제외
+//   2. resource item : 모든 channel 에 남은 같은 resource 작업량이 많은 것 먼저 (bottleneck 유지)
+//   3. resource 가 없는 item : resource 대기중인 item 이 있으면 resource 가 풀릴때 까지의
+//      시간에 맞는 가장 긴 item (없으면 가장 짧은 item), 아니면 가장 긴 item 먼저
+// item 시간 = grant 전송 부터 S 응답 까지 (gid, did 별 ewma, SCHED_FILE_PATH 에 저장).
+// ready 시점에 모든 plan channel 을 같은 규칙으로 simulation 해서 예상 완료 시간 계산,
+// 완료(X) 시 실제 시간과 같이 sched_done log, metrics 로 출력.
+//
+// grant 는 request queue 에 들어갈 때 까지 (window/queue full) 유지하고 다시 요청.
+// 모든 item 이 끝나면 plan:done 을 device 의 ack (M 또는 X) 까지 SCHED_DONE_RETRY_MS 마다 재전송.
+//
+//------------------------------------------------------------------------------
+#define SCHED_FILE_PATH     "result/sched.dat"
+
+#define SCHED_CH_MAX        2
+#define SCHED_ITEM_MAX      100
+#define SCHED_KEY_MAX       256
+/* plan:done 재전송 간격 (device ack 전까지) */
+#define SCHED_DONE_RETRY_MS 1000
+/* 기록이 없는 item 의 예상 시간 */
+#define SCHED_DEFAULT_US    (500*1000)
+/* ewma weight = 1 / 2^SCHED_EWMA_SHIFT */
+#define SCHED_EWMA_SHIFT    2
+
+/* channel 간 공유 resource (server.cfg D line 의 resource : a = adc, n = net, - = 없음) */
+#define SCHED_RES_ADC       0x01    // jig i2c adc (led, audio, header check)
+#define SCHED_RES_NET       0x02    // jig ethernet link (iperf)
+
+/* D line 에 resource 가 없는 경우 (device_check.c 에서 jig adc, iperf 를 사용하는 item) */
+#define SCHED_RES_DEFAULT(gid, did) \
+    ((((gid) == eGID_LED) || ((gid) == eGID_AUDIO) || ((gid) == eGID_HEADER)) ? SCHED_RES_ADC : \
+     (((gid) == eGID_ETHERNET) && (((did) == 2) || ((did) == 6) || ((did) == 7))) ? SCHED_RES_NET : 0)
+
+typedef struct sched_item__t {
+    int         gid, did;
+    int         pos;        // d_item pos
+    int         res;        // SCHED_RES_xxx
+    uint32_t    est_us;     // 예상 시간 (sched_start 에서 history 로 설정)
+}   sched_item_t;
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+extern  int     sched_init      (const char *fname);
+/* "a", "n", "an", "-" , return -1 = 값 없음 (gid 기본값 사용) */
+extern  int     sched_parse_res (const char *str);
+
+/* ready : plan 시작, return 예상 완료 시간 (ms) */
+extern  uint32_t sched_start    (int ch, const sched_item_t *items, int cnt);
+/* board 제거, test 중단 (보고 없음) */
+extern  void    sched_stop      (int ch);
+/* return 1 = 다음 grant (pitem) */
+extern  int     sched_next      (int ch, sched_item_t *pitem);
+/* return 1 = grant 있음 (pqueued = request queue 에 들어감) */
+extern  int     sched_granted   (int ch, sched_item_t *pitem, int *pqueued);
+extern  void    sched_queued    (int ch);
+/* grant 응답 (us = grant 전송 부터 응답 까지) */
+extern  void    sched_reply     (int ch, int gid, int did, uint32_t us);
+/* 응답 없이 재전송을 포기한 grant */
+extern  void    sched_drop      (int ch, int gid, int did);
+/* return 1 = 모든 item 완료, plan:done 전송 (ack 전까지 SCHED_DONE_RETRY_MS 마다) */
+extern  int     sched_done      (int ch);
+/* plan:done ack (M, X) */
+extern  void    sched_done_ack  (int ch);
+/* X : 예상 / 실제 완료 시간 보고 */
+extern  void    sched_finish    (int ch, uint32_t actual_ms, const char *mac);
+
+extern  void    sched_save      (void);
+extern  int     sched_render    (char *buf, int size);
+
+//------------------------------------------------------------------------------
+#endif  // __PLAN_SCHED_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,202 @@
+//------------------------------------------------------------------------------
+/**
+ * @file power_mon.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server channel power rail monitor (board insert/remove).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+
+//------------------------------------------------------------------------------
+#include "server.h"
+#include "power_mon.h"
+#include "wave.h"
+#include "log_ring.h"
+#include "mono_time.h"
+
+//------------------------------------------------------------------------------
+static pthread_mutex_t  *AdcMutex = NULL;
+static power_ch_t       PowerCh [POWER_MON_CH_MAX];
+static int              PowerEvent = 0;
+
+static pthread_mutex_t  power_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   power_cond;
+static pthread_t        thread_power;
+
+//------------------------------------------------------------------------------
+// channel rail 을 한번 읽고 hysteresis 적용, return 1 = 모든 rail up
+//------------------------------------------------------------------------------
+static int power_sample (channel_t *pch, power_ch_t *pc, int nch, uint64_t now)
+{
+    int i, pin, up = 0;
+    uint64_t start_us;
+
+    for (i = 0; (i < pch->pw_item_cnt) && (i < POWER_MON_RAIL_MAX); i++) {
+        pw_item_t *pw = &pch->pw_item[i];
+
+        pthread_mutex_lock   (AdcMutex);
+        start_us = mono_us ();
+        hw_adc_read (pch->i2c_fd, pw->cname, &pw->read_mV, &pin);
+        metrics_observe (nch, eHIST_ADC_READ, mono_us () - start_us);
+        pthread_mutex_unlock (AdcMutex);
+        wave_sample (nch, i, start_us, pw->read_mV);
+
+        if (!pc->rail[i] && (pw->read_mV >= pw->check_mV)) {
+            pc->rail[i] = 1;
+            /* board 가 없는 상태에서 처음 올라온 rail 기준으로 rail 별 up 시간 기록 */
+            if (!pc->state) {
+                if (!pc->first_up_us)   pc->first_up_us = now;
+                pc->rail_up_us[i] = (uint32_t)(now - pc->first_up_us);
+            }
+        }
+        else if (pc->rail[i] && (pw->read_mV < pw->check_mV - POWER_MON_HYST_MV))
+            pc->rail[i] = 0;
+
+        up += pc->rail[i];
+    }
+    /* 모든 rail 이 내려가면 다음 insert 를 위해 초기화 */
+    if (!up && !pc->state)  pc->first_up_us = 0;
+
+    wave_update (nch, pch, pc->state, now);
+    return (i > 0) && (up == i);
+}
+
+//------------------------------------------------------------------------------
+static void power_update (int nch, power_ch_t *pc, int raw, uint64_t now)
+{
+    if (raw && !pc->raw)    pc->all_up_us = now;
+    if (raw != pc->raw && pc->cnt)      pc->glitches++;
+    pc->raw = raw;
+
+    if (raw == pc->state)   { pc->cnt = 0;  return; }
+    if (++pc->cnt < POWER_MON_DEBOUNCE) return;
+
+    pthread_mutex_lock (&power_mutex);
+    pc->state = raw;
+    pc->cnt   = 0;
+    if (raw) {
+        pc->insert_us = now;
+        pc->inserts++;
+        LOG_EVENT (nch, eLOG_POWER_ON, "",
+            (int)((pc->all_up_us - pc->first_up_us) / 1000), (int)((now - pc->first_up_us) / 1000));
+    } else {
+        pc->remove_us   = now;
+        pc->first_up_us = 0;
+        pc->removes++;
+        LOG_EVENT (nch, eLOG_POWER_OFF, "", (int)pc->glitches);
+    }
+    PowerEvent = 1;
+    pthread_cond_broadcast (&power_cond);
+    pthread_mutex_unlock   (&power_mutex);
+}
+
+//------------------------------------------------------------------------------
+static void *thread_power_func (void *arg)
+{
+    server_t *p = (server_t *)arg;
+    uint64_t now, next = mono_us ();
+    int nch, raw, tick, capture;
+
+    while (1) {
+        tick    = (mono_us () >= next);
+        capture = 0;
+        for (nch = 0; (nch < p->ch_cnt) && (nch < POWER_MON_CH_MAX); nch++) {
+            channel_t *pch = &p->ch[nch];
+
+            if (pch->i2c_fd == -1)  continue;
+            /* waveform capture 중인 channel 은 주기와 관계없이 연속으로 읽음 */
+            if (!tick && !wave_active (nch))    continue;
+
+            now = mono_us ();
+            raw = power_sample (pch, &PowerCh[nch], nch, now);
+            /* debounce 는 고정 주기 sample 기준 */
+            if (tick)   power_update (nch, &PowerCh[nch], raw, now);
+            capture |= wave_active (nch);
+        }
+        /* 고정 주기 (adc read 시간 포함) */
+        now = mono_us ();
+        if (tick) {
+            next += POWER_MON_PERIOD_MS * 1000;
+            if (next < now)     next = now;
+        }
+        if (next > now)
+            usleep ((capture && (next - now > WAVE_SAMPLE_US)) ? WAVE_SAMPLE_US : next - now);
+    }
+    return arg;
+}
+
+//------------------------------------------------------------------------------
+int power_mon_state (int ch)
+{
+    if ((ch < 0) || (ch >= POWER_MON_CH_MAX))   return 0;
+    return PowerCh[ch].state;
+}
+
+//------------------------------------------------------------------------------
+int power_mon_info (int ch, power_ch_t *pinfo)
+{
+    if ((ch < 0) || (ch >= POWER_MON_CH_MAX))   return 0;
+
+    pthread_mutex_lock   (&power_mutex);
+    memcpy (pinfo, &PowerCh[ch], sizeof(power_ch_t));
+    pthread_mutex_unlock (&power_mutex);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// ui thread : timeout 까지 대기, insert/remove event 가 있으면 바로 return 1
+//------------------------------------------------------------------------------
+int power_mon_wait (int64_t timeout_us)
+{
+    struct timespec ts;
+    int event;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    ts.tv_sec  += timeout_us / 1000000;
+    ts.tv_nsec += (timeout_us % 1000000) * 1000;
+    if (ts.tv_nsec >= 1000000000)   { ts.tv_sec++;  ts.tv_nsec -= 1000000000; }
+
+    pthread_mutex_lock (&power_mutex);
+    while (!PowerEvent)
+        if (pthread_cond_timedwait (&power_cond, &power_mutex, &ts))    break;
+    event = PowerEvent;
+    PowerEvent = 0;
+    pthread_mutex_unlock (&power_mutex);
+    return event;
+}
+
+//------------------------------------------------------------------------------
+int power_mon_init (server_t *p, pthread_mutex_t *adc_mutex)
+{
+    pthread_condattr_t attr;
+
+    AdcMutex = adc_mutex;
+    memset (PowerCh, 0, sizeof(PowerCh));
+
+    pthread_condattr_init     (&attr);
+    pthread_condattr_setclock (&attr, CLOCK_MONOTONIC);
+    pthread_cond_init         (&power_cond, &attr);
+    pthread_condattr_destroy  (&attr);
+
+    printf ("%s : period %d ms, hysteresis %d mV, debounce %d\n", __func__,
+        POWER_MON_PERIOD_MS, POWER_MON_HYST_MV, POWER_MON_DEBOUNCE);
+
+    pthread_create (&thread_power, NULL, thread_power_func, (void *)p);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,66 @@
+//------------------------------------------------------------------------------
+/**
+ * @file power_mon.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server channel power rail monitor (board insert/remove).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __POWER_MON_H__
+#define __POWER_MON_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <pthread.h>
+
+//------------------------------------------------------------------------------
+//
+// 'P' line rail 을 POWER_MON_PERIOD_MS 간격으로 계속 읽음.
+//   rail up   : read_mV >= check_mV
+//   rail down : read_mV <  check_mV - POWER_MON_HYST_MV
+// 모든 rail 이 up 인 상태가 POWER_MON_DEBOUNCE 회 연속되면 insert,
+// 하나라도 down 인 상태가 POWER_MON_DEBOUNCE 회 연속되면 remove.
+// insert/remove 는 ui thread 를 바로 깨워서 처리 (power_mon_wait).
+// rail 이 올라오기 시작하면 wave.c capture 동안 주기 대기 없이 연속으로 읽음.
+//
+//------------------------------------------------------------------------------
+#define POWER_MON_PERIOD_MS     10
+#define POWER_MON_HYST_MV       200
+#define POWER_MON_DEBOUNCE      3
+#define POWER_MON_CH_MAX        2
+#define POWER_MON_RAIL_MAX      10
+
+typedef struct power_ch__t {
+    int         state;          // debounced (1 = board insert)
+    int         raw;            // 마지막 sample (모든 rail up = 1)
+    int         cnt;            // raw != state 연속 횟수
+    uint8_t     rail [POWER_MON_RAIL_MAX];      // rail 상태 (hysteresis)
+    uint64_t    first_up_us;    // 처음 rail 이 올라온 시각 (mono us)
+    uint64_t    all_up_us;      // 모든 rail 이 올라온 시각 (mono us)
+    uint64_t    insert_us;      // insert 확정 시각 (mono us)
+    uint64_t    remove_us;      // remove 확정 시각 (mono us)
+    uint32_t    rail_up_us [POWER_MON_RAIL_MAX];  // first_up 기준 각 rail up 시간
+    uint32_t    inserts, removes, glitches;
+}   power_ch_t;
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+struct server__t;
+
+extern  int     power_mon_init      (struct server__t *p, pthread_mutex_t *adc_mutex);
+extern  int     power_mon_state     (int ch);
+extern  int     power_mon_info      (int ch, power_ch_t *pinfo);
+extern  int     power_mon_wait      (int64_t timeout_us);
+
+//------------------------------------------------------------------------------
+#endif  // __POWER_MON_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
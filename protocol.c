@@ -17,12 +17,46 @@
 #include <unistd.h>
 #include <string.h>
 #include <time.h>
+#include <ctype.h>
 #include <getopt.h>
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 /* protocol control 함수 */
 #include "protocol.h"
+#include "protocol_v3.h"
+#include "device_check.h"
+#include "mono_time.h"
+#include "log_ring.h"
+#include "metrics.h"
+#include "capture.h"
+
+//------------------------------------------------------------------------------
+// channel 별 uart 등록 (log/metrics 의 channel 구분용)
+//------------------------------------------------------------------------------
+static uart_t *ProtocolUart [PROTOCOL_CH_MAX];
+
+/* channel 별 frame version (ready 에서 협상), v3 수신 상태 및 마지막 수신 frame */
+static int          ProtocolVer   [PROTOCOL_CH_MAX];
+static ptc_v3_rx_t  ProtocolRx    [PROTOCOL_CH_MAX];
+static ptc_frame_t  ProtocolFrame [PROTOCOL_CH_MAX];
+
+void protocol_ch_init (int ch, uart_t *puart)
+{
+    if ((ch >= 0) && (ch < PROTOCOL_CH_MAX)) {
+        ProtocolUart[ch] = puart;
+        ProtocolVer [ch] = PROTOCOL_V2;
+    }
+}
+
+int protocol_uart_ch (uart_t *puart)
+{
+    int ch;
+
+    for (ch = 0; ch < PROTOCOL_CH_MAX; ch++)
+        if (ProtocolUart[ch] == puart)  return ch;
+    return LOG_CH_NONE;
+}
 
 //------------------------------------------------------------------------------
 //
@@ -47,18 +81,82 @@ int protocol_catch (ptc_var_t *var)
         case 'M': case 'E': case 'X':
             return 1;
         default :
-            printf ("%s unknown command %c\n", __func__, cmd);
+            {
+                char str[2] = { cmd, 0 };
+                LOG_EVENT (LOG_CH_NONE, eLOG_UART_CATCH, str);
+            }
             return 0;
     }
 }
 
+//------------------------------------------------------------------------------
+// v2 frame ("@,c,gg,dddd,s,value,#") 을 v3 frame 으로 변환 전송
+//------------------------------------------------------------------------------
+static int protocol_v3_conv_tx (uart_t *puart, int ch, const char *tx_msg)
+{
+    uint8_t frame [PTC_V3_HDR_SIZE + DEVICE_RESP_SIZE + PTC_V3_CRC_SIZE];
+    char value [DEVICE_RESP_SIZE +1], *v = value;
+    int size, seq;
+
+    /* line end 는 v3 에서 사용하지 않음 */
+    if ((int)strlen (tx_msg) != SERIAL_RESP_SIZE)   return 0;
+
+    memcpy (value, &tx_msg[14], DEVICE_RESP_SIZE -2);
+    value[DEVICE_RESP_SIZE -2] = 0;
+    while (*v == ' ')   v++;
+    seq  = protocol_seq_strip (v);
+    size = ptc_v3_encode (frame, sizeof(frame), tx_msg[2], tx_msg[12],
+                atoi (&tx_msg[4]), atoi (&tx_msg[7]), seq, v, strlen (v));
+
+    uart_write   (puart, frame, size);
+    capture_data (ch, eCAPTURE_TX, frame, size);
+    return size;
+}
+
 //------------------------------------------------------------------------------
 void protocol_msg_tx (uart_t *puart, void *tx_msg)
 {
+    int size, ch;
+
     if (puart == NULL)  return;
 
-    uart_write (puart, tx_msg, (int)strlen(tx_msg));
-    printf ("%s : size = %d, data = %s\n", __func__, (int)strlen(tx_msg), (char *)tx_msg);
+    size = (int)strlen(tx_msg);
+    ch   = protocol_uart_ch (puart);
+
+    if ((ch < PROTOCOL_CH_MAX) && (ProtocolVer[ch] == PROTOCOL_V3)) {
+        if ((size = protocol_v3_conv_tx (puart, ch, tx_msg)) == 0)  return;
+        metrics_count (ch, eCNT_UART_TX_BYTES, size);
+        metrics_count (ch, eCNT_FRAME_TX, 1);
+        LOG_EVENT (ch, eLOG_UART_TX, tx_msg, puart->fd, size);
+        return;
+    }
+    uart_write (puart, tx_msg, size);
+    capture_data (ch, eCAPTURE_TX, tx_msg, size);
+
+    metrics_count (ch, eCNT_UART_TX_BYTES, size);
+    /* frame 과 line end("\r\n") 가 따로 전송됨 */
+    if (size > 2)
+        metrics_count (ch, eCNT_FRAME_TX, 1);
+    LOG_EVENT (ch, eLOG_UART_TX, tx_msg, puart->fd, size);
+}
+
+//------------------------------------------------------------------------------
+// v3 frame 을 v2 frame 형식으로 변환 (protocol_parse 공용)
+// value 는 앞 20 byte (seq 포함) 만 사용, 전체 payload 는 protocol_payload()
+//------------------------------------------------------------------------------
+static void protocol_v3_conv_rx (const ptc_frame_t *pf, char *rx_msg)
+{
+    char value [DEVICE_RESP_SIZE -1], resp [DEVICE_RESP_SIZE +1], *c;
+
+    if (pf->seq)    protocol_seq_value (value, pf->seq, (const char *)pf->payload);
+    else            snprintf (value, sizeof(value), "%s", pf->payload);
+
+    /* v2 field 구분자 */
+    for (c = value; *c; c++)
+        if ((*c == ',') || (*c < ' '))  *c = ' ';
+
+    DEVICE_RESP_FORM_STR (resp, pf->status ? pf->status : 'P', value);
+    SERIAL_RESP_FORM (rx_msg, pf->cmd, pf->gid, pf->did, resp);
 }
 
 //------------------------------------------------------------------------------
@@ -70,6 +168,18 @@ int protocol_msg_rx (uart_t *puart, char *rx_msg)
 
     /* uart data processing */
     if (uart_read (puart, &idata, 1)) {
+        int ch = protocol_uart_ch (puart);
+        int v3 = (ch < PROTOCOL_CH_MAX) && (ProtocolVer[ch] == PROTOCOL_V3);
+
+        metrics_count (ch, eCNT_UART_RX_BYTES, 1);
+        capture_data  (ch, eCAPTURE_RX, &idata, 1);
+
+        if (v3 && ptc_v3_decode (&ProtocolRx[ch], idata, &ProtocolFrame[ch])) {
+            protocol_v3_conv_rx (&ProtocolFrame[ch], rx_msg);
+            metrics_count (ch, eCNT_FRAME_RX, 1);
+            return 1;
+        }
+        /* v3 channel 도 v2 frame 확인 (client 재시작시 v2 ready) */
         ptc_event (puart, idata);
         for (p_cnt = 0; p_cnt < puart->pcnt; p_cnt++) {
             if (puart->p[p_cnt].var.pass) {
@@ -82,6 +192,15 @@ int protocol_msg_rx (uart_t *puart, char *rx_msg)
                 for (i = 0; i < (int)var->size; i++)
                     // uuid start position is 2
                     rx_msg [i] = var->buf[(var->p_sp + i) % var->size];
+
+                if (v3) {
+                    /* binary data 중 우연히 맞은 frame 은 무시, v2 ready 만 v2 로 복귀 */
+                    if (strncmp (rx_msg, "@,R,-1,-001,", 12))  return 0;
+                    ProtocolVer[ch] = PROTOCOL_V2;
+                    ProtocolRx [ch].pos = 0;
+                    LOG_EVENT (ch, eLOG_PROTOCOL_VER, "", PROTOCOL_V2);
+                }
+                metrics_count (ch, eCNT_FRAME_RX, 1);
                 return 1;
             }
         }
@@ -89,5 +208,264 @@ int protocol_msg_rx (uart_t *puart, char *rx_msg)
     return 0;
 }
 
+//------------------------------------------------------------------------------
+// ready(O) 전송 후 frame version 변경 (v3 는 sequence id 협상된 경우만)
+//------------------------------------------------------------------------------
+void protocol_set_version (uart_t *puart, int version)
+{
+    int ch = protocol_uart_ch (puart);
+
+    if ((ch >= PROTOCOL_CH_MAX) || (ProtocolVer[ch] == version))    return;
+
+    ProtocolVer[ch] = version;
+    ProtocolRx [ch].pos = 0;
+    LOG_EVENT (ch, eLOG_PROTOCOL_VER, "", version);
+}
+
+//------------------------------------------------------------------------------
+int protocol_version (uart_t *puart)
+{
+    int ch = protocol_uart_ch (puart);
+
+    return (ch < PROTOCOL_CH_MAX) ? ProtocolVer[ch] : PROTOCOL_V2;
+}
+
+//------------------------------------------------------------------------------
+// 마지막 수신 v3 frame 의 전체 payload (v2 channel 은 NULL)
+//------------------------------------------------------------------------------
+const char *protocol_payload (uart_t *puart, int *len)
+{
+    int ch = protocol_uart_ch (puart);
+
+    if ((ch >= PROTOCOL_CH_MAX) || (ProtocolVer[ch] != PROTOCOL_V3))  return NULL;
+
+    if (len)    *len = ProtocolFrame[ch].len;
+    return (const char *)ProtocolFrame[ch].payload;
+}
+
+//------------------------------------------------------------------------------
+// v3 channel : 긴 payload 직접 전송 (v2 channel 은 value 20 byte 로 잘라서 전송)
+//------------------------------------------------------------------------------
+void protocol_v3_tx (uart_t *puart, char cmd, char status, int gid, int did, int seq,
+                     const void *payload, int len)
+{
+    static uint8_t frame [PTC_V3_FRAME_MAX];
+    char value [DEVICE_RESP_SIZE -1], resp [DEVICE_RESP_SIZE +1], tx_msg [SERIAL_RESP_SIZE +1];
+    int ch = protocol_uart_ch (puart), size;
+
+    if (puart == NULL)  return;
+
+    if ((ch >= PROTOCOL_CH_MAX) || (ProtocolVer[ch] != PROTOCOL_V3)) {
+        if (seq)    protocol_seq_value (value, seq, payload);
+        else        snprintf (value, sizeof(value), "%.*s", len, (const char *)payload);
+        DEVICE_RESP_FORM_STR (resp, status, value);
+        SERIAL_RESP_FORM (tx_msg, cmd, gid, did, resp);
+        protocol_msg_tx (puart, tx_msg);
+        protocol_msg_tx (puart, "\r\n");
+        return;
+    }
+    if ((size = ptc_v3_encode (frame, sizeof(frame), cmd, status, gid, did, seq, payload, len))) {
+        uart_write   (puart, frame, size);
+        capture_data (ch, eCAPTURE_TX, frame, size);
+        metrics_count (ch, eCNT_UART_TX_BYTES, size);
+        metrics_count (ch, eCNT_FRAME_TX, 1);
+    }
+}
+
+//------------------------------------------------------------------------------
+// sequence id 확장 (protocol.h 참조)
+//------------------------------------------------------------------------------
+// req 응답 timeout (timer thread) : main loop 의 protocol_seq_poll 에서 재전송
+static void protocol_seq_timeout (tw_timer_t *t)
+{
+    ptc_seq_t *ps = (ptc_seq_t *)t->arg;
+
+    __atomic_fetch_or (&ps->due, 1 << (int)(t - ps->tmr), __ATOMIC_ACQ_REL);
+}
+
+//------------------------------------------------------------------------------
+void protocol_seq_reset (ptc_seq_t *ps, int ch, int window)
+{
+    int i;
+
+    /* 대기중인 timer 는 wheel 에서 먼저 제거 */
+    for (i = 0; i < PROTOCOL_WINDOW_MAX; i++)
+        tw_cancel (&ps->tmr[i]);
+
+    memset (ps, 0, sizeof(ptc_seq_t));
+    ps->ch     = ch;
+    ps->window = (window > PROTOCOL_WINDOW_MAX) ? PROTOCOL_WINDOW_MAX : window;
+    ps->next   = 1;
+    ps->version = PROTOCOL_V2;
+    for (i = 0; i < PROTOCOL_WINDOW_MAX; i++)
+        tw_setup (&ps->tmr[i], protocol_seq_timeout, ps);
+}
+
+//------------------------------------------------------------------------------
+// client ready value ("ready:<window>") 확인, return window (0 = 기존 protocol)
+// resp = okay(O) frame 의 status/value
+//------------------------------------------------------------------------------
+int protocol_seq_ready (ptc_seq_t *ps, const char *value, char *resp)
+{
+    char str [PROTOCOL_SEQ_VALUE +1];
+    int window = 0, version = PROTOCOL_V2, plan = 0;
+
+    if (!strncmp (value, "ready:", strlen("ready:"))) {
+        window = atoi (value + strlen("ready:"));
+        if (strstr (value, ":v3") != NULL)      version = PROTOCOL_V3;
+        if (strstr (value, ":plan") != NULL)    plan = 1;
+    }
+    protocol_seq_reset (ps, ps->ch, (window > 0) ? window : 0);
+    if (ps->window) {
+        ps->version = version;
+        ps->plan    = plan;
+        sprintf (str, "seq:%d%s%s", ps->window, (version == PROTOCOL_V3) ? ":v3" : "",
+                                     plan ? ":plan" : "");
+        DEVICE_RESP_FORM_STR (resp, 'P', str);
+    }
+    return ps->window;
+}
+
+//------------------------------------------------------------------------------
+// value 앞의 "nnn:" 제거, return seq (0 = seq 없음)
+//------------------------------------------------------------------------------
+int protocol_seq_strip (char *value)
+{
+    int seq;
+
+    if (!isdigit((int)value[0]) || !isdigit((int)value[1]) ||
+        !isdigit((int)value[2]) || (value[3] != ':'))
+        return 0;
+
+    seq = atoi (value);
+    memmove (value, value + 4, strlen (value + 4) + 1);
+    return seq;
+}
+
+//------------------------------------------------------------------------------
+void protocol_seq_value (char *buf, int seq, const char *value)
+{
+    /* v3 seq 는 16 bit, value 20 byte 를 넘지 않도록 3 자리로 제한 */
+    sprintf (buf, "%03u:%.*s", (unsigned)seq % (PROTOCOL_SEQ_MAX +1), PROTOCOL_SEQ_VALUE, value ? value : "");
+}
+
+//------------------------------------------------------------------------------
+// return 1 = 같은 item 요청이 전송/대기 중
+//------------------------------------------------------------------------------
+int protocol_seq_pending (ptc_seq_t *ps, int gid, int did)
+{
+    int i;
+
+    for (i = 0; i < PROTOCOL_WINDOW_MAX; i++)
+        if (ps->req[i].seq && (ps->req[i].gid == gid) && (ps->req[i].did == did))
+            return 1;
+    for (i = ps->q_head; i != ps->q_tail; i = (i + 1) % PROTOCOL_QUEUE_MAX)
+        if ((ps->queue[i].gid == gid) && (ps->queue[i].did == did))
+            return 1;
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// 같은 item 이 전송/대기 중이면 추가하지 않음. return 0 = queue full 또는 seq 미사용
+//------------------------------------------------------------------------------
+int protocol_seq_request (ptc_seq_t *ps, int gid, int did, int pos)
+{
+    ptc_req_t *preq;
+
+    if (!ps->window)    return 0;
+
+    if (protocol_seq_pending (ps, gid, did))    return 1;
+
+    if ((ps->q_tail + 1) % PROTOCOL_QUEUE_MAX == ps->q_head)    return 0;
+
+    preq = &ps->queue[ps->q_tail];
+    memset (preq, 0, sizeof(ptc_req_t));
+    preq->gid = gid;
+    preq->did = did;
+    preq->pos = pos;
+    ps->q_tail = (ps->q_tail + 1) % PROTOCOL_QUEUE_MAX;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// status(S) 응답과 전송중인 요청 비교 (seq, gid, did), return 1 = 요청에 대한 응답
+//------------------------------------------------------------------------------
+int protocol_seq_reply (ptc_seq_t *ps, int seq, int gid, int did, ptc_req_t *preq)
+{
+    int i;
+
+    if (!ps->window || !seq)    return 0;
+
+    for (i = 0; i < PROTOCOL_WINDOW_MAX; i++) {
+        ptc_req_t *r = &ps->req[i];
+
+        if ((r->seq != seq) || (r->gid != gid) || (r->did != did))  continue;
+        if (preq)   memcpy (preq, r, sizeof(ptc_req_t));
+        r->seq = 0;
+        tw_cancel (&ps->tmr[i]);
+        return 1;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+static void protocol_seq_send (uart_t *puart, ptc_req_t *preq)
+{
+    char value [DEVICE_RESP_SIZE -1], resp [DEVICE_RESP_SIZE +1];
+    char serial_resp [SERIAL_RESP_SIZE +1];
+
+    protocol_seq_value   (value, preq->seq, NULL);
+    DEVICE_RESP_FORM_STR (resp, 'P', value);
+    SERIAL_RESP_FORM     (serial_resp, RESP_CMD_REQUEST, preq->gid, preq->did, resp);
+    protocol_msg_tx (puart, serial_resp);
+    protocol_msg_tx (puart, "\r\n");
+}
+
+//------------------------------------------------------------------------------
+// main loop : 응답 없는 요청 재전송, window 가 비면 대기중인 요청 전송
+//------------------------------------------------------------------------------
+void protocol_seq_poll (ptc_seq_t *ps, uart_t *puart, uint64_t now)
+{
+    int i, due;
+
+    if (!ps->window || (puart == NULL))     return;
+
+    due = __atomic_exchange_n (&ps->due, 0, __ATOMIC_ACQ_REL);
+    for (i = 0; i < ps->window; i++) {
+        ptc_req_t *r = &ps->req[i];
+
+        if (!r->seq) {
+            if (ps->q_head == ps->q_tail)   continue;
+
+            memcpy (r, &ps->queue[ps->q_head], sizeof(ptc_req_t));
+            ps->q_head = (ps->q_head + 1) % PROTOCOL_QUEUE_MAX;
+
+            r->seq    = ps->next;
+            r->req_us = now;
+            r->tx_us  = now;
+            ps->next  = (ps->next % PROTOCOL_SEQ_MAX) + 1;
+            metrics_item_request (ps->ch, r->pos);
+            protocol_seq_send (puart, r);
+            tw_arm (&ps->tmr[i], PROTOCOL_RETRY_MS);
+            continue;
+        }
+        /* timer 만료 후 응답 전에 slot 이 다시 사용된 경우 (다시 설정된 timer) 는 무시 */
+        if (!(due & (1 << i)) || tw_pending (&ps->tmr[i]))  continue;
+
+        if (r->retry >= PROTOCOL_RETRY_MAX) {
+            LOG_EVENT (ps->ch, eLOG_SEQ_DROP, "", r->seq, r->gid, r->did);
+            metrics_count (ps->ch, eCNT_SEQ_DROP, 1);
+            r->seq = 0;
+            continue;
+        }
+        r->retry++;
+        r->tx_us = now;
+        LOG_EVENT (ps->ch, eLOG_SEQ_RETRY, "", r->seq, r->gid, r->did, r->retry);
+        metrics_count (ps->ch, eCNT_SEQ_RETRY, 1);
+        protocol_seq_send (puart, r);
+        tw_arm (&ps->tmr[i], PROTOCOL_RETRY_MS);
+    }
+}
+
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
\ No newline at end of file
@@ -18,14 +18,93 @@
 
 #include "lib_uart/lib_uart.h"
 
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "timer_wheel.h"
+
+//------------------------------------------------------------------------------
+#define PROTOCOL_CH_MAX     2
+
+//------------------------------------------------------------------------------
+//
+// sequence id 확장 (client ready(R) / server okay(O) 에서 협상)
+//   client : @,R,-1,-001,P,             ready:<window>,#
+//   server : @,O,-1,-001,P,               seq:<window>,#  (window = min(client, server))
+// 협상된 channel 은 R/S/A/C frame 의 value 앞에 "nnn:" (001 ~ 999) 를 붙임 (value 최대 16 byte).
+//   server 요청(R) 에 대한 S 는 요청의 seq, client S 에 대한 A/C 는 S 의 seq 로 응답.
+//   server 는 window 개 까지 R 을 연속 전송하고 seq 로 응답을 찾음 (순서 무관),
+//   PROTOCOL_RETRY_MS 동안 응답이 없으면 같은 seq 로 재전송 (PROTOCOL_RETRY_MAX 회).
+//   요청별 응답 timeout 은 timer wheel (timer_wheel.c) 에서 만료된 요청만 main loop 에 알림.
+// "ready" 만 보내는 client 는 기존 protocol (1 request, seq 없음) 로 동작.
+//
+// binary frame v3 (protocol_v3.h) : client ready 가 "ready:<window>:v3" 이면 server 는
+// "seq:<window>:v3" 응답 후 v3 frame 사용 (seq 는 frame header, payload 최대 2KB, CRC-32).
+// protocol_parse 는 v2 형식으로 변환된 frame 을 받고, 전체 payload 는 protocol_payload().
+// v3 channel 에서 v2 ready 를 받으면 (client 재시작) v2 로 복귀.
+//
+// test plan (plan_sched.h) : client ready 에 ":plan" 을 붙이면 ("ready:<n>[:v3]:plan", seq 필요)
+// server 는 "seq:<n>[:v3]:plan" 응답 후 item 을 하나씩 요청(R, grant) 하고, client 는 요청받은
+// item 만 시험해서 S 로 응답. 모든 item 이 끝나면 server 가 "@,O,-1,-001,P,plan:done,#" 전송,
+// client 는 기존과 같이 M, X 로 종료. M (또는 X) 이 plan:done 의 ack 이며, 받기 전까지 server 는
+// SCHED_DONE_RETRY_MS 마다 plan:done 재전송 (client 는 중복 plan:done 을 무시).
+//
+//------------------------------------------------------------------------------
+#define PROTOCOL_V2             2
+#define PROTOCOL_V3             3
+
+#define PROTOCOL_WINDOW_MAX     8
+#define PROTOCOL_QUEUE_MAX      128
+#define PROTOCOL_SEQ_MAX        999
+#define PROTOCOL_SEQ_VALUE      16
+#define PROTOCOL_RETRY_MS       1000
+#define PROTOCOL_RETRY_MAX      3
+
+typedef struct ptc_req__t {
+    int         seq;        // 0 = empty
+    int         gid, did, pos;
+    int         retry;
+    uint64_t    req_us;     // 처음 전송 시각 (mono us)
+    uint64_t    tx_us;      // 마지막 전송 시각 (mono us)
+}   ptc_req_t;
+
+typedef struct ptc_seq__t {
+    int         ch;
+    int         window;     // 0 = 기존 protocol
+    int         version;    // 협상된 frame version (PROTOCOL_V2, V3)
+    int         plan;       // 1 = server grant 순서로 test (client ready ":plan")
+    int         next;
+    ptc_req_t   req   [PROTOCOL_WINDOW_MAX];
+    ptc_req_t   queue [PROTOCOL_QUEUE_MAX];
+    int         q_head, q_tail;
+    tw_timer_t  tmr   [PROTOCOL_WINDOW_MAX];    // req 응답 timeout
+    int         due;                            // timeout 된 req (bit, timer thread -> main loop)
+}   ptc_seq_t;
+
 //------------------------------------------------------------------------------
 // function prototype define
 //------------------------------------------------------------------------------
+extern  void    protocol_ch_init(int ch, uart_t *puart);
+extern  int     protocol_uart_ch(uart_t *puart);
 extern  int     protocol_catch  (ptc_var_t *var);
 extern  int     protocol_check  (ptc_var_t *var);
 extern  void    protocol_msg_tx (uart_t *puart, void *tx_msg);
 extern  int     protocol_msg_rx (uart_t *puart, char *rx_msg);
 
+extern  void    protocol_set_version(uart_t *puart, int version);
+extern  int     protocol_version    (uart_t *puart);
+extern  const char *protocol_payload(uart_t *puart, int *len);
+extern  void    protocol_v3_tx      (uart_t *puart, char cmd, char status, int gid, int did,
+                                     int seq, const void *payload, int len);
+
+extern  void    protocol_seq_reset  (ptc_seq_t *ps, int ch, int window);
+extern  int     protocol_seq_ready  (ptc_seq_t *ps, const char *value, char *resp);
+extern  int     protocol_seq_strip  (char *value);
+extern  void    protocol_seq_value  (char *buf, int seq, const char *value);
+extern  int     protocol_seq_request(ptc_seq_t *ps, int gid, int did, int pos);
+extern  int     protocol_seq_reply  (ptc_seq_t *ps, int seq, int gid, int did, ptc_req_t *preq);
+extern  int     protocol_seq_pending(ptc_seq_t *ps, int gid, int did);
+extern  void    protocol_seq_poll   (ptc_seq_t *ps, uart_t *puart, uint64_t now);
+
 //------------------------------------------------------------------------------
 #endif	// #define	__PROTOCOL_H__
 
@@ -0,0 +1,162 @@
+//------------------------------------------------------------------------------
+/**
+ * @file protocol_v3.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG protocol v3 binary frame (length prefixed, CRC-32, escape free).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//------------------------------------------------------------------------------
+#include "protocol_v3.h"
+#include "crc.h"
+
+//------------------------------------------------------------------------------
+static void put_u16 (uint8_t *p, uint16_t v) { p[0] = v & 0xFF;  p[1] = v >> 8; }
+static uint16_t get_u16 (const uint8_t *p)   { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+//------------------------------------------------------------------------------
+int ptc_v3_encode (uint8_t *buf, int size, char cmd, char status,
+                   int gid, int did, int seq, const void *payload, int len)
+{
+    uint32_t crc;
+
+    if ((len < 0) || (len > PTC_V3_PAYLOAD_MAX))    return 0;
+    if (size < PTC_V3_HDR_SIZE + len + PTC_V3_CRC_SIZE) return 0;
+
+    buf[0] = PTC_V3_SOF0;
+    buf[1] = PTC_V3_SOF1;
+    put_u16 (&buf[2], (uint16_t)len);
+    buf[4] = (uint8_t)cmd;
+    buf[5] = (uint8_t)status;
+    buf[6] = (uint8_t)(int8_t)gid;
+    put_u16 (&buf[7], (uint16_t)(int16_t)did);
+    put_u16 (&buf[9], (uint16_t)seq);
+    buf[11] = (uint8_t)crc32_calc (&buf[2], PTC_V3_HDR_SIZE -3);
+
+    if (len)    memcpy (&buf[PTC_V3_HDR_SIZE], payload, len);
+
+    crc = crc32_calc (&buf[2], PTC_V3_HDR_SIZE -2 + len);
+    buf[PTC_V3_HDR_SIZE + len +0] = (uint8_t)(crc);
+    buf[PTC_V3_HDR_SIZE + len +1] = (uint8_t)(crc >> 8);
+    buf[PTC_V3_HDR_SIZE + len +2] = (uint8_t)(crc >> 16);
+    buf[PTC_V3_HDR_SIZE + len +3] = (uint8_t)(crc >> 24);
+    return PTC_V3_HDR_SIZE + len + PTC_V3_CRC_SIZE;
+}
+
+//------------------------------------------------------------------------------
+// 현재 buffer 확인, return 1 = frame, 0 = data 부족, -1 = 오류 (resync)
+//------------------------------------------------------------------------------
+static int ptc_v3_check (ptc_v3_rx_t *rx, ptc_frame_t *pframe)
+{
+    const uint8_t *b = rx->buf;
+    uint32_t crc;
+    int len;
+
+    if ((rx->pos >= 1) && (b[0] != PTC_V3_SOF0))    return -1;
+    if ((rx->pos >= 2) && (b[1] != PTC_V3_SOF1))    return -1;
+    if (rx->pos < PTC_V3_HDR_SIZE)                  return 0;
+
+    len = get_u16 (&b[2]);
+    if ((len > PTC_V3_PAYLOAD_MAX) ||
+        (b[11] != (uint8_t)crc32_calc (&b[2], PTC_V3_HDR_SIZE -3))) {
+        rx->hdr_err++;
+        return -1;
+    }
+    if (rx->pos < PTC_V3_HDR_SIZE + len + PTC_V3_CRC_SIZE)  return 0;
+
+    crc = crc32_calc (&b[2], PTC_V3_HDR_SIZE -2 + len);
+    b  += PTC_V3_HDR_SIZE + len;
+    if (crc != ((uint32_t)b[0] | (uint32_t)b[1] << 8 | (uint32_t)b[2] << 16 | (uint32_t)b[3] << 24)) {
+        rx->crc_err++;
+        return -1;
+    }
+
+    b = rx->buf;
+    pframe->cmd    = (char)b[4];
+    pframe->status = (char)b[5];
+    pframe->gid    = (int8_t)b[6];
+    pframe->did    = (int16_t)get_u16 (&b[7]);
+    pframe->seq    = get_u16 (&b[9]);
+    pframe->len    = len;
+    memcpy (pframe->payload, &b[PTC_V3_HDR_SIZE], len);
+    pframe->payload[len] = 0;
+    rx->frames++;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+int ptc_v3_decode (ptc_v3_rx_t *rx, uint8_t data, ptc_frame_t *pframe)
+{
+    int ret, i;
+
+    /* frame 시작 전 byte 는 버림 (v2 ascii, noise) */
+    if (!rx->pos && (data != PTC_V3_SOF0))  return 0;
+
+    rx->buf[rx->pos++] = data;
+    while ((ret = ptc_v3_check (rx, pframe)) < 0) {
+        /* 오류 frame 안의 다음 sof 부터 다시 확인 */
+        for (i = 1; (i < rx->pos) && (rx->buf[i] != PTC_V3_SOF0); i++);
+        memmove (rx->buf, rx->buf + i, rx->pos - i);
+        rx->pos -= i;
+    }
+    if (ret == 1) {
+        /* resync 로 다음 frame 일부가 이미 buffer 에 있는 경우 */
+        i = PTC_V3_HDR_SIZE + pframe->len + PTC_V3_CRC_SIZE;
+        memmove (rx->buf, rx->buf + i, rx->pos - i);
+        rx->pos -= i;
+    }
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+int ptc_v3_batch_add (uint8_t *buf, int size, int pos,
+                      int gid, int did, char status, const char *value)
+{
+    int len = value ? (int)strlen (value) : 0;
+
+    if (len > PTC_V3_BATCH_VALUE)   len = PTC_V3_BATCH_VALUE;
+    if (pos + 5 + len > size)       return 0;
+
+    buf[pos +0] = (uint8_t)(int8_t)gid;
+    put_u16 (&buf[pos +1], (uint16_t)(int16_t)did);
+    buf[pos +3] = (uint8_t)status;
+    buf[pos +4] = (uint8_t)len;
+    if (len)    memcpy (&buf[pos +5], value, len);
+    return pos + 5 + len;
+}
+
+//------------------------------------------------------------------------------
+int ptc_v3_batch_get (const uint8_t *buf, int len, ptc_batch_t *pbatch, int max)
+{
+    int pos = 0, cnt = 0, vlen;
+
+    while (pos < len) {
+        if ((cnt >= max) || (pos + 5 > len))    return -1;
+
+        vlen = buf[pos +4];
+        if ((vlen > PTC_V3_BATCH_VALUE) || (pos + 5 + vlen > len))  return -1;
+
+        pbatch[cnt].gid    = (int8_t)buf[pos +0];
+        pbatch[cnt].did    = (int16_t)get_u16 (&buf[pos +1]);
+        pbatch[cnt].status = (char)buf[pos +3];
+        memcpy (pbatch[cnt].value, &buf[pos +5], vlen);
+        pbatch[cnt].value[vlen] = 0;
+        pos += 5 + vlen;
+        cnt++;
+    }
+    return cnt;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+/**
+ * @file protocol_v3.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG protocol v3 binary frame (length prefixed, CRC-32, escape free).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __PROTOCOL_V3_H__
+#define __PROTOCOL_V3_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+//
+// v3 frame (little endian)
+//
+//   | sof0 | sof1 | len(2) | cmd | status | gid | did(2) | seq(2) | hcrc | payload(len) | crc(4) |
+//   | 0xA5 | 0x5A |
+//
+//   gid, did  : signed (-1 = 없음, v2 의 "-1", "-001")
+//   hcrc      : crc32 (len ~ seq) 하위 1 byte. 깨진 len 으로 긴 payload 를 기다리지 않도록 먼저 확인.
+//   crc       : crc32 (len ~ payload)
+//
+// escape 없이 sof + length 로 구분. header/crc 오류시 sof 다음 byte 부터 다시 찾음.
+//
+//------------------------------------------------------------------------------
+#define PTC_V3_SOF0         0xA5
+#define PTC_V3_SOF1         0x5A
+#define PTC_V3_HDR_SIZE     12
+#define PTC_V3_CRC_SIZE     4
+#define PTC_V3_PAYLOAD_MAX  2048
+#define PTC_V3_FRAME_MAX    (PTC_V3_HDR_SIZE + PTC_V3_PAYLOAD_MAX + PTC_V3_CRC_SIZE)
+
+//------------------------------------------------------------------------------
+//
+// batch (N) payload : item status record 연속, server 는 A frame payload 의 bitmap 으로 응답
+//
+//   record    : | gid | did(2) | status | len | value(len, 최대 20) |
+//   A bitmap  : bit n (byte n / 8, bit n % 8) = record n 처리됨
+//   최대 64 record (64 x 25 byte < payload max)
+//
+//------------------------------------------------------------------------------
+#define PTC_V3_BATCH_MAX    64
+#define PTC_V3_BATCH_VALUE  20
+#define PTC_V3_BATCH_BITMAP (PTC_V3_BATCH_MAX / 8)
+
+typedef struct ptc_batch__t {
+    int         gid;
+    int         did;
+    char        status;
+    char        value [PTC_V3_BATCH_VALUE +1];
+}   ptc_batch_t;
+
+typedef struct ptc_frame__t {
+    char        cmd;
+    char        status;
+    int         gid;
+    int         did;
+    int         seq;
+    int         len;
+    uint8_t     payload [PTC_V3_PAYLOAD_MAX +1];    // NULL terminated
+}   ptc_frame_t;
+
+typedef struct ptc_v3_rx__t {
+    int         pos;
+    uint32_t    crc_err, hdr_err, frames;
+    uint8_t     buf [PTC_V3_FRAME_MAX];
+}   ptc_v3_rx_t;
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+/* return frame size (0 = buffer 부족) */
+extern  int     ptc_v3_encode   (uint8_t *buf, int size, char cmd, char status,
+                                 int gid, int did, int seq, const void *payload, int len);
+/* 1 byte 씩 입력, return 1 = frame 수신 (pframe) */
+extern  int     ptc_v3_decode   (ptc_v3_rx_t *rx, uint8_t data, ptc_frame_t *pframe);
+/* return 추가 후 payload size (0 = buffer 부족) */
+extern  int     ptc_v3_batch_add(uint8_t *buf, int size, int pos,
+                                 int gid, int did, char status, const char *value);
+/* return record 수 (-1 = format 오류) */
+extern  int     ptc_v3_batch_get(const uint8_t *buf, int len, ptc_batch_t *pbatch, int max);
+
+//------------------------------------------------------------------------------
+#endif  // __PROTOCOL_V3_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,549 @@
+//------------------------------------------------------------------------------
+/**
+ * @file result_store.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server board test result store (append only, indexed by MAC/time).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+//------------------------------------------------------------------------------
+#include "result_store.h"
+#include "mono_time.h"
+#include "crc.h"
+#include "spc.h"
+#include "plan_sched.h"
+
+//------------------------------------------------------------------------------
+#define RESULT_HASH_SIZE    65536
+#define RESULT_INDEX_STEP   4096
+#define RESULT_REC_MAX_SIZE (sizeof(result_rec_t) + sizeof(result_sec_t) * eRESULT_TAG_END)
+
+//------------------------------------------------------------------------------
+// mac index : hash bucket -> node chain, time index : end_ts 정렬 배열
+//------------------------------------------------------------------------------
+typedef struct mac_node__t {
+    uint64_t    key;
+    uint64_t    offset;
+    int32_t     next;
+}   mac_node_t;
+
+typedef struct time_node__t {
+    uint64_t    end_ts;
+    uint64_t    offset;
+}   time_node_t;
+
+typedef struct result_queue__t {
+    result_rec_t            rec;
+    struct result_queue__t  *next;
+}   result_queue_t;
+
+//------------------------------------------------------------------------------
+static int          StoreFd = -1;
+static uint64_t     StoreSize = 0;
+static uint32_t     StoreSeq  = 0;
+
+static int32_t      *MacHash  = NULL;
+static mac_node_t   *MacNode  = NULL;
+static int          MacCnt = 0, MacMax = 0;
+
+static time_node_t  *TimeNode = NULL;
+static int          TimeCnt = 0, TimeMax = 0;
+
+static result_queue_t   *QueueHead = NULL, *QueueTail = NULL;
+
+static pthread_t        thread_result;
+static pthread_mutex_t  index_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t  queue_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   queue_cond  = PTHREAD_COND_INITIALIZER;
+
+//------------------------------------------------------------------------------
+// "00:1e:06:12:34:56", "001e06123456" -> 48bit value, 그 외 문자열은 FNV-1a hash
+//------------------------------------------------------------------------------
+uint64_t result_mac_key (const char *mac)
+{
+    uint64_t key = 0, hash = 0xcbf29ce484222325ull;
+    const char *p;
+    int digit = 0;
+
+    for (p = mac; *p; p++) {
+        hash = (hash ^ (uint8_t)*p) * 0x100000001b3ull;
+        if (isxdigit ((unsigned char)*p)) {
+            key = (key << 4) | (uint64_t)(isdigit ((unsigned char)*p) ?
+                    (*p - '0') : (tolower ((unsigned char)*p) - 'a' + 10));
+            digit++;
+        }
+        else if ((*p != ':') && (*p != '-') && (*p != ' '))
+            digit = 13;
+    }
+    /* bit 63 : hashed key (mac 형식이 아닌 경우) */
+    return (digit == 12) ? key : (hash | (1ull << 63));
+}
+
+//------------------------------------------------------------------------------
+static void *result_grow (void *ptr, int *max, size_t size)
+{
+    void *p = realloc (ptr, (*max + RESULT_INDEX_STEP) * size);
+
+    if (p != NULL)  *max += RESULT_INDEX_STEP;
+    return p;
+}
+
+//------------------------------------------------------------------------------
+static void result_index_add (const result_rec_t *prec, uint64_t offset)
+{
+    int i;
+
+    pthread_mutex_lock (&index_mutex);
+    if (MacCnt >= MacMax) {
+        mac_node_t *p = result_grow (MacNode, &MacMax, sizeof(mac_node_t));
+        if (p == NULL)  goto out;
+        MacNode = p;
+    }
+    if (TimeCnt >= TimeMax) {
+        time_node_t *p = result_grow (TimeNode, &TimeMax, sizeof(time_node_t));
+        if (p == NULL)  goto out;
+        TimeNode = p;
+    }
+
+    if (prec->mac[0]) {
+        uint64_t key = result_mac_key (prec->mac);
+        uint32_t bucket = (uint32_t)(key ^ (key >> 24)) & (RESULT_HASH_SIZE -1);
+
+        MacNode[MacCnt].key    = key;
+        MacNode[MacCnt].offset = offset;
+        MacNode[MacCnt].next   = MacHash[bucket];
+        MacHash[bucket] = MacCnt++;
+    }
+
+    /* 대부분 시간순으로 추가되므로 삽입 정렬 비용은 O(1) */
+    for (i = TimeCnt; (i > 0) && (TimeNode[i -1].end_ts > prec->end_ts); i--)
+        TimeNode[i] = TimeNode[i -1];
+    TimeNode[i].end_ts = prec->end_ts;
+    TimeNode[i].offset = offset;
+    TimeCnt++;
+out:
+    pthread_mutex_unlock (&index_mutex);
+}
+
+//------------------------------------------------------------------------------
+static size_t result_sec_add (uint8_t *buf, int tag, int cnt, const void *data, size_t size)
+{
+    result_sec_t sec;
+
+    sec.tag  = (uint16_t)tag;
+    sec.cnt  = (uint16_t)cnt;
+    sec.size = (uint32_t)size;
+    memcpy (buf, &sec, sizeof(sec));
+    memcpy (buf + sizeof(sec), data, size);
+    return sizeof(sec) + size;
+}
+
+//------------------------------------------------------------------------------
+static size_t result_encode (const result_rec_t *prec, uint8_t *buf)
+{
+    result_hdr_t hdr;
+    size_t size = sizeof(hdr);
+
+    size += result_sec_add (buf + size, eRESULT_TAG_HEAD, 1,
+                prec, offsetof(result_rec_t, item));
+    size += result_sec_add (buf + size, eRESULT_TAG_ITEM, prec->item_cnt,
+                prec->item, prec->item_cnt * sizeof(result_item_t));
+    size += result_sec_add (buf + size, eRESULT_TAG_ERR, prec->err_cnt,
+                prec->err, prec->err_cnt * RESULT_ERR_SIZE);
+    if (prec->wave_cnt)
+        size += result_sec_add (buf + size, eRESULT_TAG_WAVE, prec->wave_cnt,
+                prec->wave, prec->wave_size);
+
+    hdr.magic = RESULT_REC_MAGIC;
+    hdr.size  = (uint32_t)(size - sizeof(hdr));
+    hdr.crc   = crc32_calc (buf + sizeof(hdr), hdr.size);
+    hdr.seq   = StoreSeq++;
+    memcpy (buf, &hdr, sizeof(hdr));
+    return size;
+}
+
+//------------------------------------------------------------------------------
+static int result_decode (const uint8_t *buf, size_t size, result_rec_t *prec)
+{
+    result_sec_t sec;
+    size_t pos = 0;
+
+    memset (prec, 0, sizeof(result_rec_t));
+    while (pos + sizeof(sec) <= size) {
+        memcpy (&sec, buf + pos, sizeof(sec));
+        pos += sizeof(sec);
+        if (pos + sec.size > size)  return 0;
+
+        switch (sec.tag) {
+            case eRESULT_TAG_HEAD:
+                if (sec.size != offsetof(result_rec_t, item))       return 0;
+                memcpy (prec, buf + pos, sec.size);
+                break;
+            case eRESULT_TAG_ITEM:
+                if ((sec.cnt > RESULT_ITEM_MAX) ||
+                    (sec.size != sec.cnt * sizeof(result_item_t)))  return 0;
+                memcpy (prec->item, buf + pos, sec.size);
+                break;
+            case eRESULT_TAG_ERR:
+                if ((sec.cnt > RESULT_ERR_MAX) ||
+                    (sec.size != sec.cnt * RESULT_ERR_SIZE))        return 0;
+                memcpy (prec->err, buf + pos, sec.size);
+                break;
+            case eRESULT_TAG_WAVE:
+                if (sec.size > RESULT_WAVE_SIZE)                    return 0;
+                memcpy (prec->wave, buf + pos, sec.size);
+                prec->wave_cnt  = (uint8_t)sec.cnt;
+                prec->wave_size = (uint16_t)sec.size;
+                break;
+            /* unknown section (newer version) skip */
+            default :
+                break;
+        }
+        pos += sec.size;
+    }
+    return (pos == size);
+}
+
+//------------------------------------------------------------------------------
+static int result_read (uint64_t offset, result_rec_t *prec)
+{
+    uint8_t buf[RESULT_REC_MAX_SIZE];
+    result_hdr_t hdr;
+
+    if (pread (StoreFd, &hdr, sizeof(hdr), offset) != sizeof(hdr))  return 0;
+    if ((hdr.magic != RESULT_REC_MAGIC) || (hdr.size > sizeof(buf))) return 0;
+    if (pread (StoreFd, buf, hdr.size, offset + sizeof(hdr)) != (ssize_t)hdr.size)
+        return 0;
+    if (crc32_calc (buf, hdr.size) != hdr.crc)  return 0;
+
+    return result_decode (buf, hdr.size, prec);
+}
+
+//------------------------------------------------------------------------------
+// offset 이후 magic 과 crc 가 맞는 다음 record 검색, return 0 = 없음
+//------------------------------------------------------------------------------
+static uint64_t result_store_resync (uint64_t offset, uint64_t end, result_rec_t *prec)
+{
+    const uint32_t magic = RESULT_REC_MAGIC;
+    uint8_t buf [4096];
+    ssize_t len, i;
+
+    for (; offset + sizeof(result_hdr_t) <= end; offset += len - (sizeof(magic) -1)) {
+        if ((len = pread (StoreFd, buf, sizeof(buf), offset)) < (ssize_t)sizeof(magic))
+            break;
+        for (i = 0; i + (ssize_t)sizeof(magic) <= len; i++)
+            if (!memcmp (&buf[i], &magic, sizeof(magic)) && result_read (offset + i, prec))
+                return offset + i;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// 전체 record scan 후 index 생성.
+// 중간의 깨진 record 는 다음 정상 record 까지 건너뜀 (기록은 유지),
+// 이후 정상 record 가 없으면 (전원 off 중 기록된 마지막 record) truncate.
+//------------------------------------------------------------------------------
+static void result_store_load (void)
+{
+    result_rec_t *prec = malloc (sizeof(result_rec_t));
+    result_hdr_t hdr;
+    uint64_t offset = 0, next, end;
+    int skip = 0;
+
+    if (prec == NULL)   return;
+
+    end = lseek (StoreFd, 0, SEEK_END);
+    while (pread (StoreFd, &hdr, sizeof(hdr), offset) == sizeof(hdr)) {
+        if (!result_read (offset, prec)) {
+            if ((next = result_store_resync (offset + 1, end, prec)) == 0)
+                break;
+            printf ("%s : broken record, skip %llu ~ %llu (%llu bytes)\n", __func__,
+                (unsigned long long)offset, (unsigned long long)next,
+                (unsigned long long)(next - offset));
+            offset = next;
+            skip++;
+            continue;
+        }
+        result_index_add (prec, offset);
+        StoreSeq = hdr.seq + 1;
+        offset += sizeof(hdr) + hdr.size;
+    }
+
+    StoreSize = end;
+    if (offset != StoreSize) {
+        printf ("%s : broken tail record, truncate %llu -> %llu\n", __func__,
+            (unsigned long long)StoreSize, (unsigned long long)offset);
+        if (ftruncate (StoreFd, offset) == 0)   StoreSize = offset;
+    }
+    printf ("%s : %d records loaded, %d broken span(s) skipped\n", __func__, TimeCnt, skip);
+    free (prec);
+}
+
+//------------------------------------------------------------------------------
+// 부분 기록된 record 제거 (write error), 이후 record 는 StoreSize 부터 다시 기록
+//------------------------------------------------------------------------------
+static int result_store_trim (void)
+{
+    if (lseek (StoreFd, 0, SEEK_END) == (off_t)StoreSize)   return 1;
+
+    if (ftruncate (StoreFd, StoreSize) != 0) {
+        printf ("%s : truncate error (%s)\n", __func__, strerror(errno));
+        return 0;
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// return 기록하지 못한 record list (NULL = 전체 기록)
+//------------------------------------------------------------------------------
+static result_queue_t *result_store_write (result_queue_t *list)
+{
+    uint8_t *buf = malloc (RESULT_REC_MAX_SIZE);
+    result_queue_t *q;
+    uint64_t offset;
+    uint32_t seq;
+    ssize_t ret;
+    size_t size;
+
+    if (buf == NULL)    return list;
+
+    /* 이전 write error 의 truncate 가 실패한 경우 정리 될 때 까지 기록하지 않음 */
+    if (!result_store_trim ()) {
+        free (buf);
+        return list;
+    }
+    for (q = list; q != NULL; q = q->next) {
+        seq    = StoreSeq;
+        size   = result_encode (&q->rec, buf);
+        offset = StoreSize;
+        if ((ret = write (StoreFd, buf, size)) != (ssize_t)size) {
+            printf ("%s : write error (%s)\n", __func__,
+                (ret < 0) ? strerror(errno) : "short write");
+            StoreSeq = seq;
+            result_store_trim ();
+            break;
+        }
+        StoreSize += size;
+        result_index_add (&q->rec, offset);
+    }
+    /* batch 단위 sync */
+    fdatasync (StoreFd);
+    free (buf);
+    return q;
+}
+
+//------------------------------------------------------------------------------
+// 기록하지 못한 record 를 queue 앞에 다시 추가 (기록 순서 유지)
+//------------------------------------------------------------------------------
+static void result_requeue (result_queue_t *list)
+{
+    result_queue_t *tail = list;
+
+    while (tail->next != NULL)  tail = tail->next;
+
+    pthread_mutex_lock (&queue_mutex);
+    tail->next = QueueHead;
+    QueueHead  = list;
+    if (QueueTail == NULL)  QueueTail = tail;
+    pthread_mutex_unlock (&queue_mutex);
+}
+
+//------------------------------------------------------------------------------
+static void *thread_result_func (void *arg)
+{
+    result_queue_t *list, *pending, *q;
+
+    while (1) {
+        pthread_mutex_lock (&queue_mutex);
+        while (QueueHead == NULL)
+            pthread_cond_wait (&queue_cond, &queue_mutex);
+        pthread_mutex_unlock (&queue_mutex);
+
+        /* 동시에 종료되는 channel 을 한번에 기록하기 위한 대기 */
+        usleep (RESULT_SYNC_DELAY);
+
+        pthread_mutex_lock (&queue_mutex);
+        list = QueueHead;   QueueHead = QueueTail = NULL;
+        pthread_mutex_unlock (&queue_mutex);
+
+        pending = result_store_write (list);
+        /* spc snapshot, item 시간 기록도 결과 기록 단위로 저장 */
+        spc_save   ();
+        sched_save ();
+        while ((q = list) != pending) {
+            list = list->next;  free (q);
+        }
+        if (pending != NULL) {
+            result_requeue (pending);
+            usleep (RESULT_RETRY_DELAY);
+        }
+    }
+    return arg;
+}
+
+//------------------------------------------------------------------------------
+int result_store_init (const char *fname)
+{
+    char path[128], *ptr;
+    int i;
+
+    memset  (path, 0, sizeof(path));
+    strncpy (path, fname ? fname : RESULT_FILE_PATH, sizeof(path) -1);
+
+    if ((ptr = strrchr (path, '/')) != NULL) {
+        *ptr = 0;   mkdir (path, 0755);     *ptr = '/';
+    }
+
+    if ((StoreFd = open (path, O_RDWR | O_CREAT | O_APPEND, 0644)) < 0) {
+        printf ("%s : %s open error (%s)\n", __func__, path, strerror(errno));
+        return 0;
+    }
+    if ((MacHash = malloc (RESULT_HASH_SIZE * sizeof(int32_t))) == NULL)
+        return 0;
+    for (i = 0; i < RESULT_HASH_SIZE; i++)  MacHash[i] = -1;
+
+    result_store_load ();
+    pthread_create (&thread_result, NULL, thread_result_func, NULL);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+int result_store_count (void)
+{
+    return TimeCnt;
+}
+
+//------------------------------------------------------------------------------
+// 최근 record 부터 max 개 까지 채움, return 전체 일치 record 수
+//------------------------------------------------------------------------------
+int result_store_find_mac (const char *mac, result_rec_t *prec, int max)
+{
+    uint64_t key = result_mac_key (mac);
+    uint32_t bucket = (uint32_t)(key ^ (key >> 24)) & (RESULT_HASH_SIZE -1);
+    int32_t n;
+    int cnt = 0;
+
+    if (MacHash == NULL)    return 0;
+
+    pthread_mutex_lock (&index_mutex);
+    for (n = MacHash[bucket]; n != -1; n = MacNode[n].next) {
+        if (MacNode[n].key != key)  continue;
+        if ((cnt < max) && (prec != NULL))
+            if (!result_read (MacNode[n].offset, &prec[cnt]))   continue;
+        cnt++;
+    }
+    pthread_mutex_unlock (&index_mutex);
+    return cnt;
+}
+
+//------------------------------------------------------------------------------
+int result_store_find_time (uint64_t from, uint64_t to, result_rec_t *prec, int max)
+{
+    int lo = 0, hi, cnt = 0;
+
+    pthread_mutex_lock (&index_mutex);
+    /* lower bound (end_ts >= from) */
+    for (hi = TimeCnt; lo < hi; ) {
+        int mid = (lo + hi) / 2;
+        if (TimeNode[mid].end_ts < from)    lo = mid + 1;
+        else                                hi = mid;
+    }
+    for (; (lo < TimeCnt) && (TimeNode[lo].end_ts <= to); lo++) {
+        if ((cnt < max) && (prec != NULL))
+            if (!result_read (TimeNode[lo].offset, &prec[cnt]))  continue;
+        cnt++;
+    }
+    pthread_mutex_unlock (&index_mutex);
+    return cnt;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void result_begin (result_rec_t *prec, int ch)
+{
+    memset (prec, 0, sizeof(result_rec_t));
+    prec->ch       = (uint8_t)ch;
+    prec->start_ts = real_ms ();
+}
+
+//------------------------------------------------------------------------------
+void result_item (result_rec_t *prec, int gid, int did, char status,
+                    const char *value, uint32_t elapsed_ms)
+{
+    result_item_t *pitem = NULL;
+    int i;
+
+    /* re-test item 은 마지막 결과로 갱신 */
+    for (i = 0; i < prec->item_cnt; i++) {
+        if ((prec->item[i].gid == gid) && (prec->item[i].did == did)) {
+            pitem = &prec->item[i];
+            break;
+        }
+    }
+    if (pitem == NULL) {
+        if (prec->item_cnt >= RESULT_ITEM_MAX)  return;
+        pitem = &prec->item[prec->item_cnt++];
+    }
+    memset (pitem, 0, sizeof(result_item_t));
+    pitem->gid        = (uint8_t)gid;
+    pitem->did        = (uint16_t)did;
+    pitem->status     = (uint8_t)status;
+    pitem->elapsed_ms = elapsed_ms;
+    if (value != NULL)
+        strncpy (pitem->value, value, RESULT_VALUE_SIZE -1);
+}
+
+//------------------------------------------------------------------------------
+void result_error (result_rec_t *prec, const char *err)
+{
+    if (prec->err_cnt >= RESULT_ERR_MAX)    return;
+
+    strncpy (prec->err[prec->err_cnt++], err, RESULT_ERR_SIZE -1);
+}
+
+//------------------------------------------------------------------------------
+// channel 에서 호출, record 복사 후 writer thread 로 전달 (blocking 없음)
+//------------------------------------------------------------------------------
+void result_commit (result_rec_t *prec, char result)
+{
+    result_queue_t *q;
+
+    prec->result = (uint8_t)result;
+    prec->end_ts = real_ms ();
+
+    if (StoreFd < 0)    return;
+    if ((q = malloc (sizeof(result_queue_t))) == NULL)  return;
+
+    memcpy (&q->rec, prec, sizeof(result_rec_t));
+    q->next = NULL;
+
+    pthread_mutex_lock (&queue_mutex);
+    if (QueueTail)  QueueTail->next = q;
+    else            QueueHead = q;
+    QueueTail = q;
+    pthread_cond_signal  (&queue_cond);
+    pthread_mutex_unlock (&queue_mutex);
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+/**
+ * @file result_store.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server board test result store (append only, indexed by MAC/time).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __RESULT_STORE_H__
+#define __RESULT_STORE_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+#define RESULT_FILE_PATH    "result/result.dat"
+
+#define RESULT_ITEM_MAX     100     // server_t d_item max
+#define RESULT_ERR_MAX      20      // USBLP_ERR_LINE
+#define RESULT_ERR_SIZE     20
+#define RESULT_MAC_SIZE     24
+#define RESULT_VALUE_SIZE   24
+/* power-up waveform (wave.c, 압축된 data) */
+#define RESULT_WAVE_SIZE    4096
+
+/* writer thread : 최대 대기시간 이후 batch write & fdatasync */
+#define RESULT_SYNC_DELAY   (500*1000)
+/* write error 시 기록하지 못한 record 재시도 간격 */
+#define RESULT_RETRY_DELAY  (1000*1000)
+
+//------------------------------------------------------------------------------
+// board result
+//------------------------------------------------------------------------------
+enum {
+    eRESULT_PASS    = 'P',
+    eRESULT_FAIL    = 'F',
+    eRESULT_TIMEOUT = 'T',  // uart ready timeout
+    eRESULT_ABORT   = 'A',  // board removed before finish
+};
+
+typedef struct result_item__t {
+    uint8_t     gid;
+    uint8_t     status;     // P/F/C/I/W
+    uint16_t    did;
+    uint32_t    elapsed_ms; // ready(R) -> status(S)
+    char        value [RESULT_VALUE_SIZE];
+}   result_item_t;
+
+typedef struct result_rec__t {
+    char        mac [RESULT_MAC_SIZE];
+    uint8_t     ch;
+    uint8_t     result;
+    uint8_t     item_cnt;
+    uint8_t     err_cnt;
+    uint32_t    ready_ms;   // power on -> ready(R)
+    uint32_t    test_ms;    // ready(R) -> complete(X)
+    uint32_t    rail_up_ms; // first rail up -> all rails up
+    uint64_t    start_ts;   // power on (epoch ms)
+    uint64_t    end_ts;     // result commit (epoch ms)
+
+    result_item_t   item [RESULT_ITEM_MAX];
+    char            err  [RESULT_ERR_MAX][RESULT_ERR_SIZE];
+
+    uint8_t         wave_cnt;   // waveform rail 수 (0 = capture 없음)
+    uint16_t        wave_size;
+    uint8_t         wave [RESULT_WAVE_SIZE];
+}   result_rec_t;
+
+//------------------------------------------------------------------------------
+// file format : record = [hdr][section]...[section]
+//               section = [tag, cnt, size][data], crc32 = section data 전체
+//------------------------------------------------------------------------------
+#define RESULT_REC_MAGIC    0x5352474A  // "JGRS"
+
+enum {
+    eRESULT_TAG_HEAD = 1,
+    eRESULT_TAG_ITEM,
+    eRESULT_TAG_ERR,
+    eRESULT_TAG_WAVE,
+    eRESULT_TAG_END
+};
+
+typedef struct result_hdr__t {
+    uint32_t    magic;
+    uint32_t    size;       // section total size
+    uint32_t    crc;
+    uint32_t    seq;
+}   result_hdr_t;
+
+typedef struct result_sec__t {
+    uint16_t    tag;
+    uint16_t    cnt;
+    uint32_t    size;
+}   result_sec_t;
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+extern  uint64_t result_mac_key     (const char *mac);
+extern  int     result_store_init   (const char *fname);
+extern  int     result_store_count  (void);
+extern  int     result_store_find_mac   (const char *mac, result_rec_t *prec, int max);
+extern  int     result_store_find_time  (uint64_t from, uint64_t to, result_rec_t *prec, int max);
+
+extern  void    result_begin    (result_rec_t *prec, int ch);
+extern  void    result_item     (result_rec_t *prec, int gid, int did, char status,
+                                    const char *value, uint32_t elapsed_ms);
+extern  void    result_error    (result_rec_t *prec, const char *err);
+extern  void    result_commit   (result_rec_t *prec, char result);
+
+//------------------------------------------------------------------------------
+#endif  // __RESULT_STORE_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
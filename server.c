@@ -42,40 +42,70 @@
 
 //------------------------------------------------------------------------------
 #include "server.h"
+#include "log_ring.h"
+#include "mono_time.h"
+#include "protocol_v3.h"
 
 //------------------------------------------------------------------------------
 // device_check.c
 //------------------------------------------------------------------------------
 extern int  device_resp_parse   (const char *resp, parse_resp_data_t *pdata);
-extern int  device_resp_check   (server_t *p, int fd, parse_resp_data_t *pdata);
+extern int  device_resp_check   (server_t *p, int fd, parse_resp_data_t *pdata,
+                                    pthread_mutex_t *adc_mutex);
 
 //------------------------------------------------------------------------------
-static int  get_board_ip        (char *ip_addr);
-static int  channel_power_status(channel_t *pch);
+static int  get_board_ip        (char *ip_addr, int retry_cnt);
+static int  channel_power_status(channel_t *pch, int nch);
+static void channel_result      (channel_t *pch, char result);
+static void status_page_update  (server_t *p, int nch);
+static void channel_power_update(server_t *p, int nch);
+static void channel_start       (server_t *p, int nch);
+static void channel_power_event (server_t *p);
 static void channel_ui_update   (server_t *p);
 static void *thread_ui_func     (void *arg);
-static int  find_ditem_uid      (server_t *p, int ui_id, int *pos);
-static int  find_ditem_pos      (server_t *p, int gid, int did);
+static void channel_error       (channel_t *pch, int nch, const char *msg, int status);
+static int  channel_item        (server_t *p, int nch, parse_resp_data_t *pitem, int seq);
+static void channel_batch       (server_t *p, int nch, int seq);
 static void protocol_parse      (server_t *p, int nch);
+static void channel_retest      (server_t *p, int nch);
+static void channel_plan        (server_t *p, int nch);
+static void channel_sched       (server_t *p, int nch);
+static int  channel_stop        (server_t *p, int nch);
+static int  channel_print_err   (server_t *p, int nch);
+static int  channel_print_mac   (server_t *p, int nch);
+static int  channel_request     (server_t *p, int nch, int pos);
 static void ts_event_check      (server_t *p, int ui_id);
+static int  ctl_request         (void *arg, const ctl_req_t *req, char *buf, int size);
 
 //------------------------------------------------------------------------------
 volatile int SystemCheckReady = 0, RunningTime = DEFAULT_RUNING_TIME;
 volatile int UIStatus = eSTATUS_WAIT;
 
 pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+/* ui thread 가 fb/ui, item table 을 사용하는 동안 잡음 (main loop 에서 교체할때 같이 잡음) */
+pthread_mutex_t ui_mutex = PTHREAD_MUTEX_INITIALIZER;
 pthread_t thread_ui;
 pthread_t thread_check;
 
+/* ui blink 위상 (timer wheel 주기 timer, ui tick 마다 toggle 하지 않음) */
+static tw_timer_t   BlinkTmr;
+static volatile int Blink = 0;
+
+/* control api (status, event) channel 상태 이름 */
+static const char *CtlStatusName [eSTATUS_END] = { "stop", "wait", "run", "print", "err" };
+
+//------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
+// retry_cnt = 0 : 대기 없이 1회만 확인 (main loop, control api)
 //------------------------------------------------------------------------------
-static int get_board_ip (char *ip_addr)
+static int get_board_ip (char *ip_addr, int retry_cnt)
 {
-    int fd, retry_cnt = 100;
+    int fd, delay_us = retry_cnt ? 100 * 1000 : 0;
     struct ifreq ifr;
 
 retry:
-    usleep (100 * 1000);    // 100ms delay
+    if (delay_us)
+        usleep (delay_us);  // 100ms delay
     /* this entire function is almost copied from ethtool source code */
     /* Open control socket. */
     if ((fd = socket(AF_INET, SOCK_DGRAM, 0)) < 0)
@@ -94,37 +124,191 @@ retry:
     inet_ntop(AF_INET, ifr.ifr_addr.sa_data+2, ip_addr, sizeof(struct sockaddr));
     printf ("%s : ip_address = %s\n", __func__, ip_addr);
 
+    close(fd);
     return 1;
 }
 
 //------------------------------------------------------------------------------
-static int channel_power_status (channel_t *pch)
+// board insert 상태 (power_mon.c 에서 rail 을 계속 읽고 debounce 한 결과)
+//------------------------------------------------------------------------------
+static int channel_power_status (channel_t *pch, int nch)
 {
-    int pin, i, retry = 2;
+    if (power_mon_state (nch))  return 1;
 
-retry:
-    for (i = 0; i < pch->pw_item_cnt; i++) {
-        pthread_mutex_lock   (&mutex);
-        adc_board_read (pch->i2c_fd,
-            pch->pw_item[i].cname, &pch->pw_item[i].read_mV, &pin);
-        pthread_mutex_unlock (&mutex);
-        if (pch->pw_item[i].read_mV < pch->pw_item[i].check_mV)   {
-            if (retry--) { usleep (FUNC_LOOP_DELAY);   goto retry;  }
+    pch->ready = 0;
+    return 0;
+}
 
-            pch->ready = 0;
-            return 0;
+//------------------------------------------------------------------------------
+// timer thread : ready(R) 없이 UART_WAIT_MS 경과 (다음 ui tick 에서 ERR 표시)
+static void channel_ready_timeout (tw_timer_t *t)
+{
+    channel_t *pch = (channel_t *)t->arg;
+
+    if (!pch->ready)    pch->ready_wait = 0;
+}
+
+//------------------------------------------------------------------------------
+static void ui_blink_func (tw_timer_t *t)
+{
+    Blink = !Blink;
+    (void)t;
+}
+
+//------------------------------------------------------------------------------
+static void channel_result (channel_t *pch, char result)
+{
+    pch->board_cnt++;
+    if (result == eRESULT_PASS) pch->pass_cnt++;
+    else                        pch->fail_cnt++;
+
+    /* power-up waveform (power_mon thread capture) 을 result 에 같이 저장 */
+    wave_attach   (pch->result.ch, &pch->result, pch->power_ms * 1000);
+    result_commit (&pch->result, result);
+    trace_commit  (pch->result.ch, pch->result.mac, result);
+
+    {
+        char mac [DEVICE_RESP_SIZE * 2];
+
+        ctl_event (CTL_EV_RESULT,
+            "\"event\":\"result\",\"ch\":%d,\"mac\":\"%s\",\"result\":\"%c\",\"test_ms\":%u",
+            pch->result.ch, ctl_json_str (mac, sizeof(mac), pch->mac), result,
+            pch->result.test_ms);
+    }
+}
+
+//------------------------------------------------------------------------------
+// channel 상태를 shared memory status page 로 복사 (seqlock)
+//------------------------------------------------------------------------------
+static void status_page_update (server_t *p, int nch)
+{
+    channel_t *pch = &p->ch[nch];
+    status_page_t *page;
+    status_ch_t *sch;
+    int status = pch->status;
+
+    if (nch >= STATUS_CH_MAX)                       return;
+    /*
+     * control api status event (상태가 바뀐 경우만).
+     * ui thread 와 main loop 모두 호출하므로 exchange 로 한쪽만 event 전송.
+     */
+    if (__atomic_exchange_n (&pch->last_status, status + 1, __ATOMIC_ACQ_REL) != status + 1)
+        ctl_event (CTL_EV_STATUS, "\"event\":\"status\",\"ch\":%d,\"status\":\"%s\",\"ready\":%d",
+            nch, CtlStatusName[status], pch->ready);
+    if ((page = status_shm_begin ()) == NULL)       return;
+
+    sch = &page->ch[nch];
+    sch->status   = pch->status;
+    sch->ready    = pch->ready;
+    sch->power    = (pch->status != eSTATUS_STOP);
+    sch->mac_dup  = pch->mac_dup;
+    sch->cur_gid  = pch->last_item.gid;
+    sch->cur_did  = pch->last_item.did;
+    sch->item_cnt = p->d_item_cnt;
+    sch->err_cnt  = pch->err_cnt;
+    strncpy (sch->cur_value, pch->last_item.resp_s, STATUS_STR_SIZE -1);
+    strncpy (sch->mac,       pch->mac,              STATUS_STR_SIZE -1);
+    memcpy  (sch->pass_map,  pch->pass_map, sizeof(sch->pass_map));
+    memcpy  (sch->fail_map,  pch->fail_map, sizeof(sch->fail_map));
+    sch->board_cnt = pch->board_cnt;
+    sch->pass_cnt  = pch->pass_cnt;
+    sch->fail_cnt  = pch->fail_cnt;
+    sch->update_ms = real_ms ();
+
+    strncpy (page->ip_addr, p->ip_addr, STATUS_STR_SIZE -1);
+    page->usblp_status = p->usblp_status;
+    status_shm_end ();
+}
+
+//------------------------------------------------------------------------------
+// board insert/remove 반영 (ui tick 또는 power_mon event)
+//------------------------------------------------------------------------------
+static void channel_power_update (server_t *p, int nch)
+{
+    channel_t *pch = &p->ch[nch];
+    int uid = nch ? p->u_item[eUID_STATUS_R] : p->u_item[eUID_STATUS_L];
+
+    if (channel_power_status (pch, nch)) {
+        // channel power ui
+        ui_set_ritem (p->pfb, p->pui,
+            nch ? p->u_item[eUID_CH_R] : p->u_item[eUID_CH_L],
+            COLOR_GREEN, -1);
+        if (pch->status == eSTATUS_STOP)
+            pch->status = eSTATUS_WAIT;
+    }
+    else {
+        // channel power ui
+        ui_set_ritem (p->pfb, p->pui,
+            nch ? p->u_item[eUID_CH_R] : p->u_item[eUID_CH_L],
+            COLOR_DIM_GRAY, -1);
+
+        if (pch->status != eSTATUS_STOP) {
+            /* board removed before test complete */
+            if (pch->status == eSTATUS_RUN)
+                channel_result (pch, eRESULT_ABORT);
+            ui_set_ritem (p->pfb, p->pui, uid, p->pui->bc.uint, -1);
+            ui_set_sitem (p->pfb, p->pui, uid, -1, -1, "WAIT");
         }
+        pch->status = eSTATUS_STOP;
+    }
+}
+
+//------------------------------------------------------------------------------
+// board insert : channel 초기화 후 RUN (ready 대기)
+//------------------------------------------------------------------------------
+static void channel_start (server_t *p, int nch)
+{
+    channel_t *pch = &p->ch[nch];
+    int uid = nch ? p->u_item[eUID_STATUS_R] : p->u_item[eUID_STATUS_L];
+    power_ch_t pw;
+
+    pch->status = eSTATUS_RUN;
+    pch->err_cnt = 0;
+    pch->ready_wait = 1;
+    tw_arm (&pch->ready_tmr, UART_WAIT_MS);
+    pch->mac_dup  = 0;
+    memset (pch->pass_map,   0, sizeof(pch->pass_map));
+    memset (pch->fail_map,   0, sizeof(pch->fail_map));
+    memset (&pch->last_item, 0, sizeof(pch->last_item));
+    result_begin (&pch->result, nch);
+    trace_begin  (nch);
+    pch->req_pos  = -1;
+
+    /* power on time = 처음 rail 이 올라온 시각 (debounce 시간 제외) */
+    pch->power_ms = mono_ms ();
+    if (power_mon_info (nch, &pw) && pw.first_up_us) {
+        pch->power_ms = pw.first_up_us / 1000;
+        pch->result.rail_up_ms = (uint32_t)((pw.all_up_us - pw.first_up_us) / 1000);
+    }
+    ui_update_group (p->pfb, p->pui, nch +1);
+    ui_set_sitem (p->pfb, p->pui, uid, -1, -1, "WAIT");
+}
+
+//------------------------------------------------------------------------------
+// power_mon event : 다음 ui tick 을 기다리지 않고 insert/remove 처리
+//------------------------------------------------------------------------------
+static void channel_power_event (server_t *p)
+{
+    channel_t *pch;
+    int nch;
+
+    for (nch = 0; nch < p->ch_cnt; nch ++) {
+        pch = &p->ch[nch];
+        if ((pch->i2c_fd == -1) || (pch->puart == NULL))    continue;
+
+        channel_power_update (p, nch);
+        if (pch->status == eSTATUS_WAIT)
+            channel_start (p, nch);
+        status_page_update (p, nch);
     }
-    return 1;
 }
+
 //------------------------------------------------------------------------------
 static void channel_ui_update (server_t *p)
 {
     channel_t *pch;
-    int nch, uid;
-    static int onoff = 0;
+    int nch, uid, onoff = Blink;
 
-    onoff = !onoff;
     for (nch = 0; nch < p->ch_cnt; nch ++) {
         pch = &p->ch[nch];
         uid = nch ? p->u_item[eUID_STATUS_R] : p->u_item[eUID_STATUS_L];
@@ -147,50 +331,37 @@ static void channel_ui_update (server_t *p)
             continue;
         }
 
-        if (channel_power_status (pch)) {
-            // channel power ui
-            ui_set_ritem (p->pfb, p->pui,
-                nch ? p->u_item[eUID_CH_R] : p->u_item[eUID_CH_L],
-                COLOR_GREEN, -1);
-            if (pch->status == eSTATUS_STOP)
-                pch->status = eSTATUS_WAIT;
-        }
-        else {
-            // channel power ui
-            ui_set_ritem (p->pfb, p->pui,
-                nch ? p->u_item[eUID_CH_R] : p->u_item[eUID_CH_L],
-                COLOR_DIM_GRAY, -1);
-
-            if (pch->status != eSTATUS_STOP) {
-                ui_set_ritem (p->pfb, p->pui, uid, p->pui->bc.uint, -1);
-                ui_set_sitem (p->pfb, p->pui, uid, -1, -1, "WAIT");
-            }
-            pch->status = eSTATUS_STOP;
-        }
+        channel_power_update (p, nch);
 
         switch (pch->status) {
             case eSTATUS_STOP:
                 break;
             case eSTATUS_WAIT:
-                pch->status = eSTATUS_RUN;
-                pch->err_cnt = 0;
-                pch->ready_wait = UART_WAIT_TIME;
-                ui_update_group (p->pfb, p->pui, nch +1);
-                ui_set_sitem (p->pfb, p->pui, uid, -1, -1, "WAIT");
+                channel_start (p, nch);
                 break;
             case eSTATUS_RUN:
-                if (!pch->ready)    pch->ready_wait--;
-                if (pch->ready_wait) {
+                if (pch->mac_dup) {
+                    ui_set_ritem (p->pfb, p->pui, uid,
+                        onoff ? DUP_BOX_ON : DUP_BOX_OFF, -1);
+                    ui_set_sitem (p->pfb, p->pui, uid, -1, -1, "E: DUP MAC");
+                } else if (pch->ready_wait) {
                     ui_set_ritem (p->pfb, p->pui, uid,
                         onoff ? RUN_BOX_ON : RUN_BOX_OFF, -1);
                     ui_set_sitem (p->pfb, p->pui, uid, -1, -1, "RUNNING");
                 } else {
                     pch->status = eSTATUS_ERR;
+                    metrics_count (nch, eCNT_READY_TIMEOUT, 1);
+                    channel_result (pch, eRESULT_TIMEOUT);
                     if (p->usblp_status)
-                        usblp_print_err ("uart", "", "", nch);
+                        spool_print_err ("uart", 0, 1, nch);
                 }
                 break;
             case eSTATUS_PRINT:
+                if (pch->mac_dup) {
+                    ui_set_ritem (p->pfb, p->pui, uid, DUP_BOX_ON, -1);
+                    ui_set_sitem (p->pfb, p->pui, uid, -1, -1, "E: DUP MAC");
+                    break;
+                }
                 ui_set_ritem (p->pfb, p->pui, uid,
                             pch->err_cnt ? COLOR_RED : COLOR_GREEN, -1);
                 ui_set_sitem (p->pfb, p->pui, uid, -1, -1, "FINISH");
@@ -200,20 +371,23 @@ static void channel_ui_update (server_t *p)
                 ui_set_sitem (p->pfb, p->pui, uid, -1, -1, "E: UART(C)");
                 break;
         }
+        status_page_update (p, nch);
     }
 }
 
 //------------------------------------------------------------------------------
 static void *thread_ui_func (void *arg)
 {
-    static int onoff = 0, system_reset_count = 3;
+    static int system_reset_count = SYSTEM_RESET_COUNT;
+    int onoff;
     server_t *p = (server_t *)arg;
 
     memset (p->ip_addr, 0, sizeof(p->ip_addr));
-    get_board_ip(p->ip_addr);
+    get_board_ip(p->ip_addr, 100);
 
     while (1) {
-        onoff = !onoff;
+        pthread_mutex_lock (&ui_mutex);
+        onoff = Blink;
         ui_set_ritem (p->pfb, p->pui, p->u_item[eUID_ALIVE],
                     onoff ? COLOR_GREEN : p->pui->bc.uint, -1);
         ui_set_sitem (p->pfb, p->pui, p->u_item[eUID_ALIVE],
@@ -231,7 +405,7 @@ static void *thread_ui_func (void *arg)
         }
 
         if (onoff)  {
-            p->usblp_status = usblp_connection();
+            p->usblp_status = hw_usblp_connection ();
             ui_update (p->pfb, p->pui, -1);
         }
 
@@ -239,54 +413,219 @@ static void *thread_ui_func (void *arg)
         {
             if (p->ts_reset_gpio != -1) {
                 int bt_status = 0;
-                if (gpio_get_value(p->ts_reset_gpio, &bt_status))
+                if (hw_gpio_get_value (p->ts_reset_gpio, &bt_status))
                 if (bt_status == p->ts_reset_level)  {
                     ui_set_ritem (p->pfb, p->pui, p->u_item[eUID_ALIVE],
                                 onoff ? COLOR_PINK : p->pui->bc.uint, -1);
 
-                    ts_reinit (p);
-
-                    // system restart??
-                    if (system_reset_count)
+                    /*
+                        touch 는 main loop 에서 다시 초기화 (tick 마다),
+                        계속 누르고 있으면 fb/ui, printer, uart 중 문제 있는 것만 다시 초기화 (channel 상태 유지),
+                        그 후에도 계속 누르고 있으면 process 재시작 (systemd)
+                    */
+                    if (system_reset_count > SYSTEM_RESET_SOFT) {
+                        soft_restart_request (SOFT_RESTART_TS);
+                        printf ("%s : SYSTEM Restart remain count %d\n", __func__, system_reset_count--);
+                    } else if (system_reset_count == SYSTEM_RESET_SOFT) {
+                        soft_restart_request (SOFT_RESTART_ALL);
+                        printf ("%s : SYSTEM Soft Restart...!!\n", __func__);
+                        system_reset_count--;
+                    } else if (system_reset_count)
                         printf ("%s : SYSTEM Restart remain count %d\n", __func__, system_reset_count--);
                     else {
                         printf ("%s : SYSTEM Restart...!!\n", __func__);
                         exit(0);
                     }
                 }
-                else system_reset_count = 3;
+                else system_reset_count = SYSTEM_RESET_COUNT;
             }
             ui_set_ritem (p->pfb, p->pui, p->u_item[eUID_USBLP],
                 p->usblp_status ? COLOR_GREEN : COLOR_DIM_GRAY, -1);
+
+            /* print spool queue depth (출력 대기 job 이 없으면 기본 문자열) */
+            {
+                char lp_str[STR_NAME_LENGTH];
+                int depth = spool_depth ();
+
+                memset (lp_str, 0, sizeof(lp_str));
+                if (depth)  sprintf (lp_str, "LP Q%d", depth);
+                ui_set_sitem (p->pfb, p->pui, p->u_item[eUID_USBLP],
+                    depth ? COLOR_GOLD : -1, -1,
+                    depth ? lp_str : p->pui->b_item[p->u_item[eUID_USBLP]].s_dfl);
+            }
+        }
+        pthread_mutex_unlock (&ui_mutex);
+
+        /* 다음 blink 까지 대기 (ui tick), 대기 중 board insert/remove event 는 바로 처리 */
+        {
+            int64_t remain;
+
+            while (Blink == onoff) {
+                remain = (int64_t)(tw_expires (&BlinkTmr) * 1000 - mono_us ());
+                if (remain < 1000)  remain = 1000;
+                if (power_mon_wait (remain)) {
+                    pthread_mutex_lock   (&ui_mutex);
+                    channel_power_event  (p);
+                    pthread_mutex_unlock (&ui_mutex);
+                }
+            }
         }
-        usleep (UPDATE_UI_DELAY);
     }
     return arg;
 }
 
 //------------------------------------------------------------------------------
+// client error msg (E) 한줄 저장 (label 출력, result)
+//------------------------------------------------------------------------------
+static void channel_error (channel_t *pch, int nch, const char *msg, int status)
+{
+    if (pch->err_cnt >= USBLP_ERR_LINE)     return;
+    memset  (&pch->err_msg [pch->err_cnt][0], 0, USBLP_MAX_CHAR);
+    strncpy (&pch->err_msg [pch->err_cnt][0], msg, strlen(msg));
+    pch->err_cnt++;
+    result_error (&pch->result, msg);
+    trace_span   (nch, eTRACE_ERROR, -1, -1, mono_us (), mono_us ());
+    LOG_EVENT (nch, eLOG_PARSE_ERR, msg, status);
+}
+
+//------------------------------------------------------------------------------
+// 숫자 결과값 spc update (string item 제외), return 1 = drift
 //------------------------------------------------------------------------------
-static int find_ditem_uid (server_t *p, int ui_id, int *pos)
+static int channel_spc (server_t *p, int nch, int pos, parse_resp_data_t *pitem)
 {
-    int i = 0;
-    for (i = 0; i < p->d_item_cnt; i++) {
-        *pos = i;
-        if (p->d_item[i].uid_l == ui_id)    return 0;
-        if (p->d_item[i].uid_r == ui_id)    return 1;
+    char *end;
+    double value;
+
+    if (p->d_item[pos].is_str)  return 0;
+
+    value = strtod (pitem->resp_s, &end);
+    if ((end == pitem->resp_s) || (*end && !isspace (*end)) || (value != value))
+        return 0;
+
+    return spc_update (nch, pitem->gid, pitem->did, value,
+                        find_qitem (p, pitem->gid, pitem->did), NULL);
+}
+
+//------------------------------------------------------------------------------
+// item status (S) 처리 : ui, check, result, pass/fail map. return check trace idx
+//------------------------------------------------------------------------------
+static int channel_item (server_t *p, int nch, parse_resp_data_t *pitem, int seq)
+{
+    channel_t *pch = &p->ch[nch];
+    int pos = find_ditem_pos (p, pitem->gid, pitem->did);
+    int uid = nch ? p->d_item[pos].uid_r : p->d_item[pos].uid_l;
+    int tidx = -1;
+    uint64_t now_us = mono_us ();
+    ptc_req_t req;
+
+    metrics_item_observe (nch, eHIST_ITEM, pos, pitem->gid, pitem->did,
+                            now_us - pch->frame_us);
+    metrics_item_reply   (nch, pos, pitem->gid, pitem->did);
+    trace_span (nch, eTRACE_ITEM, pitem->gid, pitem->did, pch->frame_us, now_us);
+    if (protocol_seq_reply (&pch->seq, seq, pitem->gid, pitem->did, &req)) {
+        trace_span  (nch, eTRACE_REQUEST, pitem->gid, pitem->did, req.req_us, now_us);
+        /* plan channel : grant 부터 응답 까지 = item 시간 */
+        sched_reply (nch, pitem->gid, pitem->did, (uint32_t)(now_us - req.req_us));
+    } else if (pch->req_pos == pos) {
+        trace_span (nch, eTRACE_REQUEST, pitem->gid, pitem->did, pch->req_us, now_us);
+        pch->req_pos = -1;
+    }
+
+    if (p->d_item[pos].is_str)
+        ui_set_sitem (p->pfb, p->pui, uid, -1, -1, pitem->resp_s);
+
+    if (pitem->status_c != 'C') {
+        /* pass 이지만 drift 인 item 은 fail 전에 표시 */
+        int drift = channel_spc (p, nch, pos, pitem);
+
+        ui_set_ritem (p->pfb, p->pui, uid,
+                    (pitem->status_i != 1) ? COLOR_RED : (drift ? DRIFT_BOX : COLOR_GREEN), -1);
+    } else {
+        ui_set_ritem (p->pfb, p->pui, uid, COLOR_YELLOW, -1);
+
+        tidx = trace_span_begin (nch, eTRACE_CHECK, pitem->gid, pitem->did);
+        pthread_mutex_lock   (&mutex);
+        device_resp_check (p, pch->i2c_fd, pitem, &mutex);
+        pthread_mutex_unlock (&mutex);
+        metrics_item_observe (nch, eHIST_ITEM_CHECK, pos,
+                    pitem->gid, pitem->did, mono_us () - now_us);
+        /* server 측정값 (adc, iperf) 도 spc 누적 */
+        if (channel_spc (p, nch, pos, pitem))
+            ui_set_ritem (p->pfb, p->pui, uid, DRIFT_BOX, -1);
+    }
+    pch->frame_us = mono_us ();
+    result_item (&pch->result, pitem->gid, pitem->did, pitem->status_c,
+        pitem->resp_s, (uint32_t)(mono_ms () - pch->ready_ms));
+    {
+        char value [DEVICE_RESP_SIZE * 2];
+
+        ctl_event (CTL_EV_ITEM,
+            "\"event\":\"item\",\"ch\":%d,\"gid\":%d,\"did\":%d,\"status\":\"%c\",\"value\":\"%s\"",
+            nch, pitem->gid, pitem->did, pitem->status_c,
+            ctl_json_str (value, sizeof(value), pitem->resp_s));
     }
-    return -1;
+
+    /* status page pass/fail bitmap */
+    if (pos < STATUS_ITEM_MAX) {
+        uint64_t bit = 1ull << (pos % 64);
+
+        pch->pass_map[pos / 64] &= ~bit;
+        pch->fail_map[pos / 64] &= ~bit;
+        if (pitem->status_c == 'P')  pch->pass_map[pos / 64] |= bit;
+        if (pitem->status_c == 'F')  pch->fail_map[pos / 64] |= bit;
+    }
+    pch->last_item = *pitem;
+    return tidx;
 }
 
 //------------------------------------------------------------------------------
-static int find_ditem_pos (server_t *p, int gid, int did)
+// v3 batch (N) : record 전체를 한번에 처리 후 bitmap A 하나로 응답
+// check(C) item 은 server 측정값을 응답해야 하므로 처리하지 않음 (client 가 S 로 다시 전송)
+//------------------------------------------------------------------------------
+static void channel_batch (server_t *p, int nch, int seq)
 {
-    int i;
+    channel_t *pch = &p->ch[nch];
+    ptc_batch_t batch [PTC_V3_BATCH_MAX];
+    parse_resp_data_t pitem;
+    uint8_t bitmap [PTC_V3_BATCH_BITMAP];
+    const char *payload;
+    int i, pos, len, cnt, done = 0;
+
+    if ((payload = protocol_payload (pch->puart, &len)) == NULL)    return;
 
-    for (i = 0; i < p->d_item_cnt; i++) {
-        if ((p->d_item[i].gid == gid) && (p->d_item[i].did == did))
-            return i;
+    cnt = ptc_v3_batch_get ((const uint8_t *)payload, len, batch, PTC_V3_BATCH_MAX);
+    if (cnt < 0) {
+        metrics_count (nch, eCNT_PARSE_FAIL, 1);
+        LOG_EVENT (nch, eLOG_BATCH, "", seq, -1, 0);
+        return;
     }
-    return 0;
+
+    memset (bitmap, 0, sizeof(bitmap));
+    for (i = 0; i < cnt; i++) {
+        pos = find_ditem_pos (p, batch[i].gid, batch[i].did);
+        if ((batch[i].status == 'C') ||
+            (p->d_item[pos].gid != batch[i].gid) || (p->d_item[pos].did != batch[i].did))
+            continue;
+
+        memset (&pitem, 0, sizeof(pitem));
+        pitem.cmd      = RESP_CMD_STATUS;
+        pitem.gid      = batch[i].gid;
+        pitem.did      = batch[i].did;
+        pitem.status_c = batch[i].status;
+        pitem.status_i = (batch[i].status == 'P') ? 1 : 0;
+        strncpy (pitem.resp_s, batch[i].value, PTC_V3_BATCH_VALUE);
+        pitem.resp_i   = atoi (pitem.resp_s);
+
+        /* batch 는 client 가 보내는 status, server 요청(R) 응답은 기존 S 로 받음 */
+        channel_item (p, nch, &pitem, 0);
+        bitmap[i / 8] |= 1 << (i % 8);
+        done++;
+    }
+    metrics_count (nch, eCNT_BATCH_ITEM, done);
+    LOG_EVENT (nch, eLOG_BATCH, "", seq, cnt, done);
+
+    protocol_v3_tx (pch->puart, RESP_CMD_ACK, (done == cnt) ? 'P' : 'F', -1, -1, seq,
+                    bitmap, (cnt + 7) / 8);
 }
 
 //------------------------------------------------------------------------------
@@ -297,158 +636,488 @@ static void protocol_parse (server_t *p, int nch)
     channel_t *pch = &p->ch[nch];
 
     char *rx_msg = (char *)pch->rx_msg;
-    char serial_resp[SERIAL_RESP_SIZE], resp [DEVICE_RESP_SIZE];
+    char serial_resp[SERIAL_RESP_SIZE +1], resp [DEVICE_RESP_SIZE +1];
+    char value [DEVICE_RESP_SIZE +1];
+    int tidx = -1, seq = 0, len, version = 0;
 
-    if (!device_resp_parse (rx_msg, &pitem))    return;
+    if (!device_resp_parse (rx_msg, &pitem)) {
+        metrics_count (nch, eCNT_PARSE_FAIL, 1);
+        return;
+    }
 
     if (pch->status == eSTATUS_ERR)             return;
 
+    /* sequence id 협상된 channel : value 앞의 "nnn:" 분리 */
+    if (pch->seq.window && (pitem.cmd != 'R')) {
+        seq = protocol_seq_strip (pitem.resp_s);
+        pitem.resp_i = atoi (pitem.resp_s);
+    }
+
     switch (pitem.cmd) {
         /* Device Ready received */
         case 'R':
-            /* Server System Ready send */
-            SERIAL_RESP_FORM(serial_resp, 'O', -1, -1, NULL);
+            /* Server System Ready send (client 가 요청하면 sequence id 사용) */
+            pch->seq.ch = nch;
+            if (protocol_seq_ready (&pch->seq, pitem.resp_s, resp))
+                SERIAL_RESP_FORM(serial_resp, 'O', -1, -1, resp);
+            else
+                SERIAL_RESP_FORM(serial_resp, 'O', -1, -1, NULL);
+            /* okay(O) 는 현재 version 으로 전송 후 협상된 version 으로 변경 */
+            version = pch->seq.window ? pch->seq.version : PROTOCOL_V2;
+            pch->req_pos = -1;
             ui_update_group (p->pfb, p->pui, nch +1);
 
             memset (pch->err_msg, 0, sizeof(pch->err_msg));
             pch->err_cnt = 0;
+
+            /* client restart : test item 결과 초기화 */
+            pch->ready_ms = mono_ms ();
+            pch->frame_us = mono_us ();
+            metrics_observe (nch, eHIST_READY, (pch->ready_ms - pch->power_ms) * 1000);
+            trace_span (nch, eTRACE_BOOT, -1, -1, pch->power_ms * 1000, pch->frame_us);
+            tidx = trace_span_begin (nch, eTRACE_READY, -1, -1);
+            pch->result.item_cnt = 0;
+            pch->result.err_cnt  = 0;
+            memset (pch->pass_map, 0, sizeof(pch->pass_map));
+            memset (pch->fail_map, 0, sizeof(pch->fail_map));
+            pch->result.ready_ms = (uint32_t)(pch->ready_ms - pch->power_ms);
             if (pch->ready_wait) {
                 pch->ready = 1;
                 pch->status  = eSTATUS_RUN;
+                tw_cancel (&pch->ready_tmr);
             }
+            /* plan channel : item 순서는 server scheduler (main loop, channel_sched) */
+            if (pch->seq.plan && (pch->status == eSTATUS_RUN))
+                channel_plan (p, nch);
             break;
         /* Device status received */
         case 'S':
-            {
-                int pos = find_ditem_pos (p, pitem.gid, pitem.did);
-                int uid = nch ? p->d_item[pos].uid_r : p->d_item[pos].uid_l;
-
-                if (p->d_item[pos].is_str)
-                    ui_set_sitem (p->pfb, p->pui, uid, -1, -1, pitem.resp_s);
-
-                if (pitem.status_c != 'C') {
-                    ui_set_ritem (p->pfb, p->pui, uid,
-                                (pitem.status_i == 1) ? COLOR_GREEN : COLOR_RED, -1);
-                } else {
-                    ui_set_ritem (p->pfb, p->pui, uid, COLOR_YELLOW, -1);
-
-                    pthread_mutex_lock   (&mutex);
-                    device_resp_check (p, pch->i2c_fd, &pitem);
-                    pthread_mutex_unlock (&mutex);
-                }
-            }
-            DEVICE_RESP_FORM_STR(resp, pitem.status_c, pitem.resp_s);
+            tidx = channel_item (p, nch, &pitem, seq);
+            /* 응답(A/C) 은 status(S) 와 같은 seq */
+            if (seq)    protocol_seq_value (value, seq, pitem.resp_s);
+            else        strcpy (value, pitem.resp_s);
+            DEVICE_RESP_FORM_STR(resp, pitem.status_c, value);
             SERIAL_RESP_FORM(serial_resp, (pitem.cmd == 'S') ? 'A' : 'C',
                                             pitem.gid, pitem.did, resp);
             break;
+        case RESP_CMD_BATCH:    // v3 batch status
+            channel_batch (p, nch, seq);
+            return;
         case 'M':   // mac print
+            /* plan channel : M = plan:done ack */
+            if (pch->seq.plan)
+                sched_done_ack (nch);
             memset  (pch->mac, 0, DEVICE_RESP_SIZE);
             strncpy (pch->mac, pitem.resp_s, strlen(pitem.resp_s));
-            printf ("%s : MAC Addr = %s\n", __func__, pch->mac);
+            strncpy (pch->result.mac, pch->mac, RESULT_MAC_SIZE -1);
+            LOG_EVENT (nch, eLOG_PARSE_MAC, pch->mac);
+
+            /* duplicate mac : label print 하지 않음 (MAC touch 로 재출력 가능) */
+            {
+                mac_slot_t slot;
+
+                if (mac_index_check (pch->mac, &slot) == 1) {
+                    int uid = nch ? p->u_item[eUID_STATUS_R] : p->u_item[eUID_STATUS_L];
+
+                    pch->mac_dup = 1;
+                    LOG_EVENT (nch, eLOG_MAC_DUP, pch->mac,
+                                (int)slot.first_ts, (int)slot.count);
+                    ui_set_ritem (p->pfb, p->pui, uid, DUP_BOX_ON, -1);
+                    ui_set_sitem (p->pfb, p->pui, uid, -1, -1, "E: DUP MAC");
+                    return;
+                }
+            }
+            tidx = trace_span_begin (nch, eTRACE_MAC, -1, -1);
             if (p->usblp_status && (pch->status == eSTATUS_RUN))
-                usblp_print_mac (pch->mac, nch);
+                spool_print_mac (pch->mac, nch);
+            trace_span_end (nch, tidx);
             return;
         case 'E':   // error msg
-            memset  (&pch->err_msg [pch->err_cnt][0], 0, USBLP_MAX_CHAR);
-            strncpy (&pch->err_msg [pch->err_cnt][0], pitem.resp_s, strlen(pitem.resp_s));
-            pch->err_cnt++;
-            printf ("%s : Err Msg(%i) = %s\n", __func__,  pitem.status_i, pitem.resp_s);
+            {
+                const char *msg = protocol_payload (pch->puart, &len);
+                int pos;
+
+                /* v3 : value 보다 긴 error text 는 label 한줄 단위로 나누어 저장 */
+                if ((msg != NULL) && (len > DEVICE_RESP_SIZE -2)) {
+                    for (pos = 0; pos < len; pos += USBLP_MAX_CHAR -1) {
+                        snprintf (value, USBLP_MAX_CHAR, "%s", msg + pos);
+                        channel_error (pch, nch, value, pitem.status_i);
+                    }
+                    return;
+                }
+            }
+            channel_error (pch, nch, pitem.resp_s, pitem.status_i);
             return;
         case 'X':   // Device test complete
+            if (pch->seq.plan)
+                sched_done_ack (nch);
+            if (pch->status == eSTATUS_RUN) {
+                int i, fail = pch->err_cnt;
+
+                for (i = 0; i < pch->result.item_cnt; i++)
+                    if (pch->result.item[i].status == 'F')  fail++;
+
+                pch->result.test_ms = (uint32_t)(mono_ms () - pch->ready_ms);
+                trace_span (nch, eTRACE_COMPLETE, -1, -1, pch->frame_us, mono_us ());
+                metrics_observe (nch, eHIST_CYCLE, (uint64_t)pch->result.test_ms * 1000);
+                if (pch->seq.plan)
+                    sched_finish (nch, pch->result.test_ms, pch->mac);
+                channel_result (pch, fail ? eRESULT_FAIL : eRESULT_PASS);
+            }
             pch->status = eSTATUS_PRINT;
             return;
         default :
-            printf ("%s : unknown command!! (%c)\n", __func__, pitem.cmd);
+            {
+                char str[2] = { pitem.cmd, 0 };
+                LOG_EVENT (nch, eLOG_PARSE_UNKNOWN, str);
+            }
             return;
     }
     protocol_msg_tx (pch->puart, serial_resp);    protocol_msg_tx (pch->puart, "\r\n");
+    if (version)    protocol_set_version (pch->puart, version);
+
+    /* ready(O), check 응답 전송 까지 server 처리 구간 */
+    trace_span_end (nch, tidx);
 }
 
 //------------------------------------------------------------------------------
-static void ts_event_check (server_t *p, int ui_id)
+// fail item 을 request window 로 한번에 재요청
+//------------------------------------------------------------------------------
+static void channel_retest (server_t *p, int nch)
+{
+    channel_t *pch = &p->ch[nch];
+    int pos, cnt = 0;
+
+    for (pos = 0; (pos < p->d_item_cnt) && (pos < STATUS_ITEM_MAX); pos++) {
+        if (!(pch->fail_map[pos / 64] & (1ull << (pos % 64))))  continue;
+        if (protocol_seq_request (&pch->seq, p->d_item[pos].gid, p->d_item[pos].did, pos))
+            cnt++;
+    }
+    printf ("%s : ch %d, %d fail items requested (window %d)\n",
+        __func__, nch, cnt, pch->seq.window);
+    protocol_seq_poll (&pch->seq, pch->puart, mono_us ());
+}
+
+//------------------------------------------------------------------------------
+// plan channel ready : d_item 전체를 scheduler 에 등록
+//------------------------------------------------------------------------------
+static void channel_plan (server_t *p, int nch)
+{
+    sched_item_t item [SCHED_ITEM_MAX];
+    int pos, cnt;
+
+    for (pos = 0, cnt = 0; (pos < p->d_item_cnt) && (cnt < SCHED_ITEM_MAX); pos++, cnt++) {
+        d_item_t *d = &p->d_item[pos];
+
+        item[cnt].gid = d->gid;
+        item[cnt].did = d->did;
+        item[cnt].pos = pos;
+        item[cnt].res = (d->res < 0) ? SCHED_RES_DEFAULT(d->gid, d->did) : d->res;
+    }
+    sched_start (nch, item, cnt);
+}
+
+//------------------------------------------------------------------------------
+// main loop : plan channel 의 다음 grant 요청, 모든 item 이 끝나면 plan:done 전송 (ack 까지)
+//------------------------------------------------------------------------------
+static void channel_sched (server_t *p, int nch)
+{
+    char serial_resp [SERIAL_RESP_SIZE], resp [DEVICE_RESP_SIZE +1];
+    channel_t *pch = &p->ch[nch];
+    sched_item_t item;
+    int queued;
+
+    if (!pch->seq.plan)     return;
+
+    /* board 제거, test 중단 */
+    if (pch->status != eSTATUS_RUN) {
+        sched_stop (nch);
+        return;
+    }
+    /*
+        request queue 가 full 이라 넣지 못한 grant 는 다시 요청,
+        queue 에 들어간 후 재전송을 포기한 grant (seq_drop) 는 건너뜀
+    */
+    if (sched_granted (nch, &item, &queued) && !protocol_seq_pending (&pch->seq, item.gid, item.did)) {
+        if (queued)
+            sched_drop (nch, item.gid, item.did);
+        else if (protocol_seq_request (&pch->seq, item.gid, item.did, item.pos)) {
+            sched_queued      (nch);
+            protocol_seq_poll (&pch->seq, pch->puart, mono_us ());
+        }
+    }
+
+    if (sched_next (nch, &item) && protocol_seq_request (&pch->seq, item.gid, item.did, item.pos)) {
+        sched_queued      (nch);
+        protocol_seq_poll (&pch->seq, pch->puart, mono_us ());
+    }
+    /* device ack (M, X) 전까지 재전송 */
+    if (sched_done (nch)) {
+        DEVICE_RESP_FORM_STR(resp, 'P', "plan:done");
+        SERIAL_RESP_FORM(serial_resp, 'O', -1, -1, resp);
+        protocol_msg_tx (pch->puart, serial_resp);
+        protocol_msg_tx (pch->puart, "\r\n");
+    }
+}
+
+//------------------------------------------------------------------------------
+// test 중 = X (test 중단), 아니면 E (종료 확인). return 0 = device not ready
+//------------------------------------------------------------------------------
+static int channel_stop (server_t *p, int nch)
 {
     char serial_resp [SERIAL_RESP_SIZE];
-    int pos, nch;
-    channel_t *pch;
+    channel_t *pch = &p->ch[nch];
+
+    if (!pch->ready)    return 0;
 
     memset (serial_resp, 0, sizeof(serial_resp));
+    SERIAL_RESP_FORM(serial_resp, (pch->status != eSTATUS_RUN) ? 'E' : 'X', -1, -1, NULL);
+    protocol_msg_tx (pch->puart, serial_resp);
+    protocol_msg_tx (pch->puart, "\r\n");
+    pch->err_cnt = 0;
+    return 1;
+}
 
-    if ((ui_id == p->u_item[eUID_STATUS_L]) || (ui_id == p->u_item[eUID_STATUS_R])) {
-        pch = (ui_id == p->u_item[eUID_STATUS_L]) ? &p->ch[0] : &p->ch[1];
+//------------------------------------------------------------------------------
+// return 0 = test 중
+//------------------------------------------------------------------------------
+static int channel_print_err (server_t *p, int nch)
+{
+    channel_t *pch = &p->ch[nch];
 
-        if (!pch->ready)    return;
+    if (pch->status == eSTATUS_RUN)     return 0;
 
-        if (pch->status != eSTATUS_RUN) {
-            SERIAL_RESP_FORM(serial_resp, 'E', -1, -1, NULL);
-            protocol_msg_tx (pch->puart, serial_resp);
-            protocol_msg_tx (pch->puart, "\r\n");
-            pch->err_cnt = 0;
-        } else {
-            SERIAL_RESP_FORM(serial_resp, 'X', -1, -1, NULL);
-            protocol_msg_tx (pch->puart, serial_resp);
-            protocol_msg_tx (pch->puart, "\r\n");
-            pch->err_cnt = 0;
-        }
+    if (pch->err_cnt) {
+        /* spooler 에서 3줄씩 label 로 묶어서 출력 */
+        spool_print_err (&pch->err_msg[0][0], USBLP_MAX_CHAR, pch->err_cnt, nch);
+        // Print Err msg L/R
+        printf ("%s : error msg printing... (ch = %d)\n", __func__, nch);
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// return 0 = test 중 또는 error 상태
+//------------------------------------------------------------------------------
+static int channel_print_mac (server_t *p, int nch)
+{
+    channel_t *pch = &p->ch[nch];
+
+    if ((pch->status == eSTATUS_RUN) || (pch->status == eSTATUS_ERR))
+        return 0;
+
+    spool_print_mac (pch->mac, nch);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// d_item[pos] 재요청. return 0 = device not ready
+//------------------------------------------------------------------------------
+static int channel_request (server_t *p, int nch, int pos)
+{
+    char serial_resp [SERIAL_RESP_SIZE];
+    channel_t *pch = &p->ch[nch];
+
+    if (!pch->ready)    {
+        printf ("%s : Device not ready. (ch = %d)\n", __func__, nch);
+        return 0;
+    }
+    /* sequence id 사용 channel : request window 로 전송 (main loop, protocol_seq_poll) */
+    if (protocol_seq_request (&pch->seq, p->d_item[pos].gid, p->d_item[pos].did, pos)) {
+        protocol_seq_poll (&pch->seq, pch->puart, mono_us ());
+        return 1;
+    }
+    memset (serial_resp, 0, sizeof(serial_resp));
+    SERIAL_RESP_FORM(serial_resp, 'R', p->d_item[pos].gid, p->d_item[pos].did, NULL);
+    metrics_item_request (nch, pos);
+    pch->req_us  = mono_us ();
+    pch->req_pos = pos;
+    protocol_msg_tx (pch->puart, serial_resp);
+    protocol_msg_tx (pch->puart, "\r\n");
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+static void ts_event_check (server_t *p, int ui_id)
+{
+    int pos, nch;
+    channel_t *pch;
+
+    if ((ui_id == p->u_item[eUID_STATUS_L]) || (ui_id == p->u_item[eUID_STATUS_R])) {
+        channel_stop (p, (ui_id == p->u_item[eUID_STATUS_L]) ? 0 : 1);
         return;
     }
 
     if ((ui_id == p->u_item[eUID_CH_L]) || (ui_id == p->u_item[eUID_CH_R])) {
-        pch = (ui_id == p->u_item[eUID_CH_L]) ? &p->ch[0] : &p->ch[1];
-        if (pch->status != eSTATUS_RUN) {
-            if (pch->err_cnt) {
-                int i;
-                for (i = 0; i < pch->err_cnt; i += 3)
-                    usblp_print_err (&pch->err_msg[i + 0][0],
-                                     &pch->err_msg[i + 1][0],
-                                     &pch->err_msg[i + 2][0],
-                                    (ui_id == p->u_item[eUID_CH_L]) ? 0 : 1);
-                // Print Err msg L/R
-                printf ("%s : error msg printing... (ch = %d)\n",
-                    __func__, (ui_id == p->u_item[eUID_CH_L]) ? 0 : 1);
-            }
+        nch = (ui_id == p->u_item[eUID_CH_L]) ? 0 : 1;
+        pch = &p->ch[nch];
+        /* test 중 : fail item 전체 재요청 (sequence id 사용 channel) */
+        if ((pch->status == eSTATUS_RUN) && pch->ready && pch->seq.window) {
+            channel_retest (p, nch);
+            return;
         }
+        channel_print_err (p, nch);
         return;
     }
-    // printer reinit
+    // printer reinit (spool thread 에서, usblp 상태는 ui tick 에서 갱신)
     if (ui_id == p->u_item[eUID_USBLP]) {
-        p->usblp_status = usblp_config ();
+        spool_config_request ();
         return;
     }
 
     // request server ip
     if (ui_id == 2) {
         memset (p->ip_addr, 0, sizeof(p->ip_addr));
-        get_board_ip(p->ip_addr);
+        get_board_ip(p->ip_addr, 100);
     }
 
     if ((nch = find_ditem_uid (p, ui_id, &pos)) == -1) return;
-    pch = &p->ch[nch];
 
+    /* MAC item : 재출력만 (test 중, error 상태이면 무시) */
     if ((ui_id == p->u_item[eUID_MAC_L]) || (ui_id == p->u_item[eUID_MAC_R])) {
-        if ((pch->status == eSTATUS_RUN) || (pch->status == eSTATUS_ERR))
+        if (!channel_print_mac (p, nch))
             return;
+    }
+
+    channel_request (p, nch, pos);
+}
+
+//------------------------------------------------------------------------------
+// control api status : 요청 channel 상태 json object
+//------------------------------------------------------------------------------
+static int ctl_status (server_t *p, int nch, char *buf, int size)
+{
+    channel_t *pch = &p->ch[nch];
+    char mac [DEVICE_RESP_SIZE * 2], value [DEVICE_RESP_SIZE * 2];
+
+    return snprintf (buf, size,
+        "{\"ch\":%d,\"status\":\"%s\",\"ready\":%d,\"mac\":\"%s\",\"mac_dup\":%d,"
+        "\"err_cnt\":%d,\"board\":%llu,\"pass\":%llu,\"fail\":%llu,"
+        "\"gid\":%d,\"did\":%d,\"value\":\"%s\"}",
+        nch, CtlStatusName[pch->status], pch->ready,
+        ctl_json_str (mac, sizeof(mac), pch->mac), pch->mac_dup, pch->err_cnt,
+        (unsigned long long)pch->board_cnt, (unsigned long long)pch->pass_cnt,
+        (unsigned long long)pch->fail_cnt, pch->last_item.gid, pch->last_item.did,
+        ctl_json_str (value, sizeof(value), pch->last_item.resp_s));
+}
+
+//------------------------------------------------------------------------------
+// control api (ctl_api.c) : main loop (ctl_poll) 에서 호출, touch 동작과 같은 처리
+//------------------------------------------------------------------------------
+static int ctl_request (void *arg, const ctl_req_t *req, char *buf, int size)
+{
+    server_t *p = (server_t *)arg;
+    channel_t *pch = NULL;
+    int nch, pos, len;
 
-        usblp_print_mac (pch->mac, nch);
+    if ((req->ch >= p->ch_cnt) || ((req->ch < 0) && (req->ch != -1))) {
+        snprintf (buf, size, "invalid ch %d", req->ch);
+        return -1;
     }
-    if (!pch->ready)    {
-        printf ("%s : Device not ready. (ch = %d)\n", __func__, nch);
-        return;
+    if (req->ch >= 0)
+        pch = &p->ch[req->ch];
+
+    switch (req->cmd) {
+        case eCTL_STATUS:
+            len = snprintf (buf, size, ",\"ip\":\"%s\",\"usblp\":%d,\"ch\":[",
+                    p->ip_addr, p->usblp_status);
+            for (nch = 0; (nch < p->ch_cnt) && (len < size); nch++) {
+                if ((req->ch >= 0) && (nch != req->ch))     continue;
+                if (buf[len -1] != '[')     buf[len++] = ',';
+                len += ctl_status (p, nch, buf + len, size - len);
+            }
+            if (len < size -1)  strcat (buf, "]");
+            return 0;
+        case eCTL_LP_INIT:
+            /* printer 연결 (network connect 등) 은 spool thread 에서, 응답은 현재 상태 */
+            spool_config_request ();
+            snprintf (buf, size, ",\"usblp\":%d", p->usblp_status);
+            return 0;
+        case eCTL_IP:
+            memset (p->ip_addr, 0, sizeof(p->ip_addr));
+            get_board_ip (p->ip_addr, 0);
+            snprintf (buf, size, ",\"ip\":\"%s\"", p->ip_addr);
+            return 0;
+        default:
+            break;
     }
-    SERIAL_RESP_FORM(serial_resp, 'R', p->d_item[pos].gid, p->d_item[pos].did, NULL);
-    protocol_msg_tx (pch->puart, serial_resp);
-    protocol_msg_tx (pch->puart, "\r\n");
+
+    if (pch == NULL) {
+        snprintf (buf, size, "ch required");
+        return -1;
+    }
+    switch (req->cmd) {
+        case eCTL_STOP:
+            if (pch->status != eSTATUS_RUN) {
+                snprintf (buf, size, "not running");
+                return -1;
+            }
+            break;
+        case eCTL_FINISH:
+            if (pch->status == eSTATUS_RUN) {
+                snprintf (buf, size, "running");
+                return -1;
+            }
+            break;
+        case eCTL_PRINT_ERR:
+            if (!channel_print_err (p, req->ch)) {
+                snprintf (buf, size, "running");
+                return -1;
+            }
+            snprintf (buf, size, ",\"err_cnt\":%d", pch->err_cnt);
+            return 0;
+        case eCTL_PRINT_MAC:
+            if (!channel_print_mac (p, req->ch)) {
+                snprintf (buf, size, "running or error");
+                return -1;
+            }
+            return 0;
+        case eCTL_REQUEST:
+            pos = find_ditem_pos (p, req->gid, req->did);
+            if (!p->d_item_cnt ||
+                (p->d_item[pos].gid != req->gid) || (p->d_item[pos].did != req->did)) {
+                snprintf (buf, size, "unknown item %d/%d", req->gid, req->did);
+                return -1;
+            }
+            if (!channel_request (p, req->ch, pos)) {
+                snprintf (buf, size, "not ready");
+                return -1;
+            }
+            return 0;
+        case eCTL_RETEST:
+            if ((pch->status != eSTATUS_RUN) || !pch->ready || !pch->seq.window) {
+                snprintf (buf, size, "not running or no request window");
+                return -1;
+            }
+            channel_retest (p, req->ch);
+            return 0;
+        default:
+            snprintf (buf, size, "unsupported cmd");
+            return -1;
+    }
+    /* stop, finish */
+    if (!channel_stop (p, req->ch)) {
+        snprintf (buf, size, "not ready");
+        return -1;
+    }
+    return 0;
 }
 
 //------------------------------------------------------------------------------
 static char *OPT_CFG_FNAME = SERVER_CFG;
 static int OPT_SW_VALUE = 0; /* 0 : default config, 1 : force odroid-c4 mode */
+static char *OPT_CAPTURE = NULL, *OPT_REPLAY = NULL;
+static int OPT_REPLAY_FAST = 0;
 
 static void print_usage (const char *prog)
 {
     puts("");
-    printf("Usage: %s [-c:server config file]\n", prog);
+    printf("Usage: %s [-c:server config file] [-w:capture file] [-r:replay file] [-f]\n", prog);
     puts("\n"
         "  e.g) -c {server cfg filename} : default {server.cfg}\n"
+        "       -w {capture filename}    : uart rx/tx session capture\n"
+        "       -r {capture filename}    : replay capture file through pty (exit code 1 = tx mismatch)\n"
+        "       -f                       : replay without original timing (fast)\n"
         "\n"
     );
     exit(1);
@@ -461,12 +1130,15 @@ static void parse_opts (int argc, char *argv[])
         static const struct option lopts[] = {
             { "config"   ,  1, 0, 'c' },
             { "gpio num" ,  1, 0, 'g' },
+            { "capture"  ,  1, 0, 'w' },
+            { "replay"   ,  1, 0, 'r' },
+            { "fast"     ,  0, 0, 'f' },
             { "help"     ,  0, 0, 'h' },
             { NULL, 0, 0, 0 },
         };
         int c;
 
-        c = getopt_long(argc, argv, "c:g:h", lopts, NULL);
+        c = getopt_long(argc, argv, "c:g:w:r:fh", lopts, NULL);
 
         if (c == -1)
             break;
@@ -479,9 +1151,9 @@ static void parse_opts (int argc, char *argv[])
             {
                 int gpio_num = -1, value = 0;
                 gpio_num = atoi(optarg);
-                if (gpio_export (gpio_num)) {
-                    if (gpio_direction (gpio_num, 0)) {
-                        if (gpio_get_value (gpio_num, &value))
+                if (hw_gpio_export (gpio_num)) {
+                    if (hw_gpio_direction (gpio_num, 0)) {
+                        if (hw_gpio_get_value (gpio_num, &value))
                             OPT_SW_VALUE = (value == 0) ? 1 :0;
                         else
                             OPT_SW_VALUE = 0;
@@ -491,6 +1163,15 @@ static void parse_opts (int argc, char *argv[])
                 }
             };
             break;
+        case 'w':
+            OPT_CAPTURE = optarg;
+            break;
+        case 'r':
+            OPT_REPLAY = optarg;
+            break;
+        case 'f':
+            OPT_REPLAY_FAST = 1;
+            break;
         case 'h':
         default:
             print_usage(argv[0]);
@@ -504,17 +1185,79 @@ int main (int argc, char *argv[])
 {
     int nch;
     server_t server;
+    const char *cfg_fname;
 
     memset (&server, 0, sizeof(server));
 
     // option check
     parse_opts(argc, argv);
+    cfg_fname = OPT_SW_VALUE ? "server.c4.cfg" : OPT_CFG_FNAME;
+
+    // binary event log (log/jig_server.blog)
+    log_init (LOG_FILE_PATH);
+
+    // 모든 channel deadline (ready, request timeout, blink, cfg settle) 을 하나의 timerfd 로
+    if (!tw_init ())
+        exit (1);
+
+    // board test result store (result/result.dat)
+    result_store_init (RESULT_FILE_PATH);
+
+    // tested mac index (result/mac_index.dat)
+    mac_index_init (MAC_INDEX_PATH);
+
+    // latency histogram (http://127.0.0.1:METRICS_PORT/metrics)
+    metrics_init (METRICS_PORT);
+
+    // per-board timeline (trace/*.json, chrome://tracing)
+    trace_init (TRACE_DIR_PATH);
+
+    // async label print spooler (result/print_spool.dat)
+    spool_init (SPOOL_FILE_PATH);
+
+    // uart session capture / replay (pty 로 channel uart 대체)
+    if (OPT_CAPTURE)
+        capture_init (OPT_CAPTURE);
+    if (OPT_REPLAY && !replay_init (OPT_REPLAY, OPT_REPLAY_FAST))
+        exit (1);
 
     // UI, UART (sw value 1 = server.c4.cfg, sw value 0 = OPT_CFG_FNAME)
-    server_setup (&server, OPT_SW_VALUE ? "server.c4.cfg" : OPT_CFG_FNAME);
+    server_setup (&server, cfg_fname);
+
+    // line aggregator 로 result record 전송 (server cfg 'A')
+    agg_push_init (RESULT_FILE_PATH);
+
+    // item 별 mean/sd/quantile/cpk (result/spc.dat, model = ui cfg)
+    spc_init (SPC_FILE_PATH, server.ui_path);
+
+    // plan channel 의 item 순서 (result/sched.dat = item 별 시간 기록)
+    sched_init (SCHED_FILE_PATH);
+
+    // external monitor status page (/dev/shm/jig_status)
+    status_shm_init (STATUS_SHM_PATH, server.ch_cnt);
+
+    // board insert/remove (power rail monitor)
+    power_mon_init (&server, &mutex);
+
+    // server.cfg, ui cfg 변경 감시 (재시작 없이 D, H, U, P, ui 적용)
+    cfg_reload_init (&server, cfg_fname, &mutex, &ui_mutex);
+
+    // ts reset button soft restart (fb/ui, uart 교체는 ui thread 와 같은 lock)
+    soft_restart_init (&ui_mutex);
+
+    // script / handling robot 용 local control api (unix socket, json line)
+    ctl_init (CTL_SOCK_PATH, ctl_request, &server);
+
+    for (nch = 0; nch < server.ch_cnt; nch++)
+        tw_setup (&server.ch[nch].ready_tmr, channel_ready_timeout, &server.ch[nch]);
+    tw_setup     (&BlinkTmr, ui_blink_func, NULL);
+    tw_arm_every (&BlinkTmr, UI_BLINK_MS);
 
     pthread_create (&thread_ui,    NULL, thread_ui_func,    (void *)&server);
 
+    if (OPT_REPLAY)
+        replay_start ();
+
     // Send Server boot msg
     {
         char serial_resp[SERIAL_RESP_SIZE];
@@ -530,19 +1273,34 @@ int main (int argc, char *argv[])
 
     while (1) {
         for (nch = 0; nch < server.ch_cnt; nch ++) {
-            if (protocol_msg_rx (server.ch[nch].puart, server.ch[nch].rx_msg))
+            if (protocol_msg_rx (server.ch[nch].puart, server.ch[nch].rx_msg)) {
                 protocol_parse  (&server, nch);
+                status_page_update (&server, nch);
+            }
+            /* request window : 대기 요청 전송, 응답 없는 요청 재전송 */
+            protocol_seq_poll (&server.ch[nch].seq, server.ch[nch].puart, mono_us ());
+
+            /* plan channel : scheduler grant */
+            channel_sched (&server, nch);
         }
+        /* 검증된 새 cfg : test 중이 아닌 channel 부터 적용 */
+        cfg_reload_apply (&server);
+
+        /* ts reset button : 문제 있는 subsystem 만 다시 초기화 */
+        soft_restart_apply (&server);
 
         if (server.pts != NULL) {
             ts_event_t event;
-            if (ts_get_event (server.pfb, server.pts, &event)) {
+            if (hw_ts_get_event (server.pfb, server.pts, &event)) {
                 int ui_id = ui_get_titem (server.pfb, server.pui, &event);
                 if ((ui_id != -1) && (event.status == eTS_STATUS_RELEASE)) {
                     ts_event_check (&server, ui_id);
                 }
             }
         }
+        /* control api : touch 와 같은 동작 (non-blocking, loop 당 CTL_CMD_PER_POLL 개) */
+        ctl_poll ();
+
         usleep (MAIN_LOOP_DELAY);
     }
     return 0;
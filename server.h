@@ -16,6 +16,9 @@
 #ifndef __SERVER_H__
 #define __SERVER_H__
 
+//------------------------------------------------------------------------------
+#include <sys/types.h>
+
 //------------------------------------------------------------------------------
 #include "lib_fbui/lib_fb.h"
 #include "lib_fbui/lib_ui.h"
@@ -24,6 +27,25 @@
 #include "lib_gpio/lib_gpio.h"
 #include "device_check.h"
 #include "protocol.h"
+#include "result_store.h"
+#include "mac_index.h"
+#include "metrics.h"
+#include "status_shm.h"
+#include "trace.h"
+#include "capture.h"
+#include "backend.h"
+#include "spooler.h"
+#include "lp_net.h"
+#include "label.h"
+#include "power_mon.h"
+#include "wave.h"
+#include "cfg_reload.h"
+#include "soft_restart.h"
+#include "timer_wheel.h"
+#include "spc.h"
+#include "agg_push.h"
+#include "ctl_api.h"
+#include "plan_sched.h"
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
@@ -40,6 +62,13 @@
 #define RUN_BOX_ON      RGB_TO_UINT(204, 204, 0)
 #define RUN_BOX_OFF     RGB_TO_UINT(153, 153, 0)
 
+/* duplicate mac (mac_index.c) */
+#define DUP_BOX_ON      RGB_TO_UINT(255, 102, 0)
+#define DUP_BOX_OFF     RGB_TO_UINT(153, 61, 0)
+
+/* pass 이지만 spc drift (spc.c) */
+#define DRIFT_BOX       RGB_TO_UINT(0, 191, 255)
+
 //------------------------------------------------------------------------------
 #define STR_PATH_LENGTH     128
 #define STR_NAME_LENGTH     16
@@ -52,6 +81,13 @@
 #define CHECK_CMD_DELAY     (500*1000)
 #define UPDATE_UI_DELAY     (500*1000)
 
+// ui blink 주기 (timer wheel), ui tick 은 blink 가 바뀔때 마다
+#define UI_BLINK_MS         (UPDATE_UI_DELAY / 1000)
+
+// ts reset button 누름 유지 (ui tick 수) : SOFT 남으면 soft restart, 0 이면 process 재시작
+#define SYSTEM_RESET_COUNT  6
+#define SYSTEM_RESET_SOFT   3
+
 //------------------------------------------------------------------------------
 #define DEFAULT_RUNING_TIME  30
 
@@ -88,6 +124,7 @@ enum {
 //------------------------------------------------------------------------------
 typedef struct d_item__t {
     int gid, did, uid_l, uid_r, is_str;
+    int res;    /* plan scheduler resource (SCHED_RES_xxx, -1 = gid 기본값) */
 }   d_item_t;
 
 typedef struct pw_item__t {
@@ -108,13 +145,14 @@ typedef struct h_item__t {
 #define USBLP_MAX_CHAR  19
 #define USBLP_ERR_LINE  20
 
-/* UART protocol wait 60s */
-#define UART_WAIT_TIME  60
+/* UART protocol wait (board insert -> ready, 기존 ui tick 60 회) */
+#define UART_WAIT_MS    (30 * 1000)
 
 typedef struct channel__t {
     int         status;
     int         ready;  /* ready signal received */
-    int         ready_wait; /* uart receive wait time */
+    int         ready_wait; /* uart receive wait (0 = UART_WAIT_MS timeout) */
+    tw_timer_t  ready_tmr;
 
     int         i2c_fd;
     char        i2c_path [STR_PATH_LENGTH];
@@ -122,6 +160,9 @@ typedef struct channel__t {
     uart_t      *puart;
 
     char        uart_path[STR_PATH_LENGTH];
+    char        uart_dev [STR_PATH_LENGTH];    /* open 된 tty (soft restart 확인용) */
+    dev_t       uart_rdev;
+    ino_t       uart_ino;
     int         uart_baud;
 
     char        rx_msg [SERIAL_RESP_SIZE +1];
@@ -133,10 +174,31 @@ typedef struct channel__t {
 
     // usblp mac msg
     char        mac [DEVICE_RESP_SIZE];
+    int         mac_dup;    /* mac already tested/printed (mac_index.c) */
     // usblp err msg
     char        err_msg [USBLP_ERR_LINE][USBLP_MAX_CHAR];
     int         err_cnt;
 
+    // board test result (result_store.c)
+    result_rec_t    result;
+    uint64_t        power_ms;   /* power on time (mono ms) */
+    uint64_t        ready_ms;   /* ready(R) received time (mono ms) */
+    uint64_t        frame_us;   /* last R/S frame received time (mono us) */
+
+    // status page (status_shm.c)
+    parse_resp_data_t   last_item;
+    uint64_t        pass_map [STATUS_ITEM_MAX / 64];
+    uint64_t        fail_map [STATUS_ITEM_MAX / 64];
+    uint64_t        board_cnt, pass_cnt, fail_cnt;
+    int             last_status;    /* ctl status event 보낸 status + 1 (0 = 처음), ui/main 공유 (atomic) */
+
+    // timeline trace (trace.c)
+    uint64_t        req_us;     /* server request(R) send time (mono us) */
+    int             req_pos;    /* requested d_item pos (-1 = none) */
+
+    // sequence id / request window (protocol.c, ready 에서 협상)
+    ptc_seq_t       seq;
+
 }   channel_t;
 
 //------------------------------------------------------------------------------
@@ -166,6 +228,10 @@ typedef struct server__t {
     h_item_t    h_item[10];
     int         h_item_cnt;
 
+    // spc limit item (Q)
+    spc_limit_t q_item[100];
+    int         q_item_cnt;
+
     // usblp connect status
     int         usblp_status;
     int         usblp_mode;
@@ -182,8 +248,16 @@ typedef struct server__t {
 //------------------------------------------------------------------------------
 // setup.c
 //------------------------------------------------------------------------------
-extern void ts_reinit       (server_t *p);
-extern int  server_setup    (server_t *p, const char *cfg_fname);
+extern void ts_reinit           (server_t *p);
+extern int  server_setup        (server_t *p, const char *cfg_fname);
+extern int  find_ditem_uid      (server_t *p, int ui_id, int *pos);
+extern int  find_ditem_pos      (server_t *p, int gid, int did);
+extern const spc_limit_t *find_qitem (server_t *p, int gid, int did);
+extern int  server_config_load  (server_t *p, const char *cfg_fname);
+extern int  server_config_path  (const char *cfg_fname, char *path);
+extern int  channel_uart_failed (server_t *p, int nch);
+extern int  channel_uart_reinit (server_t *p, int nch);
+extern int  ui_reinit           (server_t *p, const char *ui_path);
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
@@ -102,6 +102,14 @@ static int find_ts_event (const char *f_str)
     }
 }
 
+//------------------------------------------------------------------------------
+static int is_tty_device (const char *path)
+{
+    struct stat st;
+
+    return (stat (path, &st) == 0) && S_ISCHR(st.st_mode);
+}
+
 //------------------------------------------------------------------------------
 static int find_uart_port (const char *path)
 {
@@ -129,6 +137,11 @@ static int find_uart_port (const char *path)
 }
 
 //------------------------------------------------------------------------------
+// cfg table 크기 (line 이 많아도 table 을 넘지 않도록)
+//------------------------------------------------------------------------------
+#define CFG_ITEM_MAX(t)     ((int)(sizeof(t) / sizeof(t[0])))
+#define CFG_CH_MAX(p)       CFG_ITEM_MAX(p->ch)
+
 //------------------------------------------------------------------------------
 static void parse_S_cmd (server_t *p, char *cfg)
 {
@@ -153,11 +166,12 @@ static void parse_S_cmd (server_t *p, char *cfg)
 static void parse_C_cmd (server_t *p, char *cfg)
 {
     char *tok;
-    int ch;
+    int ch = 0;
 
     if (strtok (cfg, ",") != NULL) {
         if ((tok = strtok (NULL, ",")) != NULL)
             ch = atoi (tok);
+        if ((ch < 0) || (ch >= CFG_CH_MAX(p)))      return;
 
         if ((tok = strtok (NULL, ",")) != NULL)
             strncpy (p->ch[ch].i2c_path, tok, strlen(tok));
@@ -177,7 +191,7 @@ static void parse_U_cmd (server_t *p, char *cfg)
     int cnt = 0;
 
     if (strtok (cfg, ",") != NULL) {
-        while ((tok = strtok (NULL, ",")) != NULL)
+        while (((tok = strtok (NULL, ",")) != NULL) && (cnt < eUID_END))
             p->u_item[cnt++] = atoi (tok);
     }
 }
@@ -191,9 +205,11 @@ static void parse_P_cmd (server_t *p, char *cfg)
     if (strtok (cfg, ",") != NULL) {
         if ((tok = strtok (NULL, ",")) != NULL)
             ch = atoi (tok);
+        if ((ch < 0) || (ch >= CFG_CH_MAX(p)) ||
+            (p->ch[ch].pw_item_cnt >= CFG_ITEM_MAX(p->ch[ch].pw_item)))   return;
 
         if ((tok = strtok (NULL, ",")) != NULL)
-            strncpy (p->ch[ch].pw_item[p->ch[ch].pw_item_cnt].cname, tok, strlen(tok));
+            strncpy (p->ch[ch].pw_item[p->ch[ch].pw_item_cnt].cname, tok, STR_NAME_LENGTH -1);
 
         if ((tok = strtok (NULL, ",")) != NULL)
             p->ch[ch].pw_item[p->ch[ch].pw_item_cnt].check_mV = atoi (tok);
@@ -207,6 +223,7 @@ static void parse_H_cmd (server_t *p, char *cfg)
 {
     char *tok;
 
+    if (p->h_item_cnt >= CFG_ITEM_MAX(p->h_item))   return;
     if (strtok (cfg, ",") != NULL) {
         if ((tok = strtok (NULL, ",")) != NULL)
             p->h_item[p->h_item_cnt].did = atoi (tok);
@@ -258,10 +275,10 @@ static void parse_M_cmd (server_t *p, char *cfg)
             level = atoi (tok);
 
         if (mem_size && gpio) {
-            gpio_export    (gpio);
-            gpio_direction (gpio, GPIO_DIR_IN);
+            hw_gpio_export    (gpio);
+            hw_gpio_direction (gpio, GPIO_DIR_IN);
 
-            if (gpio_get_value (gpio, &in_value)) {
+            if (hw_gpio_get_value (gpio, &in_value)) {
                 if (level == in_value) {
                     p->test_mem_model = mem_size;
                     printf ("%s : gpio = %d, value = %d, test memory model = %d GB\n"
@@ -277,6 +294,7 @@ static void parse_D_cmd (server_t *p, char *cfg)
 {
     char *tok;
 
+    if (p->d_item_cnt >= CFG_ITEM_MAX(p->d_item))   return;
     if (strtok (cfg, ",") != NULL) {
         if ((tok = strtok (NULL, ",")) != NULL)
             p->d_item[p->d_item_cnt].gid = atoi (tok);
@@ -293,37 +311,146 @@ static void parse_D_cmd (server_t *p, char *cfg)
         if ((tok = strtok (NULL, ",")) != NULL)
             p->d_item[p->d_item_cnt].is_str = atoi (tok);
 
+        /* optional : plan scheduler resource (a = adc, n = net, - = 없음) */
+        p->d_item[p->d_item_cnt].res = -1;
+        if ((tok = strtok (NULL, ",")) != NULL)
+            p->d_item[p->d_item_cnt].res = sched_parse_res (tok);
+
         p->d_item_cnt ++;
     }
 }
 
 //------------------------------------------------------------------------------
-static int channel_setup (channel_t *pch)
+// '-' = limit 없음, return 1 = limit 있음
+//------------------------------------------------------------------------------
+static int parse_limit (char *tok, double *limit)
 {
-    char uart_path[STR_PATH_LENGTH];
-    // i2c init
-    pch->i2c_fd = adc_board_init (pch->i2c_path);
+    while (*tok == ' ')     tok++;
+    if ((*tok == '-') && !isdigit (tok[1]))     return 0;
 
-    memset (uart_path, 0, sizeof(uart_path));
+    *limit = atof (tok);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+static void parse_Q_cmd (server_t *p, char *cfg)
+{
+    spc_limit_t *q = &p->q_item[p->q_item_cnt];
+    char *tok;
+
+    if (p->q_item_cnt >= CFG_ITEM_MAX(p->q_item))   return;
+    if (strtok (cfg, ",") != NULL) {
+        memset (q, 0, sizeof(spc_limit_t));
+        if ((tok = strtok (NULL, ",")) != NULL)
+            q->gid = atoi (tok);
+
+        if ((tok = strtok (NULL, ",")) != NULL)
+            q->did = atoi (tok);
+
+        if ((tok = strtok (NULL, ",")) != NULL)
+            q->lsl_on = parse_limit (tok, &q->lsl);
+
+        if ((tok = strtok (NULL, ",")) != NULL)
+            q->usl_on = parse_limit (tok, &q->usl);
+        p->q_item_cnt++;
+    }
+}
+
+//------------------------------------------------------------------------------
+static void channel_uart_path (channel_t *pch, int nch, char *uart_path)
+{
+    memset (uart_path, 0, STR_PATH_LENGTH);
+    /* replay mode : capture 파일을 pty 로 재생 */
+    if (replay_uart_path (nch) != NULL)
+        strncpy (uart_path, replay_uart_path (nch), STR_PATH_LENGTH -1);
+    /* tty device 직접 지정 (e.g. tools/jig_sim pty link) */
+    else if (is_tty_device (pch->uart_path))
+        strncpy (uart_path, pch->uart_path, STR_PATH_LENGTH -1);
+    else
+        sprintf (uart_path, "/dev/ttyUSB%d", find_uart_port(pch->uart_path));
+}
+
+//------------------------------------------------------------------------------
+static int channel_uart_setup (channel_t *pch, int nch)
+{
     // find uart & protocol init
-    sprintf (uart_path, "/dev/ttyUSB%d", find_uart_port(pch->uart_path));
+    channel_uart_path (pch, nch, pch->uart_dev);
 
-    if ((pch->puart = uart_init (uart_path, pch->uart_baud)) != NULL) {
+    if ((pch->puart = uart_init (pch->uart_dev, pch->uart_baud)) != NULL) {
+        struct stat st;
+
+        /* 같은 이름으로 다시 생성된 device node 구분 (soft restart) */
+        if (stat (pch->uart_dev, &st) == 0) {
+            pch->uart_rdev = st.st_rdev;
+            pch->uart_ino  = st.st_ino;
+        }
         if (ptc_grp_init (pch->puart, 1)) {
             if (!ptc_func_init (pch->puart, 0, SERIAL_RESP_SIZE, protocol_check, protocol_catch)) {
                 printf ("%s : protocol install error.", __func__);
                 exit(1);
             }
         }
+        protocol_ch_init (nch, pch->puart);
         return 1;
     }
-    pch->status = eSTATUS_ERR;
     printf ("%s : Error... Protocol not installed!\n", __func__);
     return 0;
 }
 
 //------------------------------------------------------------------------------
-static int server_config (server_t *p, const char *cfg_fname)
+static int channel_setup (channel_t *pch, int nch)
+{
+    // i2c init
+    pch->i2c_fd = hw_adc_init (pch->i2c_path);
+
+    if (channel_uart_setup (pch, nch))
+        return 1;
+    pch->status = eSTATUS_ERR;
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// d_item 검색 (ui touch id, protocol gid/did)
+//------------------------------------------------------------------------------
+int find_ditem_uid (server_t *p, int ui_id, int *pos)
+{
+    int i = 0;
+    for (i = 0; i < p->d_item_cnt; i++) {
+        *pos = i;
+        if (p->d_item[i].uid_l == ui_id)    return 0;
+        if (p->d_item[i].uid_r == ui_id)    return 1;
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+int find_ditem_pos (server_t *p, int gid, int did)
+{
+    int i;
+
+    for (i = 0; i < p->d_item_cnt; i++) {
+        if ((p->d_item[i].gid == gid) && (p->d_item[i].did == did))
+            return i;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+const spc_limit_t *find_qitem (server_t *p, int gid, int did)
+{
+    int i;
+
+    for (i = 0; i < p->q_item_cnt; i++) {
+        if ((p->q_item[i].gid == gid) && (p->q_item[i].did == did))
+            return &p->q_item[i];
+    }
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+// reload = 1 : table 만 읽음 (M gpio, B backend, L printer 설정은 부팅시만 적용)
+//------------------------------------------------------------------------------
+static int server_config (server_t *p, const char *cfg_fname, int reload)
 {
     FILE *pfd;
     char buf[STR_PATH_LENGTH] = {0,};
@@ -358,7 +485,11 @@ static int server_config (server_t *p, const char *cfg_fname)
             case 'T':   parse_T_cmd (p, buf);  break;
             case 'D':   parse_D_cmd (p, buf);  break;
             case 'H':   parse_H_cmd (p, buf);  break;
-            case 'M':   parse_M_cmd (p, buf);  break;
+            case 'Q':   parse_Q_cmd (p, buf);  break;
+            case 'M':   if (!reload)    parse_M_cmd (p, buf);  break;
+            case 'B':   if (!reload)    backend_config (buf);  break;
+            case 'L':   if (!reload)    lp_net_config  (buf);  break;
+            case 'A':   if (!reload)    agg_push_config(buf);  break;
             default :
                 break;
         }
@@ -376,9 +507,13 @@ void ts_reinit (server_t *p)
     char ts_event[STR_PATH_LENGTH];
 
     if (p->pts) {
-        ts_deinit (p->pts); p->pts = NULL;
+        hw_ts_deinit (p->pts); p->pts = NULL;
     }
 
+    /* headless (ts backend mem/none) : touch device 검색하지 않음 */
+    if (backend_type (eHW_TS) != eBACKEND_DEV)
+        return;
+
     // Vu12 (222a:0001)
     if      ((p->pfb->w == 1920) && (p->pfb->h == 720))
         event_no = find_ts_event ("222a");
@@ -393,13 +528,13 @@ void ts_reinit (server_t *p)
 
         memset  (ts_event, 0, sizeof(ts_event));
         sprintf (ts_event, "/dev/input/event%d", event_no);
-        p->pts = ts_init (ts_event);
+        p->pts = hw_ts_init (ts_event);
         printf ("%s : ts_event path = %s\n", __func__, ts_event);
 
         // ts reset button define
         if (p->ts_reset_gpio != -1) {
-            gpio_export    (p->ts_reset_gpio);
-            gpio_direction (p->ts_reset_gpio, 0);   // input
+            hw_gpio_export    (p->ts_reset_gpio);
+            hw_gpio_direction (p->ts_reset_gpio, 0);   // input
             printf ("%s : ts reset button = %d\n", __func__, p->ts_reset_gpio);
         }
     }
@@ -408,25 +543,96 @@ void ts_reinit (server_t *p)
 //------------------------------------------------------------------------------
 int server_setup (server_t *p, const char *cfg_fname)
 {
-    if (server_config (p, cfg_fname)) {
-        if ((p->pfb = fb_init (p->fb_path)) == NULL)            exit(1);
+    if (server_config (p, cfg_fname, 0)) {
+        if ((p->pfb = hw_fb_init (p->fb_path)) == NULL)         exit(1);
         if ((p->pui = ui_init (p->pfb, p->ui_path)) == NULL)    exit(1);
 
         // touch init
         ts_reinit (p);
 
-        // usb label printer setting
-        p->usblp_status = usblp_config ();
+        // label printer setting (lpmode 1, 2 : network printer)
+        if (p->usblp_mode)  lp_net_init (p->usblp_mode);
+        p->usblp_status = spool_config ();
 
         // left, right channel init
         {
             int i;
-            for (i = 0; i < p->ch_cnt; i++)  channel_setup (&p->ch[i]);
+            for (i = 0; i < p->ch_cnt; i++)  channel_setup (&p->ch[i], i);
         }
         return 1;
     }
     return 0;
 }
 
+//------------------------------------------------------------------------------
+// cfg hot reload (cfg_reload.c) : 실행중 server 와 별도의 server_t 에 cfg table 만 읽음
+//------------------------------------------------------------------------------
+int server_config_load (server_t *p, const char *cfg_fname)
+{
+    return server_config (p, cfg_fname, 1);
+}
+
+//------------------------------------------------------------------------------
+int server_config_path (const char *cfg_fname, char *path)
+{
+    return find_file_path (cfg_fname, path);
+}
+
+//------------------------------------------------------------------------------
+// soft restart (soft_restart.c) : 실행중 channel 의 uart 만 다시 open
+//------------------------------------------------------------------------------
+// return 1 : uart 없음, device node 가 사라졌거나 다시 생성됨, 다른 ttyUSB 로 다시 잡힘 (usb 재연결)
+int channel_uart_failed (server_t *p, int nch)
+{
+    channel_t *pch = &p->ch[nch];
+    char uart_path[STR_PATH_LENGTH];
+    struct stat st;
+
+    if ((pch->puart == NULL) || (stat (pch->uart_dev, &st) != 0) || !S_ISCHR(st.st_mode))
+        return 1;
+    if ((st.st_rdev != pch->uart_rdev) || (st.st_ino != pch->uart_ino))
+        return 1;
+
+    channel_uart_path (pch, nch, uart_path);
+    return strcmp (uart_path, pch->uart_dev) ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------
+// channel status, result, seq 는 유지. 협상된 protocol version 도 그대로 사용.
+int channel_uart_reinit (server_t *p, int nch)
+{
+    channel_t *pch = &p->ch[nch];
+    int version = protocol_version (pch->puart);
+
+    if (pch->puart) {
+        protocol_ch_init (nch, NULL);
+        ptc_grp_close (pch->puart);
+        uart_close    (pch->puart);
+        pch->puart = NULL;
+    }
+    if (!channel_uart_setup (pch, nch))
+        return 0;
+
+    if (version != PROTOCOL_V2)
+        protocol_set_version (pch->puart, version);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// 실행중 ui 교체 (cfg_reload, soft_restart)
+// ui thread 와 같은 lock (ui_mutex) 을 잡고 호출하므로 이전 ui 는 바로 해제
+//------------------------------------------------------------------------------
+int ui_reinit (server_t *p, const char *ui_path)
+{
+    ui_grp_t *pui = ui_init (p->pfb, ui_path), *pui_old = p->pui;
+
+    if (pui == NULL)
+        return 0;
+
+    p->pui = pui;
+    ui_close (pui_old);
+    return 1;
+}
+
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
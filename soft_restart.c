@@ -0,0 +1,188 @@
+//------------------------------------------------------------------------------
+/**
+ * @file soft_restart.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server in-process soft restart (touch, fb/ui, printer, channel uart).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+//------------------------------------------------------------------------------
+#include "server.h"
+#include "soft_restart.h"
+#include "log_ring.h"
+#include "mono_time.h"
+
+//------------------------------------------------------------------------------
+static int              RestartReq = 0;     // 요청 mask (ui thread -> main loop)
+
+/* ui thread 가 fb/ui, channel uart 를 사용하는 동안 잡는 lock (server.c) */
+static pthread_mutex_t  *UiMutex = NULL;
+
+//------------------------------------------------------------------------------
+void soft_restart_init (pthread_mutex_t *ui_mutex)
+{
+    UiMutex = ui_mutex;
+}
+
+//------------------------------------------------------------------------------
+void soft_restart_request (int mask)
+{
+    __atomic_fetch_or (&RestartReq, mask, __ATOMIC_ACQ_REL);
+}
+
+//------------------------------------------------------------------------------
+// return 1 : open 된 fb 가 없어졌거나 device node 가 다시 생성됨 (driver reload)
+static int fb_failed (server_t *p)
+{
+    struct stat fs, ps;
+
+    /* mem/none backend 는 device 없음 */
+    if (backend_type (eHW_FB) != eBACKEND_DEV)  return 0;
+
+    if ((fstat (p->pfb->fd, &fs) != 0) || (stat (p->fb_path, &ps) != 0))
+        return 1;
+    return (fs.st_ino != ps.st_ino) || (fs.st_rdev != ps.st_rdev);
+}
+
+//------------------------------------------------------------------------------
+// 새 ui 에 test 중 (RUN, PRINT) 인 channel 의 item 결과를 다시 표시 (channel_item 과 같은 색)
+// channel status box 는 다음 ui tick (channel_ui_update) 에서 다시 그려짐
+//------------------------------------------------------------------------------
+static void ui_item_restore (server_t *p, int nch)
+{
+    channel_t *pch = &p->ch[nch];
+    int i, pos, uid;
+
+    if ((pch->status != eSTATUS_RUN) && (pch->status != eSTATUS_PRINT))
+        return;
+
+    for (i = 0; (i < pch->result.item_cnt) && (i < RESULT_ITEM_MAX); i++) {
+        result_item_t *pitem = &pch->result.item[i];
+
+        pos = find_ditem_pos (p, pitem->gid, pitem->did);
+        uid = nch ? p->d_item[pos].uid_r : p->d_item[pos].uid_l;
+
+        if (p->d_item[pos].is_str)
+            ui_set_sitem (p->pfb, p->pui, uid, -1, -1, pitem->value);
+
+        ui_set_ritem (p->pfb, p->pui, uid,
+            (pitem->status == 'C') ? COLOR_YELLOW :
+            (pitem->status == 'P') ? COLOR_GREEN  : COLOR_RED, -1);
+    }
+}
+
+//------------------------------------------------------------------------------
+// return 1 : fb, ui 다시 생성 (ui_mutex 를 잡은 상태, 이전 fb 는 바로 해제)
+//------------------------------------------------------------------------------
+static int fb_reinit (server_t *p)
+{
+    fb_info_t *pfb, *pfb_old = p->pfb;
+
+    if ((pfb = hw_fb_init (p->fb_path)) == NULL) {
+        printf ("%s : %s init error\n", __func__, p->fb_path);
+        return 0;
+    }
+    p->pfb = pfb;
+    if (!ui_reinit (p, p->ui_path)) {
+        printf ("%s : %s ui init error\n", __func__, p->ui_path);
+        p->pfb = pfb_old;
+        fb_close (pfb);
+        return 0;
+    }
+    fb_close (pfb_old);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// main loop 에서 호출 (uart, touch 는 main loop 에서만 사용)
+//------------------------------------------------------------------------------
+void soft_restart_apply (server_t *p)
+{
+    int req = __atomic_exchange_n (&RestartReq, 0, __ATOMIC_ACQ_REL);
+    int done = 0, fail = 0, nch;
+    uint64_t start_us, step_us;
+    char name[LOG_STR_SIZE];
+
+    if (!req)   return;
+
+    start_us = mono_us ();
+    memset (name, 0, sizeof(name));
+
+    if (req & SOFT_RESTART_TS) {
+        step_us = mono_us ();
+        ts_reinit (p);
+        done |= SOFT_RESTART_TS;
+        if ((p->pts == NULL) && (backend_type (eHW_TS) == eBACKEND_DEV))
+            fail |= SOFT_RESTART_TS;
+        strcat (name, "ts ");
+        printf ("%s : touch %s, %d us\n", __func__,
+            (fail & SOFT_RESTART_TS) ? "not found" : "ok", (int)(mono_us () - step_us));
+    }
+
+    if (req & SOFT_RESTART_UI) {
+        step_us = mono_us ();
+        pthread_mutex_lock (UiMutex);
+        if (fb_failed (p)) {
+            done |= SOFT_RESTART_UI;
+            if (fb_reinit (p)) {
+                for (nch = 0; nch < p->ch_cnt; nch++)   ui_item_restore (p, nch);
+                strcat (name, "fb ");
+            }
+            else
+                fail |= SOFT_RESTART_UI;
+        }
+        /* fb 가 정상이면 화면 전체만 다시 그림 (ui item 상태는 그대로) */
+        ui_update (p->pfb, p->pui, -1);
+        pthread_mutex_unlock (UiMutex);
+        printf ("%s : fb/ui %s, %d us\n", __func__,
+            (done & SOFT_RESTART_UI) ? ((fail & SOFT_RESTART_UI) ? "error" : "reinit") : "redraw",
+            (int)(mono_us () - step_us));
+    }
+
+    /* printer 연결 (print 중 lp_mutex, network connect) 은 spool thread 에서, 결과는 ui tick 의 usblp 상태 */
+    if ((req & SOFT_RESTART_LP) && !hw_usblp_connection ()) {
+        spool_config_request ();
+        done |= SOFT_RESTART_LP;
+        strcat (name, "lp ");
+        printf ("%s : printer reinit requested\n", __func__);
+    }
+
+    for (nch = 0; nch < p->ch_cnt; nch++) {
+        if (!(req & SOFT_RESTART_UART(nch)) || !channel_uart_failed (p, nch))
+            continue;
+
+        step_us = mono_us ();
+        done |= SOFT_RESTART_UART(nch);
+        /* ui thread (channel_ui_update, channel_start) 도 uart 를 사용 */
+        pthread_mutex_lock   (UiMutex);
+        if (!channel_uart_reinit (p, nch))
+            fail |= SOFT_RESTART_UART(nch);
+        pthread_mutex_unlock (UiMutex);
+        strcat (name, nch ? "uart1 " : "uart0 ");
+        printf ("%s : ch %d uart %s %s, %d us\n", __func__, nch, p->ch[nch].uart_dev,
+            (fail & SOFT_RESTART_UART(nch)) ? "error" : "reopen", (int)(mono_us () - step_us));
+    }
+
+    if (strlen (name))  name[strlen (name) -1] = 0;
+    printf ("%s : req 0x%02x, reinit 0x%02x, fail 0x%02x, recovery %d us\n",
+        __func__, req, done, fail, (int)(mono_us () - start_us));
+    LOG_EVENT (LOG_CH_NONE, eLOG_SOFT_RESTART, name, req, done, fail,
+        (int)((mono_us () - start_us) / 1000));
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,57 @@
+//------------------------------------------------------------------------------
+/**
+ * @file soft_restart.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server in-process soft restart (touch, fb/ui, printer, channel uart).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __SOFT_RESTART_H__
+#define __SOFT_RESTART_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <pthread.h>
+
+//------------------------------------------------------------------------------
+//
+// ts reset button 을 누르고 있으면 (ui thread) soft restart 를 요청,
+// main loop (soft_restart_apply) 에서 요청된 subsystem 중 문제가 있는 것만 다시 초기화.
+//
+//   touch   : 요청시 항상 (button 자체가 touch reset)
+//   fb, ui  : fb device 오류시 fb, ui 다시 생성 후 test 중인 item 상태 복원, 아니면 화면 전체 다시 그림
+//   printer : 연결 끊김시 spool thread 에 spool_config 요청 (usb / network, main loop 는 대기하지 않음)
+//   uart    : tty 가 없거나 다른 ttyUSB 로 다시 잡힌 channel 만 다시 open
+//
+// channel status, result, seq, 협상된 protocol version 은 유지 (process 재시작 없음).
+// fb/ui, uart 교체는 ui thread 와 같은 lock (ui_mutex) 을 잡고 실행, 이전 fb/ui 는 바로 해제.
+// 복구 시간은 soft_restart log (log/jig_server.blog) 로 기록.
+//
+//------------------------------------------------------------------------------
+#define SOFT_RESTART_TS         0x01
+#define SOFT_RESTART_UI         0x02
+#define SOFT_RESTART_LP         0x04
+#define SOFT_RESTART_UART(ch)   (0x10 << (ch))
+#define SOFT_RESTART_ALL        (SOFT_RESTART_TS | SOFT_RESTART_UI | SOFT_RESTART_LP | \
+                                 SOFT_RESTART_UART(0) | SOFT_RESTART_UART(1))
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+struct server__t;
+
+extern  void    soft_restart_init       (pthread_mutex_t *ui_mutex);
+extern  void    soft_restart_request    (int mask);
+extern  void    soft_restart_apply      (struct server__t *p);
+
+//------------------------------------------------------------------------------
+#endif  // __SOFT_RESTART_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,443 @@
+//------------------------------------------------------------------------------
+/**
+ * @file spc.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server item statistical process control (mean/variance, quantile, Cpk).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+//------------------------------------------------------------------------------
+#include "spc.h"
+#include "crc.h"
+#include "log_ring.h"
+
+//------------------------------------------------------------------------------
+#define SPC_MAGIC           0x4350534A  // "JSPC"
+#define SPC_HASH_SIZE       (SPC_KEY_MAX * 2)
+#define SPC_Q_CNT           3
+
+static const double SpcQuantile [SPC_Q_CNT] = { 0.05, 0.50, 0.95 };
+
+//------------------------------------------------------------------------------
+// P-square marker (Jain & Chlamtac), 처음 5 개는 q[] 에 정렬 저장
+//------------------------------------------------------------------------------
+typedef struct spc_p2__t {
+    double      q  [5];
+    double      np [5];
+    int32_t     n  [5];
+}   spc_p2_t;
+
+typedef struct spc_entry__t {
+    char        model [SPC_MODEL_SIZE];
+    uint32_t    model_crc;
+    int32_t     ch, gid, did;
+    uint32_t    n;
+    int32_t     drift;
+    double      mean, m2, min, max, ewma, cpk;
+    spc_p2_t    p2 [SPC_Q_CNT];
+}   spc_entry_t;
+
+typedef struct spc_hdr__t {
+    uint32_t    magic;
+    uint32_t    rec_size;
+    uint32_t    cnt;
+    uint32_t    crc;
+}   spc_hdr_t;
+
+//------------------------------------------------------------------------------
+static spc_entry_t      SpcEntry [SPC_KEY_MAX];
+static int16_t          SpcHash  [SPC_HASH_SIZE];   // entry idx + 1 (0 = empty)
+static int              SpcCnt   = 0;
+static int              SpcDirty = 0;
+static int              SpcFull  = 0;       // table full log (한번만)
+
+static char             SpcPath  [128];
+static char             SpcModel [SPC_MODEL_SIZE];
+static uint32_t         SpcModelCrc = 0;
+
+static pthread_mutex_t  spc_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+//------------------------------------------------------------------------------
+// libm 없이 sqrt (newton, x 이상의 초기값에서 단조 감소)
+//------------------------------------------------------------------------------
+static double spc_sqrt (double x)
+{
+    double r, n;
+    int i;
+
+    if (x <= 0)     return 0;
+    r = (x > 1) ? x : 1;
+    for (i = 0; i < 128; i++) {
+        n = 0.5 * (r + x / r);
+        if (n >= r) break;
+        r = n;
+    }
+    return r;
+}
+
+//------------------------------------------------------------------------------
+static void spc_p2_add (spc_p2_t *e, double p, uint32_t cnt, double x)
+{
+    double d, qp;
+    int i, k, s;
+
+    /* cnt : x 를 포함한 sample 수 */
+    if (cnt <= 5) {
+        for (i = cnt -1; (i > 0) && (e->q[i -1] > x); i--)
+            e->q[i] = e->q[i -1];
+        e->q[i] = x;
+        if (cnt == 5) {
+            for (i = 0; i < 5; i++)     e->n[i] = i;
+            e->np[0] = 0;       e->np[1] = 2 * p;   e->np[2] = 4 * p;
+            e->np[3] = 2 + 2 * p;                   e->np[4] = 4;
+        }
+        return;
+    }
+
+    if (x < e->q[0])        { e->q[0] = x;  k = 0; }
+    else if (x >= e->q[4])  { e->q[4] = x;  k = 3; }
+    else for (k = 0; (k < 3) && (x >= e->q[k +1]); k++);
+
+    for (i = k +1; i < 5; i++)  e->n[i]++;
+    /* desired position 증가량 : 0, p/2, p, (1+p)/2, 1 */
+    e->np[1] += p / 2;
+    e->np[2] += p;
+    e->np[3] += (1 + p) / 2;
+    e->np[4] += 1;
+
+    for (i = 1; i <= 3; i++) {
+        d = e->np[i] - e->n[i];
+        if (((d >=  1) && (e->n[i +1] - e->n[i] >  1)) ||
+            ((d <= -1) && (e->n[i -1] - e->n[i] < -1))) {
+            s  = (d >= 0) ? 1 : -1;
+            qp = e->q[i] + (double)s / (e->n[i +1] - e->n[i -1]) *
+                ((e->n[i] - e->n[i -1] + s) * (e->q[i +1] - e->q[i]) / (e->n[i +1] - e->n[i]) +
+                 (e->n[i +1] - e->n[i] - s) * (e->q[i] - e->q[i -1]) / (e->n[i] - e->n[i -1]));
+            if ((e->q[i -1] < qp) && (qp < e->q[i +1]))
+                e->q[i] = qp;
+            else
+                e->q[i] += s * (e->q[i + s] - e->q[i]) / (e->n[i + s] - e->n[i]);
+            e->n[i] += s;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+static double spc_p2_get (const spc_p2_t *e, double p, uint32_t cnt)
+{
+    if (!cnt)       return 0;
+    if (cnt < 5)    return e->q[(int)(p * (cnt -1) + 0.5)];
+    return e->q[2];
+}
+
+//------------------------------------------------------------------------------
+static uint32_t spc_hash (uint32_t model_crc, int ch, int gid, int did)
+{
+    uint32_t h = model_crc ^ ((uint32_t)ch << 24) ^ ((uint32_t)(gid & 0xFF) << 16) ^ (did & 0xFFFF);
+
+    h ^= h >> 16;   h *= 0x45D9F3B;     h ^= h >> 16;
+    return h % SPC_HASH_SIZE;
+}
+
+//------------------------------------------------------------------------------
+static void spc_hash_add (int idx)
+{
+    spc_entry_t *e = &SpcEntry[idx];
+    uint32_t h = spc_hash (e->model_crc, e->ch, e->gid, e->did);
+
+    while (SpcHash[h])  h = (h + 1) % SPC_HASH_SIZE;
+    SpcHash[h] = idx + 1;
+}
+
+//------------------------------------------------------------------------------
+// 현재 model 의 entry, create = 1 이면 없을 때 추가 (spc_mutex lock 상태)
+//------------------------------------------------------------------------------
+static spc_entry_t *spc_find (int ch, int gid, int did, int create)
+{
+    uint32_t h = spc_hash (SpcModelCrc, ch, gid, did);
+    spc_entry_t *e;
+
+    for (; SpcHash[h]; h = (h + 1) % SPC_HASH_SIZE) {
+        e = &SpcEntry[SpcHash[h] -1];
+        if ((e->model_crc == SpcModelCrc) && (e->ch == ch) &&
+            (e->gid == gid) && (e->did == did) && !strcmp (e->model, SpcModel))
+            return e;
+    }
+    if (!create)    return NULL;
+    /* table full : 새 key 는 누적하지 않음 (spc.dat 삭제로 초기화) */
+    if (SpcCnt >= SPC_KEY_MAX) {
+        if (!SpcFull) {
+            SpcFull = 1;
+            printf ("%s : %s key table full (%d), gid %d, did %d not tracked\n",
+                __func__, SpcModel, SPC_KEY_MAX, gid, did);
+            LOG_EVENT (ch, eLOG_SPC_FULL, SpcModel, SPC_KEY_MAX, gid, did);
+        }
+        return NULL;
+    }
+
+    e = &SpcEntry[SpcCnt];
+    memset (e, 0, sizeof(spc_entry_t));
+    memcpy (e->model, SpcModel, sizeof(e->model));
+    e->cpk = -1;
+    e->model_crc = SpcModelCrc;
+    e->ch = ch;     e->gid = gid;   e->did = did;
+    SpcHash[h] = ++SpcCnt;
+    return e;
+}
+
+//------------------------------------------------------------------------------
+static void spc_stat (const spc_entry_t *e, const spc_limit_t *plimit, spc_stat_t *pstat)
+{
+    double cpu, cpl;
+
+    memset (pstat, 0, sizeof(spc_stat_t));
+    pstat->n     = e->n;
+    pstat->mean  = e->mean;
+    pstat->sd    = (e->n > 1) ? spc_sqrt (e->m2 / (e->n - 1)) : 0;
+    pstat->min   = e->min;
+    pstat->max   = e->max;
+    pstat->ewma  = e->ewma;
+    pstat->drift = e->drift;
+    pstat->p05   = spc_p2_get (&e->p2[0], SpcQuantile[0], e->n);
+    pstat->p50   = spc_p2_get (&e->p2[1], SpcQuantile[1], e->n);
+    pstat->p95   = spc_p2_get (&e->p2[2], SpcQuantile[2], e->n);
+
+    /* limit 이 없으면 마지막 update 시 계산한 값 */
+    pstat->cpk   = plimit ? -1 : e->cpk;
+    if (plimit && (plimit->lsl_on || plimit->usl_on) && (pstat->sd > 0)) {
+        cpu = plimit->usl_on ? (plimit->usl - e->mean) / (3 * pstat->sd) : 0;
+        cpl = plimit->lsl_on ? (e->mean - plimit->lsl) / (3 * pstat->sd) : 0;
+        if (!plimit->usl_on)        pstat->cpk = cpl;
+        else if (!plimit->lsl_on)   pstat->cpk = cpu;
+        else                        pstat->cpk = (cpu < cpl) ? cpu : cpl;
+        if (pstat->cpk < 0)         pstat->cpk = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+int spc_update (int ch, int gid, int did, double value,
+                const spc_limit_t *plimit, spc_stat_t *pstat)
+{
+    spc_entry_t *e;
+    spc_stat_t stat;
+    double d, limit, prev_mean;
+    int i, drift, prev;
+
+    pthread_mutex_lock (&spc_mutex);
+    if ((e = spc_find (ch, gid, did, 1)) == NULL) {
+        pthread_mutex_unlock (&spc_mutex);
+        return 0;
+    }
+
+    /* ewma 는 이전 누적 평균 (기준값) 과 비교 */
+    prev_mean = e->n ? e->mean : value;
+    e->ewma   = e->n ? (SPC_EWMA_LAMBDA * value + (1 - SPC_EWMA_LAMBDA) * e->ewma) : value;
+
+    e->n++;
+    d        = value - e->mean;
+    e->mean += d / e->n;
+    e->m2   += d * (value - e->mean);
+    if ((e->n == 1) || (value < e->min))    e->min = value;
+    if ((e->n == 1) || (value > e->max))    e->max = value;
+    for (i = 0; i < SPC_Q_CNT; i++)
+        spc_p2_add (&e->p2[i], SpcQuantile[i], e->n, value);
+
+    spc_stat (e, plimit, &stat);
+    e->cpk = stat.cpk;
+
+    drift = 0;
+    if (e->n >= SPC_MIN_N) {
+        limit = SPC_EWMA_L * stat.sd *
+                spc_sqrt (SPC_EWMA_LAMBDA / (2 - SPC_EWMA_LAMBDA));
+        d = e->ewma - prev_mean;
+        if ((d > limit) || (d < -limit))                drift |= 0x01;
+        if ((stat.cpk >= 0) && (stat.cpk < SPC_CPK_WARN))  drift |= 0x02;
+    }
+    prev = e->drift;
+    e->drift = stat.drift = drift ? 1 : 0;
+    SpcDirty = 1;
+    pthread_mutex_unlock (&spc_mutex);
+
+    if (drift && !prev)
+        LOG_EVENT (ch, eLOG_SPC_DRIFT, (drift & 0x01) ? "ewma" : "cpk",
+            gid, did, (int)(stat.cpk * 100), (int)stat.ewma);
+
+    if (pstat)  *pstat = stat;
+    return stat.drift;
+}
+
+//------------------------------------------------------------------------------
+int spc_get (int ch, int gid, int did, spc_stat_t *pstat)
+{
+    spc_entry_t *e;
+
+    pthread_mutex_lock (&spc_mutex);
+    if ((e = spc_find (ch, gid, did, 0)) != NULL)
+        spc_stat (e, NULL, pstat);
+    pthread_mutex_unlock (&spc_mutex);
+    return (e != NULL);
+}
+
+//------------------------------------------------------------------------------
+// ui cfg path -> model 이름 (file 이름)
+//------------------------------------------------------------------------------
+void spc_model (const char *ui_path)
+{
+    const char *ptr = strrchr (ui_path, '/');
+
+    pthread_mutex_lock (&spc_mutex);
+    memset  (SpcModel, 0, sizeof(SpcModel));
+    strncpy (SpcModel, ptr ? ptr + 1 : ui_path, sizeof(SpcModel) -1);
+    SpcModelCrc = crc32_calc (SpcModel, strlen (SpcModel));
+    pthread_mutex_unlock (&spc_mutex);
+}
+
+//------------------------------------------------------------------------------
+// snapshot 저장 (result writer thread), tmp 기록 후 rename
+//------------------------------------------------------------------------------
+void spc_save (void)
+{
+    char tmp_path[sizeof(SpcPath) + 8];
+    spc_entry_t *buf;
+    spc_hdr_t hdr;
+    int fd, cnt, ok;
+
+    pthread_mutex_lock (&spc_mutex);
+    if (!SpcDirty || !SpcPath[0] ||
+        ((buf = malloc (sizeof(spc_entry_t) * SPC_KEY_MAX)) == NULL)) {
+        pthread_mutex_unlock (&spc_mutex);
+        return;
+    }
+    cnt = SpcCnt;
+    memcpy (buf, SpcEntry, sizeof(spc_entry_t) * cnt);
+    SpcDirty = 0;
+    pthread_mutex_unlock (&spc_mutex);
+
+    hdr.magic    = SPC_MAGIC;
+    hdr.rec_size = sizeof(spc_entry_t);
+    hdr.cnt      = cnt;
+    hdr.crc      = crc32_calc (buf, sizeof(spc_entry_t) * cnt);
+
+    sprintf (tmp_path, "%s.tmp", SpcPath);
+    if ((fd = open (tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0) {
+        printf ("%s : %s open error (%s)\n", __func__, tmp_path, strerror(errno));
+        free (buf);
+        return;
+    }
+    ok = (write (fd, &hdr, sizeof(hdr)) == sizeof(hdr)) &&
+         (write (fd, buf, sizeof(spc_entry_t) * cnt) == (ssize_t)(sizeof(spc_entry_t) * cnt));
+    fdatasync (fd);
+    close (fd);
+    free  (buf);
+
+    if (ok)     rename (tmp_path, SpcPath);
+    else {
+        printf ("%s : write error (%s)\n", __func__, strerror(errno));
+        unlink (tmp_path);
+        /* 다음 결과 기록 시 다시 저장 */
+        pthread_mutex_lock   (&spc_mutex);
+        SpcDirty = 1;
+        pthread_mutex_unlock (&spc_mutex);
+    }
+}
+
+//------------------------------------------------------------------------------
+static void spc_load (void)
+{
+    spc_hdr_t hdr;
+    int fd, i;
+
+    if ((fd = open (SpcPath, O_RDONLY)) < 0)    return;
+
+    if ((read (fd, &hdr, sizeof(hdr)) != sizeof(hdr)) ||
+        (hdr.magic != SPC_MAGIC) || (hdr.rec_size != sizeof(spc_entry_t)) ||
+        (hdr.cnt > SPC_KEY_MAX) ||
+        (read (fd, SpcEntry, sizeof(spc_entry_t) * hdr.cnt) != (ssize_t)(sizeof(spc_entry_t) * hdr.cnt)) ||
+        (hdr.crc != crc32_calc (SpcEntry, sizeof(spc_entry_t) * hdr.cnt))) {
+        printf ("%s : %s broken, reset statistics\n", __func__, SpcPath);
+        close (fd);
+        return;
+    }
+    close (fd);
+
+    for (i = 0; i < (int)hdr.cnt; i++) {
+        SpcEntry[i].model[SPC_MODEL_SIZE -1] = 0;
+        spc_hash_add (i);
+    }
+    SpcCnt = hdr.cnt;
+    printf ("%s : %d items loaded\n", __func__, SpcCnt);
+}
+
+//------------------------------------------------------------------------------
+int spc_init (const char *fname, const char *ui_path)
+{
+    char *ptr;
+
+    memset  (SpcPath, 0, sizeof(SpcPath));
+    strncpy (SpcPath, fname ? fname : SPC_FILE_PATH, sizeof(SpcPath) -1);
+
+    if ((ptr = strrchr (SpcPath, '/')) != NULL) {
+        *ptr = 0;   mkdir (SpcPath, 0755);  *ptr = '/';
+    }
+    memset (SpcHash, 0, sizeof(SpcHash));
+    SpcCnt = 0;
+
+    spc_load  ();
+    spc_model (ui_path);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// metrics gauge (현재 model 만)
+//------------------------------------------------------------------------------
+int spc_render (char *buf, int size)
+{
+    static const char *name[] = { "jig_spc_mean", "jig_spc_sd", "jig_spc_cpk", "jig_spc_drift" };
+    spc_stat_t stat;
+    double v = 0;
+    int i, id, len = 0;
+
+    pthread_mutex_lock (&spc_mutex);
+    for (id = 0; id < (int)(sizeof(name) / sizeof(name[0])); id++) {
+        len += snprintf (buf + len, size - len, "# TYPE %s gauge\n", name[id]);
+        for (i = 0; (i < SpcCnt) && (len < size); i++) {
+            spc_entry_t *e = &SpcEntry[i];
+
+            if (strcmp (e->model, SpcModel))    continue;
+            spc_stat (e, NULL, &stat);
+            switch (id) {
+                case 0: v = stat.mean;  break;
+                case 1: v = stat.sd;    break;
+                case 2:
+                    if (stat.cpk < 0)   continue;
+                    v = stat.cpk;
+                    break;
+                case 3: v = stat.drift; break;
+            }
+            len += snprintf (buf + len, size - len, "%s{ch=\"%d\",gid=\"%d\",did=\"%d\"} %.3f\n",
+                name[id], e->ch, e->gid, e->did, v);
+        }
+        if (len >= size)    break;
+    }
+    pthread_mutex_unlock (&spc_mutex);
+    return (len >= size) ? size : len;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
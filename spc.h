@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+/**
+ * @file spc.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server item statistical process control (mean/variance, quantile, Cpk).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __SPC_H__
+#define __SPC_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+//
+// (model, channel, gid, did) 별 숫자 결과값 통계. result 1 개당 O(1) update.
+//
+//   mean, sd  : Welford (전체 누적)
+//   p05/50/95 : P-square quantile 추정 (marker 5 개, sample 저장 없음)
+//   ewma      : lambda 0.2, 최근 값의 이동 평균
+//   cpk       : min (usl - mean, mean - lsl) / 3sd (server.cfg 'Q' limit 이 있는 경우)
+//
+// drift : sample 이 SPC_MIN_N 이상이고
+//   |ewma - mean| > SPC_EWMA_L * sd * sqrt (lambda / (2 - lambda)) 또는 cpk < SPC_CPK_WARN
+//
+// model 은 ui cfg file 이름 (ui cfg 가 바뀌면 새 model 로 누적).
+// key (model, ch, gid, did) 는 SPC_KEY_MAX 까지, 가득 차면 새 key 는 누적하지 않고
+// spc_full log 를 한번 남김 (eviction 없음, SPC_FILE_PATH 삭제로 초기화).
+// snapshot (SPC_FILE_PATH) 은 result writer thread 에서 결과 기록 후 저장.
+//
+//------------------------------------------------------------------------------
+#define SPC_FILE_PATH       "result/spc.dat"
+
+#define SPC_KEY_MAX         512
+#define SPC_MODEL_SIZE      32
+#define SPC_MIN_N           30
+#define SPC_CPK_WARN        1.33
+#define SPC_EWMA_LAMBDA     0.2
+#define SPC_EWMA_L          3.0
+
+/* server.cfg 'Q' line : Q,gid,did,lsl,usl, (limit 이 없으면 '-') */
+typedef struct spc_limit__t {
+    int         gid, did;
+    double      lsl, usl;
+    uint8_t     lsl_on, usl_on;
+}   spc_limit_t;
+
+typedef struct spc_stat__t {
+    uint32_t    n;
+    double      mean, sd, min, max;
+    double      p05, p50, p95;
+    double      ewma, cpk;      // cpk < 0 = limit 없음
+    int         drift;
+}   spc_stat_t;
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+extern  int     spc_init    (const char *fname, const char *ui_path);
+extern  void    spc_model   (const char *ui_path);
+/* return 1 = drift (pstat 은 NULL 가능) */
+extern  int     spc_update  (int ch, int gid, int did, double value,
+                             const spc_limit_t *plimit, spc_stat_t *pstat);
+extern  int     spc_get     (int ch, int gid, int did, spc_stat_t *pstat);
+extern  void    spc_save    (void);
+extern  int     spc_render  (char *buf, int size);
+
+//------------------------------------------------------------------------------
+#endif  // __SPC_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,407 @@
+//------------------------------------------------------------------------------
+/**
+ * @file spooler.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server label print spooler (usblp async print queue).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+//------------------------------------------------------------------------------
+#include "spooler.h"
+#include "backend.h"
+#include "mono_time.h"
+
+//------------------------------------------------------------------------------
+typedef struct spool_slot__t {
+    spool_job_t job;
+    off_t       off;        // file offset (saved == 1)
+    int         saved;
+}   spool_slot_t;
+
+//------------------------------------------------------------------------------
+static spool_slot_t SpoolSlot [SPOOL_JOB_MAX];
+static int          SpoolHead = 0, SpoolCnt = 0;
+static uint32_t     SpoolSeq  = 1;
+
+static char         SpoolPath [128];
+static int          SpoolFd = -1;
+static off_t        SpoolEnd = 0;
+
+/* printer 재시도 시각 (mono ms), 0 = 즉시 */
+static uint64_t     RetryAt = 0;
+static int          RetryMs = 0;
+static int          ConfigReq = 0;      // printer reinit 요청 (control api)
+
+static pthread_mutex_t  spool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t  lp_mutex    = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   spool_cond;
+static pthread_t        thread_spool;
+
+//------------------------------------------------------------------------------
+#define SLOT(i)     (&SpoolSlot[(SpoolHead + (i)) % SPOOL_JOB_MAX])
+
+//------------------------------------------------------------------------------
+static int spool_label_cnt (spool_job_t *pjob)
+{
+    if (pjob->type == eSPOOL_MAC)   return 1;
+
+    return (pjob->lines + SPOOL_LABEL_LINE - 1) / SPOOL_LABEL_LINE;
+}
+
+//------------------------------------------------------------------------------
+static void spool_mark (off_t off, uint8_t done)
+{
+    if (SpoolFd < 0)    return;
+
+    if (pwrite (SpoolFd, &done, sizeof(done), off + offsetof(spool_job_t, done)) != sizeof(done))
+        printf ("%s : %s write error (%s)\n", __func__, SpoolPath, strerror(errno));
+    fdatasync (SpoolFd);
+}
+
+//------------------------------------------------------------------------------
+// enqueue 된 job 을 file 에 기록 (main/ui thread 에서는 file io 하지 않음)
+//------------------------------------------------------------------------------
+static void spool_save (void)
+{
+    static spool_job_t save [SPOOL_JOB_MAX];
+    int i, cnt = 0, pos [SPOOL_JOB_MAX];
+    off_t off;
+
+    pthread_mutex_lock (&spool_mutex);
+    for (i = 0; i < SpoolCnt; i++) {
+        if (SLOT(i)->saved)     continue;
+        pos [cnt] = i;
+        memcpy (&save[cnt++], &SLOT(i)->job, sizeof(spool_job_t));
+    }
+    off = SpoolEnd;
+    pthread_mutex_unlock (&spool_mutex);
+
+    if (!cnt)   return;
+
+    if (SpoolFd >= 0) {
+        if (pwrite (SpoolFd, save, cnt * sizeof(spool_job_t), off) != (ssize_t)(cnt * sizeof(spool_job_t)))
+            printf ("%s : %s write error (%s)\n", __func__, SpoolPath, strerror(errno));
+        fdatasync (SpoolFd);
+    }
+
+    /* head 는 spool thread 만 이동하므로 pos 는 그대로 유효함 */
+    pthread_mutex_lock (&spool_mutex);
+    for (i = 0; i < cnt; i++) {
+        SLOT(pos[i])->off   = off + i * sizeof(spool_job_t);
+        SLOT(pos[i])->saved = 1;
+    }
+    SpoolEnd = off + cnt * sizeof(spool_job_t);
+    pthread_mutex_unlock (&spool_mutex);
+}
+
+//------------------------------------------------------------------------------
+// return 1 : label 출력, 0 : printer 연결 없음 (retry)
+//------------------------------------------------------------------------------
+static int spool_print_label (spool_job_t *pjob, int label)
+{
+    int ret = 0, l = label * SPOOL_LABEL_LINE;
+
+    pthread_mutex_lock (&lp_mutex);
+    if (hw_usblp_connection ()) {
+        if (pjob->type == eSPOOL_MAC)
+            ret = hw_usblp_print_mac (pjob->text[0], pjob->ch);
+        else
+            ret = hw_usblp_print_err (
+                    (l + 0 < pjob->lines) ? pjob->text[l + 0] : "",
+                    (l + 1 < pjob->lines) ? pjob->text[l + 1] : "",
+                    (l + 2 < pjob->lines) ? pjob->text[l + 2] : "",
+                    pjob->ch);
+    }
+    pthread_mutex_unlock (&lp_mutex);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+// head job 출력. 같은 printer 를 공유하므로 channel 순서는 queue 순서와 같음.
+//------------------------------------------------------------------------------
+static void spool_print_head (void)
+{
+    spool_job_t job;
+    off_t off;
+    int label, saved;
+
+    pthread_mutex_lock (&spool_mutex);
+    memcpy (&job, &SLOT(0)->job, sizeof(job));
+    off = SLOT(0)->off;     saved = SLOT(0)->saved;
+    pthread_mutex_unlock (&spool_mutex);
+
+    for (label = job.done; label < spool_label_cnt (&job); label++) {
+        if (!spool_print_label (&job, label)) {
+            RetryMs = RetryMs ? RetryMs * 2 : SPOOL_RETRY_MIN_MS;
+            if (RetryMs > SPOOL_RETRY_MAX_MS)   RetryMs = SPOOL_RETRY_MAX_MS;
+            RetryAt = mono_ms () + RetryMs;
+            printf ("%s : printer not ready, seq = %u, retry %d ms\n",
+                __func__, job.seq, RetryMs);
+            pthread_mutex_lock   (&spool_mutex);
+            SLOT(0)->job.done = label;
+            pthread_mutex_unlock (&spool_mutex);
+            return;
+        }
+        /* 출력된 label 수 기록 (재시작시 나머지 label 부터 출력) */
+        if (saved)  spool_mark (off, label + 1);
+    }
+    RetryMs = 0;    RetryAt = 0;
+    if (saved)  spool_mark (off, SPOOL_JOB_DONE);
+
+    pthread_mutex_lock (&spool_mutex);
+    SpoolHead = (SpoolHead + 1) % SPOOL_JOB_MAX;
+    SpoolCnt--;
+    /* queue 가 비면 file 을 header 만 남기고 정리 */
+    if (!SpoolCnt && (SpoolFd >= 0)) {
+        if (ftruncate (SpoolFd, sizeof(spool_hdr_t)) == 0)
+            SpoolEnd = sizeof(spool_hdr_t);
+    }
+    pthread_mutex_unlock (&spool_mutex);
+}
+
+//------------------------------------------------------------------------------
+static void *thread_spool_func (void *arg)
+{
+    struct timespec ts;
+    uint64_t now;
+
+    int config;
+
+    while (1) {
+        pthread_mutex_lock (&spool_mutex);
+        while (1) {
+            int unsaved = 0, i;
+
+            for (i = 0; i < SpoolCnt; i++)
+                if (!SLOT(i)->saved)    unsaved = 1;
+
+            now = mono_ms ();
+            if (unsaved || ConfigReq || (SpoolCnt && (now >= RetryAt)))
+                break;
+
+            if (!SpoolCnt)
+                pthread_cond_wait (&spool_cond, &spool_mutex);
+            else {
+                clock_gettime (CLOCK_MONOTONIC, &ts);
+                ts.tv_sec  += (RetryAt - now) / 1000;
+                ts.tv_nsec += ((RetryAt - now) % 1000) * 1000000;
+                if (ts.tv_nsec >= 1000000000)   { ts.tv_sec++;  ts.tv_nsec -= 1000000000; }
+                pthread_cond_timedwait (&spool_cond, &spool_mutex, &ts);
+            }
+        }
+        config = ConfigReq;     ConfigReq = 0;
+        pthread_mutex_unlock (&spool_mutex);
+
+        if (config) {
+            printf ("%s : printer reinit %s\n", __func__, spool_config () ? "ok" : "error");
+            continue;
+        }
+        spool_save ();
+        if (mono_ms () >= RetryAt)
+            spool_print_head ();
+    }
+    return arg;
+}
+
+//------------------------------------------------------------------------------
+// 같은 내용의 job 이 출력 대기중이면 추가하지 않음 (printer jam 중 반복 touch 등)
+//------------------------------------------------------------------------------
+static int spool_enqueue (spool_job_t *pjob)
+{
+    int i, label = spool_label_cnt (pjob);
+
+    pthread_mutex_lock (&spool_mutex);
+    for (i = 0; i < SpoolCnt; i++) {
+        spool_job_t *q = &SLOT(i)->job;
+
+        if ((q->type == pjob->type) && (q->ch == pjob->ch) && (q->lines == pjob->lines) &&
+            !memcmp (q->text, pjob->text, sizeof(q->text)) && (i || !q->done)) {
+            pthread_mutex_unlock (&spool_mutex);
+            printf ("%s : ch = %d, same job pending (seq = %u)\n", __func__, pjob->ch, q->seq);
+            return 0;
+        }
+    }
+    if (SpoolCnt >= SPOOL_JOB_MAX) {
+        pthread_mutex_unlock (&spool_mutex);
+        printf ("%s : ch = %d, spool full (%d jobs)\n", __func__, pjob->ch, SpoolCnt);
+        return 0;
+    }
+    pjob->seq = SpoolSeq++;
+    memcpy (&SLOT(SpoolCnt)->job, pjob, sizeof(spool_job_t));
+    SLOT(SpoolCnt)->saved = 0;
+    SpoolCnt++;
+    pthread_cond_signal  (&spool_cond);
+    pthread_mutex_unlock (&spool_mutex);
+
+    printf ("%s : ch = %d, seq = %u, %d label(s)\n", __func__, pjob->ch, pjob->seq, label);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+int spool_print_mac (const char *mac, int ch)
+{
+    spool_job_t job;
+
+    memset  (&job, 0, sizeof(job));
+    job.type  = eSPOOL_MAC;
+    job.ch    = ch;
+    job.lines = 1;
+    strncpy (job.text[0], mac, SPOOL_LINE_SIZE -1);
+
+    return spool_enqueue (&job);
+}
+
+//------------------------------------------------------------------------------
+// msg = msg_size 간격의 문자열 cnt 개. 빈 문자열은 제외하고 3줄씩 label 로 묶음.
+//------------------------------------------------------------------------------
+int spool_print_err (const char *msg, int msg_size, int cnt, int ch)
+{
+    spool_job_t job;
+    int i;
+
+    memset  (&job, 0, sizeof(job));
+    job.type = eSPOOL_ERR;
+    job.ch   = ch;
+
+    for (i = 0; (i < cnt) && (job.lines < SPOOL_LINE_MAX); i++) {
+        const char *str = msg + i * msg_size;
+
+        if (!str[0])    continue;
+        strncpy (job.text[job.lines++], str,
+            (msg_size && (msg_size < SPOOL_LINE_SIZE)) ? msg_size : SPOOL_LINE_SIZE -1);
+    }
+    if (!job.lines)     return 0;
+
+    return spool_enqueue (&job);
+}
+
+//------------------------------------------------------------------------------
+// printer reinit (touch) : 대기중인 job 은 바로 재시도
+//------------------------------------------------------------------------------
+int spool_config (void)
+{
+    int ret;
+
+    pthread_mutex_lock   (&lp_mutex);
+    ret = hw_usblp_config ();
+    pthread_mutex_unlock (&lp_mutex);
+
+    pthread_mutex_lock   (&spool_mutex);
+    RetryMs = 0;    RetryAt = 0;
+    pthread_cond_signal  (&spool_cond);
+    pthread_mutex_unlock (&spool_mutex);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+// printer reinit 을 spool thread 에서 실행 (control api, 호출한 thread 는 바로 return)
+// 결과는 ui thread 의 usblp 상태 (hw_usblp_connection) 로 확인
+//------------------------------------------------------------------------------
+void spool_config_request (void)
+{
+    pthread_mutex_lock   (&spool_mutex);
+    ConfigReq = 1;
+    pthread_cond_signal  (&spool_cond);
+    pthread_mutex_unlock (&spool_mutex);
+}
+
+//------------------------------------------------------------------------------
+int spool_depth (void)
+{
+    return SpoolCnt;
+}
+
+//------------------------------------------------------------------------------
+// file 의 미출력 job 을 queue 에 load 후 file 을 다시 기록 (compaction)
+//------------------------------------------------------------------------------
+static void spool_load (void)
+{
+    spool_hdr_t hdr;
+    spool_job_t job;
+    int i;
+
+    if ((read (SpoolFd, &hdr, sizeof(hdr)) == sizeof(hdr)) &&
+        (hdr.magic == SPOOL_MAGIC) && (hdr.rec_size == sizeof(spool_job_t))) {
+        while (read (SpoolFd, &job, sizeof(job)) == sizeof(job)) {
+            if (job.seq >= SpoolSeq)    SpoolSeq = job.seq + 1;
+            if ((job.done == SPOOL_JOB_DONE) || (SpoolCnt >= SPOOL_JOB_MAX))
+                continue;
+            if ((job.type != eSPOOL_MAC) && (job.type != eSPOOL_ERR))
+                continue;
+            job.lines = (job.lines > SPOOL_LINE_MAX) ? SPOOL_LINE_MAX : job.lines;
+            memcpy (&SLOT(SpoolCnt++)->job, &job, sizeof(job));
+        }
+    }
+
+    memset (&hdr, 0, sizeof(hdr));
+    hdr.magic    = SPOOL_MAGIC;
+    hdr.version  = SPOOL_VERSION;
+    hdr.rec_size = sizeof(spool_job_t);
+
+    if (ftruncate (SpoolFd, 0) || (pwrite (SpoolFd, &hdr, sizeof(hdr), 0) != sizeof(hdr))) {
+        printf ("%s : %s write error (%s)\n", __func__, SpoolPath, strerror(errno));
+        close (SpoolFd);    SpoolFd = -1;
+        return;
+    }
+    SpoolEnd = sizeof(hdr);
+    for (i = 0; i < SpoolCnt; i++) {
+        if (pwrite (SpoolFd, &SLOT(i)->job, sizeof(spool_job_t), SpoolEnd) != sizeof(spool_job_t))
+            break;
+        SLOT(i)->off   = SpoolEnd;
+        SLOT(i)->saved = 1;
+        SpoolEnd += sizeof(spool_job_t);
+    }
+    fdatasync (SpoolFd);
+}
+
+//------------------------------------------------------------------------------
+int spool_init (const char *fname)
+{
+    pthread_condattr_t attr;
+    char *ptr;
+
+    memset  (SpoolPath, 0, sizeof(SpoolPath));
+    strncpy (SpoolPath, fname ? fname : SPOOL_FILE_PATH, sizeof(SpoolPath) -1);
+
+    if ((ptr = strrchr (SpoolPath, '/')) != NULL) {
+        *ptr = 0;   mkdir (SpoolPath, 0755);    *ptr = '/';
+    }
+
+    pthread_condattr_init     (&attr);
+    pthread_condattr_setclock (&attr, CLOCK_MONOTONIC);
+    pthread_cond_init         (&spool_cond, &attr);
+    pthread_condattr_destroy  (&attr);
+
+    /* file 이 없어도 spooler 는 동작 (memory queue) */
+    if ((SpoolFd = open (SpoolPath, O_RDWR | O_CREAT, 0644)) < 0)
+        printf ("%s : %s open error (%s)\n", __func__, SpoolPath, strerror(errno));
+    else
+        spool_load ();
+
+    printf ("%s : %s, %d job(s) pending\n", __func__, SpoolPath, SpoolCnt);
+
+    pthread_create (&thread_spool, NULL, thread_spool_func, NULL);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------------
+/**
+ * @file spooler.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server label print spooler (usblp async print queue).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __SPOOLER_H__
+#define __SPOOLER_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+//
+// main/ui thread 는 print job 을 queue 에 넣고 바로 return.
+// spool thread 가 job 을 file 에 기록(fdatasync) 후 printer 로 출력.
+// 출력 완료 표시 전에 server 가 종료되면 다음 실행시 다시 출력함.
+//
+//------------------------------------------------------------------------------
+#define SPOOL_FILE_PATH     "result/print_spool.dat"
+#define SPOOL_MAGIC         0x4C50534A  // "JSPL"
+#define SPOOL_VERSION       1
+
+#define SPOOL_JOB_MAX       64
+#define SPOOL_LINE_MAX      20          // USBLP_ERR_LINE
+#define SPOOL_LINE_SIZE     20          // USBLP_MAX_CHAR + 1
+#define SPOOL_LABEL_LINE    3           // usblp_print_err 1 label = 3 line
+
+/* printer 출력 실패시 retry 간격 (2배씩 증가) */
+#define SPOOL_RETRY_MIN_MS  200
+#define SPOOL_RETRY_MAX_MS  10000
+
+enum {
+    eSPOOL_MAC = 1,
+    eSPOOL_ERR,
+};
+
+//------------------------------------------------------------------------------
+// file record (fixed size), done = 출력 완료된 label 수 (0xFF = job 완료)
+//------------------------------------------------------------------------------
+#define SPOOL_JOB_DONE      0xFF
+
+typedef struct spool_job__t {
+    uint32_t    seq;
+    uint8_t     type;
+    uint8_t     ch;
+    uint8_t     lines;
+    uint8_t     done;
+    char        text [SPOOL_LINE_MAX][SPOOL_LINE_SIZE];
+}   spool_job_t;
+
+typedef struct spool_hdr__t {
+    uint32_t    magic;
+    uint16_t    version;
+    uint16_t    rec_size;
+}   spool_hdr_t;
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+extern  int     spool_init      (const char *fname);
+extern  int     spool_print_mac (const char *mac, int ch);
+extern  int     spool_print_err (const char *msg, int msg_size, int cnt, int ch);
+extern  int     spool_config    (void);
+extern  void    spool_config_request (void);
+extern  int     spool_depth     (void);
+
+//------------------------------------------------------------------------------
+#endif  // __SPOOLER_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
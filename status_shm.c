@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+/**
+ * @file status_shm.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server status page (shared memory, seqlock).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+//------------------------------------------------------------------------------
+#include "status_shm.h"
+
+//------------------------------------------------------------------------------
+#define STATUS_READ_RETRY   1000
+
+//------------------------------------------------------------------------------
+static status_page_t    *StatusPage = NULL;
+
+/* writer 는 ui/main thread 두곳, writer 간에만 lock 사용 */
+static pthread_mutex_t  status_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+//------------------------------------------------------------------------------
+int status_shm_init (const char *fname, int ch_cnt)
+{
+    struct timespec ts;
+    int fd;
+
+    if ((fd = open (fname, O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0) {
+        printf ("%s : %s open error (%s)\n", __func__, fname, strerror(errno));
+        return 0;
+    }
+    if (ftruncate (fd, sizeof(status_page_t)) < 0) {
+        close (fd);
+        return 0;
+    }
+    StatusPage = mmap (NULL, sizeof(status_page_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close (fd);
+
+    if (StatusPage == MAP_FAILED) {
+        StatusPage = NULL;
+        return 0;
+    }
+
+    clock_gettime (CLOCK_REALTIME, &ts);
+    memset (StatusPage, 0, sizeof(status_page_t));
+    StatusPage->version = STATUS_SHM_VERSION;
+    StatusPage->ch_cnt  = (ch_cnt > STATUS_CH_MAX) ? STATUS_CH_MAX : ch_cnt;
+    StatusPage->boot_ts = (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+
+    /* reader 는 magic 확인 후 사용 */
+    __atomic_store_n (&StatusPage->magic, STATUS_SHM_MAGIC, __ATOMIC_RELEASE);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// seq 홀수 = 갱신중, status_shm_end() 까지 page 수정 가능 (return NULL : 미사용)
+//------------------------------------------------------------------------------
+status_page_t *status_shm_begin (void)
+{
+    if (StatusPage == NULL)     return NULL;
+
+    pthread_mutex_lock (&status_mutex);
+    __atomic_store_n (&StatusPage->seq, StatusPage->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence (__ATOMIC_RELEASE);
+    return StatusPage;
+}
+
+//------------------------------------------------------------------------------
+void status_shm_end (void)
+{
+    if (StatusPage == NULL)     return;
+
+    __atomic_store_n (&StatusPage->seq, StatusPage->seq + 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock (&status_mutex);
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+const status_page_t *status_shm_open (const char *fname)
+{
+    const status_page_t *page;
+    int fd;
+
+    if ((fd = open (fname, O_RDONLY)) < 0)  return NULL;
+
+    page = mmap (NULL, sizeof(status_page_t), PROT_READ, MAP_SHARED, fd, 0);
+    close (fd);
+
+    if (page == MAP_FAILED)     return NULL;
+    if ((__atomic_load_n (&page->magic, __ATOMIC_ACQUIRE) != STATUS_SHM_MAGIC) ||
+        (page->version != STATUS_SHM_VERSION)) {
+        munmap ((void *)page, sizeof(status_page_t));
+        return NULL;
+    }
+    return page;
+}
+
+//------------------------------------------------------------------------------
+// return 1 : consistent snapshot, 0 : writer 가 계속 갱신중 (retry 초과)
+//------------------------------------------------------------------------------
+int status_shm_read (const status_page_t *page, status_page_t *snap)
+{
+    uint32_t seq1, seq2;
+    int retry;
+
+    for (retry = 0; retry < STATUS_READ_RETRY; retry++) {
+        seq1 = __atomic_load_n (&page->seq, __ATOMIC_ACQUIRE);
+        if (seq1 & 1)   { sched_yield (); continue; }
+
+        memcpy (snap, page, sizeof(status_page_t));
+        __atomic_thread_fence (__ATOMIC_ACQUIRE);
+
+        seq2 = __atomic_load_n (&page->seq, __ATOMIC_RELAXED);
+        if (seq1 == seq2)   return 1;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
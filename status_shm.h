@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+/**
+ * @file status_shm.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server status page (shared memory, seqlock).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __STATUS_SHM_H__
+#define __STATUS_SHM_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+//
+// 외부 monitor(dashboard, script) 용 고정 layout status page.
+// server 는 seqlock 으로 갱신하며 reader 는 lock 없이 seq 값이 같을 때까지 재시도 한다.
+//
+//------------------------------------------------------------------------------
+#define STATUS_SHM_PATH     "/dev/shm/jig_status"
+#define STATUS_SHM_MAGIC    0x5453474A  // "JGST"
+#define STATUS_SHM_VERSION  1
+
+#define STATUS_CH_MAX       2
+#define STATUS_ITEM_MAX     128         // bitmap size (d_item pos)
+#define STATUS_STR_SIZE     24
+
+//------------------------------------------------------------------------------
+typedef struct status_ch__t {
+    uint32_t    status;         // eSTATUS_xxx (server.h)
+    uint32_t    ready;
+    uint32_t    power;          // board power detect
+    uint32_t    mac_dup;
+    int32_t     cur_gid;        // last received item
+    int32_t     cur_did;
+    char        cur_value [STATUS_STR_SIZE];
+    char        mac       [STATUS_STR_SIZE];
+    uint32_t    item_cnt;       // d_item count
+    uint32_t    err_cnt;
+    uint64_t    pass_map [STATUS_ITEM_MAX / 64];
+    uint64_t    fail_map [STATUS_ITEM_MAX / 64];
+    uint64_t    board_cnt;      // server start 이후 누적
+    uint64_t    pass_cnt;
+    uint64_t    fail_cnt;
+    uint64_t    update_ms;      // epoch ms
+}   status_ch_t;
+
+typedef struct status_page__t {
+    uint32_t    magic;
+    uint32_t    version;
+    uint32_t    seq;            // seqlock (odd = writing)
+    uint32_t    ch_cnt;
+    uint64_t    boot_ts;        // epoch ms
+    char        ip_addr [STATUS_STR_SIZE];
+    uint32_t    usblp_status;
+    uint32_t    rsvd;
+    status_ch_t ch [STATUS_CH_MAX];
+}   status_page_t;
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+/* server (writer) */
+extern  int             status_shm_init     (const char *fname, int ch_cnt);
+extern  status_page_t   *status_shm_begin   (void);
+extern  void            status_shm_end      (void);
+
+/* monitor (reader) */
+extern  const status_page_t *status_shm_open(const char *fname);
+extern  int             status_shm_read     (const status_page_t *page, status_page_t *snap);
+
+//------------------------------------------------------------------------------
+#endif  // __STATUS_SHM_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
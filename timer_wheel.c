@@ -0,0 +1,304 @@
+//------------------------------------------------------------------------------
+/**
+ * @file timer_wheel.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server hierarchical timer wheel (CLOCK_MONOTONIC, single timerfd).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/timerfd.h>
+
+//------------------------------------------------------------------------------
+#include "timer_wheel.h"
+#include "mono_time.h"
+
+//------------------------------------------------------------------------------
+#define TW_L0_SIZE      (1 << TW_L0_BITS)
+#define TW_LN_SIZE      (1 << TW_LN_BITS)
+#define TW_SHIFT(l)     ((l) ? TW_L0_BITS + TW_LN_BITS * ((l) -1) : 0)
+#define TW_MASK(l)      ((l) ? TW_LN_SIZE -1 : TW_L0_SIZE -1)
+
+static pthread_mutex_t  tw_mutex = PTHREAD_MUTEX_INITIALIZER;
+static tw_timer_t       *Wheel    [TW_LEVELS][TW_L0_SIZE];
+static uint64_t         WheelMap  [TW_LEVELS][TW_L0_SIZE / 64];    // slot 사용 bitmap
+static uint64_t         WheelNow = 0;   // 다음에 처리할 ms (mono ms)
+static int              WheelCnt = 0;   // 대기중인 timer 수
+
+static int              TwFd   = -1;
+static uint64_t         TwNext = 0;     // timerfd 설정 시각 (0 = 해제)
+static pthread_t        thread_tw;
+
+//------------------------------------------------------------------------------
+static void tw_link (tw_timer_t *t, int lvl, int idx)
+{
+    tw_timer_t **head = &Wheel[lvl][idx];
+
+    if ((t->next = *head) != NULL)  t->next->pprev = &t->next;
+    *head    = t;
+    t->pprev = head;
+    t->slot  = (uint16_t)((lvl << 8) | idx);
+    WheelMap[lvl][idx / 64] |= 1ull << (idx % 64);
+    WheelCnt++;
+}
+
+//------------------------------------------------------------------------------
+static void tw_unlink (tw_timer_t *t)
+{
+    int lvl = t->slot >> 8, idx = t->slot & 0xFF;
+
+    if ((*t->pprev = t->next) != NULL)  t->next->pprev = t->pprev;
+    t->next  = NULL;
+    t->pprev = NULL;
+    if (Wheel[lvl][idx] == NULL)
+        WheelMap[lvl][idx / 64] &= ~(1ull << (idx % 64));
+    WheelCnt--;
+}
+
+//------------------------------------------------------------------------------
+// 남은 시간으로 level 결정 (level n 은 WheelNow 기준 1 ~ 63 slot 뒤에만 들어감)
+//------------------------------------------------------------------------------
+static void tw_add (tw_timer_t *t)
+{
+    uint64_t expire = (t->expire < WheelNow) ? WheelNow : t->expire;
+    int lvl;
+
+    /* wheel 범위를 넘는 timer 는 마지막 slot 에서 다시 cascade */
+    if (expire - WheelNow > TW_MAX_MS)  expire = WheelNow + TW_MAX_MS;
+
+    for (lvl = 0; lvl < TW_LEVELS -1; lvl++)
+        if (expire - WheelNow < (1ull << TW_SHIFT(lvl +1)))     break;
+
+    tw_link (t, lvl, (int)((expire >> TW_SHIFT(lvl)) & TW_MASK(lvl)));
+}
+
+//------------------------------------------------------------------------------
+// 현재 slot 의 timer 를 아래 level 로 내림, return slot index (0 이면 위 level 도 cascade)
+//------------------------------------------------------------------------------
+static int tw_cascade (int lvl)
+{
+    int idx = (int)((WheelNow >> TW_SHIFT(lvl)) & TW_MASK(lvl));
+    tw_timer_t *t, *list = Wheel[lvl][idx];
+
+    Wheel[lvl][idx] = NULL;
+    WheelMap[lvl][idx / 64] &= ~(1ull << (idx % 64));
+
+    while ((t = list) != NULL) {
+        list = t->next;
+        t->next = NULL;     t->pprev = NULL;
+        WheelCnt--;
+        tw_add (t);
+    }
+    return idx;
+}
+
+//------------------------------------------------------------------------------
+static int tw_slot_busy (int lvl, int idx)
+{
+    return (WheelMap[lvl][idx / 64] >> (idx % 64)) & 1;
+}
+
+//------------------------------------------------------------------------------
+// 가장 빠른 처리 시각 (level 0 = 만료 시각, level n = 해당 slot 의 cascade 시각), 0 = timer 없음
+//------------------------------------------------------------------------------
+static uint64_t tw_next (void)
+{
+    uint64_t next = 0, base, at;
+    int lvl, k, idx;
+
+    if (!WheelCnt)  return 0;
+
+    for (k = 0; k < TW_L0_SIZE; k++) {
+        if (tw_slot_busy (0, (int)((WheelNow + k) & TW_MASK(0)))) {
+            next = WheelNow + k;
+            break;
+        }
+    }
+    for (lvl = 1; lvl < TW_LEVELS; lvl++) {
+        /* WheelNow 이후 첫 cascade 구간 */
+        base = (WheelNow + (1ull << TW_SHIFT(lvl)) -1) >> TW_SHIFT(lvl);
+        for (k = 0; k < TW_LN_SIZE; k++) {
+            idx = (int)((base + k) & TW_MASK(lvl));
+            if (!tw_slot_busy (lvl, idx))   continue;
+
+            at = (base + k) << TW_SHIFT(lvl);
+            if (!next || (at < next))   next = at;
+            break;
+        }
+    }
+    return next;
+}
+
+//------------------------------------------------------------------------------
+static void tw_settime (uint64_t at)
+{
+    struct itimerspec its;
+
+    if (TwFd < 0)   return;
+
+    memset (&its, 0, sizeof(its));
+    its.it_value.tv_sec  = at / 1000;
+    its.it_value.tv_nsec = (at % 1000) * 1000000;
+    if (timerfd_settime (TwFd, TFD_TIMER_ABSTIME, &its, NULL) == 0)
+        TwNext = at;
+}
+
+//------------------------------------------------------------------------------
+// now (mono ms) 까지 만료된 timer 실행 (tw_mutex lock 상태, callback 은 unlock 후 실행)
+//------------------------------------------------------------------------------
+static void tw_run (uint64_t now)
+{
+    void (*func)(tw_timer_t *t);
+    tw_timer_t *t;
+    int idx, lvl;
+
+    while (WheelNow <= now) {
+        idx = (int)(WheelNow & TW_MASK(0));
+
+        if (!idx)
+            for (lvl = 1; (lvl < TW_LEVELS) && !tw_cascade (lvl); lvl++);
+
+        /* level 0 이 비어있으면 다음 cascade 시각까지 건너뜀 */
+        if (idx && !WheelMap[0][0] && !WheelMap[0][1] && !WheelMap[0][2] && !WheelMap[0][3]) {
+            uint64_t b = (WheelNow | TW_MASK(0)) +1;
+
+            WheelNow = (now +1 < b) ? now +1 : b;
+            continue;
+        }
+        while ((t = Wheel[0][idx]) != NULL) {
+            tw_unlink (t);
+            /* 주기 timer : 이전 만료 시각 기준 (밀린 경우 현재 기준) */
+            if (t->period) {
+                t->expire = (t->expire + t->period > WheelNow) ?
+                            t->expire + t->period : WheelNow + t->period;
+                tw_add (t);
+            }
+            func = t->func;
+            pthread_mutex_unlock (&tw_mutex);
+            if (func)   func (t);
+            pthread_mutex_lock   (&tw_mutex);
+        }
+        WheelNow++;
+    }
+}
+
+//------------------------------------------------------------------------------
+static void *thread_tw_func (void *arg)
+{
+    uint64_t cnt;
+
+    while (1) {
+        if (read (TwFd, &cnt, sizeof(cnt)) != sizeof(cnt)) {
+            if (errno != EINTR)     usleep (1000);
+            continue;
+        }
+        pthread_mutex_lock   (&tw_mutex);
+        tw_run (mono_ms ());
+        tw_settime (tw_next ());
+        pthread_mutex_unlock (&tw_mutex);
+    }
+    return arg;
+}
+
+//------------------------------------------------------------------------------
+// 대기중이 아닌 (0 으로 초기화된) timer 만 설정
+//------------------------------------------------------------------------------
+void tw_setup (tw_timer_t *t, void (*func)(tw_timer_t *t), void *arg)
+{
+    memset (t, 0, sizeof(tw_timer_t));
+    t->func = func;
+    t->arg  = arg;
+}
+
+//------------------------------------------------------------------------------
+static void tw_start (tw_timer_t *t, uint32_t ms, uint32_t period)
+{
+    pthread_mutex_lock   (&tw_mutex);
+    /* tw_init 이전 설정 (cfg, channel 초기화) */
+    if (!WheelNow)  WheelNow = mono_ms ();
+    if (t->pprev)   tw_unlink (t);
+
+    t->expire = mono_ms () + ms;
+    t->period = period;
+    tw_add (t);
+
+    /* 현재 timerfd 보다 빠른 timer 만 다시 설정 */
+    if (!TwNext || (t->expire < TwNext))
+        tw_settime (t->expire);
+    pthread_mutex_unlock (&tw_mutex);
+}
+
+//------------------------------------------------------------------------------
+void tw_arm (tw_timer_t *t, uint32_t ms)
+{
+    tw_start (t, ms, 0);
+}
+
+//------------------------------------------------------------------------------
+void tw_arm_every (tw_timer_t *t, uint32_t period_ms)
+{
+    tw_start (t, period_ms, period_ms ? period_ms : 1);
+}
+
+//------------------------------------------------------------------------------
+void tw_cancel (tw_timer_t *t)
+{
+    pthread_mutex_lock   (&tw_mutex);
+    if (t->pprev)   tw_unlink (t);
+    pthread_mutex_unlock (&tw_mutex);
+}
+
+//------------------------------------------------------------------------------
+int tw_pending (tw_timer_t *t)
+{
+    int pending;
+
+    pthread_mutex_lock   (&tw_mutex);
+    pending = (t->pprev != NULL);
+    pthread_mutex_unlock (&tw_mutex);
+    return pending;
+}
+
+//------------------------------------------------------------------------------
+uint64_t tw_expires (tw_timer_t *t)
+{
+    uint64_t expire;
+
+    pthread_mutex_lock   (&tw_mutex);
+    expire = t->pprev ? t->expire : 0;
+    pthread_mutex_unlock (&tw_mutex);
+    return expire;
+}
+
+//------------------------------------------------------------------------------
+int tw_init (void)
+{
+    if ((TwFd = timerfd_create (CLOCK_MONOTONIC, TFD_CLOEXEC)) < 0) {
+        printf ("%s : timerfd_create error (%s)\n", __func__, strerror (errno));
+        return 0;
+    }
+    pthread_mutex_lock   (&tw_mutex);
+    if (!WheelNow)  WheelNow = mono_ms ();
+    tw_settime (tw_next ());
+    pthread_mutex_unlock (&tw_mutex);
+
+    pthread_create (&thread_tw, NULL, thread_tw_func, NULL);
+    printf ("%s : tick 1 ms, %d level, max %d sec\n", __func__,
+        TW_LEVELS, (int)(TW_MAX_MS / 1000));
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,66 @@
+//------------------------------------------------------------------------------
+/**
+ * @file timer_wheel.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server hierarchical timer wheel (CLOCK_MONOTONIC, single timerfd).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __TIMER_WHEEL_H__
+#define __TIMER_WHEEL_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+//
+// 1ms tick, 4 level wheel (256 x 64 x 64 x 64 slot, 최대 약 18 시간)
+//
+//   level 0 : 0 ~ 255 ms 안에 만료되는 timer (slot = 만료 ms)
+//   level n : level n-1 한 바퀴가 돌때마다 해당 slot 을 아래 level 로 내림 (cascade)
+//
+// timer 는 사용하는 쪽 구조체에 포함 (별도 alloc 없음), slot list 연결/해제만 하므로 arm, cancel 은 O(1).
+// 전체 timer 중 가장 빠른 만료 시각 하나로 timerfd 를 설정, timer thread 가 깨어나서 callback 실행.
+//
+// callback 은 timer thread 에서 실행되므로 짧게 (flag, event 전달) 만 처리.
+// 실제 처리 (uart 전송, ui) 는 각 thread 에서.
+//
+//------------------------------------------------------------------------------
+#define TW_L0_BITS      8
+#define TW_LN_BITS      6
+#define TW_LEVELS       4
+#define TW_MAX_MS       ((1ull << (TW_L0_BITS + TW_LN_BITS * (TW_LEVELS -1))) -1)
+
+typedef struct tw_timer__t {
+    struct tw_timer__t  *next, **pprev;     // slot list (pprev == NULL : 대기중 아님)
+    uint64_t            expire;             // 만료 시각 (mono ms)
+    uint32_t            period;             // 0 = one shot, 주기 timer 는 만료 시각 기준으로 다시 설정 (drift 없음)
+    uint16_t            slot;               // level << 8 | index
+    void                (*func) (struct tw_timer__t *t);
+    void                *arg;
+}   tw_timer_t;
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+extern  int         tw_init     (void);
+extern  void        tw_setup    (tw_timer_t *t, void (*func)(tw_timer_t *t), void *arg);
+/* 대기중인 timer 도 다시 설정 (이전 만료 시각 취소) */
+extern  void        tw_arm      (tw_timer_t *t, uint32_t ms);
+extern  void        tw_arm_every(tw_timer_t *t, uint32_t period_ms);
+extern  void        tw_cancel   (tw_timer_t *t);
+extern  int         tw_pending  (tw_timer_t *t);
+/* 다음 만료 시각 (mono ms, 0 = 대기중 아님) */
+extern  uint64_t    tw_expires  (tw_timer_t *t);
+
+//------------------------------------------------------------------------------
+#endif  // __TIMER_WHEEL_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
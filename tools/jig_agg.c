@@ -0,0 +1,625 @@
+//------------------------------------------------------------------------------
+/**
+ * @file jig_agg.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG line result aggregator (jig server 'A' line push, merged store).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <ctype.h>
+#include <signal.h>
+#include <getopt.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+
+//------------------------------------------------------------------------------
+#include "../agg_push.h"
+#include "../result_store.h"
+#include "../lz.h"
+#include "../crc.h"
+
+//------------------------------------------------------------------------------
+//
+// merged store (agg/agg.dat) : record = [agg_rec_t][result.dat raw record]
+//   station / store 별 다음 offset 과 mac index 는 시작시 store scan 으로 생성.
+//
+//------------------------------------------------------------------------------
+#define AGG_STORE_PATH      "agg/agg.dat"
+#define AGG_REC_MAGIC       0x4147414A  // "JAGA"
+
+#define AGG_CONN_MAX        32
+#define AGG_STATION_MAX     64
+#define AGG_HASH_SIZE       65536
+#define AGG_INDEX_STEP      4096
+
+typedef struct agg_rec__t {
+    uint32_t    magic;
+    uint32_t    store_id;
+    uint32_t    size;       // raw record size (result_hdr_t 포함)
+    uint32_t    reserved;
+    uint64_t    src_offset; // server result.dat offset
+    uint64_t    recv_ts;    // epoch ms
+    char        station [AGG_STATION_SIZE];
+}   agg_rec_t;
+
+typedef struct agg_station__t {
+    char        station [AGG_STATION_SIZE];
+    uint32_t    store_id;
+    uint64_t    next;       // 다음 받을 src offset
+    uint32_t    cnt, pass, dup;
+}   agg_station_t;
+
+typedef struct agg_node__t {
+    uint64_t    key;
+    uint64_t    offset;
+    int32_t     next;
+}   agg_node_t;
+
+typedef struct agg_conn__t {
+    int         fd;
+    int         no;
+    int         pos;        // header + payload 수신 위치
+    agg_msg_t   msg;
+    uint8_t     *buf;
+}   agg_conn_t;
+
+//------------------------------------------------------------------------------
+static agg_conn_t       Conn [AGG_CONN_MAX];
+static agg_station_t    Station [AGG_STATION_MAX];
+static int              StationCnt = 0;
+
+static int32_t          *MacHash = NULL;
+static agg_node_t       *MacNode = NULL;
+static int              MacCnt = 0, MacMax = 0;
+
+static int              StoreFd = -1;
+static uint64_t         StoreSize = 0;
+static uint8_t          *RawBuf;
+static volatile int     Running = 1;
+static uint32_t         Conns = 0;
+
+static int  OPT_PORT = AGG_PORT, OPT_SUMMARY = 0;
+static char *OPT_STORE = AGG_STORE_PATH, *OPT_QUERY = NULL, *OPT_HOST = "127.0.0.1";
+
+//------------------------------------------------------------------------------
+static void print_usage (const char *prog)
+{
+    puts("");
+    printf("Usage: %s [-p port] [-o store] [-s] [-q mac [-a host]]\n", prog);
+    puts("\n"
+        "  -p {port}     : listen port (default 9200)\n"
+        "  -o {store}    : merged store file (default agg/agg.dat)\n"
+        "  -s            : station 별 record / pass / yield 출력 후 종료 (store file)\n"
+        "  -q {mac}      : 실행중인 aggregator 에서 mac 검색\n"
+        "  -a {host}     : -q 로 접속할 aggregator (default 127.0.0.1)\n"
+        "\n"
+        "  e.g) jig_agg -p 9200 -o /data/agg.dat\n"
+        "       jig_agg -q 00:1e:06:12:34:56\n"
+    );
+    exit(1);
+}
+
+//------------------------------------------------------------------------------
+static void parse_opts (int argc, char *argv[])
+{
+    int c;
+
+    while ((c = getopt (argc, argv, "p:o:sq:a:h")) != -1) {
+        switch (c) {
+            case 'p':   OPT_PORT    = atoi (optarg); break;
+            case 'o':   OPT_STORE   = optarg;        break;
+            case 's':   OPT_SUMMARY = 1;             break;
+            case 'q':   OPT_QUERY   = optarg;        break;
+            case 'a':   OPT_HOST    = optarg;        break;
+            default :   print_usage (argv[0]);       break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+static void sig_handler (int sig)
+{
+    (void)sig;
+    Running = 0;
+}
+
+//------------------------------------------------------------------------------
+static uint64_t real_ms (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+//------------------------------------------------------------------------------
+// mac 구분자 / 대소문자 무시 FNV-1a
+//------------------------------------------------------------------------------
+static uint64_t mac_key (const char *mac)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+
+    for (; *mac; mac++) {
+        if ((*mac == ':') || (*mac == '-') || (*mac == ' '))    continue;
+        hash = (hash ^ (uint8_t)tolower ((unsigned char)*mac)) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+//------------------------------------------------------------------------------
+// raw record (result_hdr_t + section) 의 HEAD section 만 해석
+//------------------------------------------------------------------------------
+static int rec_head (const uint8_t *raw, int size, result_rec_t *prec)
+{
+    const result_hdr_t *hdr = (const result_hdr_t *)raw;
+    result_sec_t sec;
+
+    if ((size < (int)(sizeof(result_hdr_t) + sizeof(sec))) || (hdr->magic != RESULT_REC_MAGIC))
+        return 0;
+    memcpy (&sec, raw + sizeof(result_hdr_t), sizeof(sec));
+    if ((sec.tag != eRESULT_TAG_HEAD) || (sec.size != offsetof(result_rec_t, item)) ||
+        (sizeof(result_hdr_t) + sizeof(sec) + sec.size > (size_t)size))
+        return 0;
+
+    memcpy (prec, raw + sizeof(result_hdr_t) + sizeof(sec), sec.size);
+    prec->mac[RESULT_MAC_SIZE -1] = 0;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+// 완전한 raw record 확인, return record size (0 = 오류)
+//------------------------------------------------------------------------------
+static int rec_check (const uint8_t *raw, int size)
+{
+    result_hdr_t hdr;
+
+    if (size < (int)sizeof(hdr))    return 0;
+    memcpy (&hdr, raw, sizeof(hdr));
+    if ((hdr.magic != RESULT_REC_MAGIC) || (hdr.size > (uint32_t)(size - sizeof(hdr))))
+        return 0;
+    if (crc32_calc (raw + sizeof(hdr), hdr.size) != hdr.crc)
+        return 0;
+    return sizeof(hdr) + hdr.size;
+}
+
+//------------------------------------------------------------------------------
+static agg_station_t *station_get (const char *name, uint32_t store_id)
+{
+    agg_station_t *s;
+    int i;
+
+    for (i = 0; i < StationCnt; i++) {
+        s = &Station[i];
+        if ((s->store_id == store_id) && !strncmp (s->station, name, AGG_STATION_SIZE))
+            return s;
+    }
+    if (StationCnt >= AGG_STATION_MAX)  return NULL;
+
+    s = &Station[StationCnt++];
+    memset (s, 0, sizeof(agg_station_t));
+    memcpy (s->station, name, AGG_STATION_SIZE);
+    s->station[AGG_STATION_SIZE -1] = 0;
+    s->store_id = store_id;
+    return s;
+}
+
+//------------------------------------------------------------------------------
+static void index_add (const agg_rec_t *prec, const uint8_t *raw, uint64_t offset)
+{
+    static result_rec_t rec;
+    agg_station_t *s = station_get (prec->station, prec->store_id);
+    uint32_t bucket;
+    uint64_t key;
+
+    if (s != NULL) {
+        s->next = prec->src_offset + prec->size;
+        s->cnt++;
+    }
+    if (!rec_head (raw, prec->size, &rec))  return;
+    if (s && (rec.result == eRESULT_PASS))  s->pass++;
+    if (!rec.mac[0])    return;
+
+    if (MacCnt >= MacMax) {
+        agg_node_t *p = realloc (MacNode, (MacMax + AGG_INDEX_STEP) * sizeof(agg_node_t));
+        if (p == NULL)  return;
+        MacNode = p;    MacMax += AGG_INDEX_STEP;
+    }
+    key    = mac_key (rec.mac);
+    bucket = (uint32_t)(key ^ (key >> 32)) & (AGG_HASH_SIZE -1);
+    MacNode[MacCnt].key    = key;
+    MacNode[MacCnt].offset = offset;
+    MacNode[MacCnt].next   = MacHash[bucket];
+    MacHash[bucket] = MacCnt++;
+}
+
+//------------------------------------------------------------------------------
+// store scan : station 별 offset, mac index. 마지막 record 가 깨진 경우 truncate
+//------------------------------------------------------------------------------
+static int store_load (void)
+{
+    agg_rec_t rec;
+    struct stat st;
+    uint64_t offset = 0;
+    char path[256], *ptr;
+    int i;
+
+    memset  (path, 0, sizeof(path));
+    strncpy (path, OPT_STORE, sizeof(path) -1);
+    if ((ptr = strrchr (path, '/')) != NULL) {
+        *ptr = 0;   mkdir (path, 0755);     *ptr = '/';
+    }
+    if ((StoreFd = open (path, O_RDWR | O_CREAT | O_APPEND, 0644)) < 0) {
+        fprintf (stderr, "%s open error (%s)\n", path, strerror(errno));
+        return 0;
+    }
+    if ((MacHash = malloc (AGG_HASH_SIZE * sizeof(int32_t))) == NULL)   return 0;
+    for (i = 0; i < AGG_HASH_SIZE; i++)     MacHash[i] = -1;
+
+    fstat (StoreFd, &st);
+    while (pread (StoreFd, &rec, sizeof(rec), offset) == sizeof(rec)) {
+        if ((rec.magic != AGG_REC_MAGIC) || (rec.size > AGG_BATCH_SIZE) ||
+            (pread (StoreFd, RawBuf, rec.size, offset + sizeof(rec)) != (ssize_t)rec.size) ||
+            (rec_check (RawBuf, rec.size) != (int)rec.size))
+            break;
+        index_add (&rec, RawBuf, offset);
+        offset += sizeof(rec) + rec.size;
+    }
+    if (offset != (uint64_t)st.st_size) {
+        fprintf (stderr, "broken record found, truncate %llu -> %llu\n",
+            (unsigned long long)st.st_size, (unsigned long long)offset);
+        if (ftruncate (StoreFd, offset)) {}
+    }
+    StoreSize = offset;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+static int conn_send (agg_conn_t *c, agg_msg_t *pmsg, const void *payload)
+{
+    if (send (c->fd, pmsg, sizeof(agg_msg_t), MSG_NOSIGNAL) != sizeof(agg_msg_t))
+        return 0;
+    if (pmsg->size && (send (c->fd, payload, pmsg->size, MSG_NOSIGNAL) != (ssize_t)pmsg->size))
+        return 0;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+static int conn_reply (agg_conn_t *c, int type, uint64_t offset)
+{
+    agg_msg_t msg;
+
+    memset (&msg, 0, sizeof(msg));
+    msg.magic    = AGG_MAGIC;
+    msg.type     = (uint16_t)type;
+    msg.store_id = c->msg.store_id;
+    msg.offset   = offset;
+    memcpy (msg.station, c->msg.station, AGG_STATION_SIZE);
+    return conn_send (c, &msg, NULL);
+}
+
+//------------------------------------------------------------------------------
+// DATA : 이미 받은 record (ack 유실 후 재전송) 는 건너뛰고 나머지 기록
+//------------------------------------------------------------------------------
+static int conn_data (agg_conn_t *c)
+{
+    agg_msg_t *m = &c->msg;
+    agg_station_t *s = station_get (m->station, m->store_id);
+    uint64_t offset = m->offset;
+    agg_rec_t rec;
+    int raw, pos, size, added = 0, dup = 0;
+
+    if (s == NULL)  return conn_reply (c, eAGG_NACK, 0);
+
+    if (m->flags & AGG_FLAG_LZ)
+        raw = lz_decompress (c->buf, m->size, RawBuf, AGG_BATCH_SIZE);
+    else {
+        /* 비압축 : payload = raw (AGG_PAYLOAD_MAX 는 RawBuf 보다 클 수 있음) */
+        if ((m->size != m->raw_size) || (m->size > AGG_BATCH_SIZE)) {
+            fprintf (stderr, "conn %d : %s size error (%u / %u)\n", c->no, s->station,
+                m->size, m->raw_size);
+            return conn_reply (c, eAGG_NACK, s->next);
+        }
+        raw = m->size;
+        memcpy (RawBuf, c->buf, raw);
+    }
+    if ((raw != (int)m->raw_size) || (crc32_calc (RawBuf, raw) != m->crc)) {
+        fprintf (stderr, "conn %d : %s payload error\n", c->no, s->station);
+        return conn_reply (c, eAGG_NACK, s->next);
+    }
+    if (offset > s->next)
+        fprintf (stderr, "conn %d : %s gap %llu -> %llu\n", c->no, s->station,
+            (unsigned long long)s->next, (unsigned long long)offset);
+
+    for (pos = 0; pos < raw; pos += size, offset += size) {
+        if (!(size = rec_check (RawBuf + pos, raw - pos)))
+            return conn_reply (c, eAGG_NACK, s->next);
+        if (offset < s->next)   { dup++;    s->dup++;   continue; }
+
+        memset (&rec, 0, sizeof(rec));
+        rec.magic      = AGG_REC_MAGIC;
+        rec.store_id   = m->store_id;
+        rec.size       = size;
+        rec.src_offset = offset;
+        rec.recv_ts    = real_ms ();
+        memcpy (rec.station, s->station, AGG_STATION_SIZE);
+
+        if ((write (StoreFd, &rec, sizeof(rec)) != sizeof(rec)) ||
+            (write (StoreFd, RawBuf + pos, size) != size)) {
+            fprintf (stderr, "store write error (%s)\n", strerror(errno));
+            /* 부분 기록은 바로 잘라냄 (다음 record 가 StoreSize 위치에 기록), 이 record 부터 재전송 */
+            if (ftruncate (StoreFd, StoreSize))
+                fprintf (stderr, "store truncate error (%s)\n", strerror(errno));
+            return conn_reply (c, eAGG_NACK, s->next);
+        }
+        index_add (&rec, RawBuf + pos, StoreSize);
+        StoreSize += sizeof(rec) + size;
+        added++;
+    }
+    fdatasync (StoreFd);
+
+    fprintf (stderr, "conn %d : %s +%d (dup %d), %d -> %d byte, total %u\n", c->no,
+        s->station, added, dup, m->raw_size, m->size, s->cnt);
+    return conn_reply (c, eAGG_ACK, s->next);
+}
+
+//------------------------------------------------------------------------------
+// QUERY : payload = mac, 응답 DATA payload = [agg_rec_t][raw record]...
+//------------------------------------------------------------------------------
+static int conn_query (agg_conn_t *c)
+{
+    uint64_t key;
+    agg_msg_t msg;
+    agg_rec_t rec;
+    int32_t n;
+    int len = 0, cnt = 0;
+
+    c->buf[c->msg.size] = 0;
+    key = mac_key ((char *)c->buf);
+
+    for (n = MacHash[(uint32_t)(key ^ (key >> 32)) & (AGG_HASH_SIZE -1)]; n != -1; n = MacNode[n].next) {
+        if (MacNode[n].key != key)  continue;
+        if (pread (StoreFd, &rec, sizeof(rec), MacNode[n].offset) != sizeof(rec))  continue;
+        if (len + (int)sizeof(rec) + (int)rec.size > AGG_BATCH_SIZE)    break;
+
+        memcpy (RawBuf + len, &rec, sizeof(rec));
+        if (pread (StoreFd, RawBuf + len + sizeof(rec), rec.size,
+                    MacNode[n].offset + sizeof(rec)) != (ssize_t)rec.size)
+            continue;
+        len += sizeof(rec) + rec.size;
+        cnt++;
+    }
+    memset (&msg, 0, sizeof(msg));
+    msg.magic    = AGG_MAGIC;
+    msg.type     = eAGG_DATA;
+    msg.cnt      = cnt;
+    msg.raw_size = len;
+    msg.size     = len;
+    msg.crc      = crc32_calc (RawBuf, len);
+    return conn_send (c, &msg, RawBuf);
+}
+
+//------------------------------------------------------------------------------
+// return 0 : connection close
+//------------------------------------------------------------------------------
+static int conn_rx (agg_conn_t *c)
+{
+    int n, want = sizeof(agg_msg_t);
+
+    if (c->pos >= (int)sizeof(agg_msg_t))
+        want += c->msg.size;
+
+    if (c->pos < (int)sizeof(agg_msg_t))
+        n = read (c->fd, (uint8_t *)&c->msg + c->pos, sizeof(agg_msg_t) - c->pos);
+    else
+        n = read (c->fd, c->buf + c->pos - sizeof(agg_msg_t), want - c->pos);
+    if (n <= 0)     return 0;
+    c->pos += n;
+
+    if (c->pos == (int)sizeof(agg_msg_t)) {
+        if ((c->msg.magic != AGG_MAGIC) || (c->msg.size > AGG_PAYLOAD_MAX) ||
+            (c->msg.raw_size > AGG_BATCH_SIZE)) {
+            fprintf (stderr, "conn %d : header error\n", c->no);
+            return 0;
+        }
+        if (c->msg.size)    return 1;
+    }
+    if (c->pos < (int)sizeof(agg_msg_t) + (int)c->msg.size)     return 1;
+
+    c->pos = 0;
+    switch (c->msg.type) {
+        case eAGG_HELLO: {
+            agg_station_t *s = station_get (c->msg.station, c->msg.store_id);
+
+            c->msg.station[AGG_STATION_SIZE -1] = 0;
+            fprintf (stderr, "conn %d : hello %s, store %08x, resume %llu\n", c->no,
+                c->msg.station, c->msg.store_id, s ? (unsigned long long)s->next : 0ull);
+            return s ? conn_reply (c, eAGG_ACK, s->next) : conn_reply (c, eAGG_NACK, 0);
+        }
+        case eAGG_DATA:     return conn_data  (c);
+        case eAGG_QUERY:    return conn_query (c);
+        default:            return 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+static int agg_server (void)
+{
+    struct sockaddr_in addr;
+    struct pollfd pfd [AGG_CONN_MAX + 1];
+    int lfd, i, on = 1;
+
+    memset (&addr, 0, sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons (OPT_PORT);
+    addr.sin_addr.s_addr = htonl (INADDR_ANY);
+
+    lfd = socket (AF_INET, SOCK_STREAM, 0);
+    setsockopt (lfd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (bind (lfd, (struct sockaddr *)&addr, sizeof(addr)) || listen (lfd, 8)) {
+        fprintf (stderr, "port %d bind error (%s)\n", OPT_PORT, strerror(errno));
+        return 1;
+    }
+    for (i = 0; i < AGG_CONN_MAX; i++)  Conn[i].fd = -1;
+
+    fprintf (stderr, "jig_agg : port %d, store %s (%d stations, %d mac)\n",
+        OPT_PORT, OPT_STORE, StationCnt, MacCnt);
+
+    while (Running) {
+        pfd[0].fd = lfd;    pfd[0].events = POLLIN;
+        for (i = 0; i < AGG_CONN_MAX; i++) {
+            pfd[i + 1].fd     = Conn[i].fd;
+            pfd[i + 1].events = POLLIN;
+        }
+        if (poll (pfd, AGG_CONN_MAX + 1, 200) <= 0)     continue;
+
+        if (pfd[0].revents & POLLIN) {
+            int fd = accept (lfd, NULL, NULL);
+
+            for (i = 0; (fd >= 0) && (i < AGG_CONN_MAX); i++) {
+                if (Conn[i].fd >= 0)    continue;
+                if ((Conn[i].buf == NULL) &&
+                    ((Conn[i].buf = malloc (AGG_PAYLOAD_MAX + 1)) == NULL))
+                    continue;
+                Conn[i].fd  = fd;   Conn[i].no = ++Conns;
+                Conn[i].pos = 0;
+                break;
+            }
+            if ((fd >= 0) && (i == AGG_CONN_MAX))   close (fd);
+        }
+        for (i = 0; i < AGG_CONN_MAX; i++) {
+            agg_conn_t *c = &Conn[i];
+
+            if ((c->fd < 0) || !(pfd[i + 1].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+            if (!conn_rx (c)) {
+                close (c->fd);  c->fd = -1;
+            }
+        }
+    }
+    for (i = 0; i < StationCnt; i++)
+        fprintf (stderr, "%-16s store %08x : %u records, duplicate %u\n",
+            Station[i].station, Station[i].store_id, Station[i].cnt, Station[i].dup);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+static void rec_print (const agg_rec_t *prec, const uint8_t *raw)
+{
+    static result_rec_t rec;
+    char tstr[32];
+    time_t t;
+
+    if (!rec_head (raw, prec->size, &rec))  return;
+    t = (time_t)(rec.end_ts / 1000);
+    strftime (tstr, sizeof(tstr), "%Y-%m-%d %H:%M:%S", localtime (&t));
+    printf ("%-16s ch%d %-20s %c %s test %u ms, items %d, err %d\n",
+        prec->station, rec.ch, rec.mac, rec.result ? rec.result : '-', tstr,
+        rec.test_ms, rec.item_cnt, rec.err_cnt);
+}
+
+//------------------------------------------------------------------------------
+// -q : aggregator 에 mac 검색 요청
+//------------------------------------------------------------------------------
+static int agg_query (void)
+{
+    struct addrinfo hints, *res = NULL;
+    agg_msg_t msg;
+    agg_rec_t rec;
+    char port [8];
+    int fd, pos, n;
+
+    memset (&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    snprintf (port, sizeof(port), "%d", OPT_PORT);
+    if (getaddrinfo (OPT_HOST, port, &hints, &res) || (res == NULL) ||
+        ((fd = socket (res->ai_family, res->ai_socktype, 0)) < 0) ||
+        connect (fd, res->ai_addr, res->ai_addrlen)) {
+        fprintf (stderr, "%s:%d connect error\n", OPT_HOST, OPT_PORT);
+        return 1;
+    }
+    freeaddrinfo (res);
+
+    memset (&msg, 0, sizeof(msg));
+    msg.magic = AGG_MAGIC;
+    msg.type  = eAGG_QUERY;
+    msg.size  = strlen (OPT_QUERY);
+    if ((send (fd, &msg, sizeof(msg), 0) != sizeof(msg)) ||
+        (send (fd, OPT_QUERY, msg.size, 0) != (ssize_t)msg.size))
+        return 1;
+
+    if ((recv (fd, &msg, sizeof(msg), MSG_WAITALL) != sizeof(msg)) ||
+        (msg.magic != AGG_MAGIC) || (msg.size > AGG_BATCH_SIZE))
+        return 1;
+    for (pos = 0; pos < (int)msg.size; pos += n)
+        if ((n = recv (fd, RawBuf + pos, msg.size - pos, 0)) <= 0)     return 1;
+    close (fd);
+
+    for (pos = 0; pos + (int)sizeof(rec) <= (int)msg.size; pos += sizeof(rec) + rec.size) {
+        memcpy (&rec, RawBuf + pos, sizeof(rec));
+        rec_print (&rec, RawBuf + pos + sizeof(rec));
+    }
+    printf ("%s : %u records\n", OPT_QUERY, msg.cnt);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// -s : station 별 요약
+//------------------------------------------------------------------------------
+static void agg_summary (void)
+{
+    uint32_t cnt = 0, pass = 0;
+    int i;
+
+    printf ("%-16s %-8s %8s %8s %8s\n", "station", "store", "records", "pass", "yield");
+    for (i = 0; i < StationCnt; i++) {
+        agg_station_t *s = &Station[i];
+
+        printf ("%-16s %08x %8u %8u %7.2f%%\n", s->station, s->store_id, s->cnt, s->pass,
+            s->cnt ? 100.0 * s->pass / s->cnt : 0.0);
+        cnt += s->cnt;  pass += s->pass;
+    }
+    printf ("%-16s %-8s %8u %8u %7.2f%%\n", "total", "", cnt, pass,
+        cnt ? 100.0 * pass / cnt : 0.0);
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char *argv[])
+{
+    parse_opts (argc, argv);
+
+    if ((RawBuf = malloc (AGG_BATCH_SIZE)) == NULL)     return 1;
+    if (OPT_QUERY)  return agg_query ();
+
+    if (!store_load ())     return 1;
+    if (OPT_SUMMARY) {
+        agg_summary ();
+        return 0;
+    }
+    signal (SIGINT,  sig_handler);
+    signal (SIGTERM, sig_handler);
+    signal (SIGPIPE, SIG_IGN);
+    return agg_server ();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,701 @@
+//------------------------------------------------------------------------------
+/**
+ * @file jig_sim.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG virtual client board simulator (pty, load generator).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <getopt.h>
+#include <pthread.h>
+
+//------------------------------------------------------------------------------
+#include "../device_check.h"
+#include "../protocol_v3.h"
+#include "../mono_time.h"
+#include "../plan_sched.h"
+
+//------------------------------------------------------------------------------
+#define SIM_CH_MAX          32
+#define SIM_ITEM_MAX        256
+#define SIM_SAMPLE_MAX      16384
+#define SIM_LINK_PREFIX     "/tmp/jig_sim"
+
+/* server 응답 대기 시간 */
+#define SIM_REPLY_TIMEOUT   3000
+#define SIM_READY_RETRY     1000
+/* plan : 다른 channel 의 resource item 이 끝날때 까지 grant 대기 */
+#define SIM_PLAN_TIMEOUT    10000
+#define SIM_RES_CNT         2
+
+//------------------------------------------------------------------------------
+enum {
+    eSIM_READY = 0,     // R -> O
+    eSIM_ITEM,          // S -> A/C
+    eSIM_CYCLE,         // R -> X
+    eSIM_END
+};
+
+static const char *SimName [eSIM_END] = { "ready", "item", "cycle" };
+
+typedef struct sim_item__t {
+    int     gid, did, is_str;
+    int     res;    // SCHED_RES_xxx (jig 공유 resource)
+}   sim_item_t;
+
+typedef struct sim_stat__t {
+    uint32_t    cnt;
+    uint32_t    timeout;
+    uint32_t    us [SIM_SAMPLE_MAX];
+}   sim_stat_t;
+
+typedef struct sim_ch__t {
+    int         ch;
+    int         fd;
+    char        path [64];
+    char        link [64];
+    unsigned    seed;
+    uint32_t    boards, fails, errs, garbage;
+    int         rx_pos;
+    char        rx [SERIAL_RESP_SIZE +1];
+    int         rx_seq;
+    /* sequence id (ready 에서 협상, 0 = 기존 protocol) */
+    int         seq_window;
+    int         seq;
+    /* binary frame v3 (ready 에서 협상) */
+    int         v3;
+    /* test plan (server grant 순서로 시험) */
+    int         plan;
+    uint64_t    res_wait_us;
+    ptc_v3_rx_t v3_rx;
+    ptc_frame_t v3_frame;
+    sim_stat_t  stat [eSIM_END];
+    pthread_t   thread;
+}   sim_ch_t;
+
+//------------------------------------------------------------------------------
+static sim_item_t   SimItem [SIM_ITEM_MAX];
+static int          SimItemCnt = 0;
+static sim_ch_t     SimCh [SIM_CH_MAX];
+
+static int  OPT_CH = 2, OPT_BOARDS = 10, OPT_JSON = 0, OPT_CHECK = 0;
+static int  OPT_DELAY_MIN = 10, OPT_DELAY_MAX = 50, OPT_BOOT = 500, OPT_GAP = 1000;
+static int  OPT_FAIL = 0, OPT_ERR = 0, OPT_GARBAGE = 0, OPT_WINDOW = 0, OPT_V3 = 0;
+static int  OPT_BATCH = 0, OPT_PLAN = 0, OPT_RES_MS = 0;
+static const char *OPT_CFG = NULL, *OPT_LINK = SIM_LINK_PREFIX;
+
+static volatile int SimStop = 0;
+
+/* jig 공유 resource (adc, ethernet) : 두 channel 이 동시에 사용할 수 없음 */
+static pthread_mutex_t SimRes [SIM_RES_CNT] = {
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER
+};
+
+//------------------------------------------------------------------------------
+// server cfg 의 D 라인 (gid, did, uid_l, uid_r, is_str) 으로 test item 구성
+//------------------------------------------------------------------------------
+static int sim_load_items (const char *fname)
+{
+    char buf [256];
+    FILE *fp;
+
+    if ((fp = fopen (fname, "r")) == NULL) {
+        printf ("%s : %s open error (%s)\n", __func__, fname, strerror(errno));
+        return 0;
+    }
+    while ((fgets (buf, sizeof(buf), fp) != NULL) && (SimItemCnt < SIM_ITEM_MAX)) {
+        int gid, did, uid_l, uid_r, is_str, res = -1;
+        char res_str [16] = "";
+
+        if (buf[0] != 'D')  continue;
+        if (sscanf (buf, "D,%d,%d,%d,%d,%d,%15[^,\r\n]",
+                    &gid, &did, &uid_l, &uid_r, &is_str, res_str) < 5)
+            continue;
+        /* resource column (server sched_parse_res 와 같은 형식) */
+        if (strchr (res_str, '-'))  res = 0;
+        if (strchr (res_str, 'a'))  res = ((res < 0) ? 0 : res) | SCHED_RES_ADC;
+        if (strchr (res_str, 'n'))  res = ((res < 0) ? 0 : res) | SCHED_RES_NET;
+
+        SimItem[SimItemCnt].gid    = gid;
+        SimItem[SimItemCnt].did    = did;
+        SimItem[SimItemCnt].is_str = is_str;
+        SimItem[SimItemCnt].res    = (res < 0) ? SCHED_RES_DEFAULT(gid, did) : res;
+        SimItemCnt++;
+    }
+    fclose (fp);
+    return SimItemCnt;
+}
+
+//------------------------------------------------------------------------------
+static int sim_rand (sim_ch_t *sc, int min, int max)
+{
+    return (max > min) ? min + (int)(rand_r (&sc->seed) % (unsigned)(max - min + 1)) : min;
+}
+
+static int sim_percent (sim_ch_t *sc, int percent)
+{
+    return (percent > 0) && ((int)(rand_r (&sc->seed) % 100) < percent);
+}
+
+//------------------------------------------------------------------------------
+// item 시험 시간 : -x 설정시 resource item 은 OPT_RES_MS 동안 resource 를 점유
+// (다른 channel 이 사용중이면 대기), 나머지는 -d 범위의 random
+//------------------------------------------------------------------------------
+static void sim_item_delay (sim_ch_t *sc, const sim_item_t *item)
+{
+    uint64_t start;
+    int r;
+
+    if (!OPT_RES_MS || !item->res) {
+        usleep (sim_rand (sc, OPT_DELAY_MIN, OPT_DELAY_MAX) * 1000);
+        return;
+    }
+    start = mono_us ();
+    for (r = 0; r < SIM_RES_CNT; r++)
+        if (item->res & (1 << r))   pthread_mutex_lock (&SimRes[r]);
+    sc->res_wait_us += mono_us () - start;
+
+    usleep (OPT_RES_MS * 1000);
+    for (r = SIM_RES_CNT -1; r >= 0; r--)
+        if (item->res & (1 << r))   pthread_mutex_unlock (&SimRes[r]);
+}
+
+//------------------------------------------------------------------------------
+static void sim_stat_add (sim_ch_t *sc, int id, uint64_t us)
+{
+    sim_stat_t *st = &sc->stat[id];
+
+    if (st->cnt < SIM_SAMPLE_MAX)
+        st->us[st->cnt++] = (us > UINT32_MAX) ? UINT32_MAX : (uint32_t)us;
+}
+
+//------------------------------------------------------------------------------
+static void sim_send_v3 (sim_ch_t *sc, char cmd, int gid, int did, char status,
+                         const void *payload, int len, int seq)
+{
+    uint8_t bin [PTC_V3_FRAME_MAX];
+    int size = ptc_v3_encode (bin, sizeof(bin), cmd, status, gid, did, seq, payload, len);
+
+    if (sim_percent (sc, OPT_GARBAGE)) {
+        bin[sim_rand (sc, 0, size -1)] ^= 0x10;
+        sc->garbage++;
+    }
+    if (write (sc->fd, bin, size) < 0)
+        printf ("%s : ch %d write error (%s)\n", __func__, sc->ch, strerror(errno));
+}
+
+//------------------------------------------------------------------------------
+// seq != 0 : value 앞에 "nnn:" 추가 (sequence id 협상된 경우)
+//------------------------------------------------------------------------------
+static void sim_send (sim_ch_t *sc, char cmd, int gid, int did, char status,
+                      const char *value, int seq)
+{
+    char resp [DEVICE_RESP_SIZE +1], frame [SERIAL_RESP_SIZE +8], str [DEVICE_RESP_SIZE -1];
+
+    if (sc->v3) {
+        sim_send_v3 (sc, cmd, gid, did, status, value, strlen (value), seq);
+        return;
+    }
+    if (seq)    snprintf (str, sizeof(str), "%03u:%.16s", (unsigned)seq % 1000, value);
+    else        snprintf (str, sizeof(str), "%s", value);
+    DEVICE_RESP_FORM_STR (resp, status, str);
+    SERIAL_RESP_FORM (frame, cmd, gid, did, resp);
+
+    /* failure injection : frame 1 byte 손상 (server parse error) */
+    if (sim_percent (sc, OPT_GARBAGE)) {
+        frame[sim_rand (sc, 1, SERIAL_RESP_SIZE -2)] = '#';
+        sc->garbage++;
+    }
+    strcat (frame, "\r\n");
+    if (write (sc->fd, frame, strlen (frame)) < 0)
+        printf ("%s : ch %d write error (%s)\n", __func__, sc->ch, strerror(errno));
+}
+
+//------------------------------------------------------------------------------
+// server frame 수신 (timeout ms), return 1 : frame 수신, 0 : timeout
+//------------------------------------------------------------------------------
+static int sim_recv (sim_ch_t *sc, parse_resp_data_t *pdata, int timeout)
+{
+    uint64_t end = mono_ms () + timeout;
+    struct pollfd pfd = { .fd = sc->fd, .events = POLLIN };
+    char c;
+
+    while (!SimStop) {
+        int64_t remain = (int64_t)(end - mono_ms ());
+
+        if (remain <= 0)    return 0;
+        if (poll (&pfd, 1, (int)remain) <= 0)   continue;
+        if (read (sc->fd, &c, 1) != 1)          continue;
+
+        if (sc->v3) {
+            if (!ptc_v3_decode (&sc->v3_rx, (uint8_t)c, &sc->v3_frame))   continue;
+
+            memset (pdata, 0, sizeof(parse_resp_data_t));
+            pdata->cmd      = sc->v3_frame.cmd;
+            pdata->gid      = sc->v3_frame.gid;
+            pdata->did      = sc->v3_frame.did;
+            pdata->status_c = sc->v3_frame.status;
+            strncpy (pdata->resp_s, (char *)sc->v3_frame.payload, sizeof(pdata->resp_s) -1);
+            sc->rx_seq = sc->v3_frame.seq;
+            return 1;
+        }
+        if (c == '@')   sc->rx_pos = 0;
+        if (sc->rx_pos >= SERIAL_RESP_SIZE)     continue;
+
+        sc->rx[sc->rx_pos++] = c;
+        if ((sc->rx_pos == SERIAL_RESP_SIZE) && (c == '#')) {
+            int gid = -1, did = -1;
+            char *value = &sc->rx[14];
+
+            sc->rx[SERIAL_RESP_SIZE] = 0;
+            memset (pdata, 0, sizeof(parse_resp_data_t));
+            /* "@,c,gg,dddd,s,value,#" */
+            pdata->cmd = sc->rx[2];
+            sscanf (&sc->rx[4], "%d,%d", &gid, &did);
+            pdata->gid = gid;
+            pdata->did = did;
+            pdata->status_c = sc->rx[12];
+
+            /* value (20 byte, 오른쪽 정렬) */
+            sc->rx[SERIAL_RESP_SIZE -2] = 0;
+            while (*value == ' ')   value++;
+            strncpy (pdata->resp_s, value, sizeof(pdata->resp_s) -1);
+
+            /* "nnn:value" */
+            sc->rx_seq = 0;
+            if (sc->seq_window && (strlen (value) >= 4) && (value[3] == ':'))
+                sc->rx_seq = atoi (value);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+static char sim_item_value (sim_ch_t *sc, const sim_item_t *item, char *value)
+{
+    char status = sim_percent (sc, OPT_FAIL) ? 'F' : 'P';
+
+    /* server check item (adc, header) */
+    if (OPT_CHECK && ((item->gid == eGID_ADC) || (item->gid == eGID_HEADER)))
+        status = 'C';
+    if (item->is_str)   sprintf (value, "sim-%d-%d", item->gid, item->did);
+    else                sprintf (value, "%d", sim_rand (sc, 0, 1000));
+    if (status == 'F')  sc->fails++;
+    return status;
+}
+
+//------------------------------------------------------------------------------
+static void sim_send_item (sim_ch_t *sc, const sim_item_t *item, int seq)
+{
+    char value [32], status = sim_item_value (sc, item, value);
+
+    sim_send (sc, RESP_CMD_STATUS, item->gid, item->did, status, value, seq);
+}
+
+//------------------------------------------------------------------------------
+// S 전송 후 같은 gid/did (seq) 의 A/C 응답 대기 (server 의 R 요청에는 요청 seq 로 응답)
+//------------------------------------------------------------------------------
+static int sim_wait_reply (sim_ch_t *sc, const sim_item_t *item, int seq)
+{
+    parse_resp_data_t r;
+    uint64_t start = mono_us ();
+    int i;
+
+    while (sim_recv (sc, &r, SIM_REPLY_TIMEOUT)) {
+        if ((r.cmd == RESP_CMD_ACK) || (r.cmd == 'C')) {
+            if ((r.gid == item->gid) && (r.did == item->did) && (sc->rx_seq == seq)) {
+                sim_stat_add (sc, eSIM_ITEM, mono_us () - start);
+                return 1;
+            }
+        }
+        if (r.cmd == RESP_CMD_REQUEST) {
+            for (i = 0; i < SimItemCnt; i++)
+                if ((SimItem[i].gid == r.gid) && (SimItem[i].did == r.did))
+                    sim_send_item (sc, &SimItem[i], sc->rx_seq);
+        }
+    }
+    sc->stat[eSIM_ITEM].timeout++;
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// v3 batch : item 결과를 N frame 으로 모아서 전송, A 의 bitmap 에 없는 item (check 등) 은 S 로 전송
+//------------------------------------------------------------------------------
+static void sim_send_batch (sim_ch_t *sc, int first, int cnt)
+{
+    uint8_t payload [PTC_V3_PAYLOAD_MAX];
+    char value [32], status [PTC_V3_BATCH_MAX];
+    parse_resp_data_t r;
+    uint64_t start;
+    int i, len = 0, seq = sc->seq = (sc->seq % 999) + 1, acked = 0;
+
+    for (i = 0; i < cnt; i++) {
+        status[i] = sim_item_value (sc, &SimItem[first + i], value);
+        len = ptc_v3_batch_add (payload, sizeof(payload), len,
+                SimItem[first + i].gid, SimItem[first + i].did, status[i], value);
+    }
+    start = mono_us ();
+    sim_send_v3 (sc, RESP_CMD_BATCH, -1, -1, 'P', payload, len, seq);
+
+    while (sim_recv (sc, &r, SIM_REPLY_TIMEOUT)) {
+        if ((r.cmd == RESP_CMD_ACK) && (sc->rx_seq == seq)) {
+            sim_stat_add (sc, eSIM_ITEM, mono_us () - start);
+            acked = 1;
+            break;
+        }
+    }
+    if (!acked)     sc->stat[eSIM_ITEM].timeout++;
+
+    /* bitmap 에 없는 item 은 하나씩 전송 */
+    for (i = 0; (i < cnt) && !SimStop; i++) {
+        if (acked && (sc->v3_frame.payload[i / 8] & (1 << (i % 8))))  continue;
+
+        seq = sc->seq = (sc->seq % 999) + 1;
+        sim_send_item  (sc, &SimItem[first + i], seq);
+        sim_wait_reply (sc, &SimItem[first + i], seq);
+    }
+}
+
+//------------------------------------------------------------------------------
+// plan : server 가 요청(R, grant) 한 item 만 시험, "plan:done" 을 받으면 return
+// 같은 seq 의 재전송은 시험 없이 결과만 다시 전송, item 통계 = 결과 전송 부터 다음 grant 까지
+//------------------------------------------------------------------------------
+static void sim_plan (sim_ch_t *sc)
+{
+    parse_resp_data_t r;
+    uint64_t sent = 0;
+    int i, seq, last = 0;
+
+    while (sim_recv (sc, &r, SIM_PLAN_TIMEOUT)) {
+        if ((r.cmd == RESP_CMD_OKAY) && (strstr (r.resp_s, "plan:done") != NULL))
+            return;
+        if ((r.cmd != RESP_CMD_REQUEST) || (r.gid < 0))     continue;
+
+        seq = sc->rx_seq;
+        for (i = 0; i < SimItemCnt; i++) {
+            if ((SimItem[i].gid != r.gid) || (SimItem[i].did != r.did))     continue;
+            if (seq != last) {
+                if (sent)   sim_stat_add (sc, eSIM_ITEM, mono_us () - sent);
+                sim_item_delay (sc, &SimItem[i]);
+            }
+            sim_send_item (sc, &SimItem[i], seq);
+            sent = mono_us ();
+            last = seq;
+            break;
+        }
+    }
+    sc->stat[eSIM_ITEM].timeout++;
+}
+
+//------------------------------------------------------------------------------
+static void sim_board (sim_ch_t *sc, int board)
+{
+    parse_resp_data_t r;
+    uint64_t start, ready = 0;
+    char mac [20], ready_value [20];
+    int i, retry, seq;
+
+    usleep (OPT_BOOT * 1000);
+
+    /* ready : server 가 O 를 보낼때 까지 R 재전송, O 의 "seq:n" 이면 sequence id 사용 */
+    /* v3 : sequence id 필요 (window 최소 1) */
+    if (OPT_V3)         sprintf (ready_value, "ready:%d:v3", OPT_WINDOW ? OPT_WINDOW : 1);
+    else if (OPT_WINDOW)sprintf (ready_value, "ready:%d", OPT_WINDOW);
+    else if (OPT_PLAN)  sprintf (ready_value, "ready:1");
+    else                sprintf (ready_value, "ready");
+    if (OPT_PLAN)       strcat  (ready_value, ":plan");
+    sc->seq_window = 0;
+    sc->v3 = 0;
+    sc->plan = 0;
+
+    for (retry = 0, start = mono_us (); !SimStop && (retry < 30); retry++) {
+        uint64_t t = mono_us ();
+
+        sim_send (sc, RESP_CMD_REQUEST, -1, -1, 'P', ready_value, 0);
+        while (sim_recv (sc, &r, SIM_READY_RETRY)) {
+            /* 이전 board 의 plan:done 재전송 은 무시 */
+            if ((r.cmd == RESP_CMD_OKAY) && (strstr (r.resp_s, "plan:done") == NULL)) {
+                if ((OPT_WINDOW || OPT_V3 || OPT_PLAN) && !strncmp (r.resp_s, "seq:", 4))
+                    sc->seq_window = atoi (r.resp_s + 4);
+                if (OPT_PLAN && (strstr (r.resp_s, ":plan") != NULL))
+                    sc->plan = 1;
+                if (OPT_V3 && (strstr (r.resp_s, ":v3") != NULL)) {
+                    memset (&sc->v3_rx, 0, sizeof(sc->v3_rx));
+                    sc->v3 = 1;
+                }
+                sim_stat_add (sc, eSIM_READY, mono_us () - t);
+                ready = 1;
+                break;
+            }
+        }
+        if (ready)  break;
+        sc->stat[eSIM_READY].timeout++;
+    }
+    if (!ready)     return;
+
+    /* plan : item 순서는 server grant */
+    i = 0;
+    if (sc->plan) {
+        sim_plan (sc);
+        i = SimItemCnt;
+    }
+    /* v3 batch : item 시험 시간은 같고 결과만 OPT_BATCH 개씩 모아서 전송 */
+    for (; sc->v3 && OPT_BATCH && (i < SimItemCnt) && !SimStop; ) {
+        int first = i;
+
+        for (; (i < SimItemCnt) && (i - first < OPT_BATCH); i++)
+            sim_item_delay (sc, &SimItem[i]);
+        sim_send_batch (sc, first, i - first);
+    }
+    for (; (i < SimItemCnt) && !SimStop; i++) {
+        sim_item_delay (sc, &SimItem[i]);
+        /* client seq : 001 ~ 999 */
+        seq = 0;
+        if (sc->seq_window)     seq = sc->seq = (sc->seq % 999) + 1;
+        sim_send_item  (sc, &SimItem[i], seq);
+        sim_wait_reply (sc, &SimItem[i], seq);
+    }
+    if (sim_percent (sc, OPT_ERR)) {
+        /* v3 : value(20 byte) 보다 긴 error text */
+        sim_send (sc, RESP_CMD_ERROR, -1, -1, 'F', sc->v3 ?
+            "sim error : usb 3.0 device enumerated as high speed (480M), check cable" :
+            "sim error", 0);
+        sc->errs++;
+    }
+
+    /* 001e06 + ch + board (중복 없음) */
+    sprintf (mac, "001e06%02x%04x", sc->ch & 0xFF, board & 0xFFFF);
+    sim_send (sc, 'M', -1, -1, 'P', mac, 0);
+    sim_send (sc, 'X', -1, -1, 'P', "complete", 0);
+    sim_stat_add (sc, eSIM_CYCLE, mono_us () - start);
+    sc->boards++;
+}
+
+//------------------------------------------------------------------------------
+static void *thread_sim_func (void *arg)
+{
+    sim_ch_t *sc = (sim_ch_t *)arg;
+    int board;
+
+    for (board = 0; !SimStop && (!OPT_BOARDS || (board < OPT_BOARDS)); board++) {
+        sim_board (sc, board);
+        usleep (OPT_GAP * 1000);
+    }
+    return arg;
+}
+
+//------------------------------------------------------------------------------
+static int sim_ch_init (sim_ch_t *sc, int ch)
+{
+    struct termios tio;
+    int slave;
+
+    sc->ch   = ch;
+    sc->seed = (unsigned)(mono_us () ^ (ch * 2654435761u));
+
+    if ((sc->fd = posix_openpt (O_RDWR | O_NOCTTY)) < 0)    return 0;
+    if (grantpt (sc->fd) || unlockpt (sc->fd))              return 0;
+    if (ptsname_r (sc->fd, sc->path, sizeof(sc->path)))     return 0;
+
+    /* echo off, raw (server 의 uart_init 이전 tty 설정), slave 는 닫지 않고 유지 */
+    if ((slave = open (sc->path, O_RDWR | O_NOCTTY)) >= 0) {
+        tcgetattr (slave, &tio);
+        cfmakeraw (&tio);
+        tcsetattr (slave, TCSANOW, &tio);
+    }
+    /* server cfg 의 C 라인에 사용할 고정 이름 */
+    sprintf (sc->link, "%s%d", OPT_LINK, ch);
+    unlink  (sc->link);
+    if (symlink (sc->path, sc->link))
+        printf ("%s : %s link error (%s)\n", __func__, sc->link, strerror(errno));
+
+    printf ("%s : ch %d = %s (%s)\n", __func__, ch, sc->link, sc->path);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+static int stat_cmp (const void *a, const void *b)
+{
+    uint32_t ua = *(const uint32_t *)a, ub = *(const uint32_t *)b;
+
+    return (ua > ub) - (ua < ub);
+}
+
+static void sim_report (uint64_t elapsed_us)
+{
+    static sim_stat_t all;
+    uint32_t boards = 0, fails = 0, errs = 0, garbage = 0;
+    uint64_t res_wait = 0;
+    int ch, id;
+
+    for (ch = 0; ch < OPT_CH; ch++) {
+        res_wait += SimCh[ch].res_wait_us;
+        boards  += SimCh[ch].boards;
+        fails   += SimCh[ch].fails;
+        errs    += SimCh[ch].errs;
+        garbage += SimCh[ch].garbage;
+    }
+
+    if (OPT_JSON)   printf ("{\"channels\":%d,\"items\":%d,\"boards\":%u,\"elapsed_ms\":%.1f,"
+                        "\"boards_per_min\":%.2f", OPT_CH, SimItemCnt, boards,
+                        elapsed_us / 1000.0, boards * 60000000.0 / (elapsed_us ? elapsed_us : 1));
+    else            printf ("\n%d channels, %d items, %u boards, %.1f sec, %.2f boards/min\n",
+                        OPT_CH, SimItemCnt, boards, elapsed_us / 1000000.0,
+                        boards * 60000000.0 / (elapsed_us ? elapsed_us : 1));
+
+    for (id = 0; id < eSIM_END; id++) {
+        uint64_t sum = 0;
+        uint32_t i;
+
+        memset (&all, 0, sizeof(all));
+        for (ch = 0; ch < OPT_CH; ch++) {
+            sim_stat_t *st = &SimCh[ch].stat[id];
+
+            for (i = 0; (i < st->cnt) && (all.cnt < SIM_SAMPLE_MAX); i++)
+                all.us[all.cnt++] = st->us[i];
+            all.timeout += st->timeout;
+        }
+        qsort (all.us, all.cnt, sizeof(uint32_t), stat_cmp);
+        for (i = 0; i < all.cnt; i++)   sum += all.us[i];
+
+#define SIM_PCT(p)  (all.cnt ? all.us[(all.cnt - 1) * (p) / 100] / 1000.0 : 0.0)
+        if (OPT_JSON)
+            printf (",\"%s\":{\"cnt\":%u,\"timeout\":%u,\"avg_ms\":%.3f,\"min_ms\":%.3f,"
+                "\"p50_ms\":%.3f,\"p99_ms\":%.3f,\"max_ms\":%.3f}",
+                SimName[id], all.cnt, all.timeout, all.cnt ? sum / 1000.0 / all.cnt : 0.0,
+                SIM_PCT(0), SIM_PCT(50), SIM_PCT(99), SIM_PCT(100));
+        else
+            printf ("%-6s cnt %6u timeout %4u avg %9.3f min %9.3f p50 %9.3f p99 %9.3f max %9.3f ms\n",
+                SimName[id], all.cnt, all.timeout, all.cnt ? sum / 1000.0 / all.cnt : 0.0,
+                SIM_PCT(0), SIM_PCT(50), SIM_PCT(99), SIM_PCT(100));
+#undef SIM_PCT
+    }
+    if (OPT_JSON)   printf (",\"res_wait_ms\":%.1f,\"inject\":{\"fail\":%u,\"error\":%u,\"corrupt\":%u}}\n",
+                        res_wait / 1000.0, fails, errs, garbage);
+    else            printf ("resource wait %.1f ms, inject fail %u, error %u, corrupt %u\n",
+                        res_wait / 1000.0, fails, errs, garbage);
+}
+
+//------------------------------------------------------------------------------
+static void sim_signal (int sig)
+{
+    SimStop = sig;
+}
+
+//------------------------------------------------------------------------------
+static void print_usage (const char *prog)
+{
+    puts("");
+    printf("Usage: %s -c {server cfg} [-n ch] [-b boards] [options]\n", prog);
+    puts("\n"
+        "  -c : server config file (D lines = test items)\n"
+        "  -n : virtual channel count (default 2)\n"
+        "  -b : boards per channel (default 10, 0 = until Ctrl+C)\n"
+        "  -d : item response delay ms (min:max, default 10:50)\n"
+        "  -t : board boot time ms before ready (default 500)\n"
+        "  -g : gap between boards ms (default 1000)\n"
+        "  -p : item fail percent (status F)\n"
+        "  -e : error msg(E) percent per board\n"
+        "  -z : corrupted frame percent\n"
+        "  -k : send status C for adc/header items (server side check)\n"
+        "  -w : request sequence id with window n (ready:n)\n"
+        "  -3 : request binary frame v3 (ready:n:v3)\n"
+        "  -m : v3 batch status (N), n items per frame (max 64)\n"
+        "  -s : test plan, run items in server grant order (ready:n:plan)\n"
+        "  -x : shared resource (adc, ethernet) item time ms, serialized across channels\n"
+        "  -l : pty link prefix (default " SIM_LINK_PREFIX ")\n"
+        "  -j : json report\n"
+        "\n"
+        "  server cfg : C,0,/dev/i2c-0," SIM_LINK_PREFIX "0,115200,\n"
+        "\n"
+    );
+    exit(1);
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char *argv[])
+{
+    uint64_t start;
+    int c, ch;
+
+    while ((c = getopt (argc, argv, "c:n:b:d:t:g:p:e:z:kw:3m:sx:l:jh")) != -1) {
+        switch (c) {
+        case 'c':   OPT_CFG     = optarg;           break;
+        case 'n':   OPT_CH      = atoi (optarg);    break;
+        case 'b':   OPT_BOARDS  = atoi (optarg);    break;
+        case 'd':
+            if (sscanf (optarg, "%d:%d", &OPT_DELAY_MIN, &OPT_DELAY_MAX) != 2)
+                OPT_DELAY_MAX = OPT_DELAY_MIN;
+            break;
+        case 't':   OPT_BOOT    = atoi (optarg);    break;
+        case 'g':   OPT_GAP     = atoi (optarg);    break;
+        case 'p':   OPT_FAIL    = atoi (optarg);    break;
+        case 'e':   OPT_ERR     = atoi (optarg);    break;
+        case 'z':   OPT_GARBAGE = atoi (optarg);    break;
+        case 'k':   OPT_CHECK   = 1;                break;
+        case 'w':   OPT_WINDOW  = atoi (optarg);    break;
+        case '3':   OPT_V3      = 1;                break;
+        case 'm':
+            OPT_BATCH = atoi (optarg);
+            if (OPT_BATCH > PTC_V3_BATCH_MAX)   OPT_BATCH = PTC_V3_BATCH_MAX;
+            break;
+        case 's':   OPT_PLAN    = 1;                break;
+        case 'x':   OPT_RES_MS  = atoi (optarg);    break;
+        case 'l':   OPT_LINK    = optarg;           break;
+        case 'j':   OPT_JSON    = 1;                break;
+        case 'h':
+        default:
+            print_usage (argv[0]);
+            break;
+        }
+    }
+    if ((OPT_CFG == NULL) || (OPT_CH < 1) || (OPT_CH > SIM_CH_MAX))
+        print_usage (argv[0]);
+
+    if (!sim_load_items (OPT_CFG)) {
+        printf ("%s : no test item(D) in %s\n", argv[0], OPT_CFG);
+        return 1;
+    }
+
+    signal (SIGINT,  sim_signal);
+    signal (SIGTERM, sim_signal);
+
+    for (ch = 0; ch < OPT_CH; ch++) {
+        if (!sim_ch_init (&SimCh[ch], ch)) {
+            printf ("%s : ch %d pty error (%s)\n", argv[0], ch, strerror(errno));
+            return 1;
+        }
+    }
+
+    start = mono_us ();
+    for (ch = 0; ch < OPT_CH; ch++)
+        pthread_create (&SimCh[ch].thread, NULL, thread_sim_func, &SimCh[ch]);
+    for (ch = 0; ch < OPT_CH; ch++)
+        pthread_join (SimCh[ch].thread, NULL);
+
+    sim_report (mono_us () - start);
+
+    for (ch = 0; ch < OPT_CH; ch++)     unlink (SimCh[ch].link);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
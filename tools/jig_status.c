@@ -0,0 +1,173 @@
+//------------------------------------------------------------------------------
+/**
+ * @file jig_status.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server status page reader (shared memory).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+
+//------------------------------------------------------------------------------
+#include "../status_shm.h"
+
+//------------------------------------------------------------------------------
+/* server.h eSTATUS_xxx 순서 */
+static const char *StatusName [] = { "STOP", "WAIT", "RUN", "PRINT", "ERR" };
+
+static int OPT_WATCH = 0, OPT_JSON = 0;
+
+//------------------------------------------------------------------------------
+static const char *status_name (uint32_t status)
+{
+    return (status < sizeof(StatusName) / sizeof(StatusName[0])) ?
+            StatusName[status] : "UNKNOWN";
+}
+
+//------------------------------------------------------------------------------
+static int bit_count (const uint64_t *map, int cnt)
+{
+    int i, n = 0;
+
+    for (i = 0; i < cnt; i++)   n += __builtin_popcountll (map[i]);
+    return n;
+}
+
+//------------------------------------------------------------------------------
+static void print_text (const status_page_t *s)
+{
+    uint32_t i;
+
+    printf ("ip = %s, usblp = %s\n", s->ip_addr, s->usblp_status ? "on" : "off");
+    printf ("ch status power ready  pass  fail items  mac                 dup  "
+            "last(gid,did,value)          boards  pass  fail\n");
+    for (i = 0; i < s->ch_cnt; i++) {
+        const status_ch_t *c = &s->ch[i];
+        printf ("%2u %-6s %5u %5u %5d %5d %5u  %-18s %4u  %2d,%4d,%-20s %6llu %5llu %5llu\n",
+            i, status_name (c->status), c->power, c->ready,
+            bit_count (c->pass_map, STATUS_ITEM_MAX / 64),
+            bit_count (c->fail_map, STATUS_ITEM_MAX / 64),
+            c->item_cnt, c->mac[0] ? c->mac : "-", c->mac_dup,
+            c->cur_gid, c->cur_did, c->cur_value,
+            (unsigned long long)c->board_cnt,
+            (unsigned long long)c->pass_cnt, (unsigned long long)c->fail_cnt);
+    }
+}
+
+//------------------------------------------------------------------------------
+// JSON string escape (ctl_api.c ctl_json_str 와 동일, src 는 STATUS_STR_SIZE 이내)
+//------------------------------------------------------------------------------
+#define JSON_STR_SIZE   (STATUS_STR_SIZE * 6 + 1)
+
+static char *json_str (char *dst, const char *src)
+{
+    int pos = 0, i;
+
+    for (i = 0; (i < STATUS_STR_SIZE) && src[i]; i++) {
+        unsigned char c = (unsigned char)src[i];
+
+        if ((c == '"') || (c == '\\')) {
+            dst[pos++] = '\\';  dst[pos++] = c;
+        } else if (c < 0x20)
+            pos += sprintf (dst + pos, "\\u%04x", c);
+        else
+            dst[pos++] = c;
+    }
+    dst[pos] = 0;
+    return dst;
+}
+
+//------------------------------------------------------------------------------
+static void print_json (const status_page_t *s)
+{
+    char ip [JSON_STR_SIZE], mac [JSON_STR_SIZE], value [JSON_STR_SIZE];
+    uint32_t i;
+
+    printf ("{\"boot_ts\":%llu,\"ip\":\"%s\",\"usblp\":%u,\"ch\":[",
+        (unsigned long long)s->boot_ts, json_str (ip, s->ip_addr), s->usblp_status);
+    for (i = 0; i < s->ch_cnt; i++) {
+        const status_ch_t *c = &s->ch[i];
+        printf ("%s{\"status\":\"%s\",\"power\":%u,\"ready\":%u,\"mac\":\"%s\",\"mac_dup\":%u,"
+            "\"items\":%u,\"pass_map\":\"%016llx%016llx\",\"fail_map\":\"%016llx%016llx\","
+            "\"err_cnt\":%u,\"gid\":%d,\"did\":%d,\"value\":\"%s\","
+            "\"boards\":%llu,\"pass\":%llu,\"fail\":%llu,\"update_ms\":%llu}",
+            i ? "," : "", status_name (c->status), c->power, c->ready,
+            json_str (mac, c->mac), c->mac_dup,
+            c->item_cnt,
+            (unsigned long long)c->pass_map[1], (unsigned long long)c->pass_map[0],
+            (unsigned long long)c->fail_map[1], (unsigned long long)c->fail_map[0],
+            c->err_cnt, c->cur_gid, c->cur_did, json_str (value, c->cur_value),
+            (unsigned long long)c->board_cnt, (unsigned long long)c->pass_cnt,
+            (unsigned long long)c->fail_cnt, (unsigned long long)c->update_ms);
+    }
+    printf ("]}\n");
+}
+
+//------------------------------------------------------------------------------
+static void print_usage (const char *prog)
+{
+    puts("");
+    printf("Usage: %s [-j] [-w interval(ms)] [-f shm file]\n", prog);
+    puts("\n"
+        "  -j : json output (1 line)\n"
+        "  -w : watch mode\n"
+        "  -f : status page file (default " STATUS_SHM_PATH ")\n"
+        "\n"
+    );
+    exit(1);
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char *argv[])
+{
+    const char *fname = STATUS_SHM_PATH;
+    const status_page_t *page;
+    status_page_t snap;
+    int c;
+
+    while ((c = getopt (argc, argv, "jw:f:h")) != -1) {
+        switch (c) {
+        case 'j':   OPT_JSON  = 1;              break;
+        case 'w':   OPT_WATCH = atoi (optarg);  break;
+        case 'f':   fname = optarg;             break;
+        case 'h':
+        default:
+            print_usage (argv[0]);
+            break;
+        }
+    }
+
+    if ((page = status_shm_open (fname)) == NULL) {
+        printf ("%s : %s not found (server not running?)\n", argv[0], fname);
+        return 1;
+    }
+
+    do {
+        if (!status_shm_read (page, &snap)) {
+            printf ("%s : status page busy\n", argv[0]);
+            return 1;
+        }
+        if (OPT_WATCH && !OPT_JSON)     printf ("\033[H\033[J");
+        if (OPT_JSON)   print_json (&snap);
+        else            print_text (&snap);
+        fflush (stdout);
+
+        if (OPT_WATCH)  usleep (OPT_WATCH * 1000);
+    } while (OPT_WATCH);
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
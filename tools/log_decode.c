@@ -0,0 +1,152 @@
+//------------------------------------------------------------------------------
+/**
+ * @file log_decode.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server binary event log decoder.
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <getopt.h>
+
+//------------------------------------------------------------------------------
+#include "../log_ring.h"
+
+//------------------------------------------------------------------------------
+#define LOG_EVENT_NAME(id, name, fmt)   name,
+#define LOG_EVENT_FMT(id, name, fmt)    fmt,
+
+static const char *EventName [] = { LOG_EVENT_TABLE(LOG_EVENT_NAME) };
+static const char *EventFmt  [] = { LOG_EVENT_TABLE(LOG_EVENT_FMT)  };
+
+static int OPT_CH = -1, OPT_EVENT = -1;
+
+//------------------------------------------------------------------------------
+// %d : next int arg, %s : record string, 그 외 문자는 그대로 출력
+//------------------------------------------------------------------------------
+static void log_render (const log_rec_t *rec)
+{
+    char tstr[32], str[LOG_STR_SIZE +1];
+    const char *fmt;
+    struct tm tm;
+    time_t sec = (time_t)(rec->ts_ns / 1000000000ull);
+    int narg = 0;
+
+    localtime_r (&sec, &tm);
+    strftime (tstr, sizeof(tstr), "%Y-%m-%d %H:%M:%S", &tm);
+
+    memset (str, 0, sizeof(str));
+    memcpy (str, rec->str, LOG_STR_SIZE);
+    /* remove tail CR/LF */
+    while (strlen(str) && ((str[strlen(str)-1] == '\r') || (str[strlen(str)-1] == '\n')))
+        str[strlen(str)-1] = 0;
+
+    printf ("%s.%06u ", tstr, (unsigned)((rec->ts_ns % 1000000000ull) / 1000));
+    if (rec->ch == LOG_CH_NONE) printf ("ch:- ");
+    else                        printf ("ch:%d ", rec->ch);
+
+    if (rec->event >= eLOG_END) {
+        printf ("event(%d) : %d %d %d %d [%s]\n", rec->event,
+            rec->arg[0], rec->arg[1], rec->arg[2], rec->arg[3], str);
+        return;
+    }
+
+    printf ("%-12s : ", EventName[rec->event]);
+    for (fmt = EventFmt[rec->event]; *fmt; fmt++) {
+        if ((fmt[0] == '%') && (fmt[1] == 'd')) {
+            printf ("%d", (narg < LOG_ARG_CNT) ? rec->arg[narg] : 0);
+            narg++; fmt++;
+        } else if ((fmt[0] == '%') && (fmt[1] == 's')) {
+            printf ("%s", str);
+            fmt++;
+        } else
+            putchar (*fmt);
+    }
+    putchar ('\n');
+}
+
+//------------------------------------------------------------------------------
+static int log_decode (const char *fname)
+{
+    FILE *fp;
+    log_file_hdr_t hdr;
+    log_rec_t rec;
+
+    if ((fp = fopen (fname, "rb")) == NULL) {
+        printf ("%s : %s file open error!\n", __func__, fname);
+        return 0;
+    }
+    if ((fread (&hdr, sizeof(hdr), 1, fp) != 1) ||
+        memcmp (hdr.magic, LOG_FILE_MAGIC, sizeof(hdr.magic)) ||
+        (hdr.rec_size != sizeof(log_rec_t))) {
+        printf ("%s : %s is not a jig binary log!\n", __func__, fname);
+        fclose (fp);
+        return 0;
+    }
+    while (fread (&rec, sizeof(rec), 1, fp) == 1) {
+        if ((OPT_CH    != -1) && (rec.ch    != OPT_CH))     continue;
+        if ((OPT_EVENT != -1) && (rec.event != OPT_EVENT))  continue;
+        log_render (&rec);
+    }
+    fclose (fp);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+static void print_usage (const char *prog)
+{
+    int i;
+
+    puts("");
+    printf("Usage: %s [-c channel] [-e event name] {log file ...}\n", prog);
+    puts("\n"
+        "  e.g) log_decode log/jig_server.blog.1 log/jig_server.blog\n"
+        "\n"
+        "  events :"
+    );
+    for (i = 0; i < eLOG_END; i++)
+        printf ("    %-12s %s\n", EventName[i], EventFmt[i]);
+    exit(1);
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char *argv[])
+{
+    int c, i;
+
+    while ((c = getopt (argc, argv, "c:e:h")) != -1) {
+        switch (c) {
+        case 'c':
+            OPT_CH = atoi (optarg);
+            break;
+        case 'e':
+            for (i = 0; i < eLOG_END; i++)
+                if (!strcmp (optarg, EventName[i]))     OPT_EVENT = i;
+            if (OPT_EVENT == -1)    print_usage (argv[0]);
+            break;
+        case 'h':
+        default:
+            print_usage (argv[0]);
+            break;
+        }
+    }
+    if (optind >= argc)     print_usage (argv[0]);
+
+    for (i = optind; i < argc; i++)
+        log_decode (argv[i]);
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
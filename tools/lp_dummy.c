@@ -0,0 +1,259 @@
+//------------------------------------------------------------------------------
+/**
+ * @file lp_dummy.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG network label printer stand-in (lpmode 1 print server, lpmode 2 raw port).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <getopt.h>
+#include <stdint.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+//------------------------------------------------------------------------------
+#define DUMMY_CONN_MAX      16
+#define DUMMY_BUF_SIZE      4096
+#define DUMMY_ID_MAX        1024
+
+//------------------------------------------------------------------------------
+typedef struct dummy_conn__t {
+    int     fd;
+    int     no;
+    int     len;
+    int     jobs;
+    char    buf [DUMMY_BUF_SIZE];
+}   dummy_conn_t;
+
+//------------------------------------------------------------------------------
+static dummy_conn_t Conn [DUMMY_CONN_MAX];
+static uint32_t     PrintedId [DUMMY_ID_MAX];
+static FILE         *OutFp;
+static volatile int Running = 1;
+
+static uint32_t     Labels = 0, Dups = 0, Nacks = 0, Conns = 0;
+
+static int  OPT_SERVER = 0, OPT_PORT = 0, OPT_DELAY = 0, OPT_DROP = 0, OPT_NACK = 0;
+static char *OPT_OUT = NULL;
+
+//------------------------------------------------------------------------------
+static void print_usage (const char *prog)
+{
+    puts("");
+    printf("Usage: %s [-s] [-p port] [-o file] [-d ms] [-x jobs] [-n nth]\n", prog);
+    puts("\n"
+        "  -s            : print server mode (lpmode 1, default raw port printer : lpmode 2)\n"
+        "  -p {port}     : listen port (default 9101 : print server, 9100 : raw)\n"
+        "  -o {file}     : printed label output (default stdout)\n"
+        "  -d {ms}       : print delay per label (slow printer)\n"
+        "  -x {jobs}     : close connection after {jobs} jobs (reconnect test)\n"
+        "  -n {nth}      : print server mode, every {nth} job fails (N reply)\n"
+        "\n"
+        "  e.g) lp_dummy -s -p 9101 -d 200\n"
+    );
+    exit(1);
+}
+
+//------------------------------------------------------------------------------
+static void parse_opts (int argc, char *argv[])
+{
+    int c;
+
+    while ((c = getopt (argc, argv, "sp:o:d:x:n:h")) != -1) {
+        switch (c) {
+            case 's':   OPT_SERVER = 1;             break;
+            case 'p':   OPT_PORT   = atoi (optarg); break;
+            case 'o':   OPT_OUT    = optarg;        break;
+            case 'd':   OPT_DELAY  = atoi (optarg); break;
+            case 'x':   OPT_DROP   = atoi (optarg); break;
+            case 'n':   OPT_NACK   = atoi (optarg); break;
+            default :   print_usage (argv[0]);      break;
+        }
+    }
+    if (!OPT_PORT)  OPT_PORT = OPT_SERVER ? 9101 : 9100;
+}
+
+//------------------------------------------------------------------------------
+static void sig_handler (int sig)
+{
+    (void)sig;
+    Running = 0;
+}
+
+//------------------------------------------------------------------------------
+static void label_out (dummy_conn_t *c, const char *type, const char *str)
+{
+    if (OPT_DELAY)  usleep (OPT_DELAY * 1000);
+
+    Labels++;
+    fprintf (OutFp, "%d,%s,%s\n", c->no, type, str);
+    fflush  (OutFp);
+}
+
+//------------------------------------------------------------------------------
+// print server : J,<id>,<ch>,<M|E>,... -> A,<id> / N,<id>
+// 재접속 후 재전송된 job (이미 출력한 id) 은 출력하지 않고 ack 만 전송
+//------------------------------------------------------------------------------
+static int job_line (dummy_conn_t *c, char *line)
+{
+    char reply [32], *p;
+    uint32_t id;
+    int i, dup = 0, nack;
+
+    if (strncmp (line, "J,", 2))    return 1;
+
+    id = (uint32_t)strtoul (line + 2, &p, 10);
+    for (i = 0; i < DUMMY_ID_MAX; i++)
+        if (PrintedId[i] == id)     dup = 1;
+
+    nack = OPT_NACK && !dup && (((Labels + Nacks + 1) % OPT_NACK) == 0);
+    if (dup)        Dups++;
+    else if (nack)  Nacks++;
+    else {
+        PrintedId[id % DUMMY_ID_MAX] = id;
+        label_out (c, "job", (*p == ',') ? p + 1 : p);
+    }
+    snprintf (reply, sizeof(reply), "%c,%u\n", nack ? 'N' : 'A', id);
+    return (send (c->fd, reply, strlen(reply), MSG_NOSIGNAL) > 0);
+}
+
+//------------------------------------------------------------------------------
+// raw port : ^XA ... ^XZ 단위로 ^FD 필드만 출력
+//------------------------------------------------------------------------------
+static void raw_label (dummy_conn_t *c, char *label)
+{
+    char str [256], *p = label, *e;
+    int len = 0;
+
+    memset (str, 0, sizeof(str));
+    while ((p = strstr (p, "^FD")) != NULL) {
+        p += 3;
+        if ((e = strstr (p, "^FS")) == NULL)    break;
+        len += snprintf (str + len, sizeof(str) - len, "%s%.*s",
+                        len ? "|" : "", (int)(e - p), p);
+        if (len >= (int)sizeof(str))    break;
+        p = e + 3;
+    }
+    label_out (c, "zpl", str);
+}
+
+//------------------------------------------------------------------------------
+// return 0 : connection close
+//------------------------------------------------------------------------------
+static int conn_parse (dummy_conn_t *c)
+{
+    char *s = c->buf, *e;
+
+    c->buf[c->len] = 0;
+    while (1) {
+        if (OPT_SERVER) {
+            if ((e = strchr (s, '\n')) == NULL)     break;
+            *e = 0;
+            if (!job_line (c, s))   return 0;
+            s = e + 1;
+        } else {
+            char *xa = strstr (s, "^XA");
+
+            if ((xa == NULL) || ((e = strstr (xa, "^XZ")) == NULL))  break;
+            e[0] = 0;
+            raw_label (c, xa);
+            s = e + 3;
+        }
+        c->jobs++;
+        if (OPT_DROP && (c->jobs >= OPT_DROP)) {
+            fprintf (stderr, "%s : conn %d, drop after %d jobs\n", __func__, c->no, c->jobs);
+            return 0;
+        }
+    }
+    c->len -= (s - c->buf);
+    memmove (c->buf, s, c->len);
+    if (c->len >= DUMMY_BUF_SIZE - 1)   c->len = 0;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char *argv[])
+{
+    struct sockaddr_in addr;
+    struct pollfd pfd [DUMMY_CONN_MAX + 1];
+    int lfd, i, n, on = 1;
+
+    parse_opts (argc, argv);
+
+    if ((OutFp = OPT_OUT ? fopen (OPT_OUT, "a") : stdout) == NULL) {
+        fprintf (stderr, "%s open error (%s)\n", OPT_OUT, strerror(errno));
+        return 1;
+    }
+    signal (SIGINT,  sig_handler);
+    signal (SIGTERM, sig_handler);
+    signal (SIGPIPE, SIG_IGN);
+
+    memset (&addr, 0, sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons (OPT_PORT);
+    addr.sin_addr.s_addr = htonl (INADDR_ANY);
+
+    lfd = socket (AF_INET, SOCK_STREAM, 0);
+    setsockopt (lfd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (bind (lfd, (struct sockaddr *)&addr, sizeof(addr)) || listen (lfd, 4)) {
+        fprintf (stderr, "port %d bind error (%s)\n", OPT_PORT, strerror(errno));
+        return 1;
+    }
+    for (i = 0; i < DUMMY_CONN_MAX; i++)    Conn[i].fd = -1;
+
+    fprintf (stderr, "lp_dummy : %s mode, port %d\n", OPT_SERVER ? "print server" : "raw", OPT_PORT);
+
+    while (Running) {
+        pfd[0].fd = lfd;    pfd[0].events = POLLIN;
+        for (i = 0; i < DUMMY_CONN_MAX; i++) {
+            pfd[i + 1].fd     = Conn[i].fd;
+            pfd[i + 1].events = POLLIN;
+        }
+        if (poll (pfd, DUMMY_CONN_MAX + 1, 200) <= 0)   continue;
+
+        if (pfd[0].revents & POLLIN) {
+            int fd = accept (lfd, NULL, NULL);
+
+            for (i = 0; (fd >= 0) && (i < DUMMY_CONN_MAX); i++) {
+                if (Conn[i].fd >= 0)    continue;
+                memset (&Conn[i], 0, sizeof(dummy_conn_t));
+                Conn[i].fd = fd;    Conn[i].no = ++Conns;
+                fprintf (stderr, "conn %d open\n", Conn[i].no);
+                break;
+            }
+            if ((fd >= 0) && (i == DUMMY_CONN_MAX))     close (fd);
+        }
+        for (i = 0; i < DUMMY_CONN_MAX; i++) {
+            dummy_conn_t *c = &Conn[i];
+
+            if ((c->fd < 0) || !(pfd[i + 1].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+
+            n = read (c->fd, c->buf + c->len, DUMMY_BUF_SIZE - c->len - 1);
+            if ((n <= 0) || ((c->len += n) && !conn_parse (c))) {
+                fprintf (stderr, "conn %d close (%d jobs)\n", c->no, c->jobs);
+                close (c->fd);  c->fd = -1;
+            }
+        }
+    }
+    fprintf (stderr, "\nlabels = %u, duplicate = %u, nack = %u, connections = %u\n",
+        Labels, Dups, Nacks, Conns);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
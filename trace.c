@@ -0,0 +1,470 @@
+//------------------------------------------------------------------------------
+/**
+ * @file trace.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server per-board timeline trace (chrome trace json, csv).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <ctype.h>
+#include <time.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+//------------------------------------------------------------------------------
+#include "trace.h"
+#include "mono_time.h"
+
+//------------------------------------------------------------------------------
+/* 1ms 미만의 idle 구간은 uart 전송 시간으로 보고 무시 */
+#define TRACE_GAP_MIN_US    1000
+
+//------------------------------------------------------------------------------
+static const char *TypeName [eTRACE_END] = {
+    "boot", "ready", "item", "check", "request", "mac", "error", "complete",
+};
+
+/* device_check.h eGID_xxx 순서 */
+static const char *GidName [] = {
+    "system", "storage", "usb", "hdmi", "adc", "ethernet", "header",
+    "audio", "led", "pwm", "ir", "gpio", "fw", "misc",
+};
+
+static const char *LaneName [] = { "", "client", "server", "request" };
+
+typedef struct trace_run__t {
+    int         ch;
+    int         gen;        // trace_begin 마다 증가 (span handle 확인용)
+    char        mac [24];
+    char        result;
+    uint64_t    t0_us;      // mono us (power on)
+    uint64_t    t0_ms;      // epoch ms (power on)
+    int         cnt;
+    trace_span_t    span [TRACE_SPAN_MAX];
+    struct trace_run__t *next;
+}   trace_run_t;
+
+//------------------------------------------------------------------------------
+static trace_run_t  TraceRun [TRACE_CH_MAX];
+static char         TraceDir [128];
+static int          TraceEnable = 0;
+
+/* trace dir 의 file 수, 크기 (trace thread 에서만 접근) */
+static int          TraceFiles = 0;
+static uint64_t     TraceBytes = 0;
+
+static trace_run_t      *QueueHead = NULL, *QueueTail = NULL;
+static pthread_t        thread_trace;
+/* TraceRun : main loop (span) 과 channel_start (ui / ctl) 에서 접근 */
+static pthread_mutex_t  run_mutex   = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t  queue_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   queue_cond  = PTHREAD_COND_INITIALIZER;
+
+//------------------------------------------------------------------------------
+static const char *span_name (const trace_span_t *s, char *buf)
+{
+    if ((s->type == eTRACE_ITEM) || (s->type == eTRACE_CHECK) || (s->type == eTRACE_REQUEST))
+        sprintf (buf, "%s %s(%d,%d)", TypeName[s->type],
+            ((s->gid >= 0) && ((size_t)s->gid < sizeof(GidName) / sizeof(GidName[0]))) ? GidName[s->gid] : "gid",
+            s->gid, s->did);
+    else
+        sprintf (buf, "%s", TypeName[s->type]);
+    return buf;
+}
+
+//------------------------------------------------------------------------------
+void trace_begin (int ch)
+{
+    trace_run_t *run;
+    int gen;
+
+    if ((ch < 0) || (ch >= TRACE_CH_MAX))   return;
+
+    pthread_mutex_lock (&run_mutex);
+    run = &TraceRun[ch];
+    gen = (run->gen + 1) & 0x7fff;
+    memset (run, 0, sizeof(trace_run_t));
+    run->ch    = ch;
+    run->gen   = gen;
+    run->t0_us = mono_us ();
+    run->t0_ms = real_ms ();
+    pthread_mutex_unlock (&run_mutex);
+}
+
+//------------------------------------------------------------------------------
+// return span idx (-1 = 기록 안함), run_mutex lock 상태에서 호출
+//------------------------------------------------------------------------------
+static int trace_span_add (trace_run_t *run, int type, int gid, int did,
+                            uint64_t start_us, uint64_t end_us)
+{
+    trace_span_t *s;
+
+    if (!run->t0_us || (run->cnt >= TRACE_SPAN_MAX))    return -1;
+
+    s = &run->span[run->cnt];
+    memset (s, 0, sizeof(trace_span_t));
+    s->type = (uint8_t)type;
+    s->gid  = (int8_t)gid;
+    s->did  = (int16_t)did;
+    s->lane = (type == eTRACE_REQUEST) ? eTRACE_LANE_REQUEST :
+              ((type == eTRACE_READY) || (type == eTRACE_CHECK) || (type == eTRACE_MAC)) ?
+                eTRACE_LANE_SERVER : eTRACE_LANE_CLIENT;
+    s->start_us = (start_us > run->t0_us) ? start_us - run->t0_us : 0;
+    s->end_us   = (end_us   > run->t0_us) ? end_us   - run->t0_us : s->start_us;
+    return run->cnt++;
+}
+
+//------------------------------------------------------------------------------
+void trace_span (int ch, int type, int gid, int did, uint64_t start_us, uint64_t end_us)
+{
+    if ((ch < 0) || (ch >= TRACE_CH_MAX))   return;
+
+    pthread_mutex_lock (&run_mutex);
+    trace_span_add (&TraceRun[ch], type, gid, did, start_us, end_us);
+    pthread_mutex_unlock (&run_mutex);
+}
+
+//------------------------------------------------------------------------------
+// return span handle (run gen << 16 | idx), 다음 board 의 span 을 잘못 닫지 않도록 gen 확인
+//------------------------------------------------------------------------------
+int trace_span_begin (int ch, int type, int gid, int did)
+{
+    uint64_t now = mono_us ();
+    int idx;
+
+    if ((ch < 0) || (ch >= TRACE_CH_MAX))   return -1;
+
+    pthread_mutex_lock (&run_mutex);
+    idx = trace_span_add (&TraceRun[ch], type, gid, did, now, now);
+    if (idx >= 0)
+        idx |= TraceRun[ch].gen << 16;
+    pthread_mutex_unlock (&run_mutex);
+    return idx;
+}
+
+//------------------------------------------------------------------------------
+void trace_span_end (int ch, int handle)
+{
+    trace_run_t *run;
+    uint64_t now = mono_us ();
+    int idx = handle & 0xffff;
+
+    if ((ch < 0) || (ch >= TRACE_CH_MAX) || (handle < 0))   return;
+
+    pthread_mutex_lock (&run_mutex);
+    run = &TraceRun[ch];
+    if (run->t0_us && (run->gen == (handle >> 16)) && (idx < run->cnt))
+        run->span[idx].end_us = (now > run->t0_us) ? now - run->t0_us : 0;
+    pthread_mutex_unlock (&run_mutex);
+}
+
+//------------------------------------------------------------------------------
+// critical path : run 종료 시점에서 역방향으로, 현재 시점 이전에 끝난 span 중
+//                 가장 늦게 끝난 span 을 선택 (request lane 은 overlay 이므로 제외)
+//------------------------------------------------------------------------------
+static uint64_t trace_critical_path (trace_run_t *run, uint64_t *type_us, uint64_t *idle_us)
+{
+    uint64_t t = 0, total = 0;
+    int i, pick;
+
+    for (i = 0; i < run->cnt; i++)
+        if (run->span[i].end_us > t)    t = run->span[i].end_us;
+    total = t;
+
+    while (t > 0) {
+        for (i = 0, pick = -1; i < run->cnt; i++) {
+            trace_span_t *s = &run->span[i];
+
+            if (s->critical || (s->lane == eTRACE_LANE_REQUEST))    continue;
+            if ((s->end_us > t) || (s->start_us >= t))              continue;
+            if ((pick == -1) || (s->end_us > run->span[pick].end_us) ||
+                ((s->end_us == run->span[pick].end_us) &&
+                 (s->start_us < run->span[pick].start_us)))
+                pick = i;
+        }
+        if (pick == -1) {
+            *idle_us += t;
+            break;
+        }
+        run->span[pick].critical = 1;
+        *idle_us += t - run->span[pick].end_us;
+        type_us[run->span[pick].type] += run->span[pick].end_us - run->span[pick].start_us;
+        t = run->span[pick].start_us;
+    }
+    return total;
+}
+
+//------------------------------------------------------------------------------
+// idle gap : 어떤 span 에도 포함되지 않는 구간
+//------------------------------------------------------------------------------
+static int span_cmp_start (const void *a, const void *b)
+{
+    const trace_span_t *sa = a, *sb = b;
+
+    return (sa->start_us > sb->start_us) - (sa->start_us < sb->start_us);
+}
+
+static void trace_write_gaps (FILE *fj, FILE *fc, const trace_run_t *run)
+{
+    trace_span_t *s = malloc (run->cnt * sizeof(trace_span_t));
+    uint64_t cover = 0;
+    int i, first = 1;
+
+    if (s == NULL)  return;
+
+    memcpy (s, run->span, run->cnt * sizeof(trace_span_t));
+    qsort  (s, run->cnt, sizeof(trace_span_t), span_cmp_start);
+
+    fprintf (fj, ",\"idle_gaps\":[");
+    for (i = 0; i < run->cnt; i++) {
+        if (s[i].start_us > cover + TRACE_GAP_MIN_US) {
+            fprintf (fj, "%s{\"start_ms\":%.3f,\"dur_ms\":%.3f}", first ? "" : ",",
+                cover / 1000.0, (s[i].start_us - cover) / 1000.0);
+            fprintf (fc, "gap,idle,,,%.3f,%.3f,,1\n",
+                cover / 1000.0, (s[i].start_us - cover) / 1000.0);
+            first = 0;
+        }
+        if (s[i].end_us > cover)    cover = s[i].end_us;
+    }
+    fprintf (fj, "]");
+    free (s);
+}
+
+//------------------------------------------------------------------------------
+// trace dir 보관 한도 관리
+//------------------------------------------------------------------------------
+typedef struct trace_file__t {
+    char        name [128];
+    time_t      mtime;
+    uint64_t    size;
+}   trace_file_t;
+
+static int trace_file_filter (const struct dirent *d)
+{
+    const char *ext = strrchr (d->d_name, '.');
+
+    return ext && (!strcmp (ext, ".json") || !strcmp (ext, ".csv"));
+}
+
+static int trace_file_cmp (const void *a, const void *b)
+{
+    const trace_file_t *fa = a, *fb = b;
+
+    if (fa->mtime != fb->mtime)     return (fa->mtime > fb->mtime) - (fa->mtime < fb->mtime);
+    return strcmp (fa->name, fb->name);
+}
+
+//------------------------------------------------------------------------------
+// prune = 0 : TraceFiles, TraceBytes 만 다시 계산
+// prune = 1 : 오래된 file 부터 한도의 90% 까지 삭제
+//------------------------------------------------------------------------------
+static void trace_dir_scan (int prune)
+{
+    struct dirent **list;
+    trace_file_t *files;
+    struct stat st;
+    char fname[400];
+    int i, n, cnt = 0, del = 0;
+
+    if ((n = scandir (TraceDir, &list, trace_file_filter, NULL)) < 0)   return;
+
+    TraceFiles = 0;     TraceBytes = 0;
+    if ((files = malloc ((n ? n : 1) * sizeof(trace_file_t))) != NULL) {
+        for (i = 0; i < n; i++) {
+            snprintf (fname, sizeof(fname), "%s/%s", TraceDir, list[i]->d_name);
+            if (stat (fname, &st) || !S_ISREG (st.st_mode))     continue;
+            strncpy (files[cnt].name, list[i]->d_name, sizeof(files[cnt].name) -1);
+            files[cnt].name[sizeof(files[cnt].name) -1] = 0;
+            files[cnt].mtime = st.st_mtime;
+            files[cnt].size  = st.st_size;
+            TraceBytes += st.st_size;
+            cnt++;
+        }
+        TraceFiles = cnt;
+
+        if (prune) {
+            qsort (files, cnt, sizeof(trace_file_t), trace_file_cmp);
+            for (i = 0; (i < cnt) && ((TraceFiles > TRACE_FILE_MAX * 9 / 10) ||
+                                      (TraceBytes > TRACE_SIZE_MAX / 10 * 9)); i++) {
+                snprintf (fname, sizeof(fname), "%s/%s", TraceDir, files[i].name);
+                if (unlink (fname))     continue;
+                TraceFiles--;   TraceBytes -= files[i].size;    del++;
+            }
+            printf ("%s : %s %d file(s) removed, %d file(s) %llu byte\n",
+                __func__, TraceDir, del, TraceFiles, (unsigned long long)TraceBytes);
+        }
+        free (files);
+    }
+    for (i = 0; i < n; i++)     free (list[i]);
+    free (list);
+}
+
+//------------------------------------------------------------------------------
+static void trace_export (trace_run_t *run)
+{
+    char fname[256], name[64], tstr[32];
+    uint64_t type_us[eTRACE_END], idle_us = 0, total_us;
+    time_t sec = (time_t)(run->t0_ms / 1000);
+    struct tm tm;
+    FILE *fj, *fc;
+    int i;
+
+    memset (type_us, 0, sizeof(type_us));
+    total_us = trace_critical_path (run, type_us, &idle_us);
+
+    localtime_r (&sec, &tm);
+    strftime (tstr, sizeof(tstr), "%Y%m%d-%H%M%S", &tm);
+
+    sprintf (fname, "%s/%s_ch%d_%s.json", TraceDir, tstr, run->ch, run->mac[0] ? run->mac : "nomac");
+    if ((fj = fopen (fname, "w")) == NULL) {
+        printf ("%s : %s open error (%s)\n", __func__, fname, strerror(errno));
+        return;
+    }
+    sprintf (fname, "%s/%s_ch%d_%s.csv", TraceDir, tstr, run->ch, run->mac[0] ? run->mac : "nomac");
+    if ((fc = fopen (fname, "w")) == NULL) {
+        fclose (fj);
+        return;
+    }
+
+    /* chrome://tracing, https://ui.perfetto.dev */
+    fprintf (fj, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    fprintf (fj, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"ch%d %s\"}}",
+        run->ch, run->ch, run->mac);
+    for (i = 1; i <= eTRACE_LANE_REQUEST; i++)
+        fprintf (fj, ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+            "\"args\":{\"name\":\"%s\"}}", run->ch, i, LaneName[i]);
+
+    fprintf (fc, "type,name,gid,did,start_ms,dur_ms,lane,critical\n");
+    for (i = 0; i < run->cnt; i++) {
+        trace_span_t *s = &run->span[i];
+
+        span_name (s, name);
+        fprintf (fj, ",{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,"
+            "\"pid\":%d,\"tid\":%d,\"args\":{\"gid\":%d,\"did\":%d,\"critical\":%d}}",
+            name, TypeName[s->type],
+            (unsigned long long)s->start_us, (unsigned long long)(s->end_us - s->start_us),
+            run->ch, s->lane, s->gid, s->did, s->critical);
+        fprintf (fc, "%s,%s,%d,%d,%.3f,%.3f,%s,%d\n", TypeName[s->type], name, s->gid, s->did,
+            s->start_us / 1000.0, (s->end_us - s->start_us) / 1000.0, LaneName[s->lane], s->critical);
+    }
+    fprintf (fj, "],\"metadata\":{\"ch\":%d,\"mac\":\"%s\",\"result\":\"%c\",\"start_ts\":%llu,"
+        "\"total_ms\":%.3f,\"critical_path_ms\":{",
+        run->ch, run->mac, run->result ? run->result : '-',
+        (unsigned long long)run->t0_ms, total_us / 1000.0);
+    for (i = 0; i < eTRACE_END; i++)
+        fprintf (fj, "%s\"%s\":%.3f", i ? "," : "", TypeName[i], type_us[i] / 1000.0);
+    fprintf (fj, ",\"idle\":%.3f}", idle_us / 1000.0);
+
+    trace_write_gaps (fj, fc, run);
+    fprintf (fj, "}}\n");
+
+    TraceFiles += 2;
+    TraceBytes += ftell (fj) + ftell (fc);
+    fclose (fj);
+    fclose (fc);
+
+    if ((TraceFiles > TRACE_FILE_MAX) || (TraceBytes > TRACE_SIZE_MAX))
+        trace_dir_scan (1);
+}
+
+//------------------------------------------------------------------------------
+static void *thread_trace_func (void *arg)
+{
+    trace_run_t *run;
+
+    /* 이전 실행에서 남은 file 포함 */
+    trace_dir_scan (0);
+    if ((TraceFiles > TRACE_FILE_MAX) || (TraceBytes > TRACE_SIZE_MAX))
+        trace_dir_scan (1);
+
+    while (1) {
+        pthread_mutex_lock (&queue_mutex);
+        while (QueueHead == NULL)
+            pthread_cond_wait (&queue_cond, &queue_mutex);
+        run = QueueHead;
+        if ((QueueHead = run->next) == NULL)    QueueTail = NULL;
+        pthread_mutex_unlock (&queue_mutex);
+
+        trace_export (run);
+        free (run);
+    }
+    return arg;
+}
+
+//------------------------------------------------------------------------------
+// file 이름, json 에 사용하므로 mac 은 hex 문자만 사용 ('/', '..' 등 제거)
+//------------------------------------------------------------------------------
+static void trace_mac_clean (char *dst, const char *src, int size)
+{
+    int n = 0;
+
+    for (; src && *src && (n < size - 1); src++)
+        if (isxdigit ((unsigned char)*src))
+            dst[n++] = *src;
+    dst[n] = 0;
+}
+
+//------------------------------------------------------------------------------
+// run 을 복사하여 export thread 로 전달 (file write 는 channel 과 분리)
+//------------------------------------------------------------------------------
+void trace_commit (int ch, const char *mac, char result)
+{
+    trace_run_t *run;
+
+    if (!TraceEnable || (ch < 0) || (ch >= TRACE_CH_MAX))   return;
+    if ((run = malloc (sizeof(trace_run_t))) == NULL)       return;
+
+    pthread_mutex_lock (&run_mutex);
+    if (!TraceRun[ch].t0_us || !TraceRun[ch].cnt) {
+        pthread_mutex_unlock (&run_mutex);
+        free (run);
+        return;
+    }
+    memcpy (run, &TraceRun[ch], sizeof(trace_run_t));
+    /* 다음 board 는 trace_begin() 이후 기록 */
+    TraceRun[ch].t0_us = 0;
+    pthread_mutex_unlock (&run_mutex);
+
+    trace_mac_clean (run->mac, mac, sizeof(run->mac));
+    run->result = result;
+    run->next   = NULL;
+
+    pthread_mutex_lock (&queue_mutex);
+    if (QueueTail)  QueueTail->next = run;
+    else            QueueHead = run;
+    QueueTail = run;
+    pthread_cond_signal  (&queue_cond);
+    pthread_mutex_unlock (&queue_mutex);
+}
+
+//------------------------------------------------------------------------------
+int trace_init (const char *dir)
+{
+    memset  (TraceDir, 0, sizeof(TraceDir));
+    strncpy (TraceDir, dir ? dir : TRACE_DIR_PATH, sizeof(TraceDir) -1);
+
+    if (mkdir (TraceDir, 0755) && (errno != EEXIST)) {
+        printf ("%s : %s mkdir error (%s)\n", __func__, TraceDir, strerror(errno));
+        return 0;
+    }
+    pthread_create (&thread_trace, NULL, thread_trace_func, NULL);
+    TraceEnable = 1;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
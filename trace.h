@@ -0,0 +1,77 @@
+//------------------------------------------------------------------------------
+/**
+ * @file trace.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server per-board timeline trace (chrome trace json, csv).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+#define TRACE_DIR_PATH      "trace"
+#define TRACE_CH_MAX        2
+#define TRACE_SPAN_MAX      512
+
+/* trace dir 보관 한도 (json + csv), 넘으면 오래된 file 부터 90% 까지 삭제 */
+#define TRACE_FILE_MAX      2000
+#define TRACE_SIZE_MAX      (64 * 1024 * 1024)
+
+//------------------------------------------------------------------------------
+// span type (lane = chrome trace tid)
+//------------------------------------------------------------------------------
+enum {
+    eTRACE_BOOT,        // power on -> ready(R)          (client)
+    eTRACE_READY,       // ready(R) -> okay(O)           (server)
+    eTRACE_ITEM,        // previous reply -> status(S)   (client)
+    eTRACE_CHECK,       // device_resp_check()           (server)
+    eTRACE_REQUEST,     // server request(R) -> status(S)(request)
+    eTRACE_MAC,         // mac(M) + label print          (server)
+    eTRACE_ERROR,       // error msg(E)                  (client)
+    eTRACE_COMPLETE,    // complete(X)                   (client)
+    eTRACE_END
+};
+
+enum {
+    eTRACE_LANE_CLIENT = 1,
+    eTRACE_LANE_SERVER,
+    eTRACE_LANE_REQUEST,
+};
+
+typedef struct trace_span__t {
+    uint8_t     type;
+    uint8_t     lane;
+    int8_t      gid;        // -1 = none
+    uint8_t     critical;   // critical path span (export 시 계산)
+    int16_t     did;
+    uint16_t    rsvd;
+    uint64_t    start_us;   // board power on 기준 (us)
+    uint64_t    end_us;
+}   trace_span_t;
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+extern  int     trace_init      (const char *dir);
+extern  void    trace_begin     (int ch);
+/* return span handle (-1 = 기록 안함), trace_span_end 에 사용 */
+extern  int     trace_span_begin(int ch, int type, int gid, int did);
+extern  void    trace_span_end  (int ch, int handle);
+extern  void    trace_span      (int ch, int type, int gid, int did, uint64_t start_us, uint64_t end_us);
+extern  void    trace_commit    (int ch, const char *mac, char result);
+
+//------------------------------------------------------------------------------
+#endif  // __TRACE_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
@@ -0,0 +1,352 @@
+//------------------------------------------------------------------------------
+/**
+ * @file wave.c
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server board power-up waveform capture (ramp, droop, overshoot).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+//------------------------------------------------------------------------------
+#include "server.h"
+#include "wave.h"
+#include "log_ring.h"
+
+//------------------------------------------------------------------------------
+#define WAVE_CH_MAX     2
+
+typedef struct wave_cap__t {
+    int             active;
+    int             armed;          // 모든 rail 이 내려간 뒤 다시 trigger 가능
+    int             rail_cnt;
+    uint64_t        base_us;        // 첫 sample (pre-trigger) 시각
+    uint64_t        trigger_us;
+    int             pre_cnt;
+    wave_rail_t     info [WAVE_RAIL_MAX];
+    uint16_t        cnt  [WAVE_RAIL_MAX];
+    wave_sample_t   s    [WAVE_RAIL_MAX][WAVE_SAMPLE_MAX];
+
+    /* trigger 이전 sample (ring) */
+    uint64_t        pre_t  [WAVE_RAIL_MAX][WAVE_PRE_CNT];
+    int32_t         pre_mV [WAVE_RAIL_MAX][WAVE_PRE_CNT];
+    uint32_t        pre_pos[WAVE_RAIL_MAX];
+}   wave_cap_t;
+
+typedef struct wave_done__t {
+    uint64_t        trigger_us;
+    int             rail_cnt;
+    int             size;
+    uint8_t         data [RESULT_WAVE_SIZE];
+}   wave_done_t;
+
+static wave_cap_t   WaveCap  [WAVE_CH_MAX];
+static wave_done_t  WaveDone [WAVE_CH_MAX];
+static uint8_t      WaveTmp  [RESULT_WAVE_SIZE];
+
+static pthread_mutex_t wave_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+//------------------------------------------------------------------------------
+static int varint_put (uint8_t *buf, int pos, int size, uint32_t v)
+{
+    do {
+        if (pos >= size)    return -1;
+        buf[pos++] = (uint8_t)((v & 0x7F) | (v > 0x7F ? 0x80 : 0));
+        v >>= 7;
+    } while (v);
+    return pos;
+}
+
+//------------------------------------------------------------------------------
+static int varint_get (const uint8_t *buf, int pos, int size, uint32_t *pv)
+{
+    uint32_t v = 0;
+    int shift = 0;
+
+    while (pos < size && shift < 32) {
+        v |= (uint32_t)(buf[pos] & 0x7F) << shift;
+        if (!(buf[pos++] & 0x80))   { *pv = v;  return pos; }
+        shift += 7;
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+static uint32_t zigzag_enc (int32_t v)  { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+static int32_t  zigzag_dec (uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+//------------------------------------------------------------------------------
+// rail 하나의 metric 계산 (pre-trigger sample 포함)
+//------------------------------------------------------------------------------
+static void wave_metric (wave_cap_t *pw, int rail)
+{
+    wave_rail_t   *pi = &pw->info[rail];
+    wave_sample_t *ps = pw->s[rail];
+    uint32_t trig = (uint32_t)(pw->trigger_us - pw->base_us);
+    int i, n = pw->cnt[rail], tail, v10, v90, i10 = -1, i90 = -1;
+    int64_t sum = 0;
+    int32_t min, max;
+
+    pi->cnt = (uint16_t)n;
+    if (n == 0)     return;
+
+    tail = n / 5 ? n / 5 : 1;
+    for (i = n - tail; i < n; i++)  sum += ps[i].mV;
+    pi->settle_mV = (int16_t)(sum / tail);
+
+    v10 = pi->settle_mV / 10;
+    v90 = pi->settle_mV * 9 / 10;
+    for (i = 0; i < n; i++) {
+        if ((i10 < 0) && (ps[i].mV >= v10)) i10 = i;
+        if (ps[i].mV >= v90)                { i90 = i;  break; }
+    }
+    if (i90 < 0)    return;
+
+    pi->ramp_us = ps[i90].t_us - ps[i10].t_us;
+    pi->up_us   = ps[i90].t_us > trig ? ps[i90].t_us - trig : 0;
+
+    min = max = ps[i90].mV;
+    for (i = i90; i < n; i++) {
+        if (ps[i].mV < min) min = ps[i].mV;
+        if (ps[i].mV > max) max = ps[i].mV;
+    }
+    pi->droop_mV     = (int16_t)(pi->settle_mV > min ? pi->settle_mV - min : 0);
+    pi->overshoot_mV = (int16_t)(max > pi->settle_mV ? max - pi->settle_mV : 0);
+}
+
+//------------------------------------------------------------------------------
+// step 간격으로 sample 을 골라 압축, return size (-1 = buffer 부족)
+//------------------------------------------------------------------------------
+static int wave_pack (wave_cap_t *pw, uint8_t *buf, int size, int step)
+{
+    wave_hdr_t hdr;
+    wave_rail_t *pinfo = (wave_rail_t *)(buf + sizeof(hdr));
+    int rail, i, pos = sizeof(hdr) + sizeof(wave_rail_t) * pw->rail_cnt;
+
+    if (pos > size)     return -1;
+
+    hdr.version    = WAVE_VERSION;
+    hdr.rail_cnt   = (uint8_t)pw->rail_cnt;
+    hdr.pre_cnt    = (uint8_t)pw->pre_cnt;
+    hdr.trigger_us = (uint32_t)(pw->trigger_us - pw->base_us);
+    memcpy (buf, &hdr, sizeof(hdr));
+
+    for (rail = 0; rail < pw->rail_cnt; rail++) {
+        wave_rail_t info = pw->info[rail];
+        uint32_t t = 0;
+        int32_t  v = 0;
+        int start = pos, cnt = 0;
+
+        for (i = 0; i < pw->cnt[rail]; i += step, cnt++) {
+            wave_sample_t *ps = &pw->s[rail][i];
+
+            if ((pos = varint_put (buf, pos, size, ps->t_us - t)) < 0)          return -1;
+            if ((pos = varint_put (buf, pos, size, zigzag_enc (ps->mV - v))) < 0) return -1;
+            t = ps->t_us;
+            v = ps->mV;
+        }
+        info.cnt  = (uint16_t)cnt;
+        info.size = (uint16_t)(pos - start);
+        memcpy (&pinfo[rail], &info, sizeof(info));
+    }
+    return pos;
+}
+
+//------------------------------------------------------------------------------
+static void wave_finish (int ch, wave_cap_t *pw)
+{
+    wave_done_t *pd = &WaveDone[ch];
+    int rail, step, size = -1;
+
+    for (rail = 0; rail < pw->rail_cnt; rail++) {
+        wave_rail_t *pi = &pw->info[rail];
+
+        wave_metric (pw, rail);
+        LOG_EVENT (ch, eLOG_POWER_WAVE, pi->name,
+            (int)pi->ramp_us, pi->droop_mV, pi->overshoot_mV, pi->settle_mV);
+    }
+    /* result record 크기를 넘으면 sample 을 줄여서 저장 (metric 은 전체 sample 기준) */
+    for (step = 1; (step <= WAVE_SAMPLE_MAX) && (size < 0); step <<= 1)
+        size = wave_pack (pw, WaveTmp, sizeof(WaveTmp), step);
+
+    pthread_mutex_lock (&wave_mutex);
+    pd->trigger_us = pw->trigger_us;
+    pd->rail_cnt   = size > 0 ? pw->rail_cnt : 0;
+    pd->size       = size > 0 ? size : 0;
+    if (size > 0)   memcpy (pd->data, WaveTmp, size);
+    pthread_mutex_unlock (&wave_mutex);
+
+    pw->active = 0;
+}
+
+//------------------------------------------------------------------------------
+static void wave_start (wave_cap_t *pw, channel_t *pch, uint64_t now)
+{
+    int rail, i, n;
+
+    pw->rail_cnt = pch->pw_item_cnt < WAVE_RAIL_MAX ? pch->pw_item_cnt : WAVE_RAIL_MAX;
+    pw->trigger_us = now;
+    pw->base_us    = now;
+    pw->pre_cnt    = WAVE_PRE_CNT;
+
+    /* pre-trigger sample 중 가장 오래된 시각을 기준으로 */
+    for (rail = 0; rail < pw->rail_cnt; rail++) {
+        n = pw->pre_pos[rail] < WAVE_PRE_CNT ? (int)pw->pre_pos[rail] : WAVE_PRE_CNT;
+        if (n < pw->pre_cnt)    pw->pre_cnt = n;
+    }
+    for (rail = 0; rail < pw->rail_cnt; rail++) {
+        uint32_t pos = pw->pre_pos[rail] - pw->pre_cnt;
+        if (pw->pre_cnt && pw->pre_t[rail][pos % WAVE_PRE_CNT] < pw->base_us)
+            pw->base_us = pw->pre_t[rail][pos % WAVE_PRE_CNT];
+    }
+    for (rail = 0; rail < pw->rail_cnt; rail++) {
+        wave_rail_t *pi = &pw->info[rail];
+        uint32_t pos = pw->pre_pos[rail] - pw->pre_cnt;
+
+        memset (pi, 0, sizeof(wave_rail_t));
+        strncpy (pi->name, pch->pw_item[rail].cname, sizeof(pi->name) -1);
+        pi->check_mV = (int16_t)pch->pw_item[rail].check_mV;
+
+        for (i = 0; i < pw->pre_cnt; i++, pos++) {
+            pw->s[rail][i].t_us = (uint32_t)(pw->pre_t[rail][pos % WAVE_PRE_CNT] - pw->base_us);
+            pw->s[rail][i].mV   = pw->pre_mV[rail][pos % WAVE_PRE_CNT];
+        }
+        pw->cnt[rail] = (uint16_t)pw->pre_cnt;
+    }
+    pw->armed   = 0;
+    pw->active  = 1;
+}
+
+//------------------------------------------------------------------------------
+// rail read 마다 호출. capture 중이면 buffer 에, 아니면 pre-trigger ring 에 기록
+//------------------------------------------------------------------------------
+void wave_sample (int ch, int rail, uint64_t t_us, int mV)
+{
+    wave_cap_t *pw;
+
+    if ((ch < 0) || (ch >= WAVE_CH_MAX) || (rail < 0) || (rail >= WAVE_RAIL_MAX))
+        return;
+
+    pw = &WaveCap[ch];
+    if (!pw->active) {
+        uint32_t pos = pw->pre_pos[rail]++ % WAVE_PRE_CNT;
+        pw->pre_t [rail][pos] = t_us;
+        pw->pre_mV[rail][pos] = mV;
+        return;
+    }
+    if ((rail >= pw->rail_cnt) || (pw->cnt[rail] >= WAVE_SAMPLE_MAX))  return;
+
+    pw->s[rail][pw->cnt[rail]].t_us = (uint32_t)(t_us - pw->base_us);
+    pw->s[rail][pw->cnt[rail]].mV   = mV;
+    pw->cnt[rail]++;
+}
+
+//------------------------------------------------------------------------------
+// 모든 rail 을 한번 읽은 뒤 호출 (trigger / capture 종료), return 1 = capture 중
+//------------------------------------------------------------------------------
+int wave_update (int ch, channel_t *pch, int state, uint64_t now)
+{
+    wave_cap_t *pw;
+    int rail, trig = 0, down = 1;
+
+    if ((ch < 0) || (ch >= WAVE_CH_MAX))    return 0;
+
+    pw = &WaveCap[ch];
+    if (pw->active) {
+        if (now - pw->trigger_us >= WAVE_CAPTURE_MS * 1000)
+            wave_finish (ch, pw);
+        return pw->active;
+    }
+
+    for (rail = 0; (rail < pch->pw_item_cnt) && (rail < WAVE_RAIL_MAX); rail++) {
+        pw_item_t *pwi = &pch->pw_item[rail];
+        int level = pwi->check_mV * WAVE_TRIGGER_PCT / 100;
+
+        if (pwi->read_mV >= level)  { trig = 1;  down = 0; }
+    }
+    /* board 제거 (모든 rail down) 후 다음 insert 를 위해 다시 arm */
+    if (down)   pw->armed = 1;
+
+    /* 현재 읽은 값은 pre-trigger ring 의 마지막 sample (trigger 시점) */
+    if (trig && pw->armed && !state)
+        wave_start (pw, pch, now);
+    return pw->active;
+}
+
+//------------------------------------------------------------------------------
+int wave_active (int ch)
+{
+    if ((ch < 0) || (ch >= WAVE_CH_MAX))    return 0;
+    return WaveCap[ch].active;
+}
+
+//------------------------------------------------------------------------------
+int wave_attach (int ch, result_rec_t *prec, uint64_t power_us)
+{
+    wave_done_t *pd;
+    int attach = 0;
+
+    if ((ch < 0) || (ch >= WAVE_CH_MAX))    return 0;
+
+    pd = &WaveDone[ch];
+    pthread_mutex_lock (&wave_mutex);
+    /* trigger 는 check_mV 도달(power_us) 직전, 같은 insert 에서 발생 */
+    if (pd->rail_cnt &&
+        (llabs ((int64_t)(power_us - pd->trigger_us)) < WAVE_CAPTURE_MS * 1000)) {
+        memcpy (prec->wave, pd->data, pd->size);
+        prec->wave_cnt  = (uint8_t)pd->rail_cnt;
+        prec->wave_size = (uint16_t)pd->size;
+        pd->rail_cnt = 0;
+        attach = 1;
+    }
+    pthread_mutex_unlock (&wave_mutex);
+    return attach;
+}
+
+//------------------------------------------------------------------------------
+int wave_decode (const uint8_t *buf, int size, int rail,
+                 wave_rail_t *pinfo, wave_sample_t *ps, int max)
+{
+    wave_hdr_t hdr;
+    wave_rail_t info;
+    int i, pos, end;
+    uint32_t dt, dv, t = 0;
+    int32_t v = 0;
+
+    if (size < (int)sizeof(hdr))    return -1;
+    memcpy (&hdr, buf, sizeof(hdr));
+    if ((hdr.version != WAVE_VERSION) || (rail >= hdr.rail_cnt))    return -1;
+
+    pos = sizeof(hdr) + sizeof(wave_rail_t) * hdr.rail_cnt;
+    if (pos > size)     return -1;
+
+    for (i = 0; i <= rail; i++) {
+        memcpy (&info, buf + sizeof(hdr) + sizeof(wave_rail_t) * i, sizeof(info));
+        if (i < rail)   pos += info.size;
+    }
+    if (pinfo)  memcpy (pinfo, &info, sizeof(info));
+    if ((end = pos + info.size) > size) return -1;
+
+    for (i = 0; (i < info.cnt) && (i < max); i++) {
+        if ((pos = varint_get (buf, pos, end, &dt)) < 0)    return -1;
+        if ((pos = varint_get (buf, pos, end, &dv)) < 0)    return -1;
+        t += dt;
+        v += zigzag_dec (dv);
+        ps[i].t_us = t;
+        ps[i].mV   = v;
+    }
+    return i;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
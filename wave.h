@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+/**
+ * @file wave.h
+ * @author charles-park (charles.park@hardkernel.com)
+ * @brief JIG Server board power-up waveform capture (ramp, droop, overshoot).
+ * @version 2.0
+ * @date 2025-10-01
+ *
+ * @package apt install iperf3, nmap, ethtool, usbutils, alsa-utils
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef __WAVE_H__
+#define __WAVE_H__
+
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "result_store.h"
+
+//------------------------------------------------------------------------------
+//
+// board 가 없는 상태에서 rail 하나라도 check_mV 의 WAVE_TRIGGER_PCT % 를 넘으면
+// power_mon thread 가 WAVE_CAPTURE_MS 동안 주기 대기 없이 rail 을 연속으로 읽음.
+// (preallocated buffer, rail 당 최대 WAVE_SAMPLE_MAX, trigger 이전 WAVE_PRE_CNT sample 포함)
+//
+// capture 가 끝나면 rail 별 metric 계산 후 delta + varint 로 압축하여 보관,
+// board result commit 시 result record 의 WAVE section 으로 저장.
+//
+//   settle    : capture 마지막 1/5 구간 평균
+//   ramp      : settle 10% -> 90% 시간
+//   droop     : 90% 도달 이후 settle 대비 최대 하강
+//   overshoot : 90% 도달 이후 settle 대비 최대 상승
+//
+// data format : [wave_hdr_t][wave_rail_t x rail_cnt][rail 0 data][rail 1 data]...
+//               sample = varint (dt us), zigzag varint (d mV)
+//
+//------------------------------------------------------------------------------
+#define WAVE_CAPTURE_MS     200
+#define WAVE_SAMPLE_MAX     512
+#define WAVE_PRE_CNT        4
+#define WAVE_TRIGGER_PCT    10
+#define WAVE_RAIL_MAX       10      // POWER_MON_RAIL_MAX
+
+/* buffer 를 capture 구간 전체에 나누어 쓰기 위한 최소 sample 간격 */
+#define WAVE_SAMPLE_US      ((WAVE_CAPTURE_MS * 1000) / (WAVE_SAMPLE_MAX - WAVE_PRE_CNT))
+
+#define WAVE_VERSION        1
+#define WAVE_NAME_SIZE      16
+
+typedef struct wave_sample__t {
+    uint32_t    t_us;       // 첫 sample 기준
+    int32_t     mV;
+}   wave_sample_t;
+
+typedef struct wave_hdr__t {
+    uint16_t    version;
+    uint8_t     rail_cnt;
+    uint8_t     pre_cnt;
+    uint32_t    trigger_us; // 첫 sample -> trigger
+}   wave_hdr_t;
+
+typedef struct wave_rail__t {
+    char        name [WAVE_NAME_SIZE];
+    int16_t     check_mV;
+    int16_t     settle_mV;
+    int16_t     droop_mV;
+    int16_t     overshoot_mV;
+    uint32_t    ramp_us;    // 10% -> 90%
+    uint32_t    up_us;      // trigger -> 90%
+    uint16_t    cnt;        // sample 수
+    uint16_t    size;       // 압축 data size
+}   wave_rail_t;
+
+//------------------------------------------------------------------------------
+// function prototype define
+//------------------------------------------------------------------------------
+struct channel__t;
+
+/* power_mon thread */
+extern  void    wave_sample     (int ch, int rail, uint64_t t_us, int mV);
+extern  int     wave_update     (int ch, struct channel__t *pch, int state, uint64_t now);
+extern  int     wave_active     (int ch);
+
+/* power_us = 처음 rail 이 올라온 시각, 같은 insert 의 capture 만 복사 */
+extern  int     wave_attach     (int ch, result_rec_t *prec, uint64_t power_us);
+/* return sample 수 (-1 = error) */
+extern  int     wave_decode     (const uint8_t *buf, int size, int rail,
+                                 wave_rail_t *pinfo, wave_sample_t *ps, int max);
+
+//------------------------------------------------------------------------------
+#endif  // __WAVE_H__
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------